@@ -114,6 +114,40 @@ bool DbAndroidInstance::isComplete(const QString& sql) const
     return DbSqlite3::complete(sql);
 }
 
+DbBlobPtr DbAndroidInstance::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(readWrite);
+    errorCode = 1;
+    errorText = tr("Android SQLite driver does not support incremental BLOB I/O.");
+    return DbBlobPtr();
+}
+
+bool DbAndroidInstance::backupTo(const QString& filePath, int pagesPerStep, int pauseMs, BackupProgressHandler progressHandler)
+{
+    UNUSED(filePath);
+    UNUSED(pagesPerStep);
+    UNUSED(pauseMs);
+    UNUSED(progressHandler);
+    errorCode = 1;
+    errorText = tr("Android SQLite driver does not support online backup.");
+    return false;
+}
+
+bool DbAndroidInstance::getMemoryStatus(MemoryStatus& status)
+{
+    // Memory is used on the device, not in this process
+    UNUSED(status);
+    return false;
+}
+
+void DbAndroidInstance::releaseMemory()
+{
+}
+
 bool DbAndroidInstance::isOpenInternal()
 {
     return (connection && connection->isConnected());
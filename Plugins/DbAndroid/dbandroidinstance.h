@@ -28,6 +28,10 @@ class DbAndroidInstance : public AbstractDb
         bool initAfterCreated();
         bool loadExtension(const QString& filePath, const QString& initFunc);
         bool isComplete(const QString& sql) const;
+        DbBlobPtr openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite);
+        bool backupTo(const QString& filePath, int pagesPerStep, int pauseMs, BackupProgressHandler progressHandler);
+        bool getMemoryStatus(MemoryStatus& status);
+        void releaseMemory();
 
     protected:
         bool isOpenInternal();
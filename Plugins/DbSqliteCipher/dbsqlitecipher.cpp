@@ -4,6 +4,7 @@
 #include "common/unused.h"
 #include "dbsqlitecipherinstance.h"
 #include "services/notifymanager.h"
+#include "db/dbperformanceprofile.h"
 #include <limits>
 
 DbSqliteCipher::DbSqliteCipher()
@@ -40,6 +41,7 @@ QList<DbPluginOption> DbSqliteCipher::getOptionsList() const
                             "See documentation for SQLCipher for details.");
     opts << opt;
 
+    opts += DbPerformanceProfile::getOptionsList();
     return opts;
 }
 
@@ -10,27 +10,27 @@ DbSqliteCipherInstance::DbSqliteCipherInstance(const QString& name, const QStrin
 void DbSqliteCipherInstance::initAfterOpen()
 {
     SqlQueryPtr res;
-
-    QString key = connOptions[DbSqliteCipher::PASSWORD_OPT].toString();
-    if (!key.isEmpty())
-    {
-        res = exec(QString("PRAGMA key = '%1';").arg(key), Flag::NO_LOCK);
-        if (res->isError())
-            qWarning() << "Error while defining SQLCipher key:" << res->getErrorText();
-    }
-
-    QString pragmas = connOptions[DbSqliteCipher::PRAGMAS_OPT].toString();
-    QStringList pragmaList = quickSplitQueries(pragmas);
-    for (const QString& pragma : pragmaList)
+    for (const QString& query : getConnectionInitQueries())
     {
-        res = exec(pragma, Flag::NO_LOCK);
+        res = exec(query, Flag::NO_LOCK);
         if (res->isError())
-            qWarning() << "Error while defining SQLCipher pragma" << pragma << ":" << res->getErrorText();
+            qWarning() << "Error while initializing SQLCipher connection:" << res->getErrorText();
     }
 
     AbstractDb3<SqlCipher>::initAfterOpen();
 }
 
+QStringList DbSqliteCipherInstance::getConnectionInitQueries()
+{
+    QStringList queries;
+    QString key = connOptions[DbSqliteCipher::PASSWORD_OPT].toString();
+    if (!key.isEmpty())
+        queries << QString("PRAGMA key = '%1';").arg(key);
+
+    queries += quickSplitQueries(connOptions[DbSqliteCipher::PRAGMAS_OPT].toString());
+    return queries;
+}
+
 QString DbSqliteCipherInstance::getAttachSql(Db* otherDb, const QString& generatedAttachName)
 {
     QString pass = "";
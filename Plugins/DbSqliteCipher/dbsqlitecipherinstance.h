@@ -25,6 +25,7 @@ class DbSqliteCipherInstance : public AbstractDb3<SqlCipher>
     protected:
         void initAfterOpen();
         QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
+        QStringList getConnectionInitQueries();
 };
 
 #endif // DBSQLITECIPHERINSTANCE_H
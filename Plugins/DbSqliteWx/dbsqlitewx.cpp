@@ -1,5 +1,6 @@
 #include "dbsqlitewx.h"
 #include "dbsqlitewxinstance.h"
+#include "db/dbperformanceprofile.h"
 #include <QMap>
 
 DbSqliteWx::DbSqliteWx()
@@ -50,7 +51,7 @@ QList<DbPluginOption> DbSqliteWx::getOptionsList() const
                             "See documentation for SQLite3 Multiple Ciphers for details.");
     opts << optPragmas;
 
-
+    opts += DbPerformanceProfile::getOptionsList();
     return opts;
 }
 
@@ -9,33 +9,31 @@ DbSqliteWxInstance::DbSqliteWxInstance(const QString& name, const QString& path,
 void DbSqliteWxInstance::initAfterOpen()
 {
     SqlQueryPtr res;
-
-    QString cipher = connOptions[DbSqliteWx::CIPHER_OPT].toString();
-    if (!cipher.isEmpty())
+    for (const QString& query : getConnectionInitQueries())
     {
-        res = exec(QString("PRAGMA cipher = '%1';").arg(cipher), Flag::NO_LOCK);
+        res = exec(query, Flag::NO_LOCK);
         if (res->isError())
-            qWarning() << "Error while defining WxSqlite3 cipher:" << res->getErrorText();
+            qWarning() << "Error while initializing WxSqlite3 connection:" << res->getErrorText();
     }
 
-    QString pragmas = connOptions[DbSqliteWx::PRAGMAS_OPT].toString();
-    QStringList pragmaList = quickSplitQueries(pragmas);
-    for (const QString& pragma : pragmaList)
-    {
-        res = exec(pragma, Flag::NO_LOCK);
-        if (res->isError())
-            qWarning() << "Error while defining WxSqlite3 pragma" << pragma << ":" << res->getErrorText();
-    }
+    AbstractDb3<WxSQLite>::initAfterOpen();
+}
+
+QStringList DbSqliteWxInstance::getConnectionInitQueries()
+{
+    // Cipher has to be defined before the key
+    QStringList queries;
+    QString cipher = connOptions[DbSqliteWx::CIPHER_OPT].toString();
+    if (!cipher.isEmpty())
+        queries << QString("PRAGMA cipher = '%1';").arg(cipher);
+
+    queries += quickSplitQueries(connOptions[DbSqliteWx::PRAGMAS_OPT].toString());
 
     QString key = connOptions[DbSqliteWx::PASSWORD_OPT].toString();
     if (!key.isEmpty())
-    {
-        res = exec(QString("PRAGMA key = '%1';").arg(key), Flag::NO_LOCK);
-        if (res->isError())
-            qWarning() << "Error while defining WxSqlite3 key:" << res->getErrorText();
-    }
+        queries << QString("PRAGMA key = '%1';").arg(key);
 
-    AbstractDb3<WxSQLite>::initAfterOpen();
+    return queries;
 }
 
 QString DbSqliteWxInstance::getAttachSql(Db *otherDb, const QString &generatedAttachName)
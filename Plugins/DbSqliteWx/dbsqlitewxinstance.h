@@ -25,6 +25,7 @@ class DbSqliteWxInstance : public AbstractDb3<WxSQLite>
     protected:
         void initAfterOpen();
         QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
+        QStringList getConnectionInitQueries();
 };
 
 #endif // DBSQLITEWXINSTANCE_H
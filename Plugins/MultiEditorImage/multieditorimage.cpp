@@ -5,6 +5,8 @@
 #include "services/notifymanager.h"
 #include <QBuffer>
 #include <QImageReader>
+#include <QImage>
+#include <QFile>
 #include <QLabel>
 #include <QScrollArea>
 #include <QHBoxLayout>
@@ -40,6 +42,7 @@ MultiEditorImage::MultiEditorImage()
 
 void MultiEditorImage::setValue(const QVariant &value)
 {
+    blob.clear();
     this->imgData = value.toByteArray();
 
     QPixmap imgPixmap;
@@ -67,7 +70,7 @@ QVariant MultiEditorImage::getValue()
 
 void MultiEditorImage::setReadOnly(bool boolValue)
 {
-    loadAction->setEnabled(!boolValue);
+    loadAction->setEnabled(!boolValue && !blob);
 }
 
 QList<QWidget*> MultiEditorImage::getNoScrollWidgets()
@@ -86,6 +89,39 @@ void MultiEditorImage::notifyAboutUnload()
     emit aboutToBeDeleted();
 }
 
+bool MultiEditorImage::isBlobSupported() const
+{
+    return true;
+}
+
+void MultiEditorImage::setBlob(const DbBlobPtr& blob)
+{
+    this->blob = blob;
+    imgData.clear();
+    loadAction->setEnabled(false);
+
+    QImage img;
+    if (blob && blob->seek(0))
+    {
+        // Reader pulls data from the BLOB handle directly, so the encoded image is never copied as a whole
+        QImageReader ir(blob.data());
+        imgFormat = ir.format();
+        img = ir.read();
+    }
+
+    if (img.isNull())
+    {
+        imgLabel->clear();
+        imgFormat.clear();
+    }
+    else
+    {
+        imgLabel->setPixmap(QPixmap::fromImage(img));
+    }
+
+    imgLabel->adjustSize();
+}
+
 void MultiEditorImage::scale(double factor)
 {
     currentZoom *= factor;
@@ -167,7 +203,8 @@ void MultiEditorImage::saveFile()
         return;
     }
 
-    if (file.write(imgData) < imgData.size())
+    bool written = blob ? blob->copyTo(&file) : (file.write(imgData) == imgData.size());
+    if (!written)
         notifyError(tr("Could not write image into the file %1").arg(fileName));
 
     file.close();
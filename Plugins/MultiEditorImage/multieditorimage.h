@@ -25,12 +25,15 @@ class MultiEditorImage : public MultiEditorWidget
         QList<QWidget*> getNoScrollWidgets();
         void focusThisWidget();
         void notifyAboutUnload();
+        bool isBlobSupported() const;
+        void setBlob(const DbBlobPtr& blob);
 
     private:
         void scale(double factor);
 
         QByteArray imgData;
         QByteArray imgFormat;
+        DbBlobPtr blob;
         QScrollArea* scrollArea = nullptr;
         QLabel* imgLabel = nullptr;
         QAction* loadAction = nullptr;
@@ -5,6 +5,7 @@
 #-------------------------------------------------
 
 QT       -= gui
+QT       += concurrent
 
 include($$PWD/../../SQLiteStudio3/plugins.pri)
 
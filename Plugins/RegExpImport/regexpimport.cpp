@@ -6,6 +6,8 @@
 #include <QRegularExpression>
 #include <QFile>
 #include <QTextStream>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 RegExpImport::RegExpImport()
 {
@@ -44,8 +46,12 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
     safe_delete(stream);
     groups.clear();
     buffer.clear();
+    bufferPos = 0;
+    block.clear();
+    blockPos = 0;
+    pendingRows.clear();
     columns.clear();
-
+    lineByLine = cfg.RegExpImport.LineByLine.get();
 
     file = new QFile(config.inputFileName);
     if (!file->open(QFile::ReadOnly) || !file->isReadable())
@@ -61,6 +67,7 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
 
     static const QString intColTemplate = QStringLiteral("column%1");
     re = new QRegularExpression(cfg.RegExpImport.Pattern.get());
+    re->optimize(); // compiles (with JIT, if available) right away, instead of after several matches
     QString colName;
     if (cfg.RegExpImport.GroupsMode.get() == "all")
     {
@@ -101,6 +108,8 @@ void RegExpImport::afterImport()
     safe_delete(file);
     safe_delete(stream);
     buffer.clear();
+    block.clear();
+    pendingRows.clear();
     groups.clear();
 }
 
@@ -115,17 +124,161 @@ QList<ImportPlugin::ColumnDefinition> RegExpImport::getColumns() const
 
 QList<QVariant> RegExpImport::next()
 {
-    QRegularExpressionMatch match = re->match(buffer);
-    QString line;
-    while (!match.hasMatch() && !(line = stream->readLine()).isNull())
+    if (lineByLine)
+    {
+        while (pendingRows.isEmpty())
+        {
+            if (!readLinesBlock())
+                return QList<QVariant>();
+        }
+        return pendingRows.takeFirst();
+    }
+
+    while (true)
+    {
+        if (bufferPos < buffer.size())
+        {
+            // Matching the reference to unconsumed part, so the "^" still refers to the beginning of the record.
+            // The match is released before reading next line, so the buffer is not detached when appending.
+            // Offsets of the match are positions in the whole buffer, not in the reference.
+            QRegularExpressionMatch match = re->match(QStringRef(&buffer, bufferPos, buffer.size() - bufferPos), 0, QRegularExpression::PartialPreferCompleteMatch);
+            if (match.hasMatch() && match.capturedLength() > 0)
+            {
+                bufferPos = match.capturedEnd();
+                return getValues(match);
+            }
+
+            // Text before partial match will never become part of any match, so it's skipped.
+            // If there is no partial match (or the pattern matched an empty string), no following line
+            // can make the current text matching, so it's skipped entirely.
+            if (match.hasPartialMatch())
+                bufferPos = match.capturedStart();
+            else
+                bufferPos = buffer.size();
+        }
+
+        if (!readLine())
+            return QList<QVariant>();
+    }
+}
+
+bool RegExpImport::readLine()
+{
+    int lineEnd = block.indexOf('\n', blockPos);
+    while (lineEnd < 0 && !stream->atEnd())
+    {
+        block = block.mid(blockPos) + stream->read(BLOCK_SIZE);
+        blockPos = 0;
+        lineEnd = block.indexOf('\n');
+    }
+
+    if (lineEnd < 0)
+    {
+        if (blockPos >= block.size())
+            return false;
+
+        lineEnd = block.size(); // last line, without terminator
+    }
+
+    if (bufferPos >= buffer.size())
+    {
+        buffer.clear();
+        bufferPos = 0;
+    }
+    else if (bufferPos > BLOCK_SIZE)
+    {
+        buffer.remove(0, bufferPos);
+        bufferPos = 0;
+    }
+
+    int lineLength = lineEnd - blockPos;
+    if (lineLength > 0 && block[lineEnd - 1] == '\r')
+        lineLength--;
+
+    buffer.append(block.midRef(blockPos, lineLength));
+    blockPos = lineEnd + 1;
+    return true;
+}
+
+bool RegExpImport::readLinesBlock()
+{
+    if (stream->atEnd())
+        return false;
+
+    QString text = stream->read(BLOCK_SIZE);
+    if (!block.isEmpty())
+    {
+        text.prepend(block);
+        block.clear();
+    }
+
+    if (!stream->atEnd())
+    {
+        // Incomplete last line waits for the next block
+        int lastLineEnd = text.lastIndexOf('\n');
+        if (lastLineEnd > -1)
+        {
+            block = text.mid(lastLineEnd + 1);
+            text.truncate(lastLineEnd + 1);
+        }
+        else
+        {
+            block = text;
+            return true;
+        }
+    }
+
+    int chunks = qMax(1, QThread::idealThreadCount());
+    int chunkSize = text.size() / chunks + 1;
+    QList<QFuture<QList<QList<QVariant>>>> futures;
+    QRegularExpression localRe = *re;
+    int from = 0;
+    int to;
+    while (from < text.size())
     {
-        buffer += line;
-        match = re->match(buffer);
+        to = text.indexOf('\n', from + chunkSize);
+        to = (to < 0) ? text.size() : (to + 1);
+
+        futures << QtConcurrent::run([this, localRe, text, from, to]() -> QList<QList<QVariant>>
+        {
+            return matchLines(localRe, text, from, to);
+        });
+        from = to;
     }
 
-    if (!match.hasMatch())
-        return QList<QVariant>();
+    for (QFuture<QList<QList<QVariant>>>& future : futures)
+        pendingRows += future.result();
+
+    return true;
+}
+
+QList<QList<QVariant>> RegExpImport::matchLines(const QRegularExpression& localRe, const QString& text, int from, int to) const
+{
+    QList<QList<QVariant>> rows;
+    QRegularExpressionMatch match;
+    int lineEnd;
+    int lineLength;
+    while (from < to)
+    {
+        lineEnd = text.indexOf('\n', from);
+        if (lineEnd < 0 || lineEnd > to)
+            lineEnd = to;
+
+        lineLength = lineEnd - from;
+        if (lineLength > 0 && text[lineEnd - 1] == '\r')
+            lineLength--;
+
+        match = localRe.match(QStringRef(&text, from, lineLength));
+        if (match.hasMatch())
+            rows << getValues(match);
+
+        from = lineEnd + 1;
+    }
+    return rows;
+}
 
+QList<QVariant> RegExpImport::getValues(const QRegularExpressionMatch& match) const
+{
     QList<QVariant> values;
     for (const QVariant& group : groups)
     {
@@ -134,9 +287,6 @@ QList<QVariant> RegExpImport::next()
         else
             values << match.captured(group.toString());
     }
-
-    buffer = buffer.mid(match.capturedEnd());
-
     return values;
 }
 
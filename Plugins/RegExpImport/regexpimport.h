@@ -7,6 +7,7 @@
 #include "config_builder.h"
 
 class QRegularExpression;
+class QRegularExpressionMatch;
 class QFile;
 class QTextStream;
 
@@ -15,6 +16,7 @@ CFG_CATEGORIES(RegExpImportConfig,
          CFG_ENTRY(QString, Pattern,           QString())
          CFG_ENTRY(QString, GroupsMode,        "all") // all / custom
          CFG_ENTRY(QString, CustomGroupList,   QString())
+         CFG_ENTRY(bool,    LineByLine,        false)
      )
 )
 
@@ -40,13 +42,68 @@ class REGEXPIMPORTSHARED_EXPORT RegExpImport : public GenericPlugin, public Impo
         bool validateOptions();
 
     private:
+        /**
+         * @brief Appends next line of the input file to the buffer.
+         * @return true if a line was appended, or false if the end of the file was reached.
+         *
+         * The file is read in blocks of BLOCK_SIZE characters. Lines are appended without line terminators,
+         * just like the pattern sees them in the default (multi-line) matching mode.
+         */
+        bool readLine();
+
+        /**
+         * @brief Reads next block of the input file and matches all its lines in parallel.
+         * @return true if there was anything to read, or false if the end of the file was reached.
+         *
+         * Used in the line-by-line mode. The block is cut at its last line terminator and split into
+         * chunks (one per available CPU core), which are matched by the global thread pool.
+         * Matched rows are appended to pendingRows in the order of lines in the file.
+         */
+        bool readLinesBlock();
+
+        /**
+         * @brief Matches every line of the text separately.
+         * @param localRe Pattern to use.
+         * @param text Text to match.
+         * @param from Position of the first character of the first line.
+         * @param to Position after the last line.
+         * @return Values of rows for lines that matched the pattern.
+         *
+         * It's called from worker threads, so it doesn't touch any member, except for read-only groups.
+         */
+        QList<QList<QVariant>> matchLines(const QRegularExpression& localRe, const QString& text, int from, int to) const;
+
+        QList<QVariant> getValues(const QRegularExpressionMatch& match) const;
+
+        static const int BLOCK_SIZE = 1024 * 1024;
+
         CFG_LOCAL_PERSISTABLE(RegExpImportConfig, cfg)
         QRegularExpression* re = nullptr;
         QList<QVariant> groups;
         QStringList columns;
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
+        bool lineByLine = false;
+
+        /**
+         * @brief Lines read so far (without terminators), not consumed by matches yet.
+         *
+         * Consumed part is not removed from the buffer after each match. Only bufferPos is moved forward
+         * and the buffer is compacted once the consumed part gets big enough.
+         */
         QString buffer;
+        int bufferPos = 0;
+
+        /**
+         * @brief Block of raw input, that was read from the file, but not appended to the buffer yet.
+         */
+        QString block;
+        int blockPos = 0;
+
+        /**
+         * @brief Rows matched in the line-by-line mode, but not returned by next() yet.
+         */
+        QList<QList<QVariant>> pendingRows;
 };
 
 #endif // REGEXPIMPORT_H
@@ -0,0 +1,20 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_benchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += tst_benchmarks.cpp \
+    benchmarkdata.cpp
+
+HEADERS += \
+    benchmarkdata.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+DEFINES += PLUGINS_DIR=\\\"$$PWD/../../../$$OUTPUT_DIR_NAME/SQLiteStudio/plugins\\\"
@@ -0,0 +1,208 @@
+#include "benchmarkdata.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+
+static const QStringList words = {
+    "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta", "iota", "kappa", "lambda", "mu",
+    "nu", "xi", "omicron", "pi", "rho", "sigma", "tau", "upsilon", "phi", "chi", "psi", "omega"
+};
+
+BenchmarkData::BenchmarkData(quint32 seed) :
+    state(seed)
+{
+}
+
+quint32 BenchmarkData::nextInt(quint32 max)
+{
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) % max;
+}
+
+QString BenchmarkData::nextWord()
+{
+    return words[nextInt(words.size())];
+}
+
+QVariant BenchmarkData::nextValue()
+{
+    switch (nextInt(4))
+    {
+        case 0:
+            return nextInt(1000000);
+        case 1:
+            return nextInt(1000000) / 100.0;
+        case 2:
+        {
+            QString value = nextWord();
+            return value + " " + nextWord();
+        }
+        default:
+            break;
+    }
+    return QVariant();
+}
+
+QString BenchmarkData::select(int joins, int conditions)
+{
+    QStringList columns;
+    for (int i = 0; i <= joins; i++)
+        columns << QString("t%1.%2").arg(i).arg(nextWord());
+
+    QString sql = QString("SELECT %1 FROM %2 t0").arg(columns.join(", "), nextWord());
+    for (int i = 1; i <= joins; i++)
+        sql += QString(" LEFT JOIN %1 t%2 ON t%2.id = t%3.%4_id").arg(nextWord()).arg(i).arg(i - 1).arg(nextWord());
+
+    QStringList where;
+    for (int i = 0; i < conditions; i++)
+    {
+        switch (nextInt(3))
+        {
+            case 0:
+                where << QString("t%1.%2 > %3").arg(nextInt(joins + 1)).arg(nextWord()).arg(nextInt(1000));
+                break;
+            case 1:
+                where << QString("t%1.%2 LIKE '%%3%'").arg(nextInt(joins + 1)).arg(nextWord()).arg(nextWord());
+                break;
+            default:
+                where << QString("t%1.%2 IN (SELECT id FROM %3 WHERE %4 IS NOT NULL)").arg(nextInt(joins + 1))
+                         .arg(nextWord()).arg(nextWord()).arg(nextWord());
+                break;
+        }
+    }
+
+    if (!where.isEmpty())
+        sql += " WHERE " + where.join(" AND ");
+
+    sql += QString(" GROUP BY t0.%1 ORDER BY 1 DESC LIMIT 100;").arg(nextWord());
+    return sql;
+}
+
+QString BenchmarkData::script(int statements)
+{
+    QStringList sqls;
+    for (int i = 0; i < statements; i++)
+    {
+        switch (nextInt(4))
+        {
+            case 0:
+            {
+                QString table = QString("%1_%2").arg(nextWord()).arg(i);
+                sqls << createTable(table, 5 + nextInt(10));
+                break;
+            }
+            case 1:
+                sqls << QString("INSERT INTO %1 (id, %2) VALUES (%3, '%4');").arg(nextWord()).arg(nextWord()).arg(nextInt(1000)).arg(nextWord());
+                break;
+            case 2:
+                sqls << QString("UPDATE %1 SET %2 = %2 + 1 WHERE id = %3;").arg(nextWord()).arg(nextWord()).arg(nextInt(1000));
+                break;
+            default:
+            {
+                int joins = nextInt(3);
+                sqls << select(joins, nextInt(4));
+                break;
+            }
+        }
+    }
+    return sqls.join("\n");
+}
+
+QString BenchmarkData::nestedExpression(int depth)
+{
+    QString expr = QString::number(nextInt(100));
+    for (int i = 0; i < depth; i++)
+    {
+        switch (nextInt(3))
+        {
+            case 0:
+                expr = QString("(%1 + %2)").arg(expr).arg(nextInt(100));
+                break;
+            case 1:
+                expr = QString("CASE WHEN %1 > %2 THEN %1 ELSE %2 END").arg(expr).arg(nextInt(100));
+                break;
+            default:
+                expr = QString("abs(%1)").arg(expr);
+                break;
+        }
+    }
+    return QString("SELECT %1;").arg(expr);
+}
+
+QString BenchmarkData::longInList(int values)
+{
+    QStringList list;
+    for (int i = 0; i < values; i++)
+        list << QString::number(nextInt(1000000));
+
+    return QString("SELECT * FROM %1 WHERE id IN (%2);").arg(nextWord(), list.join(", "));
+}
+
+QString BenchmarkData::csv(int rows, int columns)
+{
+    QString result;
+    for (int row = 0; row < rows; row++)
+    {
+        QStringList cells;
+        for (int col = 0; col < columns; col++)
+        {
+            switch (nextInt(5))
+            {
+                case 0:
+                    cells << QString("\"%1, %2\"").arg(nextWord()).arg(nextWord());
+                    break;
+                case 1:
+                    cells << QString("\"%1\"\"%2\"\"\"").arg(nextWord()).arg(nextWord());
+                    break;
+                case 2:
+                    cells << QString("\"%1\n%2\"").arg(nextWord()).arg(nextWord());
+                    break;
+                case 3:
+                    cells << QString::number(nextInt(1000000));
+                    break;
+                default:
+                    cells << nextWord();
+                    break;
+            }
+        }
+        result += cells.join(",") + "\n";
+    }
+    return result;
+}
+
+QString BenchmarkData::createTable(const QString& table, int columns)
+{
+    static const QStringList types = {"INTEGER", "TEXT", "REAL", "BLOB", "NUMERIC"};
+
+    QStringList colDefs = {"id INTEGER PRIMARY KEY"};
+    for (int i = 0; i < columns; i++)
+        colDefs << QString("c%1 %2").arg(i).arg(types[nextInt(types.size())]);
+
+    return QString("CREATE TABLE %1 (%2);").arg(table, colDefs.join(", "));
+}
+
+void BenchmarkData::fillTable(Db* db, const QString& table, int columns, int rows)
+{
+    db->exec(createTable(table, columns));
+
+    QStringList colNames;
+    QStringList argList;
+    for (int i = 0; i < columns; i++)
+    {
+        colNames << QString("c%1").arg(i);
+        argList << "?";
+    }
+
+    db->begin();
+    SqlQueryPtr query = db->prepare(QString("INSERT INTO %1 (%2) VALUES (%3);").arg(table, colNames.join(", "), argList.join(", ")));
+    QList<QVariant> args;
+    for (int row = 0; row < rows; row++)
+    {
+        args.clear();
+        for (int i = 0; i < columns; i++)
+            args << nextValue();
+
+        query->setArgs(args);
+        query->execute();
+    }
+    db->commit();
+}
@@ -0,0 +1,67 @@
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+class Db;
+
+/**
+ * @brief Deterministic generator of SQL and data for benchmarks.
+ *
+ * It uses its own linear congruential generator with a fixed seed and draws values
+ * in a fixed order, so the same input is generated on every platform and in every run,
+ * which keeps benchmark results comparable across releases.
+ */
+class BenchmarkData
+{
+    public:
+        explicit BenchmarkData(quint32 seed = DEFAULT_SEED);
+
+        quint32 nextInt(quint32 max);
+        QString nextWord();
+        QVariant nextValue();
+
+        /**
+         * @brief Generates a single SELECT with joins, conditions, grouping and ordering.
+         */
+        QString select(int joins, int conditions);
+
+        /**
+         * @brief Generates a script of mixed DDL and DML statements.
+         */
+        QString script(int statements);
+
+        /**
+         * @brief Generates an expression nested to the given depth.
+         */
+        QString nestedExpression(int depth);
+
+        /**
+         * @brief Generates a SELECT with a very long IN list.
+         */
+        QString longInList(int values);
+
+        /**
+         * @brief Generates CSV document with some values quoted and containing separators or new lines.
+         */
+        QString csv(int rows, int columns);
+
+        /**
+         * @brief Generates CREATE TABLE with the given number of columns named c0, c1, etc.
+         */
+        QString createTable(const QString& table, int columns);
+
+        /**
+         * @brief Creates a table in the database and fills it with rows of random values.
+         */
+        void fillTable(Db* db, const QString& table, int columns, int rows);
+
+    private:
+        static const quint32 DEFAULT_SEED = 20240101;
+
+        quint32 state;
+};
+
+#endif // BENCHMARKDATA_H
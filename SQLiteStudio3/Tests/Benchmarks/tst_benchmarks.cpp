@@ -0,0 +1,380 @@
+#include "benchmarkdata.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "db/queryexecutor.h"
+#include "db/sqlquery.h"
+#include "csvserializer.h"
+#include "completionhelper.h"
+#include "expectedtoken.h"
+#include "tablemodifier.h"
+#include "plugins/exportplugin.h"
+#include "plugins/genericplugin.h"
+#include "common/utils_sql.h"
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+#include <QPluginLoader>
+#include <QDebug>
+
+/**
+ * @brief Benchmarks of hot paths in the core library.
+ *
+ * All input is generated by BenchmarkData, so it's identical in each run. Unless any output
+ * is requested explicitly with the -o option, results are printed to the standard output and
+ * also written in the QtTest XML format to the benchmarks.xml file in the current directory,
+ * so they can be collected and compared between releases.
+ *
+ * Export plugins are loaded from the output directory of the build. Their benchmarks
+ * are skipped if plugins were not built.
+ */
+class Benchmarks : public QObject
+{
+        Q_OBJECT
+
+    public:
+        Benchmarks();
+
+    private:
+        void sqlData();
+
+        static const int ROWS = 10000;
+        static const int WIDE_SCHEMA_TABLES = 50;
+        static const int WIDE_SCHEMA_COLUMNS = 300;
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void lexerTokenize_data();
+        void lexerTokenize();
+        void parserParse_data();
+        void parserParse();
+        void csvDeserialize_data();
+        void csvDeserialize();
+        void csvDeserializeStream_data();
+        void csvDeserializeStream();
+        void queryExecutor_data();
+        void queryExecutor();
+        void rowFetch_data();
+        void rowFetch();
+        void exportPlugin_data();
+        void exportPlugin();
+        void completionExpectedTokens_data();
+        void completionExpectedTokens();
+        void tableModifierWideSchema();
+};
+
+Benchmarks::Benchmarks()
+{
+}
+
+void Benchmarks::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    CompletionHelper::init();
+    initMocks();
+    initUtilsSql();
+
+    db = new DbSqlite3Mock("benchmarkdb");
+    db->open();
+
+    BenchmarkData data;
+    data.fillTable(db, "narrow", 5, ROWS);
+    data.fillTable(db, "wide", 100, ROWS / 10);
+
+    db->exec(data.createTable("wide_schema", WIDE_SCHEMA_COLUMNS));
+    for (int i = 0; i < WIDE_SCHEMA_TABLES; i++)
+    {
+        db->exec(QString("CREATE TABLE ref_%1 (id INTEGER PRIMARY KEY, wide_id INTEGER REFERENCES wide_schema (id), c%1 TEXT);").arg(i));
+        db->exec(QString("CREATE INDEX ref_%1_idx ON ref_%1 (wide_id);").arg(i));
+    }
+}
+
+void Benchmarks::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+    deleteMockRepo();
+}
+
+void Benchmarks::sqlData()
+{
+    BenchmarkData data;
+    QTest::addColumn<QString>("sql");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("small") << data.select(1, 2) << true;
+    QTest::newRow("large select") << data.select(20, 50) << true;
+    QTest::newRow("large script") << data.script(500) << true;
+    QTest::newRow("nested expression") << data.nestedExpression(50) << false;
+    QTest::newRow("long IN list") << data.longInList(5000) << true;
+}
+
+void Benchmarks::lexerTokenize_data()
+{
+    sqlData();
+}
+
+void Benchmarks::lexerTokenize()
+{
+    QFETCH(QString, sql);
+
+    TokenList tokens;
+    QBENCHMARK {
+        tokens = Lexer::tokenize(sql);
+    }
+    QVERIFY(tokens.size() > 0);
+}
+
+void Benchmarks::parserParse_data()
+{
+    sqlData();
+}
+
+void Benchmarks::parserParse()
+{
+    QFETCH(QString, sql);
+    QFETCH(bool, valid);
+
+    Parser parser;
+    bool res = false;
+    QBENCHMARK {
+        res = parser.parse(sql);
+    }
+
+    // Deeply nested input may hit the parser stack limit, it's still measured
+    if (valid)
+        QVERIFY2(res, parser.getErrorString().toUtf8().constData());
+}
+
+void Benchmarks::csvDeserialize_data()
+{
+    BenchmarkData data;
+    QTest::addColumn<QString>("input");
+    QTest::newRow("narrow") << data.csv(ROWS, 5);
+    QTest::newRow("wide") << data.csv(ROWS / 10, 100);
+}
+
+void Benchmarks::csvDeserialize()
+{
+    QFETCH(QString, input);
+
+    QList<QStringList> rows;
+    QBENCHMARK {
+        rows = CsvSerializer::deserialize(input, CsvFormat::DEFAULT);
+    }
+    QVERIFY(rows.size() > 0);
+}
+
+void Benchmarks::csvDeserializeStream_data()
+{
+    csvDeserialize_data();
+}
+
+void Benchmarks::csvDeserializeStream()
+{
+    QFETCH(QString, input);
+
+    int rows = 0;
+    QBENCHMARK {
+        rows = 0;
+        QTextStream stream(&input, QIODevice::ReadOnly);
+        while (!stream.atEnd())
+        {
+            CsvSerializer::deserializeOneEntry(stream, CsvFormat::DEFAULT);
+            rows++;
+        }
+    }
+    QVERIFY(rows > 0);
+}
+
+void Benchmarks::queryExecutor_data()
+{
+    QTest::addColumn<QString>("sql");
+    QTest::addColumn<bool>("simpleMode");
+    QTest::newRow("smart, narrow") << "SELECT * FROM narrow WHERE c0 IS NOT NULL" << false;
+    QTest::newRow("simple, narrow") << "SELECT * FROM narrow WHERE c0 IS NOT NULL" << true;
+    QTest::newRow("smart, wide") << "SELECT * FROM wide" << false;
+    QTest::newRow("simple, wide") << "SELECT * FROM wide" << true;
+    QTest::newRow("smart, join") << "SELECT n.*, w.c0 FROM narrow n JOIN wide w ON w.id = n.id" << false;
+    QTest::newRow("simple, join") << "SELECT n.*, w.c0 FROM narrow n JOIN wide w ON w.id = n.id" << true;
+}
+
+void Benchmarks::queryExecutor()
+{
+    QFETCH(QString, sql);
+    QFETCH(bool, simpleMode);
+
+    QueryExecutor executor(db, sql);
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setForceSimpleMode(simpleMode);
+    executor.setResultsPerPage(1000);
+
+    int rows = 0;
+    QBENCHMARK {
+        rows = 0;
+        executor.exec([&rows](SqlQueryPtr results)
+        {
+            while (results->hasNext())
+            {
+                results->next();
+                rows++;
+            }
+        });
+    }
+    QVERIFY(rows > 0);
+}
+
+void Benchmarks::rowFetch_data()
+{
+    QTest::addColumn<QString>("table");
+    QTest::newRow("narrow") << "narrow";
+    QTest::newRow("wide") << "wide";
+}
+
+void Benchmarks::rowFetch()
+{
+    QFETCH(QString, table);
+
+    int rows = 0;
+    QBENCHMARK {
+        rows = 0;
+        SqlQueryPtr results = db->exec(QString("SELECT * FROM %1;").arg(table));
+        while (results->hasNext())
+        {
+            results->next();
+            rows++;
+        }
+    }
+    QVERIFY(rows > 0);
+}
+
+void Benchmarks::exportPlugin_data()
+{
+    static const QStringList plugins = {"CsvExport", "HtmlExport", "JsonExport", "SqlExport", "XmlExport"};
+
+    QTest::addColumn<QString>("plugin");
+    for (const QString& plugin : plugins)
+        QTest::newRow(plugin.toLatin1().constData()) << plugin;
+}
+
+void Benchmarks::exportPlugin()
+{
+    QFETCH(QString, plugin);
+
+    QPluginLoader loader(QString(PLUGINS_DIR) + "/" + plugin);
+    ExportPlugin* exportPlugin = dynamic_cast<ExportPlugin*>(dynamic_cast<Plugin*>(loader.instance()));
+    if (!exportPlugin)
+        QSKIP(QString("Could not load %1: %2").arg(plugin, loader.errorString()).toUtf8().constData());
+
+    GenericPlugin* genericPlugin = dynamic_cast<GenericPlugin*>(exportPlugin);
+    if (genericPlugin)
+        genericPlugin->loadMetaData(loader.metaData());
+
+    QVERIFY(exportPlugin->init());
+
+    SqlQueryPtr results = db->exec("SELECT * FROM narrow;");
+    QStringList columns = results->getColumnNames();
+    QList<SqlResultsRowPtr> rows = results->getAll();
+
+    Parser parser;
+    QString ddl = db->exec("SELECT sql FROM sqlite_master WHERE name = 'narrow';")->getSingleCell().toString();
+    QVERIFY(parser.parse(ddl));
+    SqliteCreateTablePtr createTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+
+    QList<int> dataLengths;
+    for (int i = 0; i < columns.size(); i++)
+        dataLengths << 50;
+
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
+    providerData[ExportManager::ROW_COUNT] = rows.size();
+    providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(dataLengths);
+
+    ExportManager::StandardExportConfig config;
+    config.codec = "UTF-8";
+    config.exportTableIndexes = false;
+    config.exportTableTriggers = false;
+    exportPlugin->setExportMode(ExportManager::TABLE);
+
+    bool res = true;
+    QBENCHMARK {
+        QByteArray output;
+        QBuffer buffer(&output);
+        buffer.open(QIODevice::WriteOnly);
+
+        res = exportPlugin->initBeforeExport(db, &buffer, config);
+        res = res && exportPlugin->exportTable("main", "narrow", columns, ddl, createTable, providerData);
+        for (const SqlResultsRowPtr& row : rows)
+            res = res && exportPlugin->exportTableRow(row);
+
+        res = res && exportPlugin->afterExportTable();
+        res = res && exportPlugin->afterExport();
+        exportPlugin->cleanupAfterExport();
+    }
+
+    exportPlugin->deinit();
+    QVERIFY(res);
+}
+
+void Benchmarks::completionExpectedTokens_data()
+{
+    QTest::addColumn<QString>("sql");
+    QTest::newRow("select columns") << "SELECT  FROM wide_schema";
+    QTest::newRow("join condition") << "SELECT * FROM wide_schema w JOIN ref_10 r ON ";
+    QTest::newRow("where") << "SELECT * FROM wide_schema w, ref_20 r WHERE w.c1 > 5 AND ";
+    QTest::newRow("table name") << "SELECT * FROM ";
+}
+
+void Benchmarks::completionExpectedTokens()
+{
+    QFETCH(QString, sql);
+
+    // For the "select columns" case the cursor is right after SELECT
+    quint32 cursorPos = sql.startsWith("SELECT  ") ? 7 : sql.length();
+
+    QList<ExpectedTokenPtr> tokens;
+    QBENCHMARK {
+        CompletionHelper helper(sql, cursorPos, db);
+        tokens = helper.getExpectedTokens().filtered();
+    }
+    QVERIFY(tokens.size() > 0);
+}
+
+void Benchmarks::tableModifierWideSchema()
+{
+    Parser parser;
+    QString ddl = db->exec("SELECT sql FROM sqlite_master WHERE name = 'wide_schema';")->getSingleCell().toString();
+    QVERIFY(parser.parse(ddl));
+    SqliteCreateTablePtr createTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    createTable->table = "wide_schema_renamed";
+    createTable->columns[1]->name = "renamed_column";
+
+    QStringList sqls;
+    QBENCHMARK {
+        TableModifier modifier(db, "wide_schema");
+        modifier.alterTable(createTable);
+        sqls = modifier.generateSqls();
+    }
+    QVERIFY(sqls.size() > WIDE_SCHEMA_TABLES);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    if (!args.contains("-o"))
+        args << "-o" << "-,txt" << "-o" << "benchmarks.xml,xml";
+
+    Benchmarks benchmarks;
+    return QTest::qExec(&benchmarks, args);
+}
+
+#include "tst_benchmarks.moc"
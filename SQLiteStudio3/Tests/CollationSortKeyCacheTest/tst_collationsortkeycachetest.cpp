@@ -0,0 +1,261 @@
+#include "db/collationsortkeycache.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "sqlitestudio.h"
+#include "collationmanagermock.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+/**
+ * @brief Collation manager with sort keys evaluated natively.
+ *
+ * Code "lower" makes keys case insensitive, code "reverse" additionally inverts key bytes, so the order is reversed.
+ */
+class TestCollationManager : public CollationManagerMock
+{
+    public:
+        QList<CollationPtr> getCollationsForDatabase(const QString&) const
+        {
+            return collations;
+        }
+
+        CollationPtr getCollation(const QString& name) const
+        {
+            for (const CollationPtr& collation : collations)
+            {
+                if (collation->name == name)
+                    return collation;
+            }
+            return CollationPtr();
+        }
+
+        QByteArray evaluateSortKey(const QString& name, const QString& value)
+        {
+            evaluations++;
+            QByteArray key = value.toLower().toUtf8();
+            CollationPtr collation = getCollation(name);
+            if (collation && collation->code == "reverse")
+            {
+                for (char& c : key)
+                    c = static_cast<char>(~c);
+            }
+            return key;
+        }
+
+        QList<CollationPtr> collations;
+        int evaluations = 0;
+};
+
+class CollationSortKeyCacheTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        CollationSortKeyCacheTest();
+
+    private:
+        CollationManager::CollationPtr createCollation(CollationManager::CollationType type, const QString& code = QString(),
+                                                       const QString& locale = QString());
+        int compare(CollationSortKeyCache& cache, const QString& value1, const QString& value2);
+        QStringList selectSorted(Db* db);
+
+        static int sign(int value);
+
+        TestCollationManager* collationManager = nullptr;
+        QStringList values;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void testSortKeyComparison();
+        void testLocaleComparison();
+        void testKeysCachedPerStatement();
+        void testEviction();
+        void testReRegisteredCollation();
+};
+
+CollationSortKeyCacheTest::CollationSortKeyCacheTest()
+{
+}
+
+void CollationSortKeyCacheTest::initTestCase()
+{
+    initMocks();
+    collationManager = new TestCollationManager();
+    SQLITESTUDIO->setCollationManager(collationManager);
+
+    values = QStringList({"a", "B", "ab", "Ab", "abc", "", "z", "ż", "ä", "a b", "10", "9", "Ärger", "Zebra", "zebra"});
+}
+
+void CollationSortKeyCacheTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void CollationSortKeyCacheTest::init()
+{
+    collationManager->collations.clear();
+    collationManager->evaluations = 0;
+}
+
+CollationManager::CollationPtr CollationSortKeyCacheTest::createCollation(CollationManager::CollationType type, const QString& code,
+                                                                          const QString& locale)
+{
+    CollationManager::CollationPtr collation = CollationManager::CollationPtr::create();
+    collation->name = "test_collation";
+    collation->type = type;
+    collation->code = code;
+    collation->locale = locale;
+    collationManager->collations = {collation};
+    return collation;
+}
+
+int CollationSortKeyCacheTest::compare(CollationSortKeyCache& cache, const QString& value1, const QString& value2)
+{
+    QByteArray bytes1 = value1.toUtf8();
+    QByteArray bytes2 = value2.toUtf8();
+    return cache.compare(bytes1.size(), bytes1.constData(), bytes2.size(), bytes2.constData());
+}
+
+QStringList CollationSortKeyCacheTest::selectSorted(Db* db)
+{
+    QStringList sorted;
+    SqlQueryPtr results = db->exec("SELECT value FROM test ORDER BY value COLLATE test_collation");
+    for (const SqlResultsRowPtr& row : results->getAll())
+        sorted << row->value("value").toString();
+
+    return sorted;
+}
+
+int CollationSortKeyCacheTest::sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+void CollationSortKeyCacheTest::testSortKeyComparison()
+{
+    CollationSortKeyCache cache(createCollation(CollationManager::CollationType::SORT_KEY_BASED, "lower"));
+
+    // Result with cached keys is the same as comparing freshly evaluated keys
+    QByteArray key1;
+    QByteArray key2;
+    for (const QString& value1 : values)
+    {
+        for (const QString& value2 : values)
+        {
+            key1 = collationManager->evaluateSortKey("test_collation", value1);
+            key2 = collationManager->evaluateSortKey("test_collation", value2);
+            QCOMPARE(compare(cache, value1, value2), (key1 > key2) - (key1 < key2));
+        }
+    }
+
+    QCOMPARE(compare(cache, "Zebra", "zebra"), 0);
+    QCOMPARE(compare(cache, "ab", "abc"), -1);
+    QCOMPARE(compare(cache, "abc", "ab"), 1);
+}
+
+void CollationSortKeyCacheTest::testLocaleComparison()
+{
+    CollationSortKeyCache cache(createCollation(CollationManager::CollationType::LOCALE_BASED, QString(), "de_DE"));
+
+    QCollator collator(QLocale("de_DE"));
+    for (const QString& value1 : values)
+    {
+        for (const QString& value2 : values)
+            QCOMPARE(compare(cache, value1, value2), sign(collator.compare(value1, value2)));
+    }
+
+    // Locale keys are not evaluated by the collation manager
+    QCOMPARE(collationManager->evaluations, 0);
+}
+
+void CollationSortKeyCacheTest::testKeysCachedPerStatement()
+{
+    CollationSortKeyCache cache(createCollation(CollationManager::CollationType::SORT_KEY_BASED, "lower"));
+
+    cache.setStatement(1);
+    compare(cache, "a", "b");
+    compare(cache, "b", "a");
+    compare(cache, "a", "c");
+    QCOMPARE(collationManager->evaluations, 3);
+
+    // The same statement keeps keys
+    cache.setStatement(1);
+    compare(cache, "c", "b");
+    QCOMPARE(collationManager->evaluations, 3);
+
+    // Next statement starts over, as the collation might be redefined in the meantime
+    cache.setStatement(2);
+    compare(cache, "c", "b");
+    QCOMPARE(collationManager->evaluations, 5);
+
+    cache.clear();
+    compare(cache, "c", "b");
+    QCOMPARE(collationManager->evaluations, 7);
+}
+
+void CollationSortKeyCacheTest::testEviction()
+{
+    CollationSortKeyCache cache(createCollation(CollationManager::CollationType::SORT_KEY_BASED, "lower"));
+    cache.setStatement(1);
+
+    static_qstring(valueTpl, "value %1");
+    for (int i = 0; i < CollationSortKeyCache::MAX_KEYS; i++)
+        compare(cache, valueTpl.arg(i), valueTpl.arg(i));
+
+    QCOMPARE(collationManager->evaluations, CollationSortKeyCache::MAX_KEYS);
+
+    // All keys still fit in the cache
+    compare(cache, valueTpl.arg(0), valueTpl.arg(CollationSortKeyCache::MAX_KEYS - 1));
+    QCOMPARE(collationManager->evaluations, CollationSortKeyCache::MAX_KEYS);
+
+    // One more key clears the cache, so previously cached keys are evaluated again, but results stay correct
+    QCOMPARE(compare(cache, "new value", valueTpl.arg(0)), -1);
+    QCOMPARE(collationManager->evaluations, CollationSortKeyCache::MAX_KEYS + 2);
+
+    QCOMPARE(compare(cache, valueTpl.arg(1), valueTpl.arg(0)), 1);
+    QCOMPARE(collationManager->evaluations, CollationSortKeyCache::MAX_KEYS + 3);
+}
+
+void CollationSortKeyCacheTest::testReRegisteredCollation()
+{
+    CollationManager::CollationPtr collation = createCollation(CollationManager::CollationType::SORT_KEY_BASED, "lower");
+
+    Db* db = new DbSqlite3Mock("testdb");
+    QVERIFY(db->open());
+    db->exec("CREATE TABLE test (value TEXT)");
+    QStringList inserted = {"delta", "Alpha", "charlie", "Bravo", "echo", "alpha"};
+    for (const QString& value : inserted)
+        db->exec("INSERT INTO test (value) VALUES (?)", {value});
+
+    // Each distinct value has its key evaluated once per statement
+    QStringList sorted = selectSorted(db);
+    QCOMPARE(sorted.mid(0, 2).join(",").toLower(), QString("alpha,alpha"));
+    QCOMPARE(sorted.mid(2), QStringList({"Bravo", "charlie", "delta", "echo"}));
+    QVERIFY(collationManager->evaluations <= inserted.size());
+
+    // Redefined collation is registered again in the database with a new cache
+    collation->code = "reverse";
+    emit collationManager->collationListChanged();
+    sorted = selectSorted(db);
+    QCOMPARE(sorted.mid(0, 4), QStringList({"echo", "delta", "charlie", "Bravo"}));
+    QCOMPARE(sorted.mid(4).join(",").toLower(), QString("alpha,alpha"));
+
+    collation->type = CollationManager::CollationType::LOCALE_BASED;
+    collation->locale = "en_US";
+    collationManager->evaluations = 0;
+    emit collationManager->collationListChanged();
+    sorted = selectSorted(db);
+    QCOMPARE(sorted.mid(2), QStringList({"Bravo", "charlie", "delta", "echo"}));
+    QCOMPARE(collationManager->evaluations, 0);
+
+    db->close();
+    delete db;
+}
+
+QTEST_GUILESS_MAIN(CollationSortKeyCacheTest)
+
+#include "tst_collationsortkeycachetest.moc"
@@ -4,6 +4,8 @@
 #include "parser/lexer.h"
 #include "parser/token.h"
 #include "parser/keywords.h"
+#include "parser/parser.h"
+#include "common/global.h"
 #include "sqlitestudio.h"
 #include "mocks.h"
 #include <QString>
@@ -21,6 +23,7 @@ class CompletionHelperTest : public QObject
     private:
         QList<ExpectedToken*> getEntryList(QList<ExpectedTokenPtr> tokens);
         QSet<ExpectedToken::Type> getTypeList(QList<ExpectedTokenPtr> tokens);
+        QStringList getCandidates(const QString& sql, bool tableLookup);
 
         Db* db = nullptr;
 
@@ -52,6 +55,12 @@ class CompletionHelperTest : public QObject
         void testFromKw();
         void testUpdateTable();
         void testUpdateCols1();
+        void testTableLookupMatchesProbing_data();
+        void testTableLookupMatchesProbing();
+        void benchmarkNextTokenCandidates_data();
+        void benchmarkNextTokenCandidates();
+        void benchmarkExpectedTokens_data();
+        void benchmarkExpectedTokens();
         void initTestCase();
         void cleanupTestCase();
 };
@@ -372,6 +381,129 @@ void CompletionHelperTest::testUpdateCols1()
     //QVERIFY(!contains(tokens, ExpectedToken::COLUMN, "id", QString(), "abc")); // TODO
 }
 
+QStringList CompletionHelperTest::getCandidates(const QString& sql, bool tableLookup)
+{
+    static_qstring(tokenTpl, "%1 %2");
+
+    Parser parser;
+    parser.setTokenTableLookup(tableLookup);
+    QStringList candidates;
+    for (const TokenPtr& token : parser.getNextTokenCandidates(sql))
+        candidates << tokenTpl.arg(Token::typeToString(token->type), token->value);
+
+    candidates.removeDuplicates();
+    candidates.sort();
+    return candidates;
+}
+
+void CompletionHelperTest::testTableLookupMatchesProbing_data()
+{
+    QTest::addColumn<QString>("sql");
+    QTest::newRow("empty") << QString();
+    QTest::newRow("select") << "SELECT ";
+    QTest::newRow("select distinct") << "SELECT DISTINCT ";
+    QTest::newRow("result column") << "SELECT id ";
+    QTest::newRow("result alias") << "SELECT id AS ";
+    QTest::newRow("from") << "SELECT * FROM ";
+    QTest::newRow("from table") << "SELECT * FROM test ";
+    QTest::newRow("from dot") << "SELECT * FROM main.";
+    QTest::newRow("where") << "SELECT id, val FROM test WHERE id > 5 AND ";
+    QTest::newRow("where expr") << "SELECT * FROM test WHERE id ";
+    QTest::newRow("where not") << "SELECT * FROM test WHERE id NOT ";
+    QTest::newRow("where in") << "SELECT * FROM test WHERE id IN (";
+    QTest::newRow("column dot") << "SELECT t.";
+    QTest::newRow("function") << "SELECT max(";
+    QTest::newRow("case") << "SELECT CASE WHEN id = 1 THEN 'a' ";
+    QTest::newRow("cast") << "SELECT CAST(id AS ";
+    QTest::newRow("join") << "SELECT * FROM test t1 LEFT JOIN abc t2 ON t1.id = t2.id ";
+    QTest::newRow("join kw") << "SELECT * FROM test NATURAL ";
+    QTest::newRow("group by") << "SELECT id FROM test GROUP BY id ";
+    QTest::newRow("order by") << "SELECT id FROM test ORDER BY id ";
+    QTest::newRow("limit") << "SELECT id FROM test LIMIT 5 ";
+    QTest::newRow("compound") << "SELECT 1 UNION ";
+    QTest::newRow("window") << "SELECT row_number() OVER (PARTITION BY id ";
+    QTest::newRow("with") << "WITH cte AS (SELECT 1) ";
+    QTest::newRow("insert") << "INSERT ";
+    QTest::newRow("insert into") << "INSERT INTO test (id, val) ";
+    QTest::newRow("upsert") << "INSERT INTO test VALUES (1) ON CONFLICT (id) DO ";
+    QTest::newRow("update") << "UPDATE test SET ";
+    QTest::newRow("update where") << "UPDATE test SET val = 1 WHERE ";
+    QTest::newRow("delete") << "DELETE FROM test ";
+    QTest::newRow("create") << "CREATE ";
+    QTest::newRow("create table") << "CREATE TABLE xyz (id INTEGER PRIMARY KEY, val TEXT NOT NULL ";
+    QTest::newRow("column constraint") << "CREATE TABLE xyz (id INTEGER ";
+    QTest::newRow("table constraint") << "CREATE TABLE xyz (id, val, ";
+    QTest::newRow("foreign key") << "CREATE TABLE xyz (id REFERENCES abc (id) ON ";
+    QTest::newRow("table options") << "CREATE TABLE xyz (id) ";
+    QTest::newRow("create index") << "CREATE UNIQUE INDEX idx ON test (";
+    QTest::newRow("create trigger") << "CREATE TRIGGER trg AFTER INSERT ON test BEGIN ";
+    QTest::newRow("trigger body") << "CREATE TRIGGER trg AFTER UPDATE ON test BEGIN UPDATE abc SET x = new.";
+    QTest::newRow("create view") << "CREATE VIEW v AS ";
+    QTest::newRow("alter") << "ALTER TABLE test ";
+    QTest::newRow("drop") << "DROP ";
+    QTest::newRow("pragma") << "PRAGMA ";
+    QTest::newRow("attach") << "ATTACH ";
+    QTest::newRow("begin") << "BEGIN ";
+    QTest::newRow("explain") << "EXPLAIN QUERY PLAN ";
+    QTest::newRow("second statement") << "SELECT 1; ";
+    QTest::newRow("syntax error") << "SELECT FROM WHERE ";
+    QTest::newRow("error recovery") << "SELECT * FROM test WHERE id = = 5 AND ";
+}
+
+void CompletionHelperTest::testTableLookupMatchesProbing()
+{
+    QFETCH(QString, sql);
+
+    QStringList fromTables = getCandidates(sql, true);
+    QStringList fromProbing = getCandidates(sql, false);
+    if (fromTables == fromProbing)
+        return;
+
+    QSet<QString> onlyTables = QSet<QString>::fromList(fromTables).subtract(QSet<QString>::fromList(fromProbing));
+    QSet<QString> onlyProbing = QSet<QString>::fromList(fromProbing).subtract(QSet<QString>::fromList(fromTables));
+    QFAIL(QString("Candidates differ. Only from tables: %1. Only from probing: %2.")
+          .arg(onlyTables.toList().join(", "), onlyProbing.toList().join(", ")).toUtf8().constData());
+}
+
+void CompletionHelperTest::benchmarkNextTokenCandidates_data()
+{
+    QTest::addColumn<QString>("sql");
+    QTest::newRow("empty") << QString();
+    QTest::newRow("select") << "SELECT ";
+    QTest::newRow("where") << "SELECT id, val FROM test WHERE id > 5 AND ";
+    QTest::newRow("join") << "SELECT * FROM test t1 LEFT JOIN abc t2 ON t1.id = t2.id ";
+    QTest::newRow("create table") << "CREATE TABLE xyz (id INTEGER PRIMARY KEY, val TEXT NOT NULL ";
+}
+
+void CompletionHelperTest::benchmarkNextTokenCandidates()
+{
+    QFETCH(QString, sql);
+
+    Parser parser;
+    TokenList tokens;
+    QBENCHMARK {
+        tokens = parser.getNextTokenCandidates(sql);
+    }
+    QVERIFY(tokens.size() > 0);
+}
+
+void CompletionHelperTest::benchmarkExpectedTokens_data()
+{
+    benchmarkNextTokenCandidates_data();
+}
+
+void CompletionHelperTest::benchmarkExpectedTokens()
+{
+    QFETCH(QString, sql);
+
+    QList<ExpectedTokenPtr> tokens;
+    QBENCHMARK {
+        CompletionHelper helper(sql, db);
+        tokens = helper.getExpectedTokens().filtered();
+    }
+    QVERIFY(tokens.size() > 0);
+}
+
 void CompletionHelperTest::initTestCase()
 {
     initKeywords();
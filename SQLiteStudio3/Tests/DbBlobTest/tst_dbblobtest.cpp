@@ -0,0 +1,174 @@
+#include "db/dbblob.h"
+#include "db/sqlquery.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+
+class DbBlobTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbBlobTest();
+
+    private:
+        static QByteArray generateData(int size, char seed);
+
+        Db* db = nullptr;
+        QByteArray data;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testReadInChunks();
+        void testReadOnlyBlobNotWritable();
+        void testWriteInPlace();
+        void testWriteBeyondEnd();
+        void testReopen();
+        void testMissingRow();
+        void testClosedWithDatabase();
+};
+
+DbBlobTest::DbBlobTest()
+{
+}
+
+QByteArray DbBlobTest::generateData(int size, char seed)
+{
+    QByteArray result(size, 0);
+    for (int i = 0; i < size; i++)
+        result[i] = static_cast<char>((i * 31 + seed) % 251);
+
+    return result;
+}
+
+void DbBlobTest::initTestCase()
+{
+    initMocks();
+
+    // More than a single chunk of copyTo() and copyFrom()
+    data = generateData(static_cast<int>(DbBlob::CHUNK_SIZE * 2 + 123), 7);
+}
+
+void DbBlobTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void DbBlobTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, data BLOB);");
+    db->exec("INSERT INTO test (id, data) VALUES (1, ?);", {data});
+    db->exec("INSERT INTO test (id, data) VALUES (2, ?);", {QByteArray("short value")});
+}
+
+void DbBlobTest::cleanup()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void DbBlobTest::testReadInChunks()
+{
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 1);
+    QVERIFY(blob);
+    QCOMPARE(blob->size(), static_cast<qint64>(data.size()));
+
+    QVERIFY(blob->seek(DbBlob::CHUNK_SIZE + 5));
+    QCOMPARE(blob->read(10), data.mid(static_cast<int>(DbBlob::CHUNK_SIZE + 5), 10));
+
+    // Reading past the end returns only the remaining bytes
+    QVERIFY(blob->seek(data.size() - 3));
+    QCOMPARE(blob->read(10), data.right(3));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(blob->copyTo(&buffer));
+    QCOMPARE(buffer.data(), data);
+}
+
+void DbBlobTest::testReadOnlyBlobNotWritable()
+{
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 2);
+    QVERIFY(blob);
+    QVERIFY(!blob->isWritable());
+    QCOMPARE(blob->write("x"), -1LL);
+    QCOMPARE(db->exec("SELECT data FROM test WHERE id = 2;")->getSingleCell().toByteArray(), QByteArray("short value"));
+}
+
+void DbBlobTest::testWriteInPlace()
+{
+    QByteArray newData = generateData(data.size(), 13);
+
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 1, true);
+    QVERIFY(blob);
+
+    QBuffer buffer(&newData);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(blob->copyFrom(&buffer));
+    blob.clear();
+
+    QCOMPARE(db->exec("SELECT data FROM test WHERE id = 1;")->getSingleCell().toByteArray(), newData);
+}
+
+void DbBlobTest::testWriteBeyondEnd()
+{
+    QByteArray newData("longer than the value");
+
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 2, true);
+    QVERIFY(blob);
+
+    // The blob cannot grow, so only the leading part is written
+    QBuffer buffer(&newData);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(!blob->copyFrom(&buffer));
+    blob.clear();
+
+    QByteArray stored = db->exec("SELECT data FROM test WHERE id = 2;")->getSingleCell().toByteArray();
+    QCOMPARE(stored, newData.left(QByteArray("short value").size()));
+}
+
+void DbBlobTest::testReopen()
+{
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 1);
+    QVERIFY(blob);
+    QVERIFY(blob->seek(100));
+
+    QVERIFY(blob->reopen(2));
+    QCOMPARE(blob->pos(), 0LL);
+    QCOMPARE(blob->size(), static_cast<qint64>(QByteArray("short value").size()));
+    QCOMPARE(blob->readAll(), QByteArray("short value"));
+
+    QVERIFY(!blob->reopen(99));
+}
+
+void DbBlobTest::testMissingRow()
+{
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 99);
+    QVERIFY(!blob);
+    QVERIFY(!db->getErrorText().isEmpty());
+}
+
+void DbBlobTest::testClosedWithDatabase()
+{
+    DbBlobPtr blob = db->openBlob("main", "test", "data", 1);
+    QVERIFY(blob);
+    QVERIFY(blob->isOpen());
+
+    db->close();
+    QVERIFY(!blob->isOpen());
+    QCOMPARE(blob->size(), 0LL);
+
+    db->open();
+}
+
+QTEST_APPLESS_MAIN(DbBlobTest)
+
+#include "tst_dbblobtest.moc"
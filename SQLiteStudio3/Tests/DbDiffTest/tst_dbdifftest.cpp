@@ -0,0 +1,448 @@
+#include "dbdiff.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "common/utils_sql.h"
+#include "parser/keywords.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+
+class DbDiffTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbDiffTest();
+
+    private:
+        void exec(Db* db, const QString& query);
+        void fill(Db* db, const QString& table, int rows);
+        QList<QList<QVariant>> dump(Db* db, const QString& query);
+        void compareAndApply(DbDiff& diff);
+        QStringList getScript(DbDiff& diff);
+        DbDiff::Table loadTable(DbDiff& diff, const QString& name);
+        DbDiff::Chunk chunk(const QList<QVariant>& boundary, int rows, const QByteArray& digest);
+
+        Db* srcDb = nullptr;
+        Db* dstDb = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testIdenticalDatabases();
+        void testInsertUpdateDelete();
+        void testNullKeys();
+        void testDuplicatedNullKeys();
+        void testRowIdTable();
+        void testSchemaMismatch();
+        void testFindDifferentSegments();
+        void testFollowingCondition();
+        void testSyncSegment();
+        void testWriteScript();
+};
+
+DbDiffTest::DbDiffTest()
+{
+}
+
+void DbDiffTest::initTestCase()
+{
+    initKeywords();
+    initUtilsSql();
+    initMocks();
+}
+
+void DbDiffTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void DbDiffTest::init()
+{
+    srcDb = new DbSqlite3Mock("src");
+    dstDb = new DbSqlite3Mock("dst");
+    srcDb->open();
+    dstDb->open();
+}
+
+void DbDiffTest::cleanup()
+{
+    srcDb->close();
+    dstDb->close();
+    safe_delete(srcDb);
+    safe_delete(dstDb);
+}
+
+void DbDiffTest::exec(Db* db, const QString& query)
+{
+    SqlQueryPtr results = db->exec(query);
+    QVERIFY2(!results->isError(), results->getErrorText().toUtf8().constData());
+}
+
+void DbDiffTest::fill(Db* db, const QString& table, int rows)
+{
+    static_qstring(insertTpl, "INSERT INTO %1 (id, value) VALUES (?, ?)");
+
+    db->begin();
+    for (int i = 1; i <= rows; i++)
+        db->exec(insertTpl.arg(table), {i, QString("value %1").arg(i)});
+
+    db->commit();
+}
+
+QList<QList<QVariant>> DbDiffTest::dump(Db* db, const QString& query)
+{
+    QList<QList<QVariant>> rows;
+    for (const SqlResultsRowPtr& row : db->exec(query)->getAll())
+        rows << row->valueList();
+
+    return rows;
+}
+
+void DbDiffTest::compareAndApply(DbDiff& diff)
+{
+    QVERIFY2(diff.compare(), diff.getErrorText().toUtf8().constData());
+    QVERIFY2(diff.apply(), diff.getErrorText().toUtf8().constData());
+}
+
+QStringList DbDiffTest::getScript(DbDiff& diff)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!diff.writeScript(&buffer))
+        return QStringList();
+
+    return QString::fromUtf8(buffer.data()).split("\n", QString::SkipEmptyParts);
+}
+
+DbDiff::Table DbDiffTest::loadTable(DbDiff& diff, const QString& name)
+{
+    DbDiff::Table table;
+    table.name = name;
+    diff.loadColumns(srcDb, table);
+    return table;
+}
+
+DbDiff::Chunk DbDiffTest::chunk(const QList<QVariant>& boundary, int rows, const QByteArray& digest)
+{
+    DbDiff::Chunk chunk;
+    chunk.boundary = boundary;
+    chunk.boundaryKey = boundary.isEmpty() ? QByteArray() : DbDiff::serialize(boundary, 0, boundary.size());
+    chunk.rows = rows;
+    chunk.digest = digest;
+    return chunk;
+}
+
+void DbDiffTest::testIdenticalDatabases()
+{
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (id INTEGER PRIMARY KEY, value TEXT)");
+        fill(db, "test", 3000);
+    }
+
+    DbDiff diff(srcDb, dstDb);
+    QVERIFY(diff.compare());
+    QCOMPARE(diff.getStatementCount(), 0LL);
+    QVERIFY(getScript(diff).isEmpty());
+    QVERIFY(diff.getTableDiffs().isEmpty());
+    QVERIFY(diff.getSchemaDifferences().isEmpty());
+}
+
+void DbDiffTest::testInsertUpdateDelete()
+{
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (id INTEGER PRIMARY KEY, value TEXT)");
+        fill(db, "test", 5000);
+    }
+
+    // Changes spread over many chunks, at the beginning, in the middle and at the end
+    exec(dstDb, "DELETE FROM test WHERE id IN (1, 2500, 4999)");
+    exec(dstDb, "UPDATE test SET value = 'changed' WHERE id IN (10, 2000, 5000)");
+    exec(dstDb, "UPDATE test SET value = NULL WHERE id = 3000");
+    exec(dstDb, "INSERT INTO test (id, value) VALUES (0, 'extra'), (2500000, 'extra')");
+
+    DbDiff diff(srcDb, dstDb);
+    compareAndApply(diff);
+
+    QCOMPARE(diff.getTableDiffs().size(), 1);
+    const DbDiff::TableDiff& tableDiff = diff.getTableDiffs().first();
+    QCOMPARE(tableDiff.table, QString("test"));
+    QCOMPARE(tableDiff.inserted, 3);
+    QCOMPARE(tableDiff.updated, 4);
+    QCOMPARE(tableDiff.deleted, 2);
+
+    static_qstring(query, "SELECT id, value FROM test ORDER BY id");
+    QCOMPARE(dump(dstDb, query), dump(srcDb, query));
+}
+
+void DbDiffTest::testNullKeys()
+{
+    // Columns of a primary key, other than INTEGER PRIMARY KEY, may hold NULLs in SQLite
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (a TEXT, b INTEGER, value TEXT, PRIMARY KEY (a, b))");
+        exec(db, "INSERT INTO test VALUES (NULL, NULL, 'n-n'), (NULL, 1, 'n-1'), (NULL, 2, 'n-2'), ('x', NULL, 'x-n'), ('x', 1, 'x-1'), "
+                 "('y', 1, 'y-1')");
+    }
+
+    exec(dstDb, "DELETE FROM test WHERE a IS NULL AND b = 1");
+    exec(dstDb, "UPDATE test SET value = 'changed' WHERE a IS NULL AND b IS NULL");
+    exec(dstDb, "UPDATE test SET value = 'changed' WHERE a = 'x' AND b IS NULL");
+    exec(dstDb, "INSERT INTO test VALUES ('z', NULL, 'extra')");
+
+    DbDiff diff(srcDb, dstDb);
+    compareAndApply(diff);
+
+    QCOMPARE(diff.getTableDiffs().size(), 1);
+    QCOMPARE(diff.getTableDiffs().first().inserted, 1);
+    QCOMPARE(diff.getTableDiffs().first().updated, 2);
+    QCOMPARE(diff.getTableDiffs().first().deleted, 1);
+
+    static_qstring(query, "SELECT a, b, value FROM test ORDER BY a, b");
+    QCOMPARE(dump(dstDb, query), dump(srcDb, query));
+}
+
+void DbDiffTest::testDuplicatedNullKeys()
+{
+    // NULLs in the primary key don't collide, so several rows can have the same key
+    for (Db* db : {srcDb, dstDb})
+        exec(db, "CREATE TABLE test (name TEXT PRIMARY KEY, value TEXT)");
+
+    exec(srcDb, "INSERT INTO test (rowid, name, value) VALUES (1, NULL, 'first'), (2, NULL, 'second'), (3, NULL, 'third'), (4, 'x', 'x'), "
+                "(5, 'y', 'y')");
+
+    // Row 'y' has different ROWID in the target database, but it's matched by the key anyway
+    exec(dstDb, "INSERT INTO test (rowid, name, value) VALUES (1, NULL, 'first'), (2, NULL, 'changed'), (4, 'x', 'x'), (9, 'y', 'y'), "
+                "(10, NULL, 'extra')");
+
+    DbDiff diff(srcDb, dstDb);
+    DbDiff::Table table = loadTable(diff, "test");
+    QVERIFY(table.nullableKey);
+    QCOMPARE(table.keyExprs.size(), 2);
+
+    compareAndApply(diff);
+
+    QCOMPARE(diff.getTableDiffs().size(), 1);
+    QCOMPARE(diff.getTableDiffs().first().inserted, 1);
+    QCOMPARE(diff.getTableDiffs().first().updated, 1);
+    QCOMPARE(diff.getTableDiffs().first().deleted, 1);
+
+    static_qstring(query, "SELECT CASE WHEN name IS NULL THEN rowid END, name, value FROM test ORDER BY 1, 2");
+    QCOMPARE(dump(dstDb, query), dump(srcDb, query));
+
+    // Nothing to do after the synchronization
+    DbDiff nextDiff(srcDb, dstDb);
+    QVERIFY(nextDiff.compare());
+    QCOMPARE(nextDiff.getStatementCount(), 0LL);
+
+    // INTEGER PRIMARY KEY is never NULL
+    exec(srcDb, "CREATE TABLE int_key (id INTEGER PRIMARY KEY, value TEXT)");
+    QVERIFY(!loadTable(diff, "int_key").nullableKey);
+}
+
+void DbDiffTest::testRowIdTable()
+{
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (id INTEGER, value TEXT)");
+        fill(db, "test", 100);
+    }
+
+    exec(dstDb, "DELETE FROM test WHERE rowid = 50");
+    exec(dstDb, "UPDATE test SET value = 'changed' WHERE rowid = 20");
+    exec(srcDb, "INSERT INTO test (rowid, id, value) VALUES (500, 500, 'new')");
+
+    DbDiff diff(srcDb, dstDb);
+    compareAndApply(diff);
+
+    QCOMPARE(diff.getTableDiffs().size(), 1);
+    QCOMPARE(diff.getTableDiffs().first().inserted, 2);
+    QCOMPARE(diff.getTableDiffs().first().updated, 1);
+    QCOMPARE(diff.getTableDiffs().first().deleted, 0);
+
+    // ROWIDs are synchronized too
+    static_qstring(query, "SELECT rowid, id, value FROM test ORDER BY rowid");
+    QCOMPARE(dump(dstDb, query), dump(srcDb, query));
+}
+
+void DbDiffTest::testSchemaMismatch()
+{
+    exec(srcDb, "CREATE TABLE different (id INTEGER PRIMARY KEY, value TEXT, extra TEXT)");
+    exec(dstDb, "CREATE TABLE different (id INTEGER PRIMARY KEY, value TEXT)");
+    exec(srcDb, "INSERT INTO different VALUES (1, 'a', 'b')");
+
+    exec(srcDb, "CREATE TABLE same_columns (id INTEGER PRIMARY KEY, value TEXT NOT NULL)");
+    exec(dstDb, "CREATE TABLE same_columns (id INTEGER PRIMARY KEY, value TEXT)");
+    exec(srcDb, "INSERT INTO same_columns VALUES (1, 'a')");
+
+    exec(srcDb, "CREATE TABLE only_src (id INTEGER PRIMARY KEY, value TEXT)");
+    exec(srcDb, "INSERT INTO only_src VALUES (1, 'a')");
+    exec(srcDb, "CREATE INDEX only_src_idx ON only_src (value)");
+    exec(dstDb, "CREATE TABLE only_dst (id INTEGER PRIMARY KEY, value TEXT)");
+
+    DbDiff diff(srcDb, dstDb);
+    compareAndApply(diff);
+
+    // Table with different columns is only reported
+    QCOMPARE(dump(dstDb, "SELECT count(*) FROM different").first().first().toInt(), 0);
+    QVERIFY(!dump(dstDb, "SELECT sql FROM sqlite_master WHERE name = 'different'").first().first().toString().contains("extra"));
+
+    // Table with the same columns gets its data only
+    QVERIFY(!dump(dstDb, "SELECT sql FROM sqlite_master WHERE name = 'same_columns'").first().first().toString().contains("NOT NULL"));
+    QCOMPARE(dump(dstDb, "SELECT id, value FROM same_columns"), dump(srcDb, "SELECT id, value FROM same_columns"));
+
+    // Missing objects are created with data, extra objects are dropped
+    QCOMPARE(dump(dstDb, "SELECT id, value FROM only_src"), dump(srcDb, "SELECT id, value FROM only_src"));
+    QCOMPARE(dump(dstDb, "SELECT count(*) FROM sqlite_master WHERE name IN ('only_src_idx', 'only_dst')").first().first().toInt(), 1);
+
+    QStringList tables;
+    for (const DbDiff::TableDiff& tableDiff : diff.getTableDiffs())
+        tables << tableDiff.table;
+
+    tables.sort();
+    QCOMPARE(tables, QStringList({"only_src", "same_columns"}));
+    QCOMPARE(diff.getSchemaDifferences().size(), 5);
+}
+
+void DbDiffTest::testFindDifferentSegments()
+{
+    DbDiff diff(srcDb, dstDb);
+    QList<DbDiff::Chunk> srcChunks = {chunk({10}, 5, "a"), chunk({20}, 5, "b"), chunk({30}, 5, "c"), chunk({}, 2, "d")};
+
+    // Identical lists
+    QVERIFY(diff.findDifferentSegments(srcChunks, srcChunks).isEmpty());
+
+    // Different digest of the chunk between boundaries 10 and 20
+    QList<DbDiff::Chunk> dstChunks = {chunk({10}, 5, "a"), chunk({20}, 5, "x"), chunk({30}, 5, "c"), chunk({}, 2, "d")};
+    QList<DbDiff::Segment> segments = diff.findDifferentSegments(srcChunks, dstChunks);
+    QCOMPARE(segments.size(), 1);
+    QCOMPARE(segments[0].lowerBoundary, QList<QVariant>({10}));
+    QCOMPARE(segments[0].srcRows, 5);
+    QCOMPARE(segments[0].dstRows, 5);
+
+    // Boundary 20 is missing in the target, so chunks up to the next common boundary make one segment.
+    // Extra boundary 25 in the target is merged the same way and the last chunk differs by the number of rows.
+    dstChunks = {chunk({10}, 5, "a"), chunk({25}, 7, "y"), chunk({30}, 2, "z"), chunk({}, 3, "d")};
+    segments = diff.findDifferentSegments(srcChunks, dstChunks);
+    QCOMPARE(segments.size(), 2);
+    QCOMPARE(segments[0].lowerBoundary, QList<QVariant>({10}));
+    QCOMPARE(segments[0].srcRows, 10);
+    QCOMPARE(segments[0].dstRows, 9);
+    QCOMPARE(segments[1].lowerBoundary, QList<QVariant>({30}));
+    QCOMPARE(segments[1].srcRows, 2);
+    QCOMPARE(segments[1].dstRows, 3);
+
+    // Empty target table has only the last chunk
+    segments = diff.findDifferentSegments(srcChunks, {chunk({}, 0, QByteArray())});
+    QCOMPARE(segments.size(), 1);
+    QVERIFY(segments[0].lowerBoundary.isEmpty());
+    QCOMPARE(segments[0].srcRows, 17);
+    QCOMPARE(segments[0].dstRows, 0);
+}
+
+void DbDiffTest::testFollowingCondition()
+{
+    static_qstring(selectTpl, "SELECT %1 FROM test%2 ORDER BY %1");
+
+    exec(srcDb, "CREATE TABLE test (a TEXT, b INTEGER, PRIMARY KEY (a, b))");
+    exec(srcDb, "INSERT INTO test VALUES (NULL, NULL), (NULL, 1), (NULL, 2), ('x', NULL), ('x', 1), ('x', 2), ('y', NULL), ('y', 5), "
+                "(NULL, 1), ('x', NULL)");
+
+    DbDiff diff(srcDb, dstDb);
+    DbDiff::Table table = loadTable(diff, "test");
+    QCOMPARE(table.keyColumns, QStringList({"a", "b"}));
+    QVERIFY(table.nullableKey);
+
+    // Every row taken as a boundary has to be followed by exactly the rest of rows
+    QString keys = table.keyExprs.join(", ");
+    QList<QList<QVariant>> orderedRows = dump(srcDb, selectTpl.arg(keys, QString()));
+    QCOMPARE(orderedRows.size(), 10);
+    for (int i = 0, total = orderedRows.size(); i < total; i++)
+    {
+        QList<QVariant> args;
+        QString condition = diff.getFollowingCondition(table, orderedRows[i], args);
+        QCOMPARE(args.size(), condition.count('?'));
+
+        QList<QList<QVariant>> followingRows;
+        SqlQueryPtr results = srcDb->exec(selectTpl.arg(keys, " WHERE " + condition), args);
+        QVERIFY2(!results->isError(), results->getErrorText().toUtf8().constData());
+        for (const SqlResultsRowPtr& row : results->getAll())
+            followingRows << row->valueList();
+
+        QCOMPARE(followingRows, orderedRows.mid(i + 1));
+    }
+
+    // Non-null boundary uses the row value comparison
+    QList<QVariant> args;
+    QCOMPARE(diff.getFollowingCondition(table, {"x", 1, QVariant()}, args), QString("(a, b) > (?, ?)"));
+    QCOMPARE(args, QList<QVariant>({"x", 1}));
+}
+
+void DbDiffTest::testSyncSegment()
+{
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (id INTEGER PRIMARY KEY, value TEXT)");
+        fill(db, "test", 10);
+    }
+
+    // Changes inside the segment (rows 4-7) and outside of it
+    exec(dstDb, "UPDATE test SET value = 'changed' WHERE id IN (2, 5)");
+    exec(dstDb, "DELETE FROM test WHERE id = 6");
+    exec(dstDb, "INSERT INTO test VALUES (65, 'extra')");
+
+    DbDiff diff(srcDb, dstDb);
+    DbDiff::Table table = loadTable(diff, "test");
+
+    DbDiff::Segment segment;
+    segment.lowerBoundary = {3};
+    segment.srcRows = 4;
+    segment.dstRows = 3;
+
+    DbDiff::TableDiff tableDiff;
+    QVERIFY(diff.openDataFile());
+    QVERIFY(diff.syncSegment(table, segment, tableDiff));
+    QCOMPARE(tableDiff.inserted, 1);
+    QCOMPARE(tableDiff.updated, 1);
+    QCOMPARE(tableDiff.deleted, 0);
+    QCOMPARE(getScript(diff), QStringList({"UPDATE test SET value = 'value 5' WHERE id IS 5;",
+                                               "INSERT INTO test (id, value) VALUES (6, 'value 6');"}));
+}
+
+void DbDiffTest::testWriteScript()
+{
+    for (Db* db : {srcDb, dstDb})
+    {
+        exec(db, "CREATE TABLE test (id INTEGER PRIMARY KEY, value TEXT)");
+        fill(db, "test", 10000);
+    }
+
+    exec(dstDb, "UPDATE test SET value = 'changed'");
+    exec(srcDb, "CREATE INDEX test_idx ON test (value)");
+
+    // Data statements are read back from the temporary file, in order and between schema statements
+    DbDiff diff(srcDb, dstDb);
+    QVERIFY(diff.compare());
+    QCOMPARE(diff.getStatementCount(), 10001LL);
+
+    QStringList script = getScript(diff);
+    QCOMPARE(script.size(), 10001);
+    QCOMPARE(script.first(), QString("UPDATE test SET value = 'value 1' WHERE id IS 1;"));
+    QCOMPARE(script[9999], QString("UPDATE test SET value = 'value 10000' WHERE id IS 10000;"));
+    QCOMPARE(script.last(), QString("CREATE INDEX test_idx ON test (value);"));
+
+    // Script can be read again to be applied
+    QVERIFY2(diff.apply(), diff.getErrorText().toUtf8().constData());
+    static_qstring(query, "SELECT id, value FROM test ORDER BY id");
+    QCOMPARE(dump(dstDb, query), dump(srcDb, query));
+}
+
+QTEST_APPLESS_MAIN(DbDiffTest)
+
+#include "tst_dbdifftest.moc"
@@ -0,0 +1,417 @@
+#include "dbmaintenance.h"
+#include "db/sqlquery.h"
+#include "plugins/dbplugin.h"
+#include "plugins/genericplugin.h"
+#include "sqlitestudio.h"
+#include "pluginmanagermock.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+class TestDbPlugin : public GenericPlugin, public DbPlugin
+{
+    public:
+        QString getName() const
+        {
+            return "TestDbPlugin";
+        }
+
+        Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString*)
+        {
+            return new DbSqlite3Mock(name, path, options);
+        }
+
+        QString getLabel() const
+        {
+            return getName();
+        }
+
+        QList<DbPluginOption> getOptionsList() const
+        {
+            return QList<DbPluginOption>();
+        }
+
+        QString generateDbName(const QVariant& baseValue)
+        {
+            return baseValue.toString();
+        }
+
+        bool checkIfDbServedByPlugin(Db* db) const
+        {
+            return dynamic_cast<DbSqlite3Mock*>(db) != nullptr;
+        }
+};
+
+class TestPluginManager : public PluginManagerMock
+{
+    public:
+        Plugin* getLoadedPlugin(const QString& pluginName) const
+        {
+            if (plugin && plugin->getName() == pluginName)
+                return plugin;
+
+            return nullptr;
+        }
+
+        Plugin* plugin = nullptr;
+};
+
+class DbMaintenanceTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbMaintenanceTest();
+
+    private:
+        Db* createDb(const QString& name, const QStringList& statements, const QString& pluginName = "TestDbPlugin");
+        QStringList createTables(int count);
+        DbMaintenance::Task createTask(DbMaintenance::Operation operation, const QString& table, int target = 0);
+        bool waitFor(const QFuture<bool>& future, int timeout = 5000);
+        QList<DbMaintenance::Result> findResults(const QList<DbMaintenance::Result>& results, const QString& database,
+                                                 DbMaintenance::Operation operation);
+
+        TestDbPlugin* plugin = nullptr;
+        QTemporaryDir tempDir;
+        QList<Db*> dbs;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void cleanup();
+        void testChecks();
+        void testAnalyze();
+        void testDbNotOpened();
+        void testTakeTaskSkipsAnalyzedDb();
+        void testTakeTaskInterrupted();
+        void testConcurrentChecksAndAnalyze();
+};
+
+DbMaintenanceTest::DbMaintenanceTest()
+{
+}
+
+Db* DbMaintenanceTest::createDb(const QString& name, const QStringList& statements, const QString& pluginName)
+{
+    QHash<QString, QVariant> options;
+    options[DB_PLUGIN] = pluginName;
+
+    Db* db = new DbSqlite3Mock(name, tempDir.filePath(name + ".db"), options);
+    dbs << db;
+    if (!db->openQuiet())
+        return db;
+
+    for (const QString& sql : statements)
+    {
+        SqlQueryPtr results = db->exec(sql);
+        if (results->isError())
+            qWarning() << "Could not prepare database" << name << ":" << results->getErrorText();
+    }
+
+    db->closeQuiet();
+    return db;
+}
+
+QStringList DbMaintenanceTest::createTables(int count)
+{
+    static_qstring(createTpl, "CREATE TABLE t%1 (id INTEGER PRIMARY KEY, val TEXT)");
+    static_qstring(indexTpl, "CREATE INDEX t%1_val ON t%1 (val)");
+    static_qstring(insertTpl, "WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < 200) "
+                              "INSERT INTO t%1 (val) SELECT 'value ' || (x % 10) FROM seq");
+
+    QStringList statements;
+    for (int i = 0; i < count; i++)
+        statements << createTpl.arg(i) << indexTpl.arg(i) << insertTpl.arg(i);
+
+    return statements;
+}
+
+DbMaintenance::Task DbMaintenanceTest::createTask(DbMaintenance::Operation operation, const QString& table, int target)
+{
+    DbMaintenance::Task task;
+    task.target = target;
+    task.operation = operation;
+    task.table = table;
+    return task;
+}
+
+bool DbMaintenanceTest::waitFor(const QFuture<bool>& future, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!future.isFinished() && timer.elapsed() < timeout)
+        QThread::msleep(10);
+
+    return future.isFinished();
+}
+
+QList<DbMaintenance::Result> DbMaintenanceTest::findResults(const QList<DbMaintenance::Result>& results, const QString& database,
+                                                            DbMaintenance::Operation operation)
+{
+    QList<DbMaintenance::Result> found;
+    for (const DbMaintenance::Result& result : results)
+    {
+        if (result.database == database && result.operation == operation)
+            found << result;
+    }
+    return found;
+}
+
+void DbMaintenanceTest::initTestCase()
+{
+    initMocks();
+
+    plugin = new TestDbPlugin();
+    TestPluginManager* pluginManager = new TestPluginManager();
+    pluginManager->plugin = plugin;
+    SQLITESTUDIO->setPluginManager(pluginManager);
+
+    QVERIFY(tempDir.isValid());
+}
+
+void DbMaintenanceTest::cleanupTestCase()
+{
+    deleteMockRepo();
+    delete plugin;
+}
+
+void DbMaintenanceTest::cleanup()
+{
+    for (Db* db : dbs)
+        QFile::remove(db->getPath());
+
+    qDeleteAll(dbs);
+    dbs.clear();
+}
+
+void DbMaintenanceTest::testChecks()
+{
+    DbMaintenance maintenance;
+    maintenance.setThreads(1);
+    maintenance.setOperations({DbMaintenance::Operation::QUICK_CHECK, DbMaintenance::Operation::INTEGRITY_CHECK,
+                               DbMaintenance::Operation::FOREIGN_KEY_CHECK});
+    maintenance.addDb(createDb("first", {"PRAGMA foreign_keys = 0",
+                                         "CREATE TABLE parent (id INTEGER PRIMARY KEY)",
+                                         "CREATE TABLE child (id INTEGER PRIMARY KEY, parent_id INTEGER REFERENCES parent (id))",
+                                         "INSERT INTO parent (id) VALUES (1)",
+                                         "INSERT INTO child (id, parent_id) VALUES (1, 1), (2, 5)"}));
+
+    QSignalSpy startedSpy(&maintenance, SIGNAL(started(int)));
+    QSignalSpy finishedSpy(&maintenance, SIGNAL(taskFinished(DbMaintenance::Result,int,int)));
+    QVERIFY(maintenance.exec());
+
+    QList<DbMaintenance::Result> results = maintenance.getResults();
+    QCOMPARE(startedSpy.size(), 1);
+    int totalTasks = startedSpy.first().first().toInt();
+    QCOMPARE(results.size(), totalTasks);
+    QCOMPARE(finishedSpy.size(), totalTasks);
+    QCOMPARE(finishedSpy.last()[1].toInt(), totalTasks);
+    QCOMPARE(totalTasks, 6);
+    for (const DbMaintenance::Result& result : results)
+        QVERIFY2(result.success, result.issues.join("\n").toUtf8().constData());
+
+    // Only the missing parent row is reported
+    for (const DbMaintenance::Result& result : findResults(results, "first", DbMaintenance::Operation::INTEGRITY_CHECK))
+        QVERIFY(result.issues.isEmpty());
+
+    for (const DbMaintenance::Result& result : findResults(results, "first", DbMaintenance::Operation::FOREIGN_KEY_CHECK))
+    {
+        if (result.object != "child")
+        {
+            QVERIFY(result.issues.isEmpty());
+            continue;
+        }
+
+        QCOMPARE(result.issues.size(), 1);
+        QVERIFY(result.issues.first().contains("ROWID 2"));
+        QVERIFY(result.issues.first().contains("parent"));
+    }
+}
+
+void DbMaintenanceTest::testAnalyze()
+{
+    DbMaintenance maintenance;
+    maintenance.setOperations({DbMaintenance::Operation::ANALYZE});
+    maintenance.addDb(createDb("first", createTables(4)));
+    maintenance.addDb(createDb("second", createTables(2)));
+    QVERIFY(maintenance.exec());
+
+    QList<DbMaintenance::Result> results = maintenance.getResults();
+    QCOMPARE(results.size(), 6);
+    for (const DbMaintenance::Result& result : results)
+        QVERIFY2(result.success, result.issues.join("\n").toUtf8().constData());
+
+    // Statistics were written to all tables of databases
+    for (Db* db : dbs)
+    {
+        QVERIFY(db->openQuiet());
+        int tables = db->exec("SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name LIKE 't%'")->getSingleCell().toInt();
+        int analyzed = db->exec("SELECT count(DISTINCT tbl) FROM sqlite_stat1")->getSingleCell().toInt();
+        QCOMPARE(analyzed, tables);
+        db->closeQuiet();
+    }
+}
+
+void DbMaintenanceTest::testDbNotOpened()
+{
+    DbMaintenance maintenance;
+    maintenance.setOperations({DbMaintenance::Operation::QUICK_CHECK, DbMaintenance::Operation::ANALYZE});
+    maintenance.addDb(createDb("first", createTables(1)));
+    maintenance.addDb(createDb("unknown", createTables(1), "MissingPlugin"));
+    QVERIFY(maintenance.exec());
+
+    QList<DbMaintenance::Result> results = maintenance.getResults();
+    QCOMPARE(results.size(), 4);
+
+    // Database that could not be opened has a single failed result per operation
+    for (DbMaintenance::Operation operation : maintenance.getOperations())
+    {
+        QList<DbMaintenance::Result> unknownResults = findResults(results, "unknown", operation);
+        QCOMPARE(unknownResults.size(), 1);
+        QVERIFY(!unknownResults.first().success);
+        QVERIFY(unknownResults.first().object.isEmpty());
+        QVERIFY(unknownResults.first().issues.first().contains("unknown"));
+
+        QList<DbMaintenance::Result> firstResults = findResults(results, "first", operation);
+        QCOMPARE(firstResults.size(), 1);
+        QVERIFY(firstResults.first().success);
+        QCOMPARE(firstResults.first().object, QString("t0"));
+    }
+}
+
+void DbMaintenanceTest::testTakeTaskSkipsAnalyzedDb()
+{
+    DbMaintenance maintenance;
+    maintenance.pendingTasks << createTask(DbMaintenance::Operation::ANALYZE, "a")
+                             << createTask(DbMaintenance::Operation::ANALYZE, "b")
+                             << createTask(DbMaintenance::Operation::QUICK_CHECK, "a")
+                             << createTask(DbMaintenance::Operation::ANALYZE, "a", 1)
+                             << createTask(DbMaintenance::Operation::QUICK_CHECK, "b");
+
+    DbMaintenance::Task analyzeTask;
+    QVERIFY(maintenance.takeTask(analyzeTask));
+    QVERIFY(analyzeTask.operation == DbMaintenance::Operation::ANALYZE);
+    QCOMPARE(analyzeTask.table, QString("a"));
+
+    // Other database can be analyzed in the meantime, but the same database only when its ANALYZE is finished
+    DbMaintenance::Task task;
+    QVERIFY(maintenance.takeTask(task));
+    QVERIFY(task.operation == DbMaintenance::Operation::QUICK_CHECK);
+    QCOMPARE(task.table, QString("a"));
+
+    DbMaintenance::Task otherDbTask;
+    QVERIFY(maintenance.takeTask(otherDbTask));
+    QVERIFY(otherDbTask.operation == DbMaintenance::Operation::ANALYZE);
+    QCOMPARE(otherDbTask.target, 1);
+
+    DbMaintenance::Task lastCheckTask;
+    QVERIFY(maintenance.takeTask(lastCheckTask));
+    QVERIFY(lastCheckTask.operation == DbMaintenance::Operation::QUICK_CHECK);
+    QCOMPARE(lastCheckTask.table, QString("b"));
+
+    // Only ANALYZE of the busy database is left, so the worker waits
+    DbMaintenance::Task waitingTask;
+    QFuture<bool> waitingWorker = QtConcurrent::run([&maintenance, &waitingTask]()
+    {
+        return maintenance.takeTask(waitingTask);
+    });
+    QThread::msleep(100);
+    QVERIFY(!waitingWorker.isFinished());
+
+    // Checks are still finished by other workers, which doesn't deadlock with the waiting worker, nor releases it
+    maintenance.finishTask(task, DbMaintenance::Result());
+    maintenance.finishTask(lastCheckTask, DbMaintenance::Result());
+    maintenance.finishTask(otherDbTask, DbMaintenance::Result());
+    QThread::msleep(100);
+    bool stillWaiting = !waitingWorker.isFinished();
+
+    // ANALYZE finished on the database releases the waiting worker
+    maintenance.finishTask(analyzeTask, DbMaintenance::Result());
+    bool released = waitFor(waitingWorker);
+    if (!released)
+    {
+        maintenance.interrupt();
+        waitingWorker.waitForFinished();
+    }
+
+    QVERIFY(stillWaiting);
+    QVERIFY(released);
+    QVERIFY(waitingWorker.result());
+    QVERIFY(waitingTask.operation == DbMaintenance::Operation::ANALYZE);
+    QCOMPARE(waitingTask.table, QString("b"));
+    QCOMPARE(waitingTask.target, 0);
+
+    QCOMPARE(maintenance.getResults().size(), 4);
+    QVERIFY(maintenance.pendingTasks.isEmpty());
+}
+
+void DbMaintenanceTest::testTakeTaskInterrupted()
+{
+    DbMaintenance maintenance;
+    maintenance.pendingTasks << createTask(DbMaintenance::Operation::ANALYZE, "a")
+                             << createTask(DbMaintenance::Operation::ANALYZE, "b");
+
+    DbMaintenance::Task analyzeTask;
+    QVERIFY(maintenance.takeTask(analyzeTask));
+
+    DbMaintenance::Task waitingTask;
+    QFuture<bool> waitingWorker = QtConcurrent::run([&maintenance, &waitingTask]()
+    {
+        return maintenance.takeTask(waitingTask);
+    });
+    QThread::msleep(100);
+    QVERIFY(!waitingWorker.isFinished());
+
+    // Interruption releases the waiting worker with no task
+    maintenance.interrupt();
+    QVERIFY(waitFor(waitingWorker));
+    QVERIFY(!waitingWorker.result());
+    QCOMPARE(maintenance.pendingTasks.size(), 1);
+}
+
+void DbMaintenanceTest::testConcurrentChecksAndAnalyze()
+{
+    DbMaintenance maintenance;
+    maintenance.setThreads(4);
+    maintenance.setOperations({DbMaintenance::Operation::QUICK_CHECK, DbMaintenance::Operation::ANALYZE,
+                               DbMaintenance::Operation::INTEGRITY_CHECK});
+    maintenance.addDb(createDb("first", createTables(8)));
+    maintenance.addDb(createDb("second", createTables(8)));
+
+    // Workers are blocked on ANALYZE of the same database while checks run, all of them have to finish
+    QFuture<bool> execution = QtConcurrent::run([&maintenance]()
+    {
+        return maintenance.exec();
+    });
+    bool finished = waitFor(execution, 60000);
+    if (!finished)
+    {
+        maintenance.interrupt();
+        execution.waitForFinished();
+    }
+    QVERIFY(finished);
+    QVERIFY(execution.result());
+
+    QList<DbMaintenance::Result> results = maintenance.getResults();
+    QCOMPARE(results.size(), 48);
+    for (const DbMaintenance::Result& result : results)
+    {
+        QVERIFY2(result.success, result.issues.join("\n").toUtf8().constData());
+        QVERIFY(result.issues.isEmpty());
+    }
+
+    for (const QString& database : {"first", "second"})
+    {
+        QCOMPARE(findResults(results, database, DbMaintenance::Operation::QUICK_CHECK).size(), 8);
+        QCOMPARE(findResults(results, database, DbMaintenance::Operation::ANALYZE).size(), 8);
+        QCOMPARE(findResults(results, database, DbMaintenance::Operation::INTEGRITY_CHECK).size(), 8);
+    }
+}
+
+QTEST_GUILESS_MAIN(DbMaintenanceTest)
+
+#include "tst_dbmaintenancetest.moc"
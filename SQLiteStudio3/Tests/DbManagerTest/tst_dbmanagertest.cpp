@@ -0,0 +1,286 @@
+#include "services/impl/dbmanagerimpl.h"
+#include "plugins/dbplugin.h"
+#include "plugins/genericplugin.h"
+#include "db/invaliddb.h"
+#include "sqlitestudio.h"
+#include "configmock.h"
+#include "pluginmanagermock.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QSemaphore>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+
+static const char* DB_NAME = "probed";
+
+/**
+ * @brief Database plugin, which can hold probing of files until released by the test.
+ */
+class TestDbPlugin : public GenericPlugin, public DbPlugin
+{
+    public:
+        QString getName() const
+        {
+            return "TestDbPlugin";
+        }
+
+        Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString*)
+        {
+            if (blocking.loadAcquire())
+                released.tryAcquire(1, 10000);
+
+            Db* db = new DbSqlite3Mock(name, path, options);
+            QObject::connect(db, &QObject::destroyed, [this]()
+            {
+                destroyedInstances.ref();
+            });
+            return db;
+        }
+
+        QString getLabel() const
+        {
+            return getName();
+        }
+
+        QList<DbPluginOption> getOptionsList() const
+        {
+            return QList<DbPluginOption>();
+        }
+
+        QString generateDbName(const QVariant& baseValue)
+        {
+            return baseValue.toString();
+        }
+
+        bool checkIfDbServedByPlugin(Db* db) const
+        {
+            return dynamic_cast<DbSqlite3Mock*>(db) != nullptr;
+        }
+
+        QAtomicInt blocking;
+        QAtomicInt destroyedInstances;
+        QSemaphore released;
+};
+
+class TestPluginManager : public PluginManagerMock
+{
+    public:
+        TestPluginManager()
+        {
+            PluginManager::registerPluginType<DbPlugin>("Database");
+        }
+
+        ~TestPluginManager()
+        {
+            delete dbPluginType;
+        }
+
+        QList<PluginType*> getPluginTypes() const
+        {
+            return {dbPluginType};
+        }
+
+        QList<Plugin*> getLoadedPlugins(PluginType* type) const
+        {
+            if (type != dbPluginType)
+                return QList<Plugin*>();
+
+            return {plugin};
+        }
+
+        Plugin* plugin = nullptr;
+
+    protected:
+        void registerPluginType(PluginType* type)
+        {
+            dbPluginType = type;
+        }
+
+    private:
+        PluginType* dbPluginType = nullptr;
+};
+
+class TestConfig : public ConfigMock
+{
+    public:
+        QList<CfgDbPtr> dbList()
+        {
+            return dbs;
+        }
+
+        DbGroupPtr getDbGroup(const QString&)
+        {
+            return DbGroupPtr::create();
+        }
+
+        QList<CfgDbPtr> dbs;
+};
+
+class DbManagerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbManagerTest();
+
+    private:
+        Config::CfgDbPtr createDbFile(const QString& name);
+
+        TestDbPlugin* plugin = nullptr;
+        TestConfig* config = nullptr;
+        QTemporaryDir tempDir;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void testProbeFinishedBeforeListLoaded();
+        void testProbeTimeout();
+        void testAbandonedProbeResultDropped();
+        void testMoreHungProbesThanThreads();
+};
+
+DbManagerTest::DbManagerTest()
+{
+}
+
+Config::CfgDbPtr DbManagerTest::createDbFile(const QString& name)
+{
+    QString path = tempDir.filePath(name + ".db");
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        qWarning() << "Could not create file" << path;
+
+    file.close();
+
+    Config::CfgDbPtr cfgDb = Config::CfgDbPtr::create();
+    cfgDb->name = name;
+    cfgDb->path = path;
+    return cfgDb;
+}
+
+void DbManagerTest::initTestCase()
+{
+    initMocks();
+
+    plugin = new TestDbPlugin();
+    TestPluginManager* pluginManager = new TestPluginManager();
+    pluginManager->plugin = plugin;
+    SQLITESTUDIO->setPluginManager(pluginManager);
+
+    QVERIFY(tempDir.isValid());
+
+    config = new TestConfig();
+    config->dbs << createDbFile(DB_NAME);
+    SQLITESTUDIO->setConfig(config);
+}
+
+void DbManagerTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void DbManagerTest::init()
+{
+    plugin->blocking = 0;
+    plugin->destroyedInstances = 0;
+    config->dbs = config->dbs.mid(0, 1);
+}
+
+void DbManagerTest::testProbeFinishedBeforeListLoaded()
+{
+    DbManagerImpl manager;
+    QSignalSpy listLoadedSpy(&manager, SIGNAL(dbListLoaded()));
+    QVERIFY(!manager.getByName(DB_NAME)->isValid());
+
+    manager.rescanInvalidDatabasesForPlugin(plugin);
+    manager.notifyDatabasesAreLoaded();
+
+    QCOMPARE(listLoadedSpy.count(), 1);
+    QVERIFY(manager.getByName(DB_NAME)->isValid());
+}
+
+void DbManagerTest::testProbeTimeout()
+{
+    plugin->blocking = 1;
+
+    DbManagerImpl manager;
+    manager.setProbeTimeout(100);
+    QSignalSpy listLoadedSpy(&manager, SIGNAL(dbListLoaded()));
+
+    QElapsedTimer timer;
+    timer.start();
+    manager.rescanInvalidDatabasesForPlugin(plugin);
+    manager.notifyDatabasesAreLoaded();
+
+    // The probe still hangs, but the list is not waiting for it
+    QVERIFY(timer.elapsed() < 5000);
+    QCOMPARE(listLoadedSpy.count(), 1);
+
+    InvalidDb* db = dynamic_cast<InvalidDb*>(manager.getByName(DB_NAME));
+    QVERIFY(db);
+    QVERIFY(db->getError().contains("could not be read"));
+
+    plugin->released.release();
+    QTRY_COMPARE(plugin->destroyedInstances.loadAcquire(), 1);
+}
+
+void DbManagerTest::testAbandonedProbeResultDropped()
+{
+    plugin->blocking = 1;
+
+    DbManagerImpl manager;
+    manager.setProbeTimeout(100);
+    manager.rescanInvalidDatabasesForPlugin(plugin);
+    manager.notifyDatabasesAreLoaded();
+    QVERIFY(!manager.getByName(DB_NAME)->isValid());
+
+    // Probe finishes after it was abandoned, so its database must be deleted, not added
+    plugin->released.release();
+    QTRY_COMPARE(plugin->destroyedInstances.loadAcquire(), 1);
+    QVERIFY(!manager.getByName(DB_NAME)->isValid());
+}
+
+void DbManagerTest::testMoreHungProbesThanThreads()
+{
+    int totalDbs = DbManagerImpl::PROBE_THREADS + 2;
+    for (int i = 1; i < totalDbs; i++)
+        config->dbs << createDbFile(QString("hung%1").arg(i));
+
+    plugin->blocking = 1;
+
+    DbManagerImpl manager;
+    manager.setProbeTimeout(100);
+    QSignalSpy listLoadedSpy(&manager, SIGNAL(dbListLoaded()));
+
+    QElapsedTimer timer;
+    timer.start();
+    manager.rescanInvalidDatabasesForPlugin(plugin);
+    manager.notifyDatabasesAreLoaded();
+
+    // Probes queued behind the hanging ones time out as well
+    QVERIFY(timer.elapsed() < 5000);
+    QCOMPARE(listLoadedSpy.count(), 1);
+    for (const Config::CfgDbPtr& cfgDb : config->dbs)
+    {
+        InvalidDb* db = dynamic_cast<InvalidDb*>(manager.getByName(cfgDb->name));
+        QVERIFY(db);
+        QVERIFY(db->getError().contains("could not be read"));
+    }
+
+    // Hanging workers don't take threads from new probes
+    plugin->blocking = 0;
+    manager.rescanInvalidDatabasesForPlugin(plugin);
+    for (const Config::CfgDbPtr& cfgDb : config->dbs)
+        QTRY_VERIFY(manager.getByName(cfgDb->name)->isValid());
+
+    // Only workers that were running were blocked, queued ones were skipped
+    plugin->released.release(DbManagerImpl::PROBE_THREADS);
+    QTRY_COMPARE(plugin->destroyedInstances.loadAcquire(), DbManagerImpl::PROBE_THREADS);
+}
+
+QTEST_GUILESS_MAIN(DbManagerTest)
+
+#include "tst_dbmanagertest.moc"
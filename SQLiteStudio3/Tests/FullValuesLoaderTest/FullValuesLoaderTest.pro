@@ -0,0 +1,14 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib widgets
+
+TARGET = tst_fullvaluesloadertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+LIBS += -lguiSQLiteStudio
+
+SOURCES += tst_fullvaluesloadertest.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
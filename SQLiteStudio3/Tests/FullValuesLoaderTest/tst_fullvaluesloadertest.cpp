@@ -0,0 +1,205 @@
+#include "datagrid/fullvaluesloader.h"
+#include "datagrid/sqlqueryitem.h"
+#include "datagrid/sqlquerymodelcolumn.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class FullValuesLoaderTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        FullValuesLoaderTest();
+
+    private:
+        SqlQueryModelColumn* createColumn(const QString& table, const QString& column);
+        SqlQueryItem* createItem(SqlQueryModelColumn* column, const RowId& rowId);
+        SqlQueryItem* createItem(SqlQueryModelColumn* column, qint64 rowId);
+
+        Db* db = nullptr;
+        QList<SqlQueryModelColumn*> columns;
+        QList<SqlQueryItem*> items;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testLoad();
+        void testManySources();
+        void testItemsNotLoadable();
+        void testAsyncLoad();
+        void testClosedDb();
+};
+
+FullValuesLoaderTest::FullValuesLoaderTest()
+{
+}
+
+void FullValuesLoaderTest::initTestCase()
+{
+    initMocks();
+    SqlQueryModelColumn::initMeta();
+}
+
+void FullValuesLoaderTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void FullValuesLoaderTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, txt TEXT, data BLOB)");
+    db->exec("CREATE TABLE other (txt TEXT)");
+    db->exec("CREATE TABLE no_rowid (id INTEGER PRIMARY KEY, txt TEXT) WITHOUT ROWID");
+
+    db->begin();
+    for (int i = 1; i <= 1200; i++)
+        db->exec("INSERT INTO test (id, txt, data) VALUES (?, ?, ?)", {i, QString("long value %1").arg(i).repeated(10), QByteArray(i, 'x')});
+
+    db->exec("INSERT INTO other (rowid, txt) VALUES (7, 'other value')");
+    db->commit();
+}
+
+void FullValuesLoaderTest::cleanup()
+{
+    qDeleteAll(items);
+    items.clear();
+    qDeleteAll(columns);
+    columns.clear();
+
+    db->close();
+    safe_delete(db);
+}
+
+SqlQueryModelColumn* FullValuesLoaderTest::createColumn(const QString& table, const QString& column)
+{
+    QueryExecutor::ResultColumnPtr resCol = QueryExecutor::ResultColumnPtr::create();
+    resCol->table = table;
+    resCol->column = column;
+    resCol->displayName = column;
+    columns << new SqlQueryModelColumn(resCol);
+    return columns.last();
+}
+
+SqlQueryItem* FullValuesLoaderTest::createItem(SqlQueryModelColumn* column, const RowId& rowId)
+{
+    SqlQueryItem* item = new SqlQueryItem();
+    item->setColumn(column);
+    item->setRowId(rowId);
+    items << item;
+    return item;
+}
+
+SqlQueryItem* FullValuesLoaderTest::createItem(SqlQueryModelColumn* column, qint64 rowId)
+{
+    RowId rowIdHash;
+    rowIdHash["ROWID"] = rowId;
+    return createItem(column, rowIdHash);
+}
+
+void FullValuesLoaderTest::testLoad()
+{
+    // More rows than loaded by a single query
+    SqlQueryModelColumn* txtCol = createColumn("test", "txt");
+    SqlQueryModelColumn* dataCol = createColumn("test", "data");
+
+    FullValuesLoader loader(db);
+    QVERIFY(loader.isEmpty());
+    for (int i = 1; i <= 1200; i++)
+    {
+        QVERIFY(loader.addItem(createItem(txtCol, i)));
+        QVERIFY(loader.addItem(createItem(dataCol, i)));
+    }
+
+    // Cell referring to a deleted row has no value
+    QVERIFY(loader.addItem(createItem(txtCol, 5000)));
+    QVERIFY(!loader.isEmpty());
+
+    QVERIFY2(loader.load(), loader.getErrorText().toUtf8().constData());
+
+    QHash<SqlQueryItem*,QVariant> values = loader.getValues();
+    QCOMPARE(values.size(), 2400);
+    for (int i = 1; i <= 1200; i++)
+    {
+        QCOMPARE(values[items[(i - 1) * 2]], QVariant(QString("long value %1").arg(i).repeated(10)));
+        QCOMPARE(values[items[(i - 1) * 2 + 1]], QVariant(QByteArray(i, 'x')));
+    }
+    QVERIFY(!values.contains(items.last()));
+}
+
+void FullValuesLoaderTest::testManySources()
+{
+    FullValuesLoader loader(db);
+    SqlQueryItem* testItem = createItem(createColumn("test", "txt"), 3);
+    SqlQueryItem* otherItem = createItem(createColumn("other", "txt"), 7);
+    QVERIFY(loader.addItem(testItem));
+    QVERIFY(loader.addItem(otherItem));
+    QVERIFY(loader.load());
+
+    QHash<SqlQueryItem*,QVariant> values = loader.getValues();
+    QCOMPARE(values.size(), 2);
+    QCOMPARE(values[testItem], QVariant(QString("long value 3").repeated(10)));
+    QCOMPARE(values[otherItem], QVariant("other value"));
+}
+
+void FullValuesLoaderTest::testItemsNotLoadable()
+{
+    FullValuesLoader loader(db);
+
+    // Expression, not a table column
+    QVERIFY(!loader.addItem(createItem(createColumn(QString(), "txt || 'x'"), 1)));
+
+    // WITHOUT ROWID table
+    RowId rowId;
+    rowId["id"] = 1;
+    QVERIFY(!loader.addItem(createItem(createColumn("no_rowid", "txt"), rowId)));
+
+    // Column of a query that cannot be edited
+    SqlQueryModelColumn* column = createColumn("test", "txt");
+    column->editionForbiddenReason << SqlQueryModelColumn::EditionForbiddenReason::COMPOUND_SELECT;
+    QVERIFY(!loader.addItem(createItem(column, 1)));
+
+    QVERIFY(loader.isEmpty());
+}
+
+void FullValuesLoaderTest::testAsyncLoad()
+{
+    SqlQueryModelColumn* txtCol = createColumn("test", "txt");
+    FullValuesLoader loader(db);
+    for (int i = 1; i <= 1200; i++)
+        QVERIFY(loader.addItem(createItem(txtCol, i)));
+
+    QSignalSpy progressSpy(&loader, SIGNAL(progress(int)));
+    QSignalSpy finishedSpy(&loader, SIGNAL(finished(bool)));
+    loader.start();
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+    QCOMPARE(loader.getValues().size(), 1200);
+
+    // One progress report per query
+    QCOMPARE(progressSpy.size(), 3);
+    QCOMPARE(progressSpy.last().first().toInt(), 100);
+}
+
+void FullValuesLoaderTest::testClosedDb()
+{
+    FullValuesLoader loader(db);
+    QVERIFY(loader.addItem(createItem(createColumn("test", "txt"), 1)));
+    db->close();
+
+    QVERIFY(!loader.load());
+    QVERIFY(!loader.getErrorText().isEmpty());
+    QVERIFY(loader.getValues().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(FullValuesLoaderTest)
+
+#include "tst_fullvaluesloadertest.moc"
@@ -0,0 +1,156 @@
+#include "indexadvisor.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "common/utils_sql.h"
+#include "parser/keywords.h"
+#include "sqlitestudio.h"
+#include "dbmanagermock.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class TestDbManager : public DbManagerMock
+{
+    public:
+        Db* createInMemDb(bool = false)
+        {
+            return new DbSqlite3Mock("index_advisor_memdb");
+        }
+};
+
+class IndexAdvisorTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        IndexAdvisorTest();
+
+    private:
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testPlanCost();
+        void testAdvise();
+        void testNoImprovement();
+        void testInvalidQueries();
+};
+
+IndexAdvisorTest::IndexAdvisorTest()
+{
+}
+
+void IndexAdvisorTest::initTestCase()
+{
+    initKeywords();
+    initUtilsSql();
+    initMocks();
+    SQLITESTUDIO->setDbManager(new TestDbManager());
+}
+
+void IndexAdvisorTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void IndexAdvisorTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE orders (id INTEGER PRIMARY KEY, customer INTEGER, status TEXT, created INTEGER, total REAL)");
+    db->exec("CREATE TABLE customers (id INTEGER PRIMARY KEY, name TEXT)");
+    db->exec("CREATE INDEX idx_orders_status ON orders (status)");
+}
+
+void IndexAdvisorTest::cleanup()
+{
+    db->close();
+    safe_delete(db);
+}
+
+void IndexAdvisorTest::testPlanCost()
+{
+    QCOMPARE(IndexAdvisor::getPlanCost({}), 0.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN orders"}), 100.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN TABLE orders"}), 100.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN orders USING INDEX idx_orders_status"}), 50.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN orders USING COVERING INDEX idx_orders_status"}), 40.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SEARCH orders USING INTEGER PRIMARY KEY (rowid=?)"}), 1.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SEARCH orders USING INDEX idx (customer=?)"}), 5.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SEARCH orders USING COVERING INDEX idx (customer=?)"}), 3.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SEARCH orders USING INDEX idx (customer=? AND created>?)"}), 10.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SEARCH o USING AUTOMATIC COVERING INDEX (customer=?)"}), 60.0);
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN orders", "USE TEMP B-TREE FOR ORDER BY"}), 130.0);
+
+    // Cost grows with every scanned table
+    QCOMPARE(IndexAdvisor::getPlanCost({"SCAN c", "SEARCH o USING INDEX idx (customer=?)"}), 105.0);
+}
+
+void IndexAdvisorTest::testAdvise()
+{
+    // Existing object with the name that would be proposed
+    db->exec("CREATE VIEW idx_orders_customer_created AS SELECT 1");
+
+    IndexAdvisor advisor(db);
+    QVERIFY(advisor.addQueries("SELECT * FROM orders WHERE customer = 5 AND created > 100;"
+                               "SELECT total FROM orders WHERE customer = ? ORDER BY created;"
+                               "SELECT * FROM customers WHERE id = 1;"
+                               "CREATE TABLE ignored (x);"));
+    QCOMPARE(advisor.getQueryCount(), 3);
+
+    QList<IndexAdvisor::RecommendationPtr> recommendations = advisor.advise();
+    QVERIFY2(advisor.getErrors().isEmpty(), advisor.getErrors().join("\n").toUtf8().constData());
+
+    // Index on (customer) helps both queries too, but it's covered by the wider index with higher benefit
+    QCOMPARE(recommendations.size(), 1);
+    IndexAdvisor::RecommendationPtr recommendation = recommendations.first();
+    QCOMPARE(recommendation->table, QString("orders"));
+    QCOMPARE(recommendation->columns, QStringList({"customer", "created"}));
+    QCOMPARE(recommendation->indexName, QString("idx_orders_customer_created_2"));
+    QCOMPARE(recommendation->queries.size(), 2);
+    QVERIFY(recommendation->estimatedBenefit > 1.0);
+
+    // Proposed index can be created in the analyzed database, which was not modified by the analysis
+    QCOMPARE(db->exec("SELECT count(*) FROM sqlite_master WHERE type = 'index'")->getSingleCell().toInt(), 1);
+    SqlQueryPtr results = db->exec(recommendation->ddl);
+    QVERIFY2(!results->isError(), results->getErrorText().toUtf8().constData());
+}
+
+void IndexAdvisorTest::testNoImprovement()
+{
+    IndexAdvisor advisor(db);
+    QVERIFY(advisor.addQueries("UPDATE orders SET total = 0 WHERE status = 'x';"
+                               "DELETE FROM orders WHERE id = 5;"
+                               "SELECT * FROM orders;"));
+
+    // Index on (status) exists already and other queries have nothing to be indexed
+    QVERIFY(advisor.advise().isEmpty());
+    QVERIFY(advisor.getErrors().isEmpty());
+}
+
+void IndexAdvisorTest::testInvalidQueries()
+{
+    IndexAdvisor advisor(db);
+    QVERIFY(!advisor.addQueries("SELEC * FRM orders"));
+    QCOMPARE(advisor.getErrors().size(), 1);
+
+    // Query that cannot be planned is skipped, the rest is analyzed
+    QVERIFY(advisor.addQueries("SELECT * FROM missing_table WHERE x = 1; SELECT * FROM orders WHERE customer = 1;"));
+    QCOMPARE(advisor.getQueryCount(), 2);
+
+    QList<IndexAdvisor::RecommendationPtr> recommendations = advisor.advise();
+    QCOMPARE(advisor.getErrors().size(), 2);
+    QVERIFY(advisor.getErrors().last().contains("missing_table"));
+
+    QCOMPARE(recommendations.size(), 1);
+    QCOMPARE(recommendations.first()->columns, QStringList({"customer"}));
+    QCOMPARE(recommendations.first()->indexName, QString("idx_orders_customer"));
+}
+
+QTEST_APPLESS_MAIN(IndexAdvisorTest)
+
+#include "tst_indexadvisortest.moc"
@@ -0,0 +1,130 @@
+#include "db/queryexecutorsteps/queryexecutorkeysetpaging.h"
+#include "db/sqlquery.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+/**
+ * @brief Tests boundary conditions of keyset paging.
+ *
+ * Each row of the test table is taken as a page boundary and the condition built for it
+ * has to select exactly the rows that follow the boundary in the sort order, including rows with NULL keys.
+ */
+class KeysetPagingTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        KeysetPagingTest();
+
+    private:
+        void verifyAllBoundaries(const QList<bool>& descending);
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testRowValueComparison();
+        void testCompositeKeyAscending();
+        void testCompositeKeyDescending();
+        void testCompositeKeyMixedOrder();
+        void testNullBoundaryDescending();
+};
+
+KeysetPagingTest::KeysetPagingTest()
+{
+}
+
+void KeysetPagingTest::initTestCase()
+{
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (a, b);");
+    db->exec("INSERT INTO test (a, b) VALUES (1, 'x'), (1, NULL), (NULL, 'y'), (NULL, NULL), (2, 'x'), (2, 'x'), "
+             "(1, 'z'), (NULL, 'x'), (3, NULL), (3, 'a');");
+}
+
+void KeysetPagingTest::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+    deleteMockRepo();
+}
+
+void KeysetPagingTest::verifyAllBoundaries(const QList<bool>& descending)
+{
+    static_qstring(selectTpl, "SELECT a, b, rid FROM (SELECT a, b, rowid AS rid FROM test)%1 ORDER BY %2");
+
+    // The ROWID goes last and ascending, just like the step adds it
+    QStringList columns = {"a", "b", "rid"};
+    QStringList orderBy;
+    for (int i = 0, total = columns.size(); i < total; i++)
+        orderBy << (columns[i] + (descending[i] ? " DESC" : " ASC"));
+
+    QList<QList<QVariant>> orderedRows;
+    SqlQueryPtr results = db->exec(selectTpl.arg(QString(), orderBy.join(", ")));
+    QVERIFY(!results->isError());
+    for (const SqlResultsRowPtr& row : results->getAll())
+        orderedRows << row->valueList();
+
+    QCOMPARE(orderedRows.size(), 10);
+
+    for (int i = 0, total = orderedRows.size(); i < total; i++)
+    {
+        QHash<QString, QVariant> params;
+        QString condition = QueryExecutorKeysetPaging::getBoundaryCondition(columns, descending, orderedRows[i], params);
+        QCOMPARE(params.size(), columns.size());
+
+        results = db->exec(selectTpl.arg(" WHERE " + condition, orderBy.join(", ")), params);
+        QVERIFY2(!results->isError(), results->getErrorText().toUtf8().constData());
+
+        QList<QList<QVariant>> followingRows;
+        for (const SqlResultsRowPtr& row : results->getAll())
+            followingRows << row->valueList();
+
+        QCOMPARE(followingRows, orderedRows.mid(i + 1));
+    }
+}
+
+void KeysetPagingTest::testRowValueComparison()
+{
+    QHash<QString, QVariant> params;
+    QString condition = QueryExecutorKeysetPaging::getBoundaryCondition({"a", "b"}, {false, false}, {1, "x"}, params);
+
+    QCOMPARE(condition, QString("(a, b) > (:sqlitestudio_keyset_0, :sqlitestudio_keyset_1)"));
+    QCOMPARE(params[":sqlitestudio_keyset_0"], QVariant(1));
+    QCOMPARE(params[":sqlitestudio_keyset_1"], QVariant("x"));
+}
+
+void KeysetPagingTest::testCompositeKeyAscending()
+{
+    verifyAllBoundaries({false, false, false});
+}
+
+void KeysetPagingTest::testCompositeKeyDescending()
+{
+    verifyAllBoundaries({true, true, false});
+}
+
+void KeysetPagingTest::testCompositeKeyMixedOrder()
+{
+    verifyAllBoundaries({false, true, false});
+    verifyAllBoundaries({true, false, false});
+}
+
+void KeysetPagingTest::testNullBoundaryDescending()
+{
+    // Nothing follows NULL in descending order
+    QHash<QString, QVariant> params;
+    QString condition = QueryExecutorKeysetPaging::getBoundaryCondition({"a"}, {true}, {QVariant()}, params);
+    QCOMPARE(condition, QString("0"));
+}
+
+QTEST_APPLESS_MAIN(KeysetPagingTest)
+
+#include "tst_keysetpagingtest.moc"
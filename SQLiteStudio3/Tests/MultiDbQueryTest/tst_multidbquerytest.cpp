@@ -0,0 +1,300 @@
+#include "multidbquery.h"
+#include "plugins/dbplugin.h"
+#include "plugins/genericplugin.h"
+#include "sqlitestudio.h"
+#include "pluginmanagermock.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+
+class TestDbPlugin : public GenericPlugin, public DbPlugin
+{
+    public:
+        QString getName() const
+        {
+            return "TestDbPlugin";
+        }
+
+        Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString*)
+        {
+            return new DbSqlite3Mock(name, path, options);
+        }
+
+        QString getLabel() const
+        {
+            return getName();
+        }
+
+        QList<DbPluginOption> getOptionsList() const
+        {
+            return QList<DbPluginOption>();
+        }
+
+        QString generateDbName(const QVariant& baseValue)
+        {
+            return baseValue.toString();
+        }
+
+        bool checkIfDbServedByPlugin(Db* db) const
+        {
+            return dynamic_cast<DbSqlite3Mock*>(db) != nullptr;
+        }
+};
+
+class TestPluginManager : public PluginManagerMock
+{
+    public:
+        Plugin* getLoadedPlugin(const QString& pluginName) const
+        {
+            if (plugin && plugin->getName() == pluginName)
+                return plugin;
+
+            return nullptr;
+        }
+
+        Plugin* plugin = nullptr;
+};
+
+class MultiDbQueryTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        MultiDbQueryTest();
+
+    private:
+        Db* createDb(const QString& name, const QStringList& statements, const QString& pluginName = "TestDbPlugin");
+        MultiDbQuery::Result findResult(const QList<MultiDbQuery::Result>& results, const QString& database);
+
+        TestDbPlugin* plugin = nullptr;
+        QTemporaryDir tempDir;
+        QList<Db*> dbs;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void cleanup();
+        void testSumMerge();
+        void testSumOverflow();
+        void testCountMerge();
+        void testMismatchedColumns();
+        void testErrorInOneDb();
+        void testMissingDriver();
+};
+
+MultiDbQueryTest::MultiDbQueryTest()
+{
+}
+
+Db* MultiDbQueryTest::createDb(const QString& name, const QStringList& statements, const QString& pluginName)
+{
+    QHash<QString, QVariant> options;
+    options[DB_PLUGIN] = pluginName;
+
+    Db* db = new DbSqlite3Mock(name, tempDir.filePath(name + ".db"), options);
+    dbs << db;
+    if (!db->openQuiet())
+        return db;
+
+    for (const QString& sql : statements)
+    {
+        SqlQueryPtr results = db->exec(sql);
+        if (results->isError())
+            qWarning() << "Could not prepare database" << name << ":" << results->getErrorText();
+    }
+
+    db->closeQuiet();
+    return db;
+}
+
+MultiDbQuery::Result MultiDbQueryTest::findResult(const QList<MultiDbQuery::Result>& results, const QString& database)
+{
+    for (const MultiDbQuery::Result& result : results)
+    {
+        if (result.database == database)
+            return result;
+    }
+    return MultiDbQuery::Result();
+}
+
+void MultiDbQueryTest::initTestCase()
+{
+    initMocks();
+
+    plugin = new TestDbPlugin();
+    TestPluginManager* pluginManager = new TestPluginManager();
+    pluginManager->plugin = plugin;
+    SQLITESTUDIO->setPluginManager(pluginManager);
+
+    QVERIFY(tempDir.isValid());
+}
+
+void MultiDbQueryTest::cleanupTestCase()
+{
+    deleteMockRepo();
+    delete plugin;
+}
+
+void MultiDbQueryTest::cleanup()
+{
+    for (Db* db : dbs)
+        QFile::remove(db->getPath());
+
+    qDeleteAll(dbs);
+    dbs.clear();
+}
+
+void MultiDbQueryTest::testSumMerge()
+{
+    MultiDbQuery query("SELECT a, b, c FROM test");
+    query.setMerge(MultiDbQuery::Merge::SUM);
+    query.setThreads(2);
+    query.addDb(createDb("first", {"CREATE TABLE test (a, b, c)",
+                                   "INSERT INTO test VALUES (1, 0.5, 'x')",
+                                   "INSERT INTO test VALUES (2, NULL, 'y')"}));
+    query.addDb(createDb("second", {"CREATE TABLE test (a, b, c)",
+                                    "INSERT INTO test VALUES (10, 1.25, 'z')"}));
+    query.addDb(createDb("third", {"CREATE TABLE test (a, b, c)"}));
+
+    QVERIFY(query.exec());
+
+    QList<MultiDbQuery::Result> results = query.getResults();
+    QCOMPARE(results.size(), 3);
+    for (const MultiDbQuery::Result& result : results)
+        QVERIFY2(result.success, result.errorText.toUtf8().constData());
+
+    QCOMPARE(findResult(results, "first").rows, 2LL);
+    QCOMPARE(findResult(results, "second").rows, 1LL);
+    QCOMPARE(findResult(results, "third").rows, 0LL);
+
+    QCOMPARE(query.getColumns(), QStringList({"a", "b", "c"}));
+
+    QList<QVariant> totals = query.getTotals();
+    QCOMPARE(totals.size(), 3);
+    QCOMPARE(totals[0].type(), QVariant::LongLong);
+    QCOMPARE(totals[0].toLongLong(), 13LL);
+    QCOMPARE(totals[1].toDouble(), 1.75);
+    QVERIFY(totals[2].isNull());
+}
+
+void MultiDbQueryTest::testSumOverflow()
+{
+    MultiDbQuery query("SELECT a, b, c FROM test");
+    query.setMerge(MultiDbQuery::Merge::SUM);
+    query.setThreads(1);
+
+    // Column "a" overflows within rows of one database, column "c" while merging results of databases
+    query.addDb(createDb("first", {"CREATE TABLE test (a, b, c)",
+                                   "INSERT INTO test VALUES (9223372036854775807, 1, -9223372036854775807 - 1)",
+                                   "INSERT INTO test VALUES (1, 2, 0)"}));
+    query.addDb(createDb("second", {"CREATE TABLE test (a, b, c)",
+                                    "INSERT INTO test VALUES (1, 3, -1)"}));
+
+    QVERIFY(query.exec());
+    for (const MultiDbQuery::Result& result : query.getResults())
+        QVERIFY2(result.success, result.errorText.toUtf8().constData());
+
+    QList<QVariant> totals = query.getTotals();
+    QCOMPARE(totals.size(), 3);
+    QCOMPARE(totals[0].type(), QVariant::Double);
+    QCOMPARE(totals[0].toDouble(), 9223372036854775808.0);
+    QCOMPARE(totals[1].type(), QVariant::LongLong);
+    QCOMPARE(totals[1].toLongLong(), 6LL);
+    QCOMPARE(totals[2].type(), QVariant::Double);
+    QCOMPARE(totals[2].toDouble(), -9223372036854775808.0);
+}
+
+void MultiDbQueryTest::testCountMerge()
+{
+    MultiDbQuery query("SELECT * FROM test");
+    query.setMerge(MultiDbQuery::Merge::COUNT);
+    query.addDb(createDb("first", {"CREATE TABLE test (a)",
+                                   "INSERT INTO test VALUES (1)",
+                                   "INSERT INTO test VALUES (2)",
+                                   "INSERT INTO test VALUES (3)"}));
+    query.addDb(createDb("second", {"CREATE TABLE test (a)",
+                                    "INSERT INTO test VALUES (1)"}));
+
+    QVERIFY(query.exec());
+
+    QList<MultiDbQuery::Result> results = query.getResults();
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(findResult(results, "first").rows, 3LL);
+    QCOMPARE(findResult(results, "second").rows, 1LL);
+}
+
+void MultiDbQueryTest::testMismatchedColumns()
+{
+    MultiDbQuery query("SELECT * FROM test");
+    query.setMerge(MultiDbQuery::Merge::SUM);
+
+    // Single worker, so the first database defines columns
+    query.setThreads(1);
+    query.addDb(createDb("first", {"CREATE TABLE test (a, b)",
+                                   "INSERT INTO test VALUES (1, 2)"}));
+    query.addDb(createDb("second", {"CREATE TABLE test (a, b, c)",
+                                    "INSERT INTO test VALUES (10, 20, 30)"}));
+
+    QVERIFY(query.exec());
+
+    QList<MultiDbQuery::Result> results = query.getResults();
+    QCOMPARE(results.size(), 2);
+    QVERIFY(results[0].success);
+    QCOMPARE(results[0].database, QString("first"));
+    QVERIFY(!results[1].success);
+    QCOMPARE(results[1].database, QString("second"));
+    QVERIFY(results[1].errorText.contains("3"));
+    QVERIFY(results[1].errorText.contains("2"));
+
+    // Rows of the mismatched database are not summed up
+    QCOMPARE(query.getColumns(), QStringList({"a", "b"}));
+    QCOMPARE(query.getTotals(), QList<QVariant>({1LL, 2LL}));
+}
+
+void MultiDbQueryTest::testErrorInOneDb()
+{
+    MultiDbQuery query("SELECT a FROM test");
+    query.setMerge(MultiDbQuery::Merge::SUM);
+    query.setThreads(1);
+    query.addDb(createDb("first", {"CREATE TABLE test (a)",
+                                   "INSERT INTO test VALUES (5)"}));
+    query.addDb(createDb("broken", {"CREATE TABLE other (a)"}));
+    query.addDb(createDb("last", {"CREATE TABLE test (a)",
+                                  "INSERT INTO test VALUES (7)"}));
+
+    QVERIFY(query.exec());
+
+    QList<MultiDbQuery::Result> results = query.getResults();
+    QCOMPARE(results.size(), 3);
+    QVERIFY(findResult(results, "first").success);
+    QVERIFY(findResult(results, "last").success);
+
+    MultiDbQuery::Result broken = findResult(results, "broken");
+    QVERIFY(!broken.success);
+    QVERIFY(broken.errorText.contains("no such table"));
+
+    QCOMPARE(query.getTotals(), QList<QVariant>({12LL}));
+}
+
+void MultiDbQueryTest::testMissingDriver()
+{
+    MultiDbQuery query("SELECT a FROM test");
+    query.addDb(createDb("first", {"CREATE TABLE test (a)"}));
+    query.addDb(createDb("unknown", {"CREATE TABLE test (a)"}, "MissingPlugin"));
+
+    QVERIFY(query.exec());
+
+    QList<MultiDbQuery::Result> results = query.getResults();
+    QCOMPARE(results.size(), 2);
+    QVERIFY(findResult(results, "first").success);
+
+    MultiDbQuery::Result unknown = findResult(results, "unknown");
+    QVERIFY(!unknown.success);
+    QVERIFY(unknown.errorText.contains("unknown"));
+}
+
+QTEST_GUILESS_MAIN(MultiDbQueryTest)
+
+#include "tst_multidbquerytest.moc"
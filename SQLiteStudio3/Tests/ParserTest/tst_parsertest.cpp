@@ -7,6 +7,7 @@
 #include "parser/keywords.h"
 #include "parser/lexer.h"
 #include "parser/parsererror.h"
+#include "parser/parsercheckpoints.h"
 #include "common/utils_sql.h"
 #include "parser/ast/sqlitewindowdefinition.h"
 #include "parser/ast/sqlitefilterover.h"
@@ -61,6 +62,7 @@ class ParserTest : public QObject
         void testFilterClause();
         void testUpdateFrom();
         void testStringAsTableId();
+        void testNextTokenCandidatesWithCheckpoints();
 };
 
 ParserTest::ParserTest()
@@ -412,6 +414,34 @@ void ParserTest::testCommentBeginMultiline()
     QVERIFY(tokens[0]->type == Token::COMMENT);
 }
 
+void ParserTest::testNextTokenCandidatesWithCheckpoints()
+{
+    QString sql;
+    for (int i = 0; i < 40; i++)
+        sql += QString("SELECT id, val FROM test%1 WHERE id > %1 AND (val LIKE 'x%' OR val IS NULL); ").arg(i);
+
+    sql += "CREATE TRIGGER trig AFTER INSERT ON test BEGIN UPDATE test SET val = new.val, id = id + 1 WHERE id = 5; END;";
+
+    ParserCheckpoints checkpoints;
+    Parser freshParser;
+    QList<QString> texts;
+    for (int lgt = sql.length() - 100; lgt <= sql.length(); lgt += 3)
+        texts << sql.left(lgt);
+
+    // Modification in the middle of the text
+    QString modified = sql;
+    modified.replace(sql.length() / 2, 10, "1 OR id IN (1, 2) AND ");
+    texts << modified << sql;
+
+    for (const QString& text : texts)
+    {
+        QSet<TokenPtr> expected = toSet(freshParser.getNextTokenCandidates(text));
+        QSet<TokenPtr> actual = toSet(parser3->getNextTokenCandidates(text, &checkpoints));
+        QVERIFY(expected == actual);
+        QVERIFY(checkpoints.count() > 0);
+    }
+}
+
 void ParserTest::testBetween()
 {
     QString sql = "SELECT * FROM test WHERE a BETWEEN 1 and 2";
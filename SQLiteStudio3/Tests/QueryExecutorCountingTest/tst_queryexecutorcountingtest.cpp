@@ -0,0 +1,312 @@
+#include "db/queryexecutor.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "common/utils_sql.h"
+#include "parser/keywords.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+
+class QueryExecutorCountingTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        QueryExecutorCountingTest();
+
+    private:
+        bool execAndCount(QueryExecutor& executor);
+        bool isCached(QueryExecutor& executor);
+        void setCached(QueryExecutor& executor, qint64 rows);
+        QString getDbState(QueryExecutor& executor);
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testExactCountCached();
+        void testCacheKeyDbState();
+        void testCacheKeyParams();
+        void testEstimateFromStat();
+        void testEstimateFromRowId();
+        void testEstimateFallback_data();
+        void testEstimateFallback();
+        void testLazyCount();
+};
+
+QueryExecutorCountingTest::QueryExecutorCountingTest()
+{
+}
+
+void QueryExecutorCountingTest::initTestCase()
+{
+    initKeywords();
+    initUtilsSql();
+    initMocks();
+}
+
+void QueryExecutorCountingTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void QueryExecutorCountingTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, val INTEGER)");
+    db->exec("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < 50) "
+             "INSERT INTO test (id, val) SELECT x, x FROM seq");
+    db->exec("CREATE TABLE no_rowid (id INTEGER PRIMARY KEY, val INTEGER) WITHOUT ROWID");
+    db->exec("INSERT INTO no_rowid (id, val) VALUES (10, 1), (20, 2), (30, 3)");
+
+    // Fresh databases end up in the same state, so counts from previous tests would be taken from the cache
+    QMutexLocker lock(&QueryExecutor::countCacheMutex);
+    QueryExecutor::countCache.clear();
+}
+
+void QueryExecutorCountingTest::cleanup()
+{
+    db->close();
+    safe_delete(db);
+}
+
+bool QueryExecutorCountingTest::execAndCount(QueryExecutor& executor)
+{
+    QSignalSpy failedSpy(&executor, SIGNAL(executionFailed(int,QString)));
+    executor.setAsyncMode(false);
+    executor.setResultsPerPage(10);
+    executor.exec();
+    if (!failedSpy.isEmpty())
+    {
+        qWarning() << "Query execution failed:" << failedSpy.first().last().toString();
+        return false;
+    }
+
+    return executor.countResults();
+}
+
+bool QueryExecutorCountingTest::isCached(QueryExecutor& executor)
+{
+    QMutexLocker lock(&QueryExecutor::countCacheMutex);
+    return !executor.countCacheKey.isNull() && QueryExecutor::countCache.contains(executor.countCacheKey);
+}
+
+void QueryExecutorCountingTest::setCached(QueryExecutor& executor, qint64 rows)
+{
+    QMutexLocker lock(&QueryExecutor::countCacheMutex);
+    QueryExecutor::countCache.insert(executor.countCacheKey, new qint64(rows));
+}
+
+QString QueryExecutorCountingTest::getDbState(QueryExecutor& executor)
+{
+    return executor.getDbStateForCountCache();
+}
+
+void QueryExecutorCountingTest::testExactCountCached()
+{
+    QueryExecutor executor(db, "SELECT * FROM test WHERE val > 10");
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 40LL);
+    QCOMPARE(executor.getTotalPages(), 4);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+    QVERIFY(isCached(executor));
+
+    // As long as the database doesn't change, the counting query is not executed again, not even by another executor
+    setCached(executor, 1234);
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 1234LL);
+
+    QueryExecutor otherExecutor(db, "SELECT * FROM test WHERE val > 10");
+    QVERIFY(execAndCount(otherExecutor));
+    QCOMPARE(otherExecutor.getTotalRowsReturned(), 1234LL);
+
+    // Any modification makes the cached number outdated
+    db->exec("INSERT INTO test (id, val) VALUES (51, 51)");
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 41LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+}
+
+void QueryExecutorCountingTest::testCacheKeyDbState()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Two connections to the same file
+    QString path = tempDir.filePath("state.db");
+    Db* firstDb = new DbSqlite3Mock("firstdb", path);
+    Db* secondDb = new DbSqlite3Mock("seconddb", path);
+    QVERIFY(firstDb->open());
+    QVERIFY(secondDb->open());
+    firstDb->exec("CREATE TABLE test (x)");
+
+    QueryExecutor executor(firstDb, "SELECT * FROM test");
+    QVERIFY(execAndCount(executor));
+    QString state = getDbState(executor);
+    QVERIFY(!state.isNull());
+
+    // Reading doesn't change the state
+    firstDb->exec("SELECT * FROM test");
+    secondDb->exec("SELECT * FROM test");
+    QCOMPARE(getDbState(executor), state);
+
+    // Change made by the same connection is not reflected by data_version, but it is by total_changes()
+    firstDb->exec("INSERT INTO test VALUES (1)");
+    QString newState = getDbState(executor);
+    QVERIFY(newState != state);
+    state = newState;
+
+    // Change made by another connection is reflected by data_version
+    secondDb->exec("INSERT INTO test VALUES (2)");
+    newState = getDbState(executor);
+    QVERIFY(newState != state);
+    state = newState;
+
+    // Schema change counts no rows, but it's reflected by schema_version
+    firstDb->exec("CREATE INDEX test_idx ON test (x)");
+    newState = getDbState(executor);
+    QVERIFY(newState != state);
+
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 2LL);
+
+    firstDb->close();
+    secondDb->close();
+    delete firstDb;
+    delete secondDb;
+}
+
+void QueryExecutorCountingTest::testCacheKeyParams()
+{
+    QueryExecutor executor(db, "SELECT * FROM test WHERE val > :min");
+    executor.setParam(":min", 10);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 40LL);
+    QString key = executor.countCacheKey;
+
+    executor.setParam(":min", 40);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 10LL);
+    QVERIFY(executor.countCacheKey != key);
+
+    // Value of other type is bound differently, so it's cached separately
+    executor.setParam(":min", "10");
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 40LL);
+    QVERIFY(executor.countCacheKey != key);
+
+    executor.setParam(":min", 10);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.countCacheKey, key);
+    QVERIFY(isCached(executor));
+}
+
+void QueryExecutorCountingTest::testEstimateFromStat()
+{
+    // The partial index has its own sqlite_stat1 entry with fewer rows than the table
+    db->exec("CREATE INDEX test_partial ON test (val) WHERE val > 45");
+    db->exec("ANALYZE");
+    QVERIFY(db->exec("SELECT count(*) FROM sqlite_stat1 WHERE tbl = 'test'")->getSingleCell().toInt() > 1);
+
+    // Rows added after ANALYZE are not included
+    db->exec("INSERT INTO test (id, val) VALUES (100, 100)");
+
+    QueryExecutor executor(db, "SELECT * FROM test");
+    executor.setCountingMode(QueryExecutor::CountingMode::ESTIMATED);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 50LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::ESTIMATED);
+
+    // Estimations are not cached
+    QVERIFY(!isCached(executor));
+}
+
+void QueryExecutorCountingTest::testEstimateFromRowId()
+{
+    db->exec("DELETE FROM test WHERE id BETWEEN 11 AND 20");
+
+    QueryExecutor executor(db, "SELECT id, val AS value FROM test");
+    executor.setCountingMode(QueryExecutor::CountingMode::ESTIMATED);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 50LL);
+    QCOMPARE(executor.getTotalPages(), 5);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::ESTIMATED);
+
+    // Empty table is known to have no rows
+    db->exec("DELETE FROM test");
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 0LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+}
+
+void QueryExecutorCountingTest::testEstimateFallback_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<qint64>("rows");
+    QTest::newRow("where") << "SELECT * FROM test WHERE val > 10" << 40LL;
+    QTest::newRow("limit") << "SELECT * FROM test LIMIT 5" << 5LL;
+    QTest::newRow("distinct") << "SELECT DISTINCT val / 10 FROM test" << 6LL;
+    QTest::newRow("aggregate") << "SELECT count(*) FROM test" << 1LL;
+    QTest::newRow("join") << "SELECT * FROM test t1 JOIN test t2 ON t1.id = t2.val" << 50LL;
+    QTest::newRow("without rowid") << "SELECT * FROM no_rowid" << 3LL;
+}
+
+void QueryExecutorCountingTest::testEstimateFallback()
+{
+    QFETCH(QString, query);
+    QFETCH(qint64, rows);
+
+    // Queries other than plain scans of tables with ROWID are counted exactly
+    QueryExecutor executor(db, query);
+    executor.setCountingMode(QueryExecutor::CountingMode::ESTIMATED);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), rows);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+}
+
+void QueryExecutorCountingTest::testLazyCount()
+{
+    QueryExecutor executor(db, "SELECT * FROM test WHERE val > 5");
+    executor.setCountingMode(QueryExecutor::CountingMode::LAZY);
+    executor.setLazyCountingLimit(20);
+    QVERIFY(execAndCount(executor));
+    QCOMPARE(executor.getTotalRowsReturned(), 20LL);
+    QCOMPARE(executor.getTotalPages(), 2);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::LOWER_BOUND);
+
+    // Lower bound is not cached
+    QVERIFY(!isCached(executor));
+
+    // Exactly as many rows as the limit is still an exact number
+    executor.setLazyCountingLimit(45);
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 45LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+    QVERIFY(isCached(executor));
+
+    // Once the exact number is known, it's used no matter of the limit
+    executor.setLazyCountingLimit(20);
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 45LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+
+    db->exec("DELETE FROM test WHERE val > 30");
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 20LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::LOWER_BOUND);
+
+    executor.setLazyCountingLimit(100);
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 25LL);
+    QVERIFY(executor.getTotalRowsAccuracy() == QueryExecutor::CountAccuracy::EXACT);
+}
+
+QTEST_GUILESS_MAIN(QueryExecutorCountingTest)
+
+#include "tst_queryexecutorcountingtest.moc"
@@ -0,0 +1,286 @@
+#include "db/queryexecutor.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "common/utils_sql.h"
+#include "parser/keywords.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class QueryExecutorSnapshotTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        QueryExecutorSnapshotTest();
+
+    private:
+        QList<QList<QVariant>> exec(QueryExecutor& executor);
+        QList<QVariant> column(const QList<QList<QVariant>>& rows, int idx);
+        QString getSnapshotTable(QueryExecutor& executor);
+        bool tableExists(const QString& table);
+        int getIndexCount(const QString& table);
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testReuse();
+        void testDisabled();
+        void testSortIndex();
+        void testFilter();
+        void testDroppedTable();
+};
+
+QueryExecutorSnapshotTest::QueryExecutorSnapshotTest()
+{
+}
+
+void QueryExecutorSnapshotTest::initTestCase()
+{
+    initKeywords();
+    initUtilsSql();
+    initMocks();
+}
+
+void QueryExecutorSnapshotTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void QueryExecutorSnapshotTest::init()
+{
+    // Scores are a permutation of 0-19, so the order by score differs from the order by id
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, score INTEGER)");
+    db->exec("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < 20) "
+             "INSERT INTO test (id, name, score) SELECT x, 'name ' || x, (x * 7) % 20 FROM seq");
+}
+
+void QueryExecutorSnapshotTest::cleanup()
+{
+    db->close();
+    safe_delete(db);
+}
+
+QList<QList<QVariant>> QueryExecutorSnapshotTest::exec(QueryExecutor& executor)
+{
+    QSignalSpy failedSpy(&executor, SIGNAL(executionFailed(int,QString)));
+
+    // Values of result columns go first, ROWID columns follow them
+    QList<QList<QVariant>> rows;
+    executor.setAsyncMode(false);
+    executor.setResultsPerPage(100);
+    executor.exec([&rows, &executor](SqlQueryPtr results)
+    {
+        int columns = executor.getResultColumns().size();
+        while (results->hasNext())
+            rows << results->next()->valueList().mid(0, columns);
+    });
+
+    if (!failedSpy.isEmpty())
+        qWarning() << "Query execution failed:" << failedSpy.first().last().toString();
+
+    return rows;
+}
+
+QList<QVariant> QueryExecutorSnapshotTest::column(const QList<QList<QVariant>>& rows, int idx)
+{
+    QList<QVariant> values;
+    for (const QList<QVariant>& row : rows)
+        values << row[idx];
+
+    return values;
+}
+
+QString QueryExecutorSnapshotTest::getSnapshotTable(QueryExecutor& executor)
+{
+    QMutexLocker lock(&executor.snapshotMutex);
+    return executor.snapshotTable;
+}
+
+bool QueryExecutorSnapshotTest::tableExists(const QString& table)
+{
+    return db->exec("SELECT count(*) FROM sqlite_temp_master WHERE type = 'table' AND name = ?", {table})->getSingleCell().toInt() > 0;
+}
+
+int QueryExecutorSnapshotTest::getIndexCount(const QString& table)
+{
+    return db->exec("SELECT count(*) FROM sqlite_temp_master WHERE type = 'index' AND tbl_name = ?", {table})->getSingleCell().toInt();
+}
+
+void QueryExecutorSnapshotTest::testReuse()
+{
+    QueryExecutor executor(db, "SELECT id, name FROM test WHERE id <= :max");
+    executor.setSnapshotMode(true);
+    executor.setParam(":max", 5);
+
+    QList<QList<QVariant>> rows = exec(executor);
+    QCOMPARE(rows.size(), 5);
+    QVERIFY(executor.isSnapshotResults());
+    QVERIFY(executor.getSnapshotTime().isValid());
+
+    QString table = getSnapshotTable(executor);
+    QVERIFY(!table.isNull());
+    QVERIFY(tableExists(table));
+
+    // The same query with the same parameters reads the same snapshot, so it doesn't see later changes
+    db->exec("UPDATE test SET name = 'changed' WHERE id = 1");
+    rows = exec(executor);
+    QCOMPARE(getSnapshotTable(executor), table);
+    QCOMPARE(rows.first()[1], QVariant("name 1"));
+
+    // Other parameter value takes a new snapshot and drops the old one
+    executor.setParam(":max", 3);
+    rows = exec(executor);
+    QCOMPARE(rows.size(), 3);
+    QCOMPARE(rows.first()[1], QVariant("changed"));
+    QVERIFY(getSnapshotTable(executor) != table);
+    QVERIFY(!tableExists(table));
+    table = getSnapshotTable(executor);
+
+    // Value of other type is bound differently, so it's another snapshot too
+    executor.setParam(":max", "3");
+    rows = exec(executor);
+    QCOMPARE(rows.size(), 3);
+    QVERIFY(getSnapshotTable(executor) != table);
+    table = getSnapshotTable(executor);
+
+    // Other query
+    executor.setParam(":max", 3);
+    executor.setQuery("SELECT id, name FROM test WHERE id <= :max AND id > 1");
+    rows = exec(executor);
+    QCOMPARE(column(rows, 0), QList<QVariant>({2LL, 3LL}));
+    QVERIFY(getSnapshotTable(executor) != table);
+    QVERIFY(!tableExists(table));
+    table = getSnapshotTable(executor);
+
+    executor.dropSnapshot();
+    QVERIFY(!tableExists(table));
+    QVERIFY(!executor.getSnapshotTime().isValid());
+}
+
+void QueryExecutorSnapshotTest::testDisabled()
+{
+    QueryExecutor executor(db, "SELECT id, name FROM test");
+    QList<QList<QVariant>> rows = exec(executor);
+    QCOMPARE(rows.size(), 20);
+    QVERIFY(!executor.isSnapshotResults());
+    QVERIFY(getSnapshotTable(executor).isNull());
+
+    executor.setSnapshotMode(true);
+    exec(executor);
+    QString table = getSnapshotTable(executor);
+    QVERIFY(tableExists(table));
+
+    // Disabling snapshot mode drops the snapshot and the query reads current data again
+    executor.setSnapshotMode(false);
+    QVERIFY(!tableExists(table));
+
+    db->exec("DELETE FROM test WHERE id > 10");
+    rows = exec(executor);
+    QCOMPARE(rows.size(), 10);
+    QVERIFY(!executor.isSnapshotResults());
+}
+
+void QueryExecutorSnapshotTest::testSortIndex()
+{
+    QueryExecutor executor(db, "SELECT id, score FROM test");
+    executor.setSnapshotMode(true);
+
+    // Without sorting rows go in order of the original results
+    QList<QList<QVariant>> rows = exec(executor);
+    QCOMPARE(rows.size(), 20);
+    for (int i = 0; i < 20; i++)
+        QCOMPARE(rows[i][0].toInt(), i + 1);
+
+    QString table = getSnapshotTable(executor);
+    QCOMPARE(getIndexCount(table), 0);
+
+    executor.setSortOrder({QueryExecutor::Sort(QueryExecutor::Sort::DESC, 1)});
+    rows = exec(executor);
+    QCOMPARE(rows.size(), 20);
+    for (int i = 0; i < 20; i++)
+        QCOMPARE(rows[i][1].toInt(), 19 - i);
+
+    QCOMPARE(getSnapshotTable(executor), table);
+    QCOMPARE(getIndexCount(table), 1);
+
+    // Sorting reads the index, it doesn't sort all rows
+    QString alias = executor.getResultColumns()[1]->queryExecutorAlias;
+    SqlQueryPtr results = db->exec(QString("EXPLAIN QUERY PLAN SELECT * FROM (SELECT * FROM temp.%1) ORDER BY %2 DESC").arg(table, alias));
+    QStringList plan;
+    for (const SqlResultsRowPtr& row : results->getAll())
+        plan << row->value("detail").toString();
+
+    QVERIFY2(!plan.join("\n").contains("TEMP B-TREE"), plan.join("\n").toUtf8().constData());
+
+    // The same order reuses the index, other order creates another one
+    exec(executor);
+    QCOMPARE(getIndexCount(table), 1);
+
+    executor.setSortOrder({QueryExecutor::Sort(QueryExecutor::Sort::ASC, 1)});
+    rows = exec(executor);
+    for (int i = 0; i < 20; i++)
+        QCOMPARE(rows[i][1].toInt(), i);
+
+    QCOMPARE(getIndexCount(table), 2);
+
+    // Indexes are dropped together with the snapshot
+    executor.dropSnapshot();
+    QCOMPARE(getIndexCount(table), 0);
+}
+
+void QueryExecutorSnapshotTest::testFilter()
+{
+    QueryExecutor executor(db, "SELECT id, name AS label, score * 2 AS \"double score\" FROM test");
+    executor.setSnapshotMode(true);
+    QCOMPARE(exec(executor).size(), 20);
+    QString table = getSnapshotTable(executor);
+
+    // Filter refers to columns by their display names, while the snapshot uses executor aliases
+    executor.setSnapshotFilter("label = 'name 3' OR \"double score\" < 4");
+    QList<QList<QVariant>> rows = exec(executor);
+    QCOMPARE(column(rows, 0), QList<QVariant>({3LL, 20LL}));
+    QCOMPARE(getSnapshotTable(executor), table);
+
+    // Filtered rows are counted
+    QVERIFY(executor.countResults());
+    QCOMPARE(executor.getTotalRowsReturned(), 2LL);
+
+    executor.setSnapshotFilter("id > 17");
+    executor.setSortOrder({QueryExecutor::Sort(QueryExecutor::Sort::DESC, 0)});
+    rows = exec(executor);
+    QCOMPARE(column(rows, 0), QList<QVariant>({20LL, 19LL, 18LL}));
+
+    executor.setSnapshotFilter(QString());
+    QCOMPARE(exec(executor).size(), 20);
+    QCOMPARE(getSnapshotTable(executor), table);
+}
+
+void QueryExecutorSnapshotTest::testDroppedTable()
+{
+    QueryExecutor executor(db, "SELECT id, name FROM test");
+    executor.setSnapshotMode(true);
+    exec(executor);
+    QString table = getSnapshotTable(executor);
+
+    // Dropped outside of the executor, i.e. by the user
+    db->exec(QString("DROP TABLE temp.%1").arg(table));
+    db->exec("DELETE FROM test WHERE id > 10");
+
+    QList<QList<QVariant>> rows = exec(executor);
+    QCOMPARE(rows.size(), 10);
+    QVERIFY(executor.isSnapshotResults());
+    QVERIFY(getSnapshotTable(executor) != table);
+    QVERIFY(tableExists(getSnapshotTable(executor)));
+}
+
+QTEST_GUILESS_MAIN(QueryExecutorSnapshotTest)
+
+#include "tst_queryexecutorsnapshottest.moc"
@@ -0,0 +1,14 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+QT       -= gui
+
+TARGET = tst_regexpimporttest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += tst_regexpimporttest.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+DEFINES += PLUGINS_DIR=\\\"$$PWD/../../../$$OUTPUT_DIR_NAME/SQLiteStudio/plugins\\\"
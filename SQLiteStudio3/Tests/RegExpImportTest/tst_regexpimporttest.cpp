@@ -0,0 +1,209 @@
+#include "plugins/importplugin.h"
+#include "plugins/genericplugin.h"
+#include "config_builder/cfgmain.h"
+#include "config_builder/cfgcategory.h"
+#include "config_builder/cfgentry.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QPluginLoader>
+#include <QTemporaryFile>
+
+/**
+ * @brief Tests of the RegExpImport plugin.
+ *
+ * The plugin is loaded from the output directory of the build. Tests are skipped if it was not built.
+ */
+class RegExpImportTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        RegExpImportTest();
+
+    private:
+        QList<QList<QVariant>> import(const QString& pattern, const QString& input, bool lineByLine = false);
+        QString generateLines(int count, const QString& terminator);
+        void verifyGeneratedRows(const QList<QList<QVariant>>& rows, int count);
+
+        /**
+         * @brief Same as RegExpImport::BLOCK_SIZE.
+         */
+        static const int BLOCK_SIZE = 1024 * 1024;
+
+        QPluginLoader* loader = nullptr;
+        ImportPlugin* plugin = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testSeveralRecordsPerLine();
+        void testRecordSpanningLines();
+        void testSkippedTextBetweenRecords();
+        void testLineByLineOrder();
+        void testLineByLineCrLf();
+        void testLineByLineLastLineWithoutTerminator();
+        void testLineByLineLongLine();
+};
+
+RegExpImportTest::RegExpImportTest()
+{
+}
+
+void RegExpImportTest::initTestCase()
+{
+    initMocks();
+
+    loader = new QPluginLoader(QString(PLUGINS_DIR) + "/RegExpImport");
+    plugin = dynamic_cast<ImportPlugin*>(dynamic_cast<Plugin*>(loader->instance()));
+    if (!plugin)
+        QSKIP(QString("Could not load RegExpImport: %1").arg(loader->errorString()).toUtf8().constData());
+
+    GenericPlugin* genericPlugin = dynamic_cast<GenericPlugin*>(plugin);
+    if (genericPlugin)
+        genericPlugin->loadMetaData(loader->metaData());
+
+    QVERIFY(plugin->init());
+}
+
+void RegExpImportTest::cleanupTestCase()
+{
+    if (plugin)
+        plugin->deinit();
+
+    safe_delete(loader);
+    deleteMockRepo();
+}
+
+QList<QList<QVariant>> RegExpImportTest::import(const QString& pattern, const QString& input, bool lineByLine)
+{
+    QList<QList<QVariant>> rows;
+    QTemporaryFile file;
+    if (!file.open())
+        return rows;
+
+    file.write(input.toUtf8());
+    file.flush();
+
+    CfgCategory* category = plugin->getConfig()->getCategories()["RegExpImport"];
+    category->getEntries()["Pattern"]->set(pattern);
+    category->getEntries()["GroupsMode"]->set("all");
+    category->getEntries()["LineByLine"]->set(lineByLine);
+
+    ImportManager::StandardImportConfig config;
+    config.codec = "UTF-8";
+    config.inputFileName = file.fileName();
+    if (!plugin->beforeImport(config))
+        return rows;
+
+    QList<QVariant> row;
+    while (!(row = plugin->next()).isEmpty())
+        rows << row;
+
+    plugin->afterImport();
+    return rows;
+}
+
+QString RegExpImportTest::generateLines(int count, const QString& terminator)
+{
+    // Every 7th line doesn't match the pattern and is skipped
+    static_qstring(lineTpl, "%1;value %1");
+    QString text;
+    for (int i = 1; i <= count; i++)
+    {
+        text += lineTpl.arg(i) + terminator;
+        if (i % 7 == 0)
+            text += "junk" + terminator;
+    }
+    return text;
+}
+
+void RegExpImportTest::verifyGeneratedRows(const QList<QList<QVariant>>& rows, int count)
+{
+    QCOMPARE(rows.size(), count);
+    for (int i = 0; i < count; i++)
+    {
+        if (rows[i] != QList<QVariant>({QString::number(i + 1), QString("value %1").arg(i + 1)}))
+            QFAIL(QString("Unexpected row %1: %2").arg(i).arg(rows[i].first().toString()).toUtf8().constData());
+    }
+}
+
+void RegExpImportTest::testSeveralRecordsPerLine()
+{
+    QList<QList<QVariant>> rows = import("(\\d+);(\\w+);", "1;a;2;b;3;c;\n4;d;5;e;\n");
+
+    QList<QList<QVariant>> expected = {{"1", "a"}, {"2", "b"}, {"3", "c"}, {"4", "d"}, {"5", "e"}};
+    QCOMPARE(rows, expected);
+}
+
+void RegExpImportTest::testRecordSpanningLines()
+{
+    // Records 3 and 5 are complete only after the next line is appended to the buffer
+    QList<QList<QVariant>> rows = import("(\\d+);(\\w+);", "1;a;2;b;3;\nc;4;d;5\n;e;");
+
+    QList<QList<QVariant>> expected = {{"1", "a"}, {"2", "b"}, {"3", "c"}, {"4", "d"}, {"5", "e"}};
+    QCOMPARE(rows, expected);
+}
+
+void RegExpImportTest::testSkippedTextBetweenRecords()
+{
+    QList<QList<QVariant>> rows = import("<(\\w+)=(\\d+)>", "junk <a=1> junk <b=2>\n<c=3> junk <d=\n4>junk");
+
+    QList<QList<QVariant>> expected = {{"a", "1"}, {"b", "2"}, {"c", "3"}, {"d", "4"}};
+    QCOMPARE(rows, expected);
+}
+
+void RegExpImportTest::testLineByLineOrder()
+{
+    // Several blocks, each matched in several chunks by parallel threads
+    static const int count = 300000;
+    QString input = generateLines(count, "\n");
+    QVERIFY(input.size() > BLOCK_SIZE * 3);
+
+    verifyGeneratedRows(import("^(\\d+);(.*)$", input, true), count);
+}
+
+void RegExpImportTest::testLineByLineCrLf()
+{
+    QList<QList<QVariant>> rows = import("^(\\d+);(\\w+)$", "1;a\r\n2;b\r\n\r\n3;c\r\n", true);
+
+    QList<QList<QVariant>> expected = {{"1", "a"}, {"2", "b"}, {"3", "c"}};
+    QCOMPARE(rows, expected);
+
+    // Line terminators at block and chunk boundaries
+    static const int count = 300000;
+    QString input = generateLines(count, "\r\n");
+    verifyGeneratedRows(import("^(\\d+);(.*)$", input, true), count);
+}
+
+void RegExpImportTest::testLineByLineLastLineWithoutTerminator()
+{
+    QList<QList<QVariant>> rows = import("^(\\d+);(\\w+)$", "1;a\n2;b", true);
+
+    QList<QList<QVariant>> expected = {{"1", "a"}, {"2", "b"}};
+    QCOMPARE(rows, expected);
+
+    // The last line comes with the last block
+    static const int count = 200000;
+    QString input = generateLines(count, "\n");
+    input.chop(1);
+    QVERIFY(!input.endsWith("junk"));
+    verifyGeneratedRows(import("^(\\d+);(.*)$", input, true), count);
+}
+
+void RegExpImportTest::testLineByLineLongLine()
+{
+    // The long line spans several blocks, so it's completed only after reading them all
+    QString longValue(BLOCK_SIZE * 2 + 100, 'x');
+    QList<QList<QVariant>> rows = import("^(\\d+);(\\w+)$", "1;a\n2;" + longValue + "\n3;c\n", true);
+
+    QCOMPARE(rows.size(), 3);
+    QCOMPARE(rows[0], QList<QVariant>({"1", "a"}));
+    QCOMPARE(rows[1][0].toString(), QString("2"));
+    QCOMPARE(rows[1][1].toString(), longValue);
+    QCOMPARE(rows[2], QList<QVariant>({"3", "c"}));
+}
+
+QTEST_APPLESS_MAIN(RegExpImportTest)
+
+#include "tst_regexpimporttest.moc"
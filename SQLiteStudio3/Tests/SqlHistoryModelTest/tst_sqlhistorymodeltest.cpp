@@ -0,0 +1,233 @@
+#include "sqlhistorymodel.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class SqlHistoryModelTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        SqlHistoryModelTest();
+
+    private:
+        void addEntries(int count, const QString& sql = "SELECT 1");
+        qint64 addEntry(const QString& sql);
+        QList<qint64> getIds(SqlHistoryModel& model);
+        bool createFtsIndex();
+
+        static const int PAGE_SIZE = 500;
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void initTestCase();
+        void cleanupTestCase();
+        void testPaging();
+        void testEntryAdded();
+        void testEntryAddedNotMatchingFilter();
+        void testEntryAddedBeyondLoadedPages();
+        void testLikeFilter();
+        void testFtsFilter();
+};
+
+SqlHistoryModelTest::SqlHistoryModelTest()
+{
+}
+
+void SqlHistoryModelTest::initTestCase()
+{
+    initMocks();
+}
+
+void SqlHistoryModelTest::cleanupTestCase()
+{
+    deleteMockRepo();
+}
+
+void SqlHistoryModelTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE sqleditor_history (id INTEGER PRIMARY KEY, dbname TEXT, date INTEGER, time_spent INTEGER, rows INTEGER, sql TEXT, "
+             "profile TEXT)");
+}
+
+void SqlHistoryModelTest::cleanup()
+{
+    db->close();
+    safe_delete(db);
+}
+
+void SqlHistoryModelTest::addEntries(int count, const QString& sql)
+{
+    db->begin();
+    for (int i = 0; i < count; i++)
+        addEntry(sql);
+
+    db->commit();
+}
+
+qint64 SqlHistoryModelTest::addEntry(const QString& sql)
+{
+    SqlQueryPtr results = db->exec("INSERT INTO sqleditor_history (dbname, date, time_spent, rows, sql) VALUES ('testdb', 0, 10, 1, ?)", {sql});
+    return results->getRegularInsertRowId();
+}
+
+QList<qint64> SqlHistoryModelTest::getIds(SqlHistoryModel& model)
+{
+    QList<qint64> ids;
+    for (int row = 0, total = model.rowCount(); row < total; row++)
+        ids << model.data(model.index(row, 0), Qt::DisplayRole).toLongLong();
+
+    return ids;
+}
+
+bool SqlHistoryModelTest::createFtsIndex()
+{
+    SqlQueryPtr results = db->exec("CREATE VIRTUAL TABLE sqleditor_history_fts USING fts5(sql, content='sqleditor_history', content_rowid='id')");
+    if (results->isError())
+        return false;
+
+    db->exec("CREATE TRIGGER sqleditor_history_fts_ai AFTER INSERT ON sqleditor_history BEGIN "
+             "INSERT INTO sqleditor_history_fts (rowid, sql) VALUES (new.id, new.sql); "
+             "END");
+    return true;
+}
+
+void SqlHistoryModelTest::testPaging()
+{
+    addEntries(PAGE_SIZE * 2 + 10);
+
+    SqlHistoryModel model(db, false);
+    QCOMPARE(model.rowCount(), PAGE_SIZE);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), PAGE_SIZE * 2);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), PAGE_SIZE * 2 + 10);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    // Most recent entries first, each entry exactly once
+    QList<qint64> ids = getIds(model);
+    for (int i = 1, total = ids.size(); i < total; i++)
+        QVERIFY(ids[i - 1] > ids[i]);
+}
+
+void SqlHistoryModelTest::testEntryAdded()
+{
+    addEntries(3);
+
+    SqlHistoryModel model(db, false);
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    qint64 id = addEntry("SELECT 2");
+    model.entryAdded(id);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(getIds(model).first(), id);
+
+    // Entry reported twice is not duplicated
+    model.entryAdded(id);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(insertedSpy.count(), 1);
+}
+
+void SqlHistoryModelTest::testEntryAddedNotMatchingFilter()
+{
+    addEntries(3, "SELECT * FROM customers");
+
+    SqlHistoryModel model(db, false);
+    model.setFilter("customers");
+    QCOMPARE(model.rowCount(), 3);
+
+    model.entryAdded(addEntry("SELECT * FROM orders"));
+    QCOMPARE(model.rowCount(), 3);
+
+    model.entryAdded(addEntry("DELETE FROM customers"));
+    QCOMPARE(model.rowCount(), 4);
+}
+
+void SqlHistoryModelTest::testEntryAddedBeyondLoadedPages()
+{
+    qint64 oldId = addEntry("SELECT 1");
+    addEntries(PAGE_SIZE + 1);
+
+    SqlHistoryModel model(db, false);
+    QCOMPARE(model.rowCount(), PAGE_SIZE);
+
+    // The entry belongs to a page that was not loaded yet, so it will come with that page
+    model.entryAdded(oldId);
+    QCOMPARE(model.rowCount(), PAGE_SIZE);
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), PAGE_SIZE + 2);
+    QCOMPARE(getIds(model).last(), oldId);
+}
+
+void SqlHistoryModelTest::testLikeFilter()
+{
+    addEntry("SELECT * FROM customers");
+    addEntry("SELECT discount_pct FROM orders");
+    addEntry("SELECT 100% FROM orders");
+
+    SqlHistoryModel model(db, false);
+    QCOMPARE(model.rowCount(), 3);
+
+    // Substring of a word matches
+    model.setFilter("ustom");
+    QCOMPARE(model.rowCount(), 1);
+
+    // Wildcards are matched literally
+    model.setFilter("%");
+    QCOMPARE(model.rowCount(), 1);
+
+    model.setFilter("_pct");
+    QCOMPARE(model.rowCount(), 1);
+
+    model.setFilter(QString());
+    QCOMPARE(model.rowCount(), 3);
+}
+
+void SqlHistoryModelTest::testFtsFilter()
+{
+    if (!createFtsIndex())
+        QSKIP("FTS5 is not available in the SQLite library.");
+
+    addEntry("SELECT * FROM customers");
+    addEntry("SELECT * FROM orders WHERE customer_id = 5");
+    addEntry("DELETE FROM \"orders\"");
+
+    SqlHistoryModel model(db, true);
+    QCOMPARE(model.rowCount(), 3);
+
+    // Words are matched as prefixes of words, not as substrings
+    model.setFilter("custom");
+    QCOMPARE(model.rowCount(), 2);
+
+    model.setFilter("ustom");
+    QCOMPARE(model.rowCount(), 0);
+
+    // All words have to match
+    model.setFilter("select orders");
+    QCOMPARE(model.rowCount(), 1);
+
+    // FTS5 query syntax is not interpreted, so OR is just another word and quotes don't break the query
+    model.setFilter("orders OR delete");
+    QCOMPARE(model.rowCount(), 1);
+
+    model.setFilter("\"orders");
+    QCOMPARE(model.rowCount(), 2);
+}
+
+QTEST_APPLESS_MAIN(SqlHistoryModelTest)
+
+#include "tst_sqlhistorymodeltest.moc"
@@ -34,6 +34,10 @@ class TableModifierTest : public QObject
         void testCase5();
         void testCase6();
         void testCase7();
+        void testNativeAlter();
+        void testNativeAlterFallback();
+        void testNativeAlterSwapColumns();
+        void testNativeAlterRenameChain();
 };
 
 TableModifierTest::TableModifierTest()
@@ -300,6 +304,142 @@ void TableModifierTest::testCase7()
     verifyRe("PRAGMA foreign_keys = 1;", sqls[i++]);
 }
 
+void TableModifierTest::testNativeAlter()
+{
+    static_qstring(ddl, "CREATE TABLE test (id int, newCol text, val2 text, added int DEFAULT 5);");
+
+    Parser parser;
+    Q_ASSERT(parser.parse(ddl));
+    Q_ASSERT(parser.getQueries().size() > 0);
+    SqliteCreateTablePtr localCreateTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    Q_ASSERT(!localCreateTable.isNull());
+    localCreateTable->columns[1]->originalName = "val";
+    localCreateTable->columns[3]->originalName = QString();
+
+    TableModifier mod(db, "test");
+    mod.alterTable(localCreateTable);
+    QStringList sqls = mod.generateSqls();
+
+    /*
+     * 1. Rename column in place.
+     * 2. Add new column in place.
+     */
+    QVERIFY(mod.getStrategy() == TableModifier::Strategy::NATIVE_ALTER);
+    QVERIFY(mod.getEstimatedRowsToCopy() == 0);
+    QVERIFY(sqls.size() == 2);
+    int i = 0;
+    verifyRe("ALTER TABLE test RENAME COLUMN val TO newCol;", sqls[i++]);
+    verifyRe("ALTER TABLE test ADD COLUMN added int DEFAULT 5;", sqls[i++]);
+}
+
+void TableModifierTest::testNativeAlterFallback()
+{
+    db->exec("CREATE INDEX i1 ON test (val);");
+    db->exec("INSERT INTO test (id, val, val2) VALUES (1, 'a', 'b'), (2, 'c', 'd'), (3, 'e', 'f');");
+
+    TableModifier mod(db, "test");
+    createTable->columns.removeAt(1);
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    /*
+     * Indexed column cannot be dropped with ALTER TABLE, so the table is rebuilt.
+     * 1. Disable FK.
+     * 2. Rename to temp in 2 steps.
+     * 3. Second step of renaming (drop).
+     * 4. Create new.
+     * 5. Copy data from temp to new one.
+     * 6. Drop temp table.
+     * 7. Enable FK.
+     */
+    QVERIFY(mod.getStrategy() == TableModifier::Strategy::REBUILD);
+    QVERIFY(mod.getEstimatedRowsToCopy() == 3);
+    QVERIFY(sqls.size() == 7);
+    int i = 0;
+    verifyRe("PRAGMA foreign_keys = 0;", sqls[i++]);
+    verifyRe("CREATE TABLE sqlitestudio_temp_table.*AS SELECT.*FROM test.*", sqls[i++]);
+    verifyRe("DROP TABLE test;", sqls[i++]);
+    verifyRe("CREATE TABLE test \\(id int, val2 text\\);", sqls[i++]);
+    verifyRe("INSERT INTO test \\(id, val2\\) SELECT id, val2 FROM sqlitestudio_temp_table.*", sqls[i++]);
+    verifyRe("DROP TABLE sqlitestudio_temp_table.*", sqls[i++]);
+    verifyRe("PRAGMA foreign_keys = 1;", sqls[i++]);
+}
+
+void TableModifierTest::testNativeAlterSwapColumns()
+{
+    db->exec("INSERT INTO test (id, val, val2) VALUES (1, 'a', 'b');");
+
+    static_qstring(ddl, "CREATE TABLE test (id int, val2 text, val text);");
+
+    Parser parser;
+    Q_ASSERT(parser.parse(ddl));
+    Q_ASSERT(parser.getQueries().size() > 0);
+    SqliteCreateTablePtr localCreateTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    Q_ASSERT(!localCreateTable.isNull());
+    localCreateTable->columns[1]->originalName = "val";
+    localCreateTable->columns[2]->originalName = "val2";
+
+    TableModifier mod(db, "test");
+    mod.alterTable(localCreateTable);
+    QStringList sqls = mod.generateSqls();
+
+    /*
+     * Target names still exist at the time of renaming, so columns are renamed through temporary names.
+     */
+    QVERIFY(mod.getStrategy() == TableModifier::Strategy::NATIVE_ALTER);
+    QVERIFY(sqls.size() == 4);
+    int i = 0;
+    verifyRe("ALTER TABLE test RENAME COLUMN val TO val_tmp;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val2 TO val2_tmp;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val_tmp TO val2;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val2_tmp TO val;", sqls[i++]);
+
+    for (const QString& sql : sqls)
+        QVERIFY2(!db->exec(sql)->isError(), sql.toUtf8().constData());
+
+    SqlQueryPtr results = db->exec("SELECT val, val2 FROM test;");
+    SqlResultsRowPtr row = results->next();
+    QVERIFY(row);
+    QCOMPARE(row->value("val").toString(), QString("b"));
+    QCOMPARE(row->value("val2").toString(), QString("a"));
+}
+
+void TableModifierTest::testNativeAlterRenameChain()
+{
+    db->exec("INSERT INTO test (id, val, val2) VALUES (1, 'a', 'b');");
+
+    static_qstring(ddl, "CREATE TABLE test (id int, val2 text, val3 text);");
+
+    Parser parser;
+    Q_ASSERT(parser.parse(ddl));
+    Q_ASSERT(parser.getQueries().size() > 0);
+    SqliteCreateTablePtr localCreateTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    Q_ASSERT(!localCreateTable.isNull());
+    localCreateTable->columns[1]->originalName = "val";
+    localCreateTable->columns[2]->originalName = "val2";
+
+    TableModifier mod(db, "test");
+    mod.alterTable(localCreateTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(mod.getStrategy() == TableModifier::Strategy::NATIVE_ALTER);
+    QVERIFY(sqls.size() == 4);
+    int i = 0;
+    verifyRe("ALTER TABLE test RENAME COLUMN val TO val_tmp;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val2 TO val2_tmp;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val_tmp TO val2;", sqls[i++]);
+    verifyRe("ALTER TABLE test RENAME COLUMN val2_tmp TO val3;", sqls[i++]);
+
+    for (const QString& sql : sqls)
+        QVERIFY2(!db->exec(sql)->isError(), sql.toUtf8().constData());
+
+    SqlQueryPtr results = db->exec("SELECT val2, val3 FROM test;");
+    SqlResultsRowPtr row = results->next();
+    QVERIFY(row);
+    QCOMPARE(row->value("val2").toString(), QString("a"));
+    QCOMPARE(row->value("val3").toString(), QString("b"));
+}
+
 void TableModifierTest::initTestCase()
 {
     initKeywords();
@@ -18,6 +18,11 @@ QList<CollationManager::CollationPtr> CollationManagerMock::getCollationsForData
     return QList<CollationManager::CollationPtr>();
 }
 
+CollationManager::CollationPtr CollationManagerMock::getCollation(const QString&) const
+{
+    return CollationPtr();
+}
+
 int CollationManagerMock::evaluate(const QString&, const QString&, const QString&)
 {
     return 0;
@@ -27,3 +32,13 @@ int CollationManagerMock::evaluateDefault(const QString&, const QString&)
 {
     return 0;
 }
+
+QByteArray CollationManagerMock::evaluateSortKey(const QString&, const QString&)
+{
+    return QByteArray();
+}
+
+QByteArray CollationManagerMock::evaluateDefaultSortKey(const QString&)
+{
+    return QByteArray();
+}
@@ -11,8 +11,11 @@ class CollationManagerMock : public CollationManager
         void setCollations(const QList<CollationPtr>&);
         QList<CollationPtr> getAllCollations() const;
         QList<CollationPtr> getCollationsForDatabase(const QString&) const;
+        CollationPtr getCollation(const QString&) const;
         int evaluate(const QString&, const QString&, const QString&);
         int evaluateDefault(const QString&, const QString&);
+        QByteArray evaluateSortKey(const QString&, const QString&);
+        QByteArray evaluateDefaultSortKey(const QString&);
 };
 
 #endif // COLLATIONMANAGERMOCK_H
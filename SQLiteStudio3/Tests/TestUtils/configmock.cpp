@@ -94,12 +94,12 @@ Config::DbGroupPtr ConfigMock::getDbGroup(const QString&)
     return Config::DbGroupPtr();
 }
 
-qint64 ConfigMock::addSqlHistory(const QString&, const QString&, int, int)
+qint64 ConfigMock::addSqlHistory(const QString&, const QString&, int, int, const QString&)
 {
     return 0;
 }
 
-void ConfigMock::updateSqlHistory(qint64, const QString&, const QString&, int, int)
+void ConfigMock::updateSqlHistory(qint64, const QString&, const QString&, int, int, const QString&)
 {
 }
 
@@ -111,11 +111,20 @@ void ConfigMock::deleteSqlHistory(const QList<qint64>&)
 {
 }
 
-QAbstractItemModel* ConfigMock::getSqlHistoryModel()
+void ConfigMock::applySqlHistoryLimit()
+{
+}
+
+SqlHistoryModel* ConfigMock::createSqlHistoryModel(QObject*)
 {
     return nullptr;
 }
 
+QList<Config::SqlHistoryEntryPtr> ConfigMock::getMostExpensiveSqlHistory(const QString&, int)
+{
+    return QList<SqlHistoryEntryPtr>();
+}
+
 void ConfigMock::addCliHistory(const QString&)
 {
 }
@@ -28,11 +28,13 @@ class ConfigMock : public Config
         void storeGroups(const QList<DbGroupPtr>&);
         QList<DbGroupPtr> getGroups();
         DbGroupPtr getDbGroup(const QString&);
-        qint64 addSqlHistory(const QString&, const QString&, int, int);
-        void updateSqlHistory(qint64, const QString&, const QString&, int, int);
+        qint64 addSqlHistory(const QString&, const QString&, int, int, const QString&);
+        void updateSqlHistory(qint64, const QString&, const QString&, int, int, const QString&);
         void clearSqlHistory();
         void deleteSqlHistory(const QList<qint64>&);
-        QAbstractItemModel*getSqlHistoryModel();
+        void applySqlHistoryLimit();
+        SqlHistoryModel* createSqlHistoryModel(QObject*);
+        QList<SqlHistoryEntryPtr> getMostExpensiveSqlHistory(const QString&, int);
         void addCliHistory(const QString&);
         void applyCliHistoryLimit();
         void clearCliHistory();
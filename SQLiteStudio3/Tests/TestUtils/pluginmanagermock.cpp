@@ -156,6 +156,18 @@ bool PluginManagerMock::arePluginsInitiallyLoaded() const
     return true;
 }
 
+void PluginManagerMock::setStartupPluginTypes(const QList<PluginType*>&)
+{
+}
+
+void PluginManagerMock::setDeferredPluginTypes(const QList<PluginType*>&)
+{
+}
+
+void PluginManagerMock::loadDeferredPlugins()
+{
+}
+
 QList<Plugin *> PluginManagerMock::getLoadedPlugins() const
 {
     return QList<Plugin *>();
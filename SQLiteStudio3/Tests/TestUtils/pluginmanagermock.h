@@ -37,6 +37,9 @@ class PluginManagerMock : public PluginManager
         QList<PluginDetails> getLoadedPluginDetails() const;
         QStringList getLoadedPluginNames() const;
         bool arePluginsInitiallyLoaded() const;
+        void setStartupPluginTypes(const QList<PluginType*>&);
+        void setDeferredPluginTypes(const QList<PluginType*>&);
+        void loadDeferredPlugins();
         QList<Plugin*> getLoadedPlugins() const;
 
     protected:
@@ -29,6 +29,48 @@ lexer_test.depends = test_utils
 formatter.subdir = FormatterTest
 formatter.depends = test_utils
 
+benchmarks.subdir = Benchmarks
+benchmarks.depends = test_utils
+
+db_manager.subdir = DbManagerTest
+db_manager.depends = test_utils
+
+keyset_paging.subdir = KeysetPagingTest
+keyset_paging.depends = test_utils
+
+sql_history_model.subdir = SqlHistoryModelTest
+sql_history_model.depends = test_utils
+
+regexp_import.subdir = RegExpImportTest
+regexp_import.depends = test_utils
+
+db_diff.subdir = DbDiffTest
+db_diff.depends = test_utils
+
+multidbquery.subdir = MultiDbQueryTest
+multidbquery.depends = test_utils
+
+dbblob.subdir = DbBlobTest
+dbblob.depends = test_utils
+
+fullvaluesloader.subdir = FullValuesLoaderTest
+fullvaluesloader.depends = test_utils
+
+index_advisor.subdir = IndexAdvisorTest
+index_advisor.depends = test_utils
+
+collation_sort_key_cache.subdir = CollationSortKeyCacheTest
+collation_sort_key_cache.depends = test_utils
+
+query_executor_counting.subdir = QueryExecutorCountingTest
+query_executor_counting.depends = test_utils
+
+query_executor_snapshot.subdir = QueryExecutorSnapshotTest
+query_executor_snapshot.depends = test_utils
+
+db_maintenance.subdir = DbMaintenanceTest
+db_maintenance.depends = test_utils
+
 SUBDIRS += \
     test_utils \
     completion_helper \
@@ -39,4 +81,18 @@ SUBDIRS += \
     dsv \
     utils_test \
     lexer_test \
-    formatter
+    formatter \
+    benchmarks \
+    db_manager \
+    keyset_paging \
+    sql_history_model \
+    regexp_import \
+    db_diff \
+    multidbquery \
+    dbblob \
+    fullvaluesloader \
+    index_advisor \
+    collation_sort_key_cache \
+    query_executor_counting \
+    query_executor_snapshot \
+    db_maintenance
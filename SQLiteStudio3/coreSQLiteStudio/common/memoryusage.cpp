@@ -1,5 +1,6 @@
 #include "memoryusage.h"
-#include <QtGlobal>
+#include <QVariant>
+#include <QStringList>
 
 #ifdef Q_OS_LINUX
 #include <QFile>
@@ -20,9 +21,9 @@
 
 #ifdef Q_OS_LINUX
 
-int getMemoryUsage()
+qint64 getMemoryUsage()
 {
-    static const QRegularExpression re("VmSize\\:\\s+(\\d+)\\s+(\\w+)");
+    static const QRegularExpression re("VmRSS\\:\\s+(\\d+)\\s+(\\w+)");
 
     QFile file("/proc/self/status");
     if (!file.open(QIODevice::ReadOnly))
@@ -34,7 +35,7 @@ int getMemoryUsage()
         return -1;
 
     bool ok;
-    int result = match.captured(1).toInt(&ok);
+    qint64 result = match.captured(1).toLongLong(&ok);
     if (!ok)
         return -1;
 
@@ -51,7 +52,7 @@ int getMemoryUsage()
 #else
 #ifdef Q_OS_WIN32
 
-int getMemoryUsage()
+qint64 getMemoryUsage()
 {
     PROCESS_MEMORY_COUNTERS_EX pmc;
     GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc));
@@ -61,7 +62,7 @@ int getMemoryUsage()
 #else
 #ifdef Q_OS_MAC
 
-int getMemoryUsage()
+qint64 getMemoryUsage()
 {
     struct task_basic_info t_info;
     mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
@@ -69,11 +70,11 @@ int getMemoryUsage()
     if (KERN_SUCCESS != task_info(mach_task_self(), TASK_BASIC_INFO, (task_info_t)&t_info, &t_info_count))
         return -1;
 
-    return t_info.virtual_size;
+    return t_info.resident_size;
 }
 
 #else
-int getMemoryUsage()
+qint64 getMemoryUsage()
 {
     return -1;
 }
@@ -81,3 +82,49 @@ int getMemoryUsage()
 #endif // Q_OS_MAC
 #endif // Q_OS_WIN32
 #endif // Q_OS_LINUX
+
+qint64 estimateMemoryUsage(const QVariant& value)
+{
+    // Header of QString/QByteArray/QList data block
+    static const int dataHeader = 24;
+
+    qint64 size = sizeof(QVariant);
+    switch (value.type())
+    {
+        case QVariant::String:
+            size += dataHeader + value.toString().size() * sizeof(QChar);
+            break;
+        case QVariant::ByteArray:
+            size += dataHeader + value.toByteArray().size();
+            break;
+        case QVariant::StringList:
+        {
+            size += dataHeader;
+            for (const QString& str : value.toStringList())
+                size += sizeof(void*) + sizeof(QString) + dataHeader + str.size() * sizeof(QChar);
+
+            break;
+        }
+        case QVariant::List:
+        {
+            size += dataHeader;
+            for (const QVariant& element : value.toList())
+                size += sizeof(void*) + estimateMemoryUsage(element);
+
+            break;
+        }
+        case QVariant::Hash:
+        case QVariant::Map:
+        {
+            size += dataHeader;
+            QVariantMap map = value.toMap();
+            for (auto it = map.cbegin(); it != map.cend(); ++it)
+                size += sizeof(void*) * 3 + sizeof(QString) + dataHeader + it.key().size() * sizeof(QChar) + estimateMemoryUsage(it.value());
+
+            break;
+        }
+        default:
+            break;
+    }
+    return size;
+}
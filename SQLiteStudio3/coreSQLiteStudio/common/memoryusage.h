@@ -1,6 +1,27 @@
 #ifndef MEMORYUSAGE_H
 #define MEMORYUSAGE_H
 
-int getMemoryUsage();
+#include "coreSQLiteStudio_global.h"
+#include <QtGlobal>
+
+class QVariant;
+
+/**
+ * @brief Provides memory used by the process.
+ * @return Number of bytes, or -1 if it could not be determined.
+ *
+ * It's the resident set size on Linux and macOS, and private bytes on Windows.
+ */
+API_EXPORT qint64 getMemoryUsage();
+
+/**
+ * @brief Estimates memory held by the value.
+ * @param value Value to estimate.
+ * @return Estimated number of bytes, including the QVariant itself.
+ *
+ * Data of strings, byte arrays and lists (recursively) is included. Implicit sharing is not taken into account,
+ * so the data shared by many values is counted for each of them.
+ */
+API_EXPORT qint64 estimateMemoryUsage(const QVariant& value);
 
 #endif // MEMORYUSAGE_H
@@ -0,0 +1,190 @@
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QList>
+#include <QHash>
+#include <QFile>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+struct StartupTraceEvent
+{
+    QString name;
+    qint64 start = 0;
+    qint64 duration = -1; // -1 for point in time events
+    quintptr threadId = 0;
+};
+
+struct StartupTraceState
+{
+    StartupTraceState()
+    {
+        // Started when the core library is loaded, which is as close to the process start as we can get portably.
+        timer.start();
+    }
+
+    QElapsedTimer timer;
+    QMutex mutex;
+    QList<StartupTraceEvent> events;
+    QString outputFile;
+};
+
+static StartupTraceState traceState;
+static QAtomicInt traceEnabled;
+
+StartupTrace::Scope::Scope(const QString& name)
+{
+    if (traceEnabled.loadAcquire())
+    {
+        this->name = name;
+        start = StartupTrace::elapsed();
+    }
+}
+
+StartupTrace::Scope::~Scope()
+{
+    end();
+}
+
+void StartupTrace::Scope::next(const QString& name)
+{
+    end();
+    if (traceEnabled.loadAcquire())
+    {
+        this->name = name;
+        start = StartupTrace::elapsed();
+    }
+}
+
+void StartupTrace::Scope::end()
+{
+    if (start < 0)
+        return;
+
+    StartupTrace::record(name, start, StartupTrace::elapsed() - start);
+    start = -1;
+}
+
+StartupTrace::StartupTrace()
+{
+}
+
+void StartupTrace::enable(const QString& outputFile)
+{
+    QMutexLocker locker(&traceState.mutex);
+    traceState.outputFile = outputFile;
+    traceEnabled.storeRelease(1);
+}
+
+void StartupTrace::enableFromEnv()
+{
+    if (traceEnabled.loadAcquire())
+        return;
+
+    QString outputFile = QString::fromLocal8Bit(qgetenv("SQLITESTUDIO_STARTUP_TRACE"));
+    if (!outputFile.isEmpty())
+        enable(outputFile);
+}
+
+bool StartupTrace::isEnabled()
+{
+    return traceEnabled.loadAcquire();
+}
+
+void StartupTrace::record(const QString& name, qint64 start, qint64 duration)
+{
+    if (!traceEnabled.loadAcquire())
+        return;
+
+    StartupTraceEvent event;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QMutexLocker locker(&traceState.mutex);
+    traceState.events << event;
+}
+
+void StartupTrace::mark(const QString& name)
+{
+    if (!traceEnabled.loadAcquire())
+        return;
+
+    record(name, elapsed(), -1);
+}
+
+qint64 StartupTrace::elapsed()
+{
+    return traceState.timer.nsecsElapsed() / 1000;
+}
+
+QByteArray StartupTrace::toChromeTraceJson()
+{
+    QMutexLocker locker(&traceState.mutex);
+
+    // Chrome expects small thread numbers, so native thread IDs are mapped to consecutive integers.
+    QHash<quintptr,int> threadNumbers;
+    QJsonArray traceEvents;
+    for (const StartupTraceEvent& event : traceState.events)
+    {
+        if (!threadNumbers.contains(event.threadId))
+            threadNumbers[event.threadId] = threadNumbers.size() + 1;
+
+        QJsonObject obj;
+        obj["name"] = event.name;
+        obj["cat"] = "startup";
+        obj["pid"] = 1;
+        obj["tid"] = threadNumbers[event.threadId];
+        obj["ts"] = event.start;
+        if (event.duration < 0)
+        {
+            obj["ph"] = "i";
+            obj["s"] = "g";
+        }
+        else
+        {
+            obj["ph"] = "X";
+            obj["dur"] = event.duration;
+        }
+        traceEvents << obj;
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool StartupTrace::finish()
+{
+    if (!traceEnabled.loadAcquire())
+        return false;
+
+    mark("Startup finished");
+    QByteArray json = toChromeTraceJson();
+    traceEnabled.storeRelease(0);
+
+    QString outputFile;
+    {
+        QMutexLocker locker(&traceState.mutex);
+        outputFile = traceState.outputFile;
+        traceState.events.clear();
+    }
+
+    QFile file(outputFile);
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        qWarning() << "Could not write startup trace to" << outputFile << ":" << file.errorString();
+        return false;
+    }
+
+    file.write(json);
+    file.close();
+    return true;
+}
@@ -0,0 +1,107 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief Records durations of application startup phases.
+ *
+ * Tracing is disabled by default and then it costs nothing more than a single flag check.
+ * It's enabled with the --startup-trace command line option (or the SQLITESTUDIO_STARTUP_TRACE environment variable),
+ * which points to the file where the trace is written once the startup is finished (see finish()).
+ *
+ * The trace is written in the Chrome Trace Event format, so it can be opened with chrome://tracing,
+ * Perfetto UI, or any other compatible viewer. Nested phases are displayed as nested bars.
+ *
+ * Usage:
+ * @code
+ * StartupTrace::Scope trace("Config");
+ * config->init();
+ * trace.next("Translations");
+ * loadTranslations(files);
+ * @endcode
+ */
+class API_EXPORT StartupTrace
+{
+    public:
+        /**
+         * @brief Measures a phase from its construction until its destruction (or until next()/end() is called).
+         */
+        class API_EXPORT Scope
+        {
+            public:
+                explicit Scope(const QString& name);
+                ~Scope();
+
+                /**
+                 * @brief Ends current phase and starts a new one.
+                 * @param name Name of the new phase.
+                 */
+                void next(const QString& name);
+
+                /**
+                 * @brief Ends current phase before the scope is destroyed.
+                 */
+                void end();
+
+            private:
+                QString name;
+                qint64 start = -1;
+        };
+
+        /**
+         * @brief Enables tracing.
+         * @param outputFile File to write the trace to, when finish() is called.
+         */
+        static void enable(const QString& outputFile);
+
+        /**
+         * @brief Enables tracing if the SQLITESTUDIO_STARTUP_TRACE environment variable is set.
+         *
+         * It does nothing if tracing was already enabled with enable().
+         */
+        static void enableFromEnv();
+
+        static bool isEnabled();
+
+        /**
+         * @brief Adds a complete phase to the trace.
+         * @param name Name of the phase.
+         * @param start Start time in microseconds, as returned by elapsed().
+         * @param duration Duration in microseconds.
+         */
+        static void record(const QString& name, qint64 start, qint64 duration);
+
+        /**
+         * @brief Adds a point in time event to the trace.
+         * @param name Name of the event.
+         */
+        static void mark(const QString& name);
+
+        /**
+         * @brief Provides time elapsed since the application start.
+         * @return Time in microseconds.
+         */
+        static qint64 elapsed();
+
+        /**
+         * @brief Serializes all recorded events.
+         * @return JSON document in the Chrome Trace Event format.
+         */
+        static QByteArray toChromeTraceJson();
+
+        /**
+         * @brief Writes the trace to the file passed to enable() and disables tracing.
+         * @return true on success, false if tracing was not enabled or the file could not be written.
+         *
+         * Subsequent calls do nothing, so it's safe to call it at every point that may end the startup.
+         */
+        static bool finish();
+
+    private:
+        StartupTrace();
+};
+
+#endif // STARTUPTRACE_H
@@ -86,7 +86,7 @@ CompletionHelper::Results CompletionHelper::getExpectedTokens()
 
     // Parse SQL up to cursor position, get accepted tokens and tokens that were parsed.
     Parser parser;
-    TokenList tokens = parser.getNextTokenCandidates(adjustedSql);
+    TokenList tokens = parser.getNextTokenCandidates(adjustedSql, parserCheckpoints);
     TokenList parsedTokens = parser.getParsedTokens();
 
     // Parse the full sql in regular mode to extract query statement
@@ -1242,6 +1242,11 @@ void CompletionHelper::setCreateTriggerTable(const QString& value)
     createTriggerTable = value;
 }
 
+void CompletionHelper::setParserCheckpoints(ParserCheckpoints* value)
+{
+    parserCheckpoints = value;
+}
+
 void CompletionHelper::initFunctions(Db* db)
 {
     sqlite3Functions << "avg(X)" << "count(X)" << "count(*)" << "group_concat(X)"
@@ -14,6 +14,7 @@
 #include <QSet>
 
 class DbAttacher;
+class ParserCheckpoints;
 
 class API_EXPORT CompletionHelper : public QObject
 {
@@ -48,6 +49,12 @@ class API_EXPORT CompletionHelper : public QObject
         QString getCreateTriggerTable() const;
         void setCreateTriggerTable(const QString& value);
 
+        /**
+         * @brief Sets parser states saved by previous completions in the same editor.
+         * @param value Checkpoints owned by the caller, or null to always parse the SQL from the beginning.
+         */
+        void setParserCheckpoints(ParserCheckpoints* value);
+
     private:
         enum class Context
         {
@@ -190,6 +197,7 @@ class API_EXPORT CompletionHelper : public QObject
         SelectResolver* selectResolver = nullptr;
         DbAttacher* dbAttacher = nullptr;
         QString createTriggerTable;
+        ParserCheckpoints* parserCheckpoints = nullptr;
 
         /**
          * @brief tableToAlias
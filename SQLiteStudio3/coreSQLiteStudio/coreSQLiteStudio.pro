@@ -68,6 +68,8 @@ SOURCES += sqlitestudio.cpp \
     chillout/windows/windowscrashhandler.cpp \
     common/compatibility.cpp \
     db/queryexecutorsteps/queryexecutorcolumntype.cpp \
+    db/queryexecutorsteps/queryexecutorkeysetpaging.cpp \
+    db/queryexecutorsteps/queryexecutorsnapshot.cpp \
     parser/ast/sqlitefilterover.cpp \
     parser/ast/sqlitenulls.cpp \
     parser/ast/sqlitewindowdefinition.cpp \
@@ -82,6 +84,7 @@ SOURCES += sqlitestudio.cpp \
     parser/lexer.cpp \
     parser/sqlite3_parse.cpp \
     parser/parsercontext.cpp \
+    parser/parsercheckpoints.cpp \
     parser/parser.cpp \
     parser/ast/sqlitestatement.cpp \
     parser/ast/sqlitequery.cpp \
@@ -124,6 +127,14 @@ SOURCES += sqlitestudio.cpp \
     parser/ast/sqliteattach.cpp \
     parser/parsererror.cpp \
     selectresolver.cpp \
+    indexadvisor.cpp \
+    dbdiff.cpp \
+    dbbackup.cpp \
+    services/memorymanager.cpp \
+    db/dbperformanceprofile.cpp \
+    dbmaintenance.cpp \
+    multidbquery.cpp \
+    dbworkerconnections.cpp \
     schemaresolver.cpp \
     parser/ast/sqlitequerytype.cpp \
     db/db.cpp \
@@ -133,6 +144,7 @@ SOURCES += sqlitestudio.cpp \
     completionhelper.cpp \
     completioncomparer.cpp \
     db/queryexecutor.cpp \
+    db/executionprofile.cpp \
     qio.cpp \
     plugins/pluginsymbolresolver.cpp \
     db/sqlerrorresults.cpp \
@@ -195,6 +207,8 @@ SOURCES += sqlitestudio.cpp \
     db/invaliddb.cpp \
     diff/diff_match_patch.cpp \
     db/sqlquery.cpp \
+    db/dbblob.cpp \
+    db/collationsortkeycache.cpp \
     db/queryexecutorsteps/queryexecutorvaluesmode.cpp \
     services/importmanager.cpp \
     importworker.cpp \
@@ -234,6 +248,7 @@ SOURCES += sqlitestudio.cpp \
     common/xmldeserializer.cpp \
     services/impl/sqliteextensionmanagerimpl.cpp \
     common/lazytrigger.cpp \
+    common/startuptrace.cpp \
     parser/ast/sqliteupsert.cpp
 
 HEADERS += sqlitestudio.h\
@@ -246,6 +261,8 @@ HEADERS += sqlitestudio.h\
     common/compatibility.h \
         coreSQLiteStudio_global.h \
     db/queryexecutorsteps/queryexecutorcolumntype.h \
+    db/queryexecutorsteps/queryexecutorkeysetpaging.h \
+    db/queryexecutorsteps/queryexecutorsnapshot.h \
     db/sqlite3.h \
     parser/ast/sqlitefilterover.h \
     parser/ast/sqlitenulls.h \
@@ -261,6 +278,7 @@ HEADERS += sqlitestudio.h\
     parser/lexer.h \
     parser/sqlite3_parse.h \
     parser/parsercontext.h \
+    parser/parsercheckpoints.h \
     parser/parser.h \
     parser/ast/sqlitestatement.h \
     parser/ast/sqlitequery.h \
@@ -306,6 +324,14 @@ HEADERS += sqlitestudio.h\
     parser/parsererror.h \
     common/objectpool.h \
     selectresolver.h \
+    indexadvisor.h \
+    dbdiff.h \
+    dbbackup.h \
+    services/memorymanager.h \
+    db/dbperformanceprofile.h \
+    dbmaintenance.h \
+    multidbquery.h \
+    dbworkerconnections.h \
     schemaresolver.h \
     db/db.h \
     services/dbmanager.h \
@@ -317,6 +343,8 @@ HEADERS += sqlitestudio.h\
     plugins/dbplugin.h \
     services/pluginmanager.h \
     db/queryexecutor.h \
+    db/executionprofile.h \
+    db/enginestats.h \
     qio.h \
     db/dbpluginoption.h \
     common/global.h \
@@ -394,6 +422,8 @@ HEADERS += sqlitestudio.h\
     db/invaliddb.h \
     diff/diff_match_patch.h \
     db/sqlquery.h \
+    db/dbblob.h \
+    db/collationsortkeycache.h \
     dbobjecttype.h \
     db/queryexecutorsteps/queryexecutorvaluesmode.h \
     plugins/importplugin.h \
@@ -444,6 +474,7 @@ HEADERS += sqlitestudio.h\
     services/sqliteextensionmanager.h \
     services/impl/sqliteextensionmanagerimpl.h \
     common/lazytrigger.h \
+    common/startuptrace.h \
     parser/ast/sqliteupsert.h
 
 unix: {
@@ -80,6 +80,7 @@ bool AbstractDb::openForProbing()
 {
     QWriteLocker locker(&dbOperLock);
     QWriteLocker connectionLocker(&connectionStateLock);
+    openedForProbing = true;
     bool res = openInternal();
     if (!res)
         return res;
@@ -368,6 +369,7 @@ SqlQueryPtr AbstractDb::execListArg(const QString& query, const QList<QVariant>&
 
 bool AbstractDb::openAndSetup()
 {
+    openedForProbing = false;
     bool result = openInternal();
     if (!result)
         return result;
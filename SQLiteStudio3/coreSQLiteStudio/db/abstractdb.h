@@ -279,6 +279,13 @@ class API_EXPORT AbstractDb : public Db
          */
         quint8 version = 0;
 
+        /**
+         * @brief Tells if the database was open with openForProbing().
+         *
+         * Such connection is used only to check if the file is a valid database, so it should not modify it.
+         */
+        bool openedForProbing = false;
+
         /**
          * @brief Map of databases attached to this database.
          *
@@ -8,9 +8,12 @@
 #include "services/collationmanager.h"
 #include "sqlitestudio.h"
 #include "db/sqlerrorcodes.h"
+#include "db/collationsortkeycache.h"
+#include "db/dbperformanceprofile.h"
 #include "log.h"
 #include <QThread>
 #include <QPointer>
+#include <QFile>
 #include <QDebug>
 
 /**
@@ -47,6 +50,10 @@ class AbstractDb3 : public AbstractDb
         bool loadExtension(const QString& filePath, const QString& initFunc = QString());
         bool isComplete(const QString& sql) const;
         QList<AliasedColumn> columnsForQuery(const QString& query);
+        DbBlobPtr openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite = false);
+        bool backupTo(const QString& filePath, int pagesPerStep = 1000, int pauseMs = 10, BackupProgressHandler progressHandler = nullptr);
+        bool getMemoryStatus(MemoryStatus& status);
+        void releaseMemory();
 
     protected:
         bool isOpenInternal();
@@ -57,6 +64,7 @@ class AbstractDb3 : public AbstractDb
         bool closeInternal();
         bool initAfterCreated();
         void initAfterOpen();
+        bool isPerformanceProfileApplicable();
         SqlQueryPtr prepare(const QString& query);
         QString getTypeLabel();
         bool deregisterFunction(const QString& name, int argCount);
@@ -65,6 +73,18 @@ class AbstractDb3 : public AbstractDb
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
 
+        /**
+         * @brief Provides queries to be executed on every additional connection to a database file.
+         * @return List of queries, in order of execution.
+         *
+         * Additional connection is opened by backupTo() for the backup file. Drivers with encryption
+         * should return queries defining the same key and cipher settings, as for the main connection,
+         * so the backup file is encrypted the same way and pages can be copied as they are.
+         *
+         * Default implementation returns empty list.
+         */
+        virtual QStringList getConnectionInitQueries();
+
     private:
         class Query : public SqlQuery
         {
@@ -87,6 +107,7 @@ class AbstractDb3 : public AbstractDb
                 int columnCount();
                 qint64 rowsAffected();
                 void finalize();
+                EngineStats getEngineStats();
 
             protected:
                 SqlResultsRowPtr nextInternal();
@@ -104,6 +125,7 @@ class AbstractDb3 : public AbstractDb
                 void copyErrorFromDb();
                 void copyErrorToDb();
                 void setError(int code, const QString& msg);
+                void collectEngineStats();
 
                 QPointer<AbstractDb3<T>> db;
                 typename T::stmt* stmt = nullptr;
@@ -114,16 +136,47 @@ class AbstractDb3 : public AbstractDb
                 bool rowAvailable = false;
         };
 
+        class Blob : public DbBlob
+        {
+            public:
+                explicit Blob(AbstractDb3<T>* db);
+                ~Blob();
+
+                bool openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite);
+                qint64 size() const;
+                void close();
+                bool reopen(qint64 rowId);
+
+            protected:
+                qint64 readData(char* data, qint64 maxSize);
+                qint64 writeData(const char* data, qint64 maxSize);
+
+            private:
+                void copyErrorFromDb();
+
+                QPointer<AbstractDb3<T>> db;
+                typename T::blob* handle = nullptr;
+        };
+
         struct CollationUserData
         {
             QString name;
             AbstractDb3<T>* db = nullptr;
+            CollationSortKeyCache* sortKeyCache = nullptr;
         };
 
         QString extractLastError();
         void cleanUp();
         void resetError();
 
+        /**
+         * @brief Executes query on the other connection than the main one.
+         * @param handle Connection handle.
+         * @param query Query to execute. Results are ignored.
+         * @return true on success, or false on failure.
+         */
+        static bool execOnHandle(typename T::handle* handle, const QString& query);
+
         /**
          * @brief Registers function to call when unknown collation was encountered by the SQLite.
          *
@@ -292,6 +345,15 @@ class AbstractDb3 : public AbstractDb
         QString dbErrorMessage;
         int dbErrorCode = T::OK;
         QList<Query*> queries;
+        QList<Blob*> blobs;
+
+        /**
+         * @brief Backups in progress.
+         *
+         * Backups are finished by cleanUp() when the database is closed. The backupTo() checks (with dbOperLock set)
+         * if its backup is still on this list before each step.
+         */
+        QList<typename T::backup*> backups;
 
         /**
          * @brief User data for default collation request handling function.
@@ -300,6 +362,13 @@ class AbstractDb3 : public AbstractDb
          * and delete it when database is closed.
          */
         CollationUserData* defaultCollationUserData = nullptr;
+
+        /**
+         * @brief Incremented each time a query is executed.
+         *
+         * Sort key based collations use it to tell when their cached keys belong to the previous statement.
+         */
+        QAtomicInt statementCounter = 0;
 };
 
 //------------------------------------------------------------------------------------
@@ -379,6 +448,200 @@ QList<AliasedColumn> AbstractDb3<T>::columnsForQuery(const QString& query)
     return result;
 }
 
+template <class T>
+DbBlobPtr AbstractDb3<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite)
+{
+    resetError();
+    if (!dbHandle)
+    {
+        dbErrorMessage = QObject::tr("Could not open BLOB, because the database is not open.");
+        dbErrorCode = T::ERROR;
+        return DbBlobPtr();
+    }
+
+    Blob* blob = new Blob(this);
+    if (!blob->openBlob(database, table, column, rowId, readWrite))
+    {
+        delete blob;
+        return DbBlobPtr();
+    }
+    return DbBlobPtr(blob);
+}
+
+template <class T>
+bool AbstractDb3<T>::backupTo(const QString& filePath, int pagesPerStep, int pauseMs, BackupProgressHandler progressHandler)
+{
+    bool fileExisted = QFile::exists(filePath);
+    typename T::handle* dstHandle = nullptr;
+    typename T::backup* backup = nullptr;
+    {
+        QWriteLocker locker(&dbOperLock);
+        resetError();
+        if (!dbHandle)
+        {
+            dbErrorMessage = QObject::tr("Could not back up the database, because it is not open.");
+            dbErrorCode = T::ERROR;
+            return false;
+        }
+
+        int res = T::open_v2(filePath.toUtf8().constData(), &dstHandle, T::OPEN_READWRITE|T::OPEN_CREATE, nullptr);
+        bool initOk = (res == T::OK);
+        for (const QString& query : getConnectionInitQueries())
+        {
+            if (!initOk)
+                break;
+
+            initOk = execOnHandle(dstHandle, query);
+        }
+
+        if (initOk)
+            backup = T::backup_init(dstHandle, "main", dbHandle, "main");
+
+        if (!backup)
+        {
+            dbErrorMessage = QObject::tr("Could not create backup file %1: %2").arg(filePath, dstHandle ? QString::fromUtf8(T::errmsg(dstHandle)) : QString());
+            dbErrorCode = dstHandle ? T::extended_errcode(dstHandle) : res;
+            T::close(dstHandle); // safe for null handle
+            if (!fileExisted)
+                QFile::remove(filePath);
+
+            return false;
+        }
+        backups << backup;
+    }
+
+    int res = T::OK;
+    int copiedPages = 0;
+    int totalPages = 0;
+    bool dbClosed = false;
+    bool cancelled = false;
+    while (true)
+    {
+        {
+            // Read lock, so the database isn't closed during the step, but other queries can still be executed
+            QReadLocker locker(&dbOperLock);
+            if (!backups.contains(backup))
+            {
+                dbClosed = true;
+                break;
+            }
+
+            res = T::backup_step(backup, pagesPerStep);
+            totalPages = T::backup_pagecount(backup);
+            copiedPages = totalPages - T::backup_remaining(backup);
+        }
+
+        if (res != T::OK && res != T::BUSY && res != T::LOCKED)
+            break;
+
+        if (progressHandler && !progressHandler(copiedPages, totalPages))
+        {
+            cancelled = true;
+            break;
+        }
+
+        // Other connections can write to the database in the meantime
+        QThread::msleep(pauseMs);
+    }
+
+    bool success = false;
+    {
+        QWriteLocker locker(&dbOperLock);
+        if (backups.removeOne(backup))
+        {
+            int finishRes = T::backup_finish(backup);
+            if (res == T::DONE)
+                res = finishRes;
+        }
+
+        success = (res == T::DONE || res == T::OK) && !dbClosed && !cancelled;
+        if (!success)
+        {
+            if (dbClosed)
+                dbErrorMessage = QObject::tr("Backup was interrupted, because the database was closed.");
+            else if (cancelled)
+                dbErrorMessage = QObject::tr("Backup was cancelled.");
+            else
+                dbErrorMessage = QObject::tr("Could not back up the database into file %1: %2").arg(filePath, QString::fromUtf8(T::errmsg(dstHandle)));
+
+            dbErrorCode = (dbClosed || cancelled) ? T::ERROR : res;
+        }
+    }
+
+    T::close(dstHandle);
+    if (!success && !fileExisted)
+        QFile::remove(filePath);
+
+    if (success && progressHandler)
+        progressHandler(totalPages, totalPages);
+
+    return success;
+}
+
+template <class T>
+bool AbstractDb3<T>::getMemoryStatus(MemoryStatus& status)
+{
+    QReadLocker locker(&dbOperLock);
+    if (!dbHandle)
+        return false;
+
+    int current = 0;
+    int highWater = 0;
+    auto readStatus = [&](int op, qint64& value) -> bool
+    {
+        if (T::db_status(dbHandle, op, &current, &highWater, 0) != T::OK)
+            return false;
+
+        value = current;
+        return true;
+    };
+
+    // Hit/miss/write counters are not supported by the oldest SQLite versions, so their failure is not fatal
+    readStatus(T::DBSTATUS_CACHE_HIT, status.cacheHits);
+    readStatus(T::DBSTATUS_CACHE_MISS, status.cacheMisses);
+    readStatus(T::DBSTATUS_CACHE_WRITE, status.cacheWrites);
+
+    return readStatus(T::DBSTATUS_CACHE_USED, status.cacheUsed) &&
+            readStatus(T::DBSTATUS_SCHEMA_USED, status.schemaUsed) &&
+            readStatus(T::DBSTATUS_STMT_USED, status.statementsUsed) &&
+            readStatus(T::DBSTATUS_LOOKASIDE_USED, status.lookasideUsed);
+}
+
+template <class T>
+void AbstractDb3<T>::releaseMemory()
+{
+    QReadLocker locker(&dbOperLock);
+    if (!dbHandle)
+        return;
+
+    T::db_release_memory(dbHandle);
+}
+
+template <class T>
+QStringList AbstractDb3<T>::getConnectionInitQueries()
+{
+    return QStringList();
+}
+
+template <class T>
+bool AbstractDb3<T>::execOnHandle(typename T::handle* handle, const QString& query)
+{
+    typename T::stmt* stmt = nullptr;
+    QByteArray sql = query.toUtf8();
+    int res = T::prepare_v2(handle, sql.constData(), sql.size(), &stmt, nullptr);
+    if (res != T::OK)
+        return false;
+
+    if (!stmt)
+        return true; // empty query
+
+    while ((res = T::step(stmt)) == T::ROW)
+        ; // results are not needed
+
+    T::finalize(stmt);
+    return res == T::DONE;
+}
+
 template <class T>
 bool AbstractDb3<T>::isOpenInternal()
 {
@@ -411,7 +674,8 @@ bool AbstractDb3<T>::openInternal()
 {
     resetError();
     typename T::handle* handle = nullptr;
-    int res = T::open_v2(path.toUtf8().constData(), &handle, T::OPEN_READWRITE|T::OPEN_CREATE, nullptr);
+    int flags = connOptions[DB_READ_ONLY].toBool() ? T::OPEN_READONLY : (T::OPEN_READWRITE|T::OPEN_CREATE);
+    int res = T::open_v2(path.toUtf8().constData(), &handle, flags, nullptr);
     if (res != T::OK)
     {
         if (handle)
@@ -433,6 +697,9 @@ bool AbstractDb3<T>::closeInternal()
     if (!dbHandle)
         return false;
 
+    if (isPerformanceProfileApplicable() && DbPerformanceProfile::isOptimizeOnClose(connOptions))
+        execOnHandle(dbHandle, "PRAGMA optimize;");
+
     cleanUp();
 
     int res = T::close(dbHandle);
@@ -460,6 +727,20 @@ void AbstractDb3<T>::initAfterOpen()
     registerDefaultCollationRequestHandler();;
     exec("PRAGMA foreign_keys = 1;", Flag::NO_LOCK);
     exec("PRAGMA recursive_triggers = 1;", Flag::NO_LOCK);
+    if (!isPerformanceProfileApplicable())
+        return;
+
+    // Persistent settings are left to the main connection
+    bool secondary = connOptions[DB_SECONDARY_CONNECTION].toBool();
+    for (const QString& pragma : DbPerformanceProfile::getPragmas(connOptions, !secondary))
+        exec(pragma, Flag::NO_LOCK);
+}
+
+template <class T>
+bool AbstractDb3<T>::isPerformanceProfileApplicable()
+{
+    // Probing and read-only connections must not modify the database (and most pragmas would fail for read-only ones).
+    return !openedForProbing && !connOptions[DB_READ_ONLY].toBool();
 }
 
 template <class T>
@@ -540,6 +821,11 @@ bool AbstractDb3<T>::registerCollationInternal(const QString& name)
 
     CollationUserData* userData = new CollationUserData;
     userData->name = name;
+    userData->db = this;
+
+    CollationManager::CollationPtr collation = COLLATIONS->getCollation(name);
+    if (collation && collation->type != CollationManager::CollationType::FUNCTION_BASED)
+        userData->sortKeyCache = new CollationSortKeyCache(collation);
 
     int res = T::create_collation_v2(dbHandle, name.toUtf8().constData(), T::UTF8, userData,
                                           &AbstractDb3<T>::evaluateCollation,
@@ -571,6 +857,14 @@ void AbstractDb3<T>::cleanUp()
     for (Query* q : queries)
         q->finalize();
 
+    for (Blob* blob : blobs)
+        blob->close();
+
+    for (typename T::backup* backup : backups)
+        T::backup_finish(backup);
+
+    backups.clear();
+
     safe_delete(defaultCollationUserData);
 }
 
@@ -727,10 +1021,14 @@ void AbstractDb3<T>::evaluateAggregateFinal(typename T::context* context)
 template <class T>
 int AbstractDb3<T>::evaluateCollation(void* userData, int length1, const void* value1, int length2, const void* value2)
 {
-    UNUSED(length1);
-    UNUSED(length2);
     CollationUserData* collUserData = reinterpret_cast<CollationUserData*>(userData);
-    return COLLATIONS->evaluate(collUserData->name, QString::fromUtf8((const char*)value1), QString::fromUtf8((const char*)value2));
+    if (collUserData->sortKeyCache)
+    {
+        collUserData->sortKeyCache->setStatement(collUserData->db->statementCounter.loadAcquire());
+        return collUserData->sortKeyCache->compare(length1, value1, length2, value2);
+    }
+
+    return COLLATIONS->evaluate(collUserData->name, QString::fromUtf8((const char*)value1, length1), QString::fromUtf8((const char*)value2, length2));
 }
 
 template <class T>
@@ -740,6 +1038,7 @@ void AbstractDb3<T>::deleteCollationUserData(void* userData)
         return;
 
     CollationUserData* collUserData = reinterpret_cast<CollationUserData*>(userData);
+    safe_delete(collUserData->sortKeyCache);
     delete collUserData;
 }
 
@@ -935,6 +1234,7 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
 
     ReadWriteLocker locker(&(db->dbOperLock), query, flags.testFlag(Db::Flag::NO_LOCK));
     logSql(db.data(), query, args, flags);
+    db->statementCounter.ref();
 
     int res;
     if (stmt)
@@ -978,6 +1278,7 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
 
     ReadWriteLocker locker(&(db->dbOperLock), query, flags.testFlag(Db::Flag::NO_LOCK));
     logSql(db.data(), query, args, flags);
+    db->statementCounter.ref();
 
     QueryWithParamNames queryWithParams = getQueryWithParamNames(query);
 
@@ -1081,11 +1382,64 @@ void AbstractDb3<T>::Query::finalize()
 {
     if (stmt)
     {
+        collectEngineStats();
         T::finalize(stmt);
         stmt = nullptr;
     }
 }
 
+template <class T>
+EngineStats AbstractDb3<T>::Query::getEngineStats()
+{
+    if (stmt && checkDbState())
+        collectEngineStats();
+
+    return engineStats;
+}
+
+template <class T>
+void AbstractDb3<T>::Query::collectEngineStats()
+{
+    if (!flags.testFlag(Db::Flag::PROFILE))
+        return;
+
+    engineStats.collected = true;
+    engineStats.fullScanSteps = T::stmt_status(stmt, T::STMTSTATUS_FULLSCAN_STEP, 0);
+    engineStats.sorts = T::stmt_status(stmt, T::STMTSTATUS_SORT, 0);
+    engineStats.autoIndexes = T::stmt_status(stmt, T::STMTSTATUS_AUTOINDEX, 0);
+    engineStats.vmSteps = T::stmt_status(stmt, T::STMTSTATUS_VM_STEP, 0);
+    engineStats.reprepares = T::stmt_status(stmt, T::STMTSTATUS_REPREPARE, 0);
+    engineStats.memoryUsed = T::stmt_status(stmt, T::STMTSTATUS_MEMUSED, 0);
+
+    engineStats.scanLoops.clear();
+    if (!T::SCANSTATUS_SUPPORTED)
+        return;
+
+    typename T::int64 loops;
+    typename T::int64 visits;
+    double estimated;
+    const char* name;
+    const char* explain;
+    int selectId;
+    for (int idx = 0; T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NLOOP, &loops) == 0; idx++)
+    {
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NVISIT, &visits);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_EST, &estimated);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NAME, &name);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_EXPLAIN, &explain);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_SELECTID, &selectId);
+
+        EngineStats::ScanLoop loop;
+        loop.loops = loops;
+        loop.visits = visits;
+        loop.estimatedRows = estimated;
+        loop.name = QString::fromUtf8(name);
+        loop.explain = QString::fromUtf8(explain);
+        loop.selectId = selectId;
+        engineStats.scanLoops << loop;
+    }
+}
+
 template <class T>
 QString AbstractDb3<T>::Query::getErrorText()
 {
@@ -1194,6 +1548,7 @@ int AbstractDb3<T>::Query::fetchNext()
             break;
         case T::DONE:
             // Empty pointer as no more results are available.
+            collectEngineStats();
             break;
         default:
             setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
@@ -1255,4 +1610,132 @@ int AbstractDb3<T>::Query::Row::getValue(typename T::stmt* stmt, int col, QVaria
     return T::OK;
 }
 
+//------------------------------------------------------------------------------------
+// Blob
+//------------------------------------------------------------------------------------
+
+template <class T>
+AbstractDb3<T>::Blob::Blob(AbstractDb3<T>* db) :
+    db(db)
+{
+    db->blobs << this;
+}
+
+template <class T>
+AbstractDb3<T>::Blob::~Blob()
+{
+    close();
+    if (!db.isNull())
+        db->blobs.removeOne(this);
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite)
+{
+    int res = T::blob_open(db->dbHandle, database.toUtf8().constData(), table.toUtf8().constData(), column.toUtf8().constData(),
+                           rowId, readWrite ? 1 : 0, &handle);
+    if (res != T::OK)
+    {
+        // SQLite may allocate the handle even on failure. It has to be released anyway.
+        db->extractLastError();
+        if (handle)
+        {
+            T::blob_close(handle);
+            handle = nullptr;
+        }
+        return false;
+    }
+
+    // Unbuffered, so no stale data is served after reopen() or writes to the blob.
+    return QIODevice::open((readWrite ? QIODevice::ReadWrite : QIODevice::ReadOnly)|QIODevice::Unbuffered);
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::size() const
+{
+    if (!handle)
+        return 0;
+
+    return T::blob_bytes(handle);
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::close()
+{
+    if (handle)
+    {
+        T::blob_close(handle);
+        handle = nullptr;
+    }
+
+    if (isOpen())
+        QIODevice::close();
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::reopen(qint64 rowId)
+{
+    if (!handle)
+        return false;
+
+    int res = T::blob_reopen(handle, rowId);
+    if (res != T::OK)
+    {
+        copyErrorFromDb();
+        return false;
+    }
+    return seek(0);
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::readData(char* data, qint64 maxSize)
+{
+    if (!handle)
+        return -1;
+
+    qint64 length = qMin(maxSize, size() - pos());
+    if (length <= 0)
+        return 0;
+
+    int res = T::blob_read(handle, data, static_cast<int>(length), static_cast<int>(pos()));
+    if (res != T::OK)
+    {
+        copyErrorFromDb();
+        return -1;
+    }
+    return length;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::writeData(const char* data, qint64 maxSize)
+{
+    if (!handle)
+        return -1;
+
+    // Blob cannot grow. Writing past the end is an error.
+    qint64 length = qMin(maxSize, size() - pos());
+    if (length <= 0)
+    {
+        setErrorString(QObject::tr("Cannot write beyond the end of BLOB."));
+        return -1;
+    }
+
+    int res = T::blob_write(handle, data, static_cast<int>(length), static_cast<int>(pos()));
+    if (res != T::OK)
+    {
+        copyErrorFromDb();
+        return -1;
+    }
+    return length;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::copyErrorFromDb()
+{
+    if (db.isNull())
+        return;
+
+    setErrorString(db->extractLastError());
+}
+
 #endif // ABSTRACTDB3_H
@@ -0,0 +1,83 @@
+#include "collationsortkeycache.h"
+#include "sqlitestudio.h"
+#include <QLocale>
+#include <cstring>
+
+CollationSortKeyCache::CollationSortKeyCache(const CollationManager::CollationPtr& collation) :
+    collationName(collation->name), type(collation->type)
+{
+    if (type == CollationManager::CollationType::LOCALE_BASED)
+        collator.setLocale(collation->locale.isEmpty() ? QLocale::system() : QLocale(collation->locale));
+}
+
+int CollationSortKeyCache::compare(int length1, const void* value1, int length2, const void* value2)
+{
+    int res;
+    if (type == CollationManager::CollationType::LOCALE_BASED)
+    {
+        // Copying the key is cheap (it's implicitly shared) and the second lookup might clear the cache.
+        QCollatorSortKey key1 = getLocaleKey(length1, value1);
+        res = key1.compare(getLocaleKey(length2, value2));
+    }
+    else
+    {
+        QByteArray key1 = getScriptKey(length1, value1);
+        res = compareBytes(key1, getScriptKey(length2, value2));
+    }
+
+    return (res > 0) - (res < 0);
+}
+
+void CollationSortKeyCache::setStatement(int statementId)
+{
+    if (statementId == currentStatementId)
+        return;
+
+    clear();
+    currentStatementId = statementId;
+}
+
+void CollationSortKeyCache::clear()
+{
+    scriptKeys.clear();
+    localeKeys.clear();
+}
+
+QByteArray CollationSortKeyCache::getScriptKey(int length, const void* value)
+{
+    QByteArray rawValue = QByteArray::fromRawData(reinterpret_cast<const char*>(value), length);
+    QHash<QByteArray,QByteArray>::const_iterator it = scriptKeys.constFind(rawValue);
+    if (it != scriptKeys.constEnd())
+        return it.value();
+
+    if (scriptKeys.size() >= MAX_KEYS)
+        scriptKeys.clear();
+
+    QByteArray key = COLLATIONS->evaluateSortKey(collationName, QString::fromUtf8(rawValue));
+    scriptKeys.insert(QByteArray(rawValue.constData(), length), key);
+    return key;
+}
+
+QCollatorSortKey CollationSortKeyCache::getLocaleKey(int length, const void* value)
+{
+    QByteArray rawValue = QByteArray::fromRawData(reinterpret_cast<const char*>(value), length);
+    QHash<QByteArray,QCollatorSortKey>::const_iterator it = localeKeys.constFind(rawValue);
+    if (it != localeKeys.constEnd())
+        return it.value();
+
+    if (localeKeys.size() >= MAX_KEYS)
+        localeKeys.clear();
+
+    QCollatorSortKey key = collator.sortKey(QString::fromUtf8(rawValue));
+    localeKeys.insert(QByteArray(rawValue.constData(), length), key);
+    return key;
+}
+
+int CollationSortKeyCache::compareBytes(const QByteArray& key1, const QByteArray& key2)
+{
+    int res = std::memcmp(key1.constData(), key2.constData(), static_cast<size_t>(qMin(key1.size(), key2.size())));
+    if (res != 0)
+        return res;
+
+    return key1.size() - key2.size();
+}
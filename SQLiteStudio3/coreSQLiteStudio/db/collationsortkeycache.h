@@ -0,0 +1,63 @@
+#ifndef COLLATIONSORTKEYCACHE_H
+#define COLLATIONSORTKEYCACHE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "services/collationmanager.h"
+#include <QHash>
+#include <QByteArray>
+#include <QCollator>
+
+/**
+ * @brief Implementation of sort key based collations for a single database connection.
+ *
+ * It handles collations of CollationManager::CollationType::SORT_KEY_BASED and CollationManager::CollationType::LOCALE_BASED
+ * types. The sort key is evaluated only once for each distinct value (by the collation script or by the QCollator)
+ * and kept in the cache, so comparing two values is just a native comparison of their keys.
+ * This way ORDER BY over n rows requires n evaluations of the collation code at most, instead of n*log(n).
+ *
+ * The cache is bound to the currently executed statement (see setStatement()) and it's limited to MAX_KEYS entries.
+ * It's not thread-safe, but SQLite never calls the collation for the same connection from two threads at once.
+ */
+class API_EXPORT CollationSortKeyCache
+{
+    public:
+        explicit CollationSortKeyCache(const CollationManager::CollationPtr& collation);
+
+        /**
+         * @brief Compares two UTF-8 values, as the SQLite collation callback does.
+         * @return -1, 0 or 1, as SQLite's collation specification demands it.
+         */
+        int compare(int length1, const void* value1, int length2, const void* value2);
+
+        /**
+         * @brief Informs the cache about the statement being executed in the database.
+         * @param statementId Identifier of the statement.
+         *
+         * If the statement is different than the one that keys were cached for, the cache is cleared.
+         */
+        void setStatement(int statementId);
+
+        void clear();
+
+        /**
+         * @brief Maximum number of keys kept in the cache.
+         *
+         * When it's exceeded, the cache is cleared and starts over.
+         */
+        static const int MAX_KEYS = 100000;
+
+    private:
+        QByteArray getScriptKey(int length, const void* value);
+        QCollatorSortKey getLocaleKey(int length, const void* value);
+
+        static int compareBytes(const QByteArray& key1, const QByteArray& key2);
+
+        QString collationName;
+        CollationManager::CollationType type;
+        QCollator collator;
+        QHash<QByteArray,QByteArray> scriptKeys;
+        QHash<QByteArray,QCollatorSortKey> localeKeys;
+        int currentStatementId = -1;
+};
+
+#endif // COLLATIONSORTKEYCACHE_H
@@ -8,6 +8,7 @@
 #include "interruptable.h"
 #include "dbobjecttype.h"
 #include "common/column.h"
+#include "db/dbblob.h"
 #include <QObject>
 #include <QList>
 #include <QHash>
@@ -43,6 +44,23 @@ static_char* DB_PURE_INIT = "sqlitestudio_pure_db_initalization";
  */
 static_char* DB_PLUGIN = "plugin";
 
+/**
+ * @brief Option to open the database in read-only mode.
+ *
+ * This connection option (with boolean value = true) is meant for additional connections used internally
+ * for reading only, so they don't take any write locks on the database. It's supported by SQLite based drivers.
+ */
+static_char* DB_READ_ONLY = "sqlitestudio_read_only";
+
+/**
+ * @brief Option marking additional connection to a database that has its main connection in the application.
+ *
+ * This connection option (with boolean value = true) is meant for connections opened internally by worker threads.
+ * Such connections don't apply persistent settings of the DbPerformanceProfile (the journal_mode),
+ * so they don't modify the database file.
+ */
+static_char* DB_SECONDARY_CONNECTION = "sqlitestudio_secondary_connection";
+
 /**
  * @brief Database managed by application.
  *
@@ -151,6 +169,7 @@ class API_EXPORT Db : public QObject, public Interruptable
                                         *   Benefit is that it speeds up execution. */
             SKIP_PARAM_COUNTING = 0x8, /**< During execution with arguments as list the number of bind parameters will not be verified.
                                         *   This speeds up execution at cost of possible error if bind params in query don't match number of args. */
+            PROFILE             = 0x10, /**< Engine counters are collected for the statement and provided with SqlQuery::getEngineStats(). */
         };
         Q_DECLARE_FLAGS(Flags, Flag)
 
@@ -162,6 +181,31 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         typedef std::function<void(SqlQueryPtr)> QueryResultsHandler;
 
+        /**
+         * @brief Function to report progress of the backup.
+         *
+         * The function receives number of pages copied so far and the total number of pages in the database.
+         * It should return true to continue the backup, or false to cancel it.
+         */
+        typedef std::function<bool(int copiedPages, int totalPages)> BackupProgressHandler;
+
+        /**
+         * @brief Memory used by the database connection.
+         *
+         * Values are taken from sqlite3_db_status(). Memory is in bytes, other values are counters
+         * accumulated since the database was open.
+         */
+        struct API_EXPORT MemoryStatus
+        {
+            qint64 cacheUsed = 0;       /**< Page cache. */
+            qint64 schemaUsed = 0;      /**< Parsed schemas of the main and attached databases. */
+            qint64 statementsUsed = 0;  /**< Prepared statements. */
+            qint64 lookasideUsed = 0;   /**< Lookaside memory slots in use. */
+            qint64 cacheHits = 0;       /**< Pages found in the page cache. */
+            qint64 cacheMisses = 0;     /**< Pages read from the file. */
+            qint64 cacheWrites = 0;     /**< Pages written to the file. */
+        };
+
         /**
          * @brief Default, empty constructor.
          */
@@ -707,6 +751,56 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual bool loadExtension(const QString& filePath, const QString& initFunc = QString()) = 0;
 
+        /**
+         * @brief Opens BLOB value for incremental reading and writing.
+         * @param database Database name ("main", "temp", or name of attached database).
+         * @param table Table name.
+         * @param column Column name.
+         * @param rowId ROWID of the row. Tables WITHOUT ROWID are not supported.
+         * @param readWrite true to open the blob for reading and writing, or false to open it for reading only.
+         * @return Opened blob, or null pointer if it could not be opened.
+         *
+         * Use it for large values, which should not be loaded entirely into the memory.
+         * See DbBlob for details.
+         *
+         * If function returns null pointer, use getErrorText() to discover details.
+         */
+        virtual DbBlobPtr openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite = false) = 0;
+
+        /**
+         * @brief Copies the database into another file using SQLite online backup API.
+         * @param filePath Path of the backup file. Existing file is overwritten.
+         * @param pagesPerStep Number of pages copied at once. Negative value copies all pages in one step.
+         * @param pauseMs Time (in milliseconds) to wait between steps.
+         * @param progressHandler Optional function called after each step.
+         * @return true on success, or false on failure or if the backup was cancelled.
+         *
+         * The database is locked only for a single step, so it can be read and modified by other connections
+         * and by this connection between steps. Changes made by this connection are applied to the backup,
+         * while changes made by other connections restart the backup. The backup file has the same page size
+         * and encryption as the database, so this method is as fast as copying the file.
+         *
+         * This method blocks until the backup is done, so it's best to call it from a separate thread.
+         *
+         * If function returns false, use getErrorText() to discover details.
+         */
+        virtual bool backupTo(const QString& filePath, int pagesPerStep = 1000, int pauseMs = 10, BackupProgressHandler progressHandler = nullptr) = 0;
+
+        /**
+         * @brief Provides memory used by the connection.
+         * @param status Structure to be filled.
+         * @return true on success, or false if the database is not open, or the driver doesn't report memory usage.
+         */
+        virtual bool getMemoryStatus(MemoryStatus& status) = 0;
+
+        /**
+         * @brief Frees as much memory as possible from the connection.
+         *
+         * Unused pages of the page cache are released. It's safe to call it at any time,
+         * the connection will simply read pages again from the file when they are needed.
+         */
+        virtual void releaseMemory() = 0;
+
     signals:
         /**
          * @brief Emitted when the connection to the database was established.
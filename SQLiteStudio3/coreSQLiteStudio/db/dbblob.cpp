@@ -0,0 +1,47 @@
+#include "dbblob.h"
+
+DbBlob::DbBlob(QObject* parent) :
+    QIODevice(parent)
+{
+}
+
+bool DbBlob::isSequential() const
+{
+    return false;
+}
+
+bool DbBlob::copyTo(QIODevice* target)
+{
+    if (!seek(0))
+        return false;
+
+    QByteArray chunk;
+    while (!atEnd())
+    {
+        chunk = read(CHUNK_SIZE);
+        if (chunk.isEmpty())
+            return false;
+
+        if (target->write(chunk) != chunk.size())
+            return false;
+    }
+    return true;
+}
+
+bool DbBlob::copyFrom(QIODevice* source)
+{
+    if (!seek(0))
+        return false;
+
+    QByteArray chunk;
+    while (!source->atEnd())
+    {
+        chunk = source->read(CHUNK_SIZE);
+        if (chunk.isEmpty())
+            return false;
+
+        if (write(chunk) != chunk.size())
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef DBBLOB_H
+#define DBBLOB_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QIODevice>
+#include <QSharedPointer>
+
+/**
+ * @brief Incremental access to a single BLOB value stored in the database.
+ *
+ * It's a random access QIODevice working directly on the value in the database (using SQLite's incremental BLOB I/O),
+ * so large values can be read or written in chunks, without loading them entirely into the memory.
+ * It's created by Db::openBlob() and it's already open when returned from there.
+ *
+ * The size of the BLOB cannot be changed by writing to it. To store a value of different size,
+ * update the cell with <tt>zeroblob(N)</tt> first, then open the blob and write the data.
+ *
+ * The blob expires when the row is modified or deleted by any other statement. All reads and writes
+ * fail after that. Database cannot be closed while there are blobs open on it, therefore all blobs
+ * are closed automatically before the database gets closed.
+ *
+ * Typical usage:
+ * @code
+ * DbBlobPtr blob = db->openBlob("main", "images", "data", rowId);
+ * if (!blob)
+ *     return db->getErrorText();
+ *
+ * QFile file("/tmp/image.png");
+ * file.open(QIODevice::WriteOnly);
+ * blob->copyTo(&file);
+ * @endcode
+ */
+class API_EXPORT DbBlob : public QIODevice
+{
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Number of bytes transferred at once by copyTo() and copyFrom().
+         */
+        static const qint64 CHUNK_SIZE = 1024 * 1024;
+
+        explicit DbBlob(QObject* parent = nullptr);
+
+        bool isSequential() const;
+
+        /**
+         * @brief Points the blob to the same column in other row.
+         * @param rowId ROWID of the other row.
+         * @return true on success, or false if the row does not exist, or it does not contain a BLOB or TEXT in that column.
+         *
+         * This is much faster than opening new blob for each row. The read/write position is reset to 0.
+         */
+        virtual bool reopen(qint64 rowId) = 0;
+
+        /**
+         * @brief Copies entire value to the other device in chunks.
+         * @param target Device to write to. It has to be open for writing.
+         * @return true on success, or false on failure. See errorString() of both devices for details.
+         */
+        bool copyTo(QIODevice* target);
+
+        /**
+         * @brief Overwrites the value with data read from the other device in chunks.
+         * @param source Device to read from. It has to be open for reading.
+         * @return true on success, or false on failure. See errorString() of both devices for details.
+         *
+         * Writing starts at the beginning of the blob. If source device provides more data
+         * than the blob can hold, the method fails, leaving the blob filled with the leading part of the data.
+         */
+        bool copyFrom(QIODevice* source);
+};
+
+typedef QSharedPointer<DbBlob> DbBlobPtr;
+
+#endif // DBBLOB_H
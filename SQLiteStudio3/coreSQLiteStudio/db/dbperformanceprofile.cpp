@@ -0,0 +1,256 @@
+#include "dbperformanceprofile.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include <QObject>
+#include <QDebug>
+
+static const QStringList tempStoreValues = {"DEFAULT", "FILE", "MEMORY"};
+static const QStringList journalModeValues = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+static const QStringList synchronousValues = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+QList<DbPluginOption> DbPerformanceProfile::getOptionsList()
+{
+    QList<DbPluginOption> opts;
+
+    DbPluginOption opt;
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = MMAP_SIZE_OPT;
+    opt.label = QObject::tr("Memory-mapped I/O size", "performance profile");
+    opt.toolTip = QObject::tr("Maximum number of bytes of the database file to be accessed with memory-mapped I/O (PRAGMA mmap_size).\n"
+                              "Accepts K, M, G and T suffixes. Leave empty to use SQLite default.", "performance profile");
+    opt.choiceValues = {"", "0", "256M", "1G", "4G", "16G", "64G", "256G"};
+    opt.choiceReadOnly = false;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = CACHE_SIZE_OPT;
+    opt.label = QObject::tr("Page cache size", "performance profile");
+    opt.toolTip = QObject::tr("Size of the page cache (PRAGMA cache_size). Accepts K, M, G and T suffixes,\n"
+                              "while a plain number is a number of pages. Leave empty to use SQLite default.", "performance profile");
+    opt.choiceValues = {"", "2M", "16M", "64M", "256M", "1G"};
+    opt.choiceReadOnly = false;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = TEMP_STORE_OPT;
+    opt.label = QObject::tr("Temporary storage", "performance profile");
+    opt.toolTip = QObject::tr("Where temporary tables and indexes are kept (PRAGMA temp_store). Leave empty to use SQLite default.", "performance profile");
+    opt.choiceValues = QStringList({""}) + tempStoreValues;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = JOURNAL_MODE_OPT;
+    opt.label = QObject::tr("Journal mode", "performance profile");
+    opt.toolTip = QObject::tr("Journal mode of the database (PRAGMA journal_mode). Leave empty to keep the current mode of the database.", "performance profile");
+    opt.choiceValues = QStringList({""}) + journalModeValues;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = SYNCHRONOUS_OPT;
+    opt.label = QObject::tr("Synchronous writes", "performance profile");
+    opt.toolTip = QObject::tr("How carefully SQLite waits for data to be written to the disk (PRAGMA synchronous).\n"
+                              "Lower levels are faster, but risk database corruption on power loss. Leave empty to use SQLite default.", "performance profile");
+    opt.choiceValues = QStringList({""}) + synchronousValues;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::CHOICE;
+    opt.key = THREADS_OPT;
+    opt.label = QObject::tr("Auxiliary threads", "performance profile");
+    opt.toolTip = QObject::tr("Maximum number of auxiliary threads that a single query may use, i.e. for sorting (PRAGMA threads).\n"
+                              "Leave empty to use SQLite default.", "performance profile");
+    opt.choiceValues = {"", "0", "1", "2", "4", "8"};
+    opt.choiceReadOnly = false;
+    opt.defaultValue = QString();
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::BOOL;
+    opt.key = OPTIMIZE_ON_CLOSE_OPT;
+    opt.label = QObject::tr("Optimize on close", "performance profile");
+    opt.toolTip = QObject::tr("Executes PRAGMA optimize before the database is closed, so the query planner statistics are kept up to date.", "performance profile");
+    opt.defaultValue = false;
+    opts << opt;
+
+    opt = DbPluginOption();
+    opt.type = DbPluginOption::BOOL;
+    opt.key = BULK_MODE_OPT;
+    opt.label = QObject::tr("Faster bulk operations", "performance profile");
+    opt.toolTip = QObject::tr("Temporarily disables synchronous writes and enlarges the page cache while importing data or populating tables.\n"
+                              "Settings are restored when the operation is finished.", "performance profile");
+    opt.defaultValue = false;
+    opts << opt;
+
+    return opts;
+}
+
+QStringList DbPerformanceProfile::getPragmas(const QHash<QString, QVariant>& options, bool includePersistent)
+{
+    static_qstring(pragmaTpl, "PRAGMA %1 = %2;");
+
+    QStringList pragmas;
+    bool ok;
+    bool hasSuffix;
+    QString value = options[MMAP_SIZE_OPT].toString().trimmed();
+    if (!value.isEmpty())
+    {
+        qint64 size = parseSize(value, ok);
+        if (ok && size >= 0)
+            pragmas << pragmaTpl.arg("mmap_size", QString::number(size));
+        else
+            qWarning() << "Invalid mmap_size in database options:" << value;
+    }
+
+    value = options[CACHE_SIZE_OPT].toString().trimmed();
+    if (!value.isEmpty())
+    {
+        qint64 size = parseSize(value, ok, &hasSuffix);
+        if (ok && hasSuffix)
+            pragmas << pragmaTpl.arg("cache_size", QString::number(-(size / 1024)));
+        else if (ok)
+            pragmas << pragmaTpl.arg("cache_size", QString::number(size));
+        else
+            qWarning() << "Invalid cache_size in database options:" << value;
+    }
+
+    value = getChoice(options, TEMP_STORE_OPT, tempStoreValues);
+    if (!value.isEmpty())
+        pragmas << pragmaTpl.arg("temp_store", value);
+
+    value = getChoice(options, JOURNAL_MODE_OPT, journalModeValues);
+    if (!value.isEmpty() && includePersistent)
+        pragmas << pragmaTpl.arg("journal_mode", value);
+
+    value = getChoice(options, SYNCHRONOUS_OPT, synchronousValues);
+    if (!value.isEmpty())
+        pragmas << pragmaTpl.arg("synchronous", value);
+
+    value = options[THREADS_OPT].toString().trimmed();
+    if (!value.isEmpty())
+    {
+        int threads = value.toInt(&ok);
+        if (ok && threads >= 0)
+            pragmas << pragmaTpl.arg("threads", QString::number(threads));
+        else
+            qWarning() << "Invalid threads in database options:" << value;
+    }
+
+    return pragmas;
+}
+
+bool DbPerformanceProfile::isOptimizeOnClose(const QHash<QString, QVariant>& options)
+{
+    return options[OPTIMIZE_ON_CLOSE_OPT].toBool();
+}
+
+QList<QPair<QString, QString>> DbPerformanceProfile::describe(const QHash<QString, QVariant>& options)
+{
+    QList<QPair<QString, QString>> result;
+    for (const DbPluginOption& opt : getOptionsList())
+    {
+        QVariant value = options[opt.key];
+        if (opt.type == DbPluginOption::BOOL)
+        {
+            if (value.toBool())
+                result << QPair<QString, QString>(opt.label, QObject::tr("enabled", "performance profile"));
+
+            continue;
+        }
+
+        QString strValue = value.toString().trimmed();
+        if (!strValue.isEmpty())
+            result << QPair<QString, QString>(opt.label, strValue.toUpper());
+    }
+    return result;
+}
+
+qint64 DbPerformanceProfile::parseSize(const QString& value, bool& ok, bool* hasSuffix)
+{
+    QString number = value.trimmed().toUpper();
+    static_qstring(suffixes, "KMGT");
+
+    qint64 multiplier = 1;
+    int suffixIdx = number.isEmpty() ? -1 : suffixes.indexOf(number.at(number.length() - 1));
+    if (suffixIdx > -1)
+    {
+        for (int i = 0; i <= suffixIdx; i++)
+            multiplier *= 1024;
+
+        number.chop(1);
+    }
+
+    if (hasSuffix)
+        *hasSuffix = (multiplier > 1);
+
+    qint64 size = number.trimmed().toLongLong(&ok);
+    return size * multiplier;
+}
+
+QString DbPerformanceProfile::getChoice(const QHash<QString, QVariant>& options, const char* key, const QStringList& allowedValues)
+{
+    QString value = options[key].toString().trimmed().toUpper();
+    if (value.isEmpty())
+        return QString();
+
+    if (!allowedValues.contains(value))
+    {
+        qWarning() << "Invalid value of" << key << "in database options:" << value;
+        return QString();
+    }
+    return value;
+}
+
+DbPerformanceProfile::BulkModeGuard::BulkModeGuard(Db* db) :
+    db(db)
+{
+    if (!db || !db->isOpen() || !db->getConnectionOptions()[BULK_MODE_OPT].toBool())
+        return;
+
+    SqlQueryPtr results = db->exec("PRAGMA synchronous;");
+    if (results->isError())
+        return;
+
+    synchronous = results->getSingleCell().toInt();
+
+    results = db->exec("PRAGMA cache_size;");
+    if (results->isError())
+        return;
+
+    cacheSize = results->getSingleCell().toInt();
+
+    // Positive cache_size is a number of pages, negative one is a number of KiB
+    qint64 cacheSizeKb = -cacheSize;
+    if (cacheSize > 0)
+        cacheSizeKb = qint64(cacheSize) * db->exec("PRAGMA page_size;")->getSingleCell().toLongLong() / 1024;
+
+    if (db->exec("PRAGMA synchronous = OFF;")->isError())
+        return;
+
+    active = true;
+    if (cacheSizeKb < BULK_CACHE_SIZE_KB)
+        cacheSizeChanged = !db->exec(QString("PRAGMA cache_size = %1;").arg(-BULK_CACHE_SIZE_KB))->isError();
+}
+
+DbPerformanceProfile::BulkModeGuard::~BulkModeGuard()
+{
+    if (!active || !db->isOpen())
+        return;
+
+    db->exec(QString("PRAGMA synchronous = %1;").arg(synchronous));
+    if (cacheSizeChanged)
+        db->exec(QString("PRAGMA cache_size = %1;").arg(cacheSize));
+}
+
+bool DbPerformanceProfile::BulkModeGuard::isActive() const
+{
+    return active;
+}
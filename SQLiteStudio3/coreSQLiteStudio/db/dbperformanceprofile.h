@@ -0,0 +1,113 @@
+#ifndef DBPERFORMANCEPROFILE_H
+#define DBPERFORMANCEPROFILE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/dbpluginoption.h"
+#include "common/global.h"
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+class Db;
+
+/**
+ * @brief Performance related connection options of SQLite based databases.
+ *
+ * Database plugins based on AbstractDb3 append options provided by getOptionsList() to their own
+ * connection options, so the user can tune each database in the DbDialog. AbstractDb3 applies them
+ * with PRAGMA statements (see getPragmas()) each time the database is open, except for connections
+ * open for probing and read-only connections (see DB_READ_ONLY). Secondary connections (see DB_SECONDARY_CONNECTION)
+ * don't apply the journal_mode, as it's persistent in the database file.
+ *
+ * All options are empty by default, which means that the SQLite default (or the value stored in the database file,
+ * like for the journal_mode) is left untouched.
+ *
+ * Size values (mmap_size, cache_size) accept K, M, G and T suffixes (i.e. 256M). A cache_size without
+ * the suffix is a number of pages, just like for the PRAGMA.
+ */
+class API_EXPORT DbPerformanceProfile
+{
+    public:
+        /**
+         * @brief Switches the database into the bulk mode for the lifetime of the object.
+         *
+         * It is used by long running bulk operations (import, populating) for databases
+         * that have the BULK_MODE_OPT enabled. The bulk mode disables synchronous writes and enlarges the page cache.
+         * Previous settings are restored when the object is destroyed, so the object should be created before
+         * the transaction of the bulk operation is started and destroyed after it's finished.
+         *
+         * The temp_store and journal_mode are not changed, because changing temp_store drops all temporary tables
+         * and the journal_mode cannot be changed while the transaction is in progress.
+         */
+        class API_EXPORT BulkModeGuard
+        {
+            public:
+                explicit BulkModeGuard(Db* db);
+                ~BulkModeGuard();
+
+                bool isActive() const;
+
+            private:
+                Db* db = nullptr;
+                bool active = false;
+                bool cacheSizeChanged = false;
+                int synchronous = 0;
+                int cacheSize = 0;
+        };
+
+        static_char* MMAP_SIZE_OPT = "mmapSize";
+        static_char* CACHE_SIZE_OPT = "cacheSize";
+        static_char* TEMP_STORE_OPT = "tempStore";
+        static_char* JOURNAL_MODE_OPT = "journalMode";
+        static_char* SYNCHRONOUS_OPT = "synchronous";
+        static_char* THREADS_OPT = "threads";
+        static_char* OPTIMIZE_ON_CLOSE_OPT = "optimizeOnClose";
+        static_char* BULK_MODE_OPT = "bulkMode";
+
+        /**
+         * @brief Provides connection options of the performance profile.
+         * @return Options to be appended to the options of the database plugin.
+         */
+        static QList<DbPluginOption> getOptionsList();
+
+        /**
+         * @brief Translates connection options into PRAGMA statements.
+         * @param options Connection options of the database.
+         * @param includePersistent If false, settings stored in the database file (journal_mode) are skipped.
+         * @return Statements to be executed right after the database is open. Invalid and empty values are skipped.
+         */
+        static QStringList getPragmas(const QHash<QString, QVariant>& options, bool includePersistent = true);
+
+        /**
+         * @brief Tells whether PRAGMA optimize should be executed before the database is closed.
+         * @param options Connection options of the database.
+         * @return true if it's enabled.
+         */
+        static bool isOptimizeOnClose(const QHash<QString, QVariant>& options);
+
+        /**
+         * @brief Describes options of the profile that differ from SQLite defaults.
+         * @param options Connection options of the database.
+         * @return Pairs of localized option label and its value.
+         */
+        static QList<QPair<QString, QString>> describe(const QHash<QString, QVariant>& options);
+
+        /**
+         * @brief Parses size with optional K, M, G or T suffix.
+         * @param value Value to parse.
+         * @param ok Set to true if the value was valid and to false otherwise.
+         * @param hasSuffix Set to true if the value had the suffix.
+         * @return Size in bytes (or unchanged number if there was no suffix).
+         */
+        static qint64 parseSize(const QString& value, bool& ok, bool* hasSuffix = nullptr);
+
+    private:
+        static QString getChoice(const QHash<QString, QVariant>& options, const char* key, const QStringList& allowedValues);
+
+        static const int BULK_CACHE_SIZE_KB = 262144;
+};
+
+#endif // DBPERFORMANCEPROFILE_H
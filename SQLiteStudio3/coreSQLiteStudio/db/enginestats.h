@@ -0,0 +1,41 @@
+#ifndef ENGINESTATS_H
+#define ENGINESTATS_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Counters collected by SQLite engine for a single statement.
+ *
+ * They are collected only for statements executed with Db::Flag::PROFILE (see SqlQuery::getEngineStats()).
+ * Counters come from sqlite3_stmt_status(). Scan loops come from sqlite3_stmt_scanstatus(),
+ * which is available only if the SQLite library was compiled with SQLITE_ENABLE_STMT_SCANSTATUS
+ * (and SQLiteStudio with the same define), otherwise the list of scan loops is empty.
+ */
+struct API_EXPORT EngineStats
+{
+    /**
+     * @brief Statistics of a single loop in the query plan.
+     */
+    struct ScanLoop
+    {
+        QString name;               /**< Name of the table or index used by the loop. */
+        QString explain;            /**< Description of the loop, as in EXPLAIN QUERY PLAN. */
+        int selectId = 0;           /**< Identifier of the SELECT that the loop belongs to. */
+        qint64 loops = 0;           /**< Number of times the loop was run. */
+        qint64 visits = 0;          /**< Number of rows visited by the loop. */
+        double estimatedRows = 0;   /**< Number of rows estimated by the query planner for each loop run. */
+    };
+
+    bool collected = false;         /**< Tells if statistics were collected at all. */
+    qint64 fullScanSteps = 0;       /**< Number of forward steps in full table scans. */
+    qint64 sorts = 0;               /**< Number of sort operations. */
+    qint64 autoIndexes = 0;         /**< Number of rows inserted into automatic (transient) indexes. */
+    qint64 vmSteps = 0;             /**< Number of virtual machine operations executed. */
+    qint64 reprepares = 0;          /**< Number of times the statement was re-prepared due to schema changes. */
+    qint64 memoryUsed = 0;          /**< Bytes of heap memory used by the statement. */
+    QList<ScanLoop> scanLoops;
+};
+
+#endif // ENGINESTATS_H
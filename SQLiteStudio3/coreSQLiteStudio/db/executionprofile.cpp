@@ -0,0 +1,283 @@
+#include "executionprofile.h"
+#include <QObject>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+
+void ExecutionProfile::clear()
+{
+    *this = ExecutionProfile();
+}
+
+void ExecutionProfile::addStep(const QString& name, qint64 time, int sqlBytes)
+{
+    Step step;
+    step.name = name;
+    step.time = time;
+    step.sqlBytes = sqlBytes;
+    steps << step;
+}
+
+bool ExecutionProfile::isEmpty() const
+{
+    return steps.isEmpty();
+}
+
+void ExecutionProfile::annotatePlan()
+{
+    qint64 totalVisits = 0;
+    for (const EngineStats::ScanLoop& loop : engineStats.scanLoops)
+        totalVisits += loop.visits;
+
+    QList<EngineStats::ScanLoop> unmatchedLoops = engineStats.scanLoops;
+    for (PlanNode& node : plan)
+    {
+        for (int i = 0; i < unmatchedLoops.size(); i++)
+        {
+            if (unmatchedLoops[i].explain != node.detail)
+                continue;
+
+            EngineStats::ScanLoop loop = unmatchedLoops.takeAt(i);
+            node.scanStats = true;
+            node.loops = loop.loops;
+            node.visits = loop.visits;
+            node.estimatedRows = loop.estimatedRows;
+            break;
+        }
+
+        QStringList reasons;
+        if (node.detail.startsWith("SCAN ") && !node.detail.contains("INDEX"))
+            reasons << QObject::tr("full table scan", "execution profile");
+
+        if (node.detail.contains("AUTOMATIC"))
+            reasons << QObject::tr("automatic index is built for this query", "execution profile");
+
+        if (node.detail.contains("USE TEMP B-TREE"))
+            reasons << QObject::tr("temporary b-tree is built for this query", "execution profile");
+
+        if (node.scanStats && totalVisits > 0 && node.visits * 2 >= totalVisits && engineStats.scanLoops.size() > 1)
+            reasons << QObject::tr("%1% of all visited rows", "execution profile").arg(node.visits * 100 / totalVisits);
+
+        node.hotSpot = !reasons.isEmpty();
+        node.hotSpotReason = reasons.join(", ");
+    }
+}
+
+int ExecutionProfile::getPlanDepth(const PlanNode& node) const
+{
+    QHash<int,int> parents;
+    for (const PlanNode& planNode : plan)
+        parents[planNode.id] = planNode.parent;
+
+    int depth = 0;
+    int parent = node.parent;
+    while (parent != 0 && parents.contains(parent) && depth < plan.size())
+    {
+        parent = parents[parent];
+        depth++;
+    }
+    return depth;
+}
+
+qint64 ExecutionProfile::getStepsTime() const
+{
+    qint64 total = 0;
+    for (const Step& step : steps)
+        total += step.time;
+
+    return total;
+}
+
+qint64 ExecutionProfile::getTotalTime() const
+{
+    return getStepsTime() + fetchTime;
+}
+
+QString ExecutionProfile::toString() const
+{
+    if (isEmpty())
+        return QString();
+
+    int nameWidth = 0;
+    for (const Step& step : steps)
+        nameWidth = qMax(nameWidth, step.name.length());
+
+    QStringList lines;
+    if (simpleMode)
+        lines << QObject::tr("Executed with simple method in %1.", "execution profile").arg(formatTime(getTotalTime()));
+    else
+        lines << QObject::tr("Executed with smart method in %1.", "execution profile").arg(formatTime(getTotalTime()));
+
+    for (const Step& step : steps)
+    {
+        lines << QString("  %1 %2 %3").arg(step.name, -nameWidth)
+                                      .arg(formatTime(step.time), 12)
+                                      .arg(QObject::tr("%1 B", "execution profile").arg(step.sqlBytes), 10);
+    }
+
+    lines << QObject::tr("Parsed: %1 time(s), statements executed: %2", "execution profile").arg(parseCount).arg(queryCount);
+    lines << QObject::tr("Prepare: %1, first row: %2", "execution profile").arg(formatTime(prepareTime), formatTime(firstRowTime));
+    lines << QObject::tr("Fetch: %1, rows fetched: %2, rows affected: %3", "execution profile").arg(formatTime(fetchTime))
+             .arg(rowsFetched).arg(rowsAffected);
+
+    if (engineStats.collected)
+    {
+        lines << QObject::tr("Engine: VM steps: %1, full scan steps: %2, sorts: %3, automatic index rows: %4", "execution profile")
+                 .arg(engineStats.vmSteps).arg(engineStats.fullScanSteps).arg(engineStats.sorts).arg(engineStats.autoIndexes);
+        lines << QObject::tr("Engine: reprepared: %1 time(s), memory used: %2 B", "execution profile")
+                 .arg(engineStats.reprepares).arg(engineStats.memoryUsed);
+    }
+
+    if (!plan.isEmpty())
+    {
+        lines << QObject::tr("Query plan:", "execution profile");
+        for (const PlanNode& node : plan)
+        {
+            QString line = QString("  %1%2 %3").arg(node.hotSpot ? "!" : " ")
+                                               .arg(QString("  ").repeated(getPlanDepth(node)), node.detail);
+            if (node.scanStats)
+            {
+                line += " " + QObject::tr("[loops: %1, rows visited: %2, rows estimated: %3]", "execution profile")
+                              .arg(node.loops).arg(node.visits).arg(node.estimatedRows, 0, 'f', 1);
+            }
+
+            if (node.hotSpot)
+                line += " <- " + node.hotSpotReason;
+
+            lines << line;
+        }
+    }
+
+    return lines.join("\n");
+}
+
+QString ExecutionProfile::toJson() const
+{
+    QJsonArray stepsArray;
+    for (const Step& step : steps)
+    {
+        QJsonObject stepObj;
+        stepObj["name"] = step.name;
+        stepObj["time"] = step.time;
+        stepObj["sqlBytes"] = step.sqlBytes;
+        stepsArray.append(stepObj);
+    }
+
+    QJsonObject obj;
+    obj["steps"] = stepsArray;
+    obj["simpleMode"] = simpleMode;
+    obj["parseCount"] = parseCount;
+    obj["queryCount"] = queryCount;
+    obj["prepareTime"] = prepareTime;
+    obj["firstRowTime"] = firstRowTime;
+    obj["fetchTime"] = fetchTime;
+    obj["rowsFetched"] = rowsFetched;
+    obj["rowsAffected"] = rowsAffected;
+
+    if (engineStats.collected)
+    {
+        QJsonArray loopsArray;
+        for (const EngineStats::ScanLoop& loop : engineStats.scanLoops)
+        {
+            QJsonObject loopObj;
+            loopObj["name"] = loop.name;
+            loopObj["explain"] = loop.explain;
+            loopObj["selectId"] = loop.selectId;
+            loopObj["loops"] = loop.loops;
+            loopObj["visits"] = loop.visits;
+            loopObj["estimatedRows"] = loop.estimatedRows;
+            loopsArray.append(loopObj);
+        }
+
+        QJsonObject engineObj;
+        engineObj["fullScanSteps"] = engineStats.fullScanSteps;
+        engineObj["sorts"] = engineStats.sorts;
+        engineObj["autoIndexes"] = engineStats.autoIndexes;
+        engineObj["vmSteps"] = engineStats.vmSteps;
+        engineObj["reprepares"] = engineStats.reprepares;
+        engineObj["memoryUsed"] = engineStats.memoryUsed;
+        engineObj["scanLoops"] = loopsArray;
+        obj["engine"] = engineObj;
+    }
+
+    if (!plan.isEmpty())
+    {
+        QJsonArray planArray;
+        for (const PlanNode& node : plan)
+        {
+            QJsonObject nodeObj;
+            nodeObj["id"] = node.id;
+            nodeObj["parent"] = node.parent;
+            nodeObj["detail"] = node.detail;
+            planArray.append(nodeObj);
+        }
+        obj["plan"] = planArray;
+    }
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+ExecutionProfile ExecutionProfile::fromJson(const QString& json)
+{
+    ExecutionProfile profile;
+    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+    if (!doc.isObject())
+        return profile;
+
+    QJsonObject obj = doc.object();
+    for (const QJsonValue& stepValue : obj["steps"].toArray())
+    {
+        QJsonObject stepObj = stepValue.toObject();
+        profile.addStep(stepObj["name"].toString(), static_cast<qint64>(stepObj["time"].toDouble()), stepObj["sqlBytes"].toInt());
+    }
+
+    profile.simpleMode = obj["simpleMode"].toBool();
+    profile.parseCount = obj["parseCount"].toInt();
+    profile.queryCount = obj["queryCount"].toInt();
+    profile.prepareTime = static_cast<qint64>(obj["prepareTime"].toDouble());
+    profile.firstRowTime = static_cast<qint64>(obj["firstRowTime"].toDouble());
+    profile.fetchTime = static_cast<qint64>(obj["fetchTime"].toDouble());
+    profile.rowsFetched = static_cast<qint64>(obj["rowsFetched"].toDouble());
+    profile.rowsAffected = static_cast<qint64>(obj["rowsAffected"].toDouble());
+
+    if (obj.contains("engine"))
+    {
+        QJsonObject engineObj = obj["engine"].toObject();
+        profile.engineStats.collected = true;
+        profile.engineStats.fullScanSteps = static_cast<qint64>(engineObj["fullScanSteps"].toDouble());
+        profile.engineStats.sorts = static_cast<qint64>(engineObj["sorts"].toDouble());
+        profile.engineStats.autoIndexes = static_cast<qint64>(engineObj["autoIndexes"].toDouble());
+        profile.engineStats.vmSteps = static_cast<qint64>(engineObj["vmSteps"].toDouble());
+        profile.engineStats.reprepares = static_cast<qint64>(engineObj["reprepares"].toDouble());
+        profile.engineStats.memoryUsed = static_cast<qint64>(engineObj["memoryUsed"].toDouble());
+        for (const QJsonValue& loopValue : engineObj["scanLoops"].toArray())
+        {
+            QJsonObject loopObj = loopValue.toObject();
+            EngineStats::ScanLoop loop;
+            loop.name = loopObj["name"].toString();
+            loop.explain = loopObj["explain"].toString();
+            loop.selectId = loopObj["selectId"].toInt();
+            loop.loops = static_cast<qint64>(loopObj["loops"].toDouble());
+            loop.visits = static_cast<qint64>(loopObj["visits"].toDouble());
+            loop.estimatedRows = loopObj["estimatedRows"].toDouble();
+            profile.engineStats.scanLoops << loop;
+        }
+    }
+
+    for (const QJsonValue& nodeValue : obj["plan"].toArray())
+    {
+        QJsonObject nodeObj = nodeValue.toObject();
+        PlanNode node;
+        node.id = nodeObj["id"].toInt();
+        node.parent = nodeObj["parent"].toInt();
+        node.detail = nodeObj["detail"].toString();
+        profile.plan << node;
+    }
+    profile.annotatePlan();
+    return profile;
+}
+
+QString ExecutionProfile::formatTime(qint64 time)
+{
+    return QObject::tr("%1 ms", "execution profile").arg(QString::number(static_cast<double>(time) / 1000, 'f', 3));
+}
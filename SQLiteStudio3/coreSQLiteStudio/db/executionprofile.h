@@ -0,0 +1,157 @@
+#ifndef EXECUTIONPROFILE_H
+#define EXECUTIONPROFILE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/enginestats.h"
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Timings and counters collected during a single QueryExecutor execution.
+ *
+ * The profile is filled by QueryExecutor while it goes through its chain of steps (see QueryExecutor::executeChain())
+ * and by QueryExecutorExecute step, which executes the final query. Time spent on reading rows from results
+ * is provided later by the code that actually reads them (see QueryExecutor::recordFetch()).
+ *
+ * All times are wall clock times in microseconds.
+ *
+ * If the execution was done with QueryExecutor::setEngineProfiling() enabled, the profile also contains
+ * SQLite engine counters of the last executed statement and its query plan, annotated with scan statistics
+ * (see annotatePlan()).
+ *
+ * The profile can be serialized with toJson(), which is how it's kept in the SQL history.
+ */
+struct API_EXPORT ExecutionProfile
+{
+    /**
+     * @brief Single executor step measurements.
+     */
+    struct Step
+    {
+        QString name;       /**< Class name of the step, followed by its object name (if any). */
+        qint64 time = 0;    /**< Time spent in the step. */
+        int sqlBytes = 0;   /**< Size of the processed query after the step, in UTF-8 bytes. */
+    };
+
+    /**
+     * @brief Single node of the EXPLAIN QUERY PLAN tree.
+     */
+    struct PlanNode
+    {
+        int id = 0;                 /**< Node identifier, as returned by EXPLAIN QUERY PLAN. */
+        int parent = 0;             /**< Identifier of the parent node, or 0 for top level nodes. */
+        QString detail;             /**< Description of the node. */
+        bool scanStats = false;     /**< Tells if scan statistics below were matched to this node. */
+        qint64 loops = 0;           /**< Number of times the loop was run. */
+        qint64 visits = 0;          /**< Number of rows visited by the loop. */
+        double estimatedRows = 0;   /**< Number of rows estimated by the query planner for each loop run. */
+        bool hotSpot = false;       /**< Tells if the node is likely the reason of slow execution. */
+        QString hotSpotReason;      /**< Human readable explanation of why the node is a hot spot. */
+    };
+
+    /**
+     * @brief Drops all collected data.
+     */
+    void clear();
+
+    /**
+     * @brief Adds measurements of the executor step.
+     * @param name Step name.
+     * @param time Time spent in the step.
+     * @param sqlBytes Size of the processed query after the step.
+     */
+    void addStep(const QString& name, qint64 time, int sqlBytes);
+
+    /**
+     * @brief Tells if there is anything measured.
+     * @return true if no steps were recorded.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Matches scan statistics to query plan nodes and marks hot spots.
+     *
+     * Scan loops from engineStats are matched to plan nodes by their description.
+     * A node is a hot spot if it does a full table scan, builds an automatic index or a temporary b-tree
+     * (for sorting, grouping or DISTINCT), or if it visited at least half of all rows visited by the statement.
+     */
+    void annotatePlan();
+
+    /**
+     * @brief Provides depth of the plan node in the plan tree.
+     * @param node Plan node.
+     * @return 0 for top level nodes, 1 for their children, etc.
+     */
+    int getPlanDepth(const PlanNode& node) const;
+
+    /**
+     * @brief Provides total time of all recorded steps.
+     * @return Sum of steps times.
+     */
+    qint64 getStepsTime() const;
+
+    /**
+     * @brief Provides total time of the execution, including reading rows.
+     * @return Steps time together with fetch time.
+     */
+    qint64 getTotalTime() const;
+
+    /**
+     * @brief Formats the profile as multi-line, human readable text.
+     * @return Formatted profile.
+     */
+    QString toString() const;
+
+    /**
+     * @brief Serializes the profile.
+     * @return Compact JSON document.
+     */
+    QString toJson() const;
+
+    /**
+     * @brief Deserializes the profile.
+     * @param json JSON document produced by toJson().
+     * @return Deserialized profile, or empty profile if the document was invalid.
+     */
+    static ExecutionProfile fromJson(const QString& json);
+
+    /**
+     * @brief Formats time for presentation.
+     * @param time Time in microseconds.
+     * @return Time in milliseconds, with 3 decimal places and the unit.
+     */
+    static QString formatTime(qint64 time);
+
+    QList<Step> steps;
+
+    /**
+     * @brief Tells if the query was executed with the "simple method".
+     *
+     * In that case steps recorded before the fallback are still there, so it's visible where the smart method failed.
+     */
+    bool simpleMode = false;
+
+    int parseCount = 0;         /**< Number of times the query was parsed by QueryExecutorParseQuery steps. */
+    int queryCount = 0;         /**< Number of statements executed in the final execution. */
+    qint64 prepareTime = 0;     /**< Time spent on preparing statements for the final execution. */
+    qint64 firstRowTime = 0;    /**< Time since final execution started until the first row of the last statement was available. */
+    qint64 fetchTime = 0;       /**< Time spent on reading rows by the results consumer. */
+    qint64 rowsFetched = 0;     /**< Number of rows read by the results consumer. */
+    qint64 rowsAffected = 0;    /**< Number of rows affected by the query. */
+
+    /**
+     * @brief SQLite engine counters of the last statement.
+     *
+     * Collected only with engine profiling enabled.
+     */
+    EngineStats engineStats;
+
+    /**
+     * @brief EXPLAIN QUERY PLAN of the last statement, in order returned by SQLite.
+     *
+     * Captured only with engine profiling enabled.
+     */
+    QList<PlanNode> plan;
+};
+
+#endif // EXECUTIONPROFILE_H
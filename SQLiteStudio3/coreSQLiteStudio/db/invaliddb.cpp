@@ -341,6 +341,35 @@ bool InvalidDb::isComplete(const QString& sql) const
     return false;
 }
 
+DbBlobPtr InvalidDb::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(readWrite);
+    return DbBlobPtr();
+}
+
+bool InvalidDb::backupTo(const QString& filePath, int pagesPerStep, int pauseMs, BackupProgressHandler progressHandler)
+{
+    UNUSED(filePath);
+    UNUSED(pagesPerStep);
+    UNUSED(pauseMs);
+    UNUSED(progressHandler);
+    return false;
+}
+
+bool InvalidDb::getMemoryStatus(MemoryStatus& status)
+{
+    UNUSED(status);
+    return false;
+}
+
+void InvalidDb::releaseMemory()
+{
+}
+
 void InvalidDb::interrupt()
 {
 }
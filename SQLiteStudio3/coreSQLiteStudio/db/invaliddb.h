@@ -61,6 +61,10 @@ class API_EXPORT InvalidDb : public Db
         void setError(const QString& value);
         bool loadExtension(const QString& filePath, const QString& initFunc);
         bool isComplete(const QString& sql) const;
+        DbBlobPtr openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readWrite);
+        bool backupTo(const QString& filePath, int pagesPerStep, int pauseMs, BackupProgressHandler progressHandler);
+        bool getMemoryStatus(MemoryStatus& status);
+        void releaseMemory();
 
     public slots:
         bool open();
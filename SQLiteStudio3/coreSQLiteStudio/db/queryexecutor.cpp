@@ -20,14 +20,18 @@
 #include "queryexecutorsteps/queryexecutordetectschemaalter.h"
 #include "queryexecutorsteps/queryexecutorvaluesmode.h"
 #include "queryexecutorsteps/queryexecutorcolumntype.h"
+#include "queryexecutorsteps/queryexecutorkeysetpaging.h"
+#include "queryexecutorsteps/queryexecutorsnapshot.h"
 #include "common/unused.h"
 #include "chainexecutor.h"
 #include "log.h"
 #include "schemaresolver.h"
 #include "parser/lexer.h"
 #include "common/table.h"
+#include "common/utils_sql.h"
 #include <QMutexLocker>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QThreadPool>
 #include <QDebug>
 #include <QtMath>
@@ -37,6 +41,9 @@
 QHash<QueryExecutor::StepPosition, QList<QueryExecutorStep*>> QueryExecutor::additionalStatelessSteps;
 QList<QueryExecutorStep*> QueryExecutor::allAdditionalStatelsssSteps;
 QHash<QueryExecutor::StepPosition, QList<QueryExecutor::StepFactory*>> QueryExecutor::additionalStatefulStepFactories;
+QCache<QString, qint64> QueryExecutor::countCache(1000);
+QMutex QueryExecutor::countCacheMutex;
+QAtomicInt QueryExecutor::snapshotSequence;
 
 QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
     QObject(parent)
@@ -56,6 +63,7 @@ QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
 
 QueryExecutor::~QueryExecutor()
 {
+    dropSnapshot();
     delete context;
     context = nullptr;
 }
@@ -94,7 +102,8 @@ void QueryExecutor::setupExecutionChain()
     executionChain.append(additionalStatelessSteps[AFTER_REPLACED_COLUMNS]);
     executionChain.append(createSteps(AFTER_REPLACED_COLUMNS));
 
-    executionChain << new QueryExecutorOrder();
+    executionChain << new QueryExecutorSnapshot()
+                   << new QueryExecutorOrder();
 
     executionChain.append(additionalStatelessSteps[AFTER_ORDER]);
     executionChain.append(createSteps(AFTER_ORDER));
@@ -105,8 +114,10 @@ void QueryExecutor::setupExecutionChain()
     executionChain.append(additionalStatelessSteps[AFTER_DISTINCT_WRAP]);
     executionChain.append(createSteps(AFTER_DISTINCT_WRAP));
 
-    executionChain << new QueryExecutorCellSize()
-                   << new QueryExecutorCountResults()
+    // Counting and keyset paging need to work on full values, not limited ones
+    executionChain << new QueryExecutorCountResults()
+                   << new QueryExecutorKeysetPaging()
+                   << new QueryExecutorCellSize()
                    << new QueryExecutorParseQuery("after CellSize");
 
     executionChain.append(additionalStatelessSteps[AFTER_CELL_SIZE_LIMIT]);
@@ -149,6 +160,7 @@ void QueryExecutor::executeChain()
 {
     // Go through all remaining steps
     bool result;
+    QElapsedTimer stepTimer;
     for (QueryExecutorStep* currentStep : executionChain)
     {
         if (isInterrupted())
@@ -158,7 +170,9 @@ void QueryExecutor::executeChain()
         }
 
         logExecutorStep(currentStep);
+        stepTimer.start();
         result = currentStep->exec();
+        context->profile.addStep(getStepName(currentStep), stepTimer.nsecsElapsed() / 1000, context->processedQuery.toUtf8().size());
         logExecutorAfterStep(context->processedQuery);
 
         if (!result)
@@ -169,6 +183,7 @@ void QueryExecutor::executeChain()
     }
 
     requiredDbAttaches = context->dbNameToAttach.leftValues();
+    storeKeysetBoundary();
 
     // We're done.
     clearChain();
@@ -212,6 +227,13 @@ void QueryExecutor::cleanupBeforeDbDestroy(Db* dbToBeUnloaded)
     if (!dbToBeUnloaded || dbToBeUnloaded != db)
         return;
 
+    // The database is about to be closed, so temporary tables will be gone anyway
+    snapshotMutex.lock();
+    snapshotTable.clear();
+    snapshotKey.clear();
+    snapshotTime = QDateTime();
+    snapshotMutex.unlock();
+
     setDb(nullptr);
     context->executionResults.clear();
 }
@@ -262,6 +284,7 @@ void QueryExecutor::run()
 void QueryExecutor::execInternal()
 {
     queriesForSimpleExecution.clear();
+    context->profile.clear();
     if (forceSimpleMode)
     {
         executeSimpleMethod();
@@ -284,6 +307,14 @@ void QueryExecutor::execInternal()
     simpleExecution = false;
     interrupted = false;
 
+    if (keysetIndexAsyncId != 0)
+    {
+        // It will be requested again once this execution is finished
+        keysetIndexAsyncId = 0;
+        keysetIndexRequested = false;
+        db->interrupt();
+    }
+
     if (resultsCountingAsyncId != 0)
     {
         resultsCountingAsyncId = 0;
@@ -296,11 +327,14 @@ void QueryExecutor::execInternal()
     context = new Context();
     context->processedQuery = originalQuery;
     context->explainMode = explainMode;
+    context->engineProfiling = engineProfiling;
     context->skipRowCounting = skipRowCounting;
     context->noMetaColumns = noMetaColumns;
     context->resultsHandler = resultsHandler;
     context->preloadResults = preloadResults;
     context->queryParameters = queryParameters;
+    context->keysetPaging = keysetPaging;
+    context->snapshotMode = snapshotMode;
 
     // Start the execution
     setupExecutionChain();
@@ -322,40 +356,82 @@ void QueryExecutor::interrupt()
 
 bool QueryExecutor::countResults()
 {
+    static_qstring(limitedCountingTpl, "SELECT count(*) AS cnt FROM (SELECT 1 FROM (%1) LIMIT %2);");
+
     if (context->skipRowCounting)
         return false;
 
     if (context->countingQuery.isEmpty()) // simple method doesn't provide that
         return false;
 
+    if (countingMode == CountingMode::ESTIMATED && estimateResults())
+    {
+        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+        return true;
+    }
+
+    QString dbState = getDbStateForCountCache();
+    countCacheKey = dbState.isNull() ? QString() : getCountCacheKey(dbState);
+    if (!countCacheKey.isNull())
+    {
+        QMutexLocker lock(&countCacheMutex);
+        qint64* cachedRows = countCache.object(countCacheKey);
+        if (cachedRows)
+        {
+            qint64 rows = *cachedRows;
+            lock.unlock();
+
+            setTotalRowsReturned(rows, CountAccuracy::EXACT);
+            emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+            return true;
+        }
+    }
+
+    QString countingQuery = context->countingQuery;
+    resultsCountingLimit = -1;
+    resultsCountingCancelled = false;
+    if (countingMode == CountingMode::LAZY && !context->countedQuery.isEmpty())
+    {
+        // Counting one row more than the limit, so it's known whether there are more rows than the limit.
+        resultsCountingLimit = lazyCountingLimit;
+        countingQuery = limitedCountingTpl.arg(context->countedQuery, QString::number(lazyCountingLimit + 1));
+    }
+
     if (asyncMode)
     {
         // Start asynchronous results counting query
-        resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        resultsCountingAsyncId = db->asyncExec(countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
     }
     else
     {
-        SqlQueryPtr results = db->exec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
-        context->totalRowsReturned = results->getSingleCell().toLongLong();
-        context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
-
-        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
-
-        if (results->isError())
-        {
-            notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
-                        .arg(results->getErrorText()));
-            return false;
-        }
+        SqlQueryPtr results = db->exec(countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        return readCountingResults(results);
     }
     return true;
 }
 
+void QueryExecutor::cancelResultsCounting()
+{
+    if (resultsCountingAsyncId == 0)
+        return;
+
+    resultsCountingCancelled = true;
+    db->asyncInterrupt();
+}
+
+bool QueryExecutor::isResultsCountingInProgress() const
+{
+    return resultsCountingAsyncId != 0;
+}
+
 void QueryExecutor::dbAsyncExecFinished(quint32 asyncId, SqlQueryPtr results)
 {
     if (handleRowCountingResults(asyncId, results))
         return;
 
+    if (handleKeysetIndexResults(asyncId, results))
+        return;
+
     // If this was raised by any other asyncExec, handle it here.
 }
 
@@ -364,6 +440,23 @@ qint64 QueryExecutor::getLastExecutionTime() const
     return context->executionTime;
 }
 
+ExecutionProfile QueryExecutor::getExecutionProfile() const
+{
+    if (!context->engineProfiling || !context->executionResults)
+        return context->profile;
+
+    ExecutionProfile profile = context->profile;
+    profile.engineStats = context->executionResults->getEngineStats();
+    profile.annotatePlan();
+    return profile;
+}
+
+void QueryExecutor::recordFetch(qint64 time, qint64 rows)
+{
+    context->profile.fetchTime += time;
+    context->profile.rowsFetched += rows;
+}
+
 qint64 QueryExecutor::getRowsAffected() const
 {
     return context->rowsAffected;
@@ -374,6 +467,11 @@ qint64 QueryExecutor::getTotalRowsReturned() const
     return context->totalRowsReturned;
 }
 
+QueryExecutor::CountAccuracy QueryExecutor::getTotalRowsAccuracy() const
+{
+    return context->totalRowsAccuracy;
+}
+
 SqliteQueryType QueryExecutor::getExecutedQueryType(int index)
 {
     if (context->parsedQueries.size() == 0)
@@ -471,9 +569,17 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
         return;
     }
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - simpleExecutionStartTime;
+    context->profile.simpleMode = true;
+    context->profile.addStep("SimpleExecution", context->executionTime * 1000, originalQuery.toUtf8().size());
+    context->profile.queryCount = queriesForSimpleExecution.size();
+    context->profile.firstRowTime = context->executionTime * 1000;
 
+    context->scannedTable.clear();
     if (simpleExecIsSelect())
-        context->countingQuery = "SELECT count(*) AS cnt FROM ("+trimQueryEnd(queriesForSimpleExecution.last())+");";
+    {
+        context->countedQuery = trimQueryEnd(queriesForSimpleExecution.last());
+        context->countingQuery = "SELECT count(*) AS cnt FROM ("+context->countedQuery+");";
+    }
     else
         context->rowsCountingRequired = true;
 
@@ -487,6 +593,7 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
     }
 
     context->rowsAffected = results->rowsAffected();
+    context->profile.rowsAffected = context->rowsAffected;
     context->totalRowsReturned = 0;
     context->executionResults = results;
     requiredDbAttaches = context->dbNameToAttach.leftValues();
@@ -506,6 +613,15 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
     emit executionFinished(results);
 }
 
+QString QueryExecutor::getStepName(QueryExecutorStep* step)
+{
+    QString name = step->metaObject()->className();
+    if (!step->objectName().isEmpty())
+        name += " (" + step->objectName() + ")";
+
+    return name;
+}
+
 bool QueryExecutor::simpleExecIsSelect()
 {
     TokenList tokens = Lexer::tokenize(queriesForSimpleExecution.last());
@@ -582,18 +698,282 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         return false;
 
     resultsCountingAsyncId = 0;
+    readCountingResults(results);
+    return true;
+}
 
-    context->totalRowsReturned = results->getSingleCell().toLongLong();
-    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+bool QueryExecutor::readCountingResults(SqlQueryPtr results)
+{
+    if (results->isError())
+    {
+        if (resultsCountingCancelled)
+        {
+            // Nothing was counted, but the results consumer knows how many rows it has already read.
+            setTotalRowsReturned(0, CountAccuracy::LOWER_BOUND);
+            emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+            return true;
+        }
+
+        setTotalRowsReturned(0, CountAccuracy::EXACT);
+        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+        notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
+                    .arg(results->getErrorText()));
+        return false;
+    }
+
+    qint64 rows = results->getSingleCell().toLongLong();
+    if (resultsCountingLimit > -1 && rows > resultsCountingLimit)
+    {
+        setTotalRowsReturned(resultsCountingLimit, CountAccuracy::LOWER_BOUND);
+    }
+    else
+    {
+        setTotalRowsReturned(rows, CountAccuracy::EXACT);
+        if (!countCacheKey.isNull())
+        {
+            QMutexLocker lock(&countCacheMutex);
+            countCache.insert(countCacheKey, new qint64(rows));
+        }
+    }
 
     emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+    return true;
+}
+
+void QueryExecutor::setTotalRowsReturned(qint64 rows, CountAccuracy accuracy)
+{
+    context->totalRowsReturned = rows;
+    context->totalRowsAccuracy = accuracy;
+    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+}
+
+bool QueryExecutor::estimateResults()
+{
+    static_qstring(statTpl, "SELECT stat FROM %1sqlite_stat1 WHERE tbl = ? COLLATE NOCASE ORDER BY idx IS NULL DESC LIMIT 1");
+    static_qstring(maxRowIdTpl, "SELECT max(ROWID) FROM %1%2");
+
+    if (!context->scannedTable)
+        return false;
+
+    QString database = context->scannedTable->database;
+    QString table = context->scannedTable->table;
+    QString dbPrefix = database.isEmpty() ? QString() : (wrapObjIfNeeded(database) + ".");
+
+    // The first number in sqlite_stat1 is number of rows in the table, as of the last ANALYZE.
+    // For indexes it's the number of index entries, which is lower for partial indexes, so the table's own row goes first.
+    SqlQueryPtr results = db->exec(statTpl.arg(dbPrefix), QList<QVariant>({table}), Db::Flag::NO_LOCK);
+    if (!results->isError())
+    {
+        bool ok = false;
+        qint64 rows = results->getSingleCell().toString().section(' ', 0, 0).toLongLong(&ok);
+        if (ok)
+        {
+            setTotalRowsReturned(rows, CountAccuracy::ESTIMATED);
+            return true;
+        }
+    }
+
+    // Virtual tables may need to scan all rows to find maximum ROWID
+    SchemaResolver resolver(db);
+    if (resolver.isVirtualTable(database.isEmpty() ? "main" : database, table))
+        return false;
+
+    results = db->exec(maxRowIdTpl.arg(dbPrefix, wrapObjIfNeeded(table)), Db::Flag::NO_LOCK);
+    if (results->isError()) // WITHOUT ROWID table
+        return false;
+
+    QVariant maxRowId = results->getSingleCell();
+    if (maxRowId.isNull())
+        setTotalRowsReturned(0, CountAccuracy::EXACT); // empty table
+    else
+        setTotalRowsReturned(qMax(0LL, maxRowId.toLongLong()), CountAccuracy::ESTIMATED);
+
+    return true;
+}
+
+QString QueryExecutor::getDbStateForCountCache()
+{
+    static_qstring(pragmaTpl, "PRAGMA %1.%2");
+
+    QStringList dbNames = {"main"};
+    dbNames += context->dbNameToAttach.rightValues();
+
+    QStringList state;
+    SqlQueryPtr results;
+    for (const QString& dbName : dbNames)
+    {
+        for (const QString& pragma : {"data_version", "schema_version"})
+        {
+            results = db->exec(pragmaTpl.arg(wrapObjIfNeeded(dbName), pragma), Db::Flag::NO_LOCK);
+            if (results->isError())
+                return QString();
+
+            state << results->getSingleCell().toString();
+        }
+    }
 
+    // The data_version doesn't change for changes made by the same connection
+    results = db->exec("SELECT total_changes()", Db::Flag::NO_LOCK);
     if (results->isError())
+        return QString();
+
+    state << results->getSingleCell().toString();
+    return state.join(",");
+}
+
+QString QueryExecutor::getCountCacheKey(const QString& dbState) const
+{
+    return QStringList({db->getName(), dbState, context->countingQuery, getParamsForCacheKey()}).join("\n");
+}
+
+QString QueryExecutor::getParamsForCacheKey() const
+{
+    QStringList paramNames = context->queryParameters.keys();
+    paramNames.sort();
+
+    QStringList params;
+    for (const QString& name : paramNames)
     {
-        notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
-                    .arg(results->getErrorText()));
+        const QVariant& value = context->queryParameters[name];
+        params << (name + "=" + value.typeName() + ":" + value.toString());
+    }
+    return params.join("\n");
+}
+
+int QueryExecutor::findKeysetBoundary(const QString& keysetQuery, int page, QList<QVariant>& keyValues)
+{
+    QString dbState = getDbStateForCountCache();
+    if (dbState.isNull())
+        return -1; // changes in data could not be detected
+
+    QString key = QStringList({db->getName(), dbState, keysetQuery, getParamsForCacheKey(), QString::number(resultsPerPage)}).join("\n");
+
+    QMutexLocker lock(&keysetMutex);
+    if (key != keysetKey)
+    {
+        keysetKey = key;
+        keysetBoundaries.clear();
+        keysetIndexRequested = false;
     }
 
+    // The first boundary greater than the page is found, so the previous one is the nearest one not greater than the page
+    QMap<int, QList<QVariant>>::const_iterator it = keysetBoundaries.upperBound(page);
+    if (it == keysetBoundaries.constBegin())
+        return 0;
+
+    --it;
+    keyValues = it.value();
+    return it.key();
+}
+
+void QueryExecutor::storeKeysetBoundary()
+{
+    if (context->keysetColumns.isEmpty() || !context->preloadResults)
+        return;
+
+    if (!context->executionResults || context->executionResults->isError())
+        return;
+
+    QList<SqlResultsRowPtr> rows = context->executionResults->getAll();
+    if (rows.size() < resultsPerPage)
+        return; // the last page
+
+    SqlResultsRowPtr lastRow = rows.last();
+    QList<QVariant> keyValues;
+    for (const QString& alias : context->keysetColumns)
+    {
+        QVariant value = lastRow->value(alias);
+        if (isKeysetValueLimited(alias, value))
+        {
+            keyValues.clear();
+            break;
+        }
+        keyValues << value;
+    }
+
+    if (!keyValues.isEmpty())
+    {
+        QMutexLocker lock(&keysetMutex);
+        keysetBoundaries[page + 1] = keyValues;
+    }
+
+    buildKeysetIndex();
+}
+
+bool QueryExecutor::isKeysetValueLimited(const QString& alias, const QVariant& value) const
+{
+    if (dataLengthLimit < 0)
+        return false;
+
+    for (const ResultColumnPtr& resCol : context->resultColumns)
+    {
+        if (resCol->queryExecutorAlias != alias)
+            continue;
+
+        if (!resCol->editionForbiddenReasons.isEmpty())
+            return false; // not limited by QueryExecutorCellSize
+
+        if (value.type() == QVariant::ByteArray)
+            return value.toByteArray().size() >= dataLengthLimit;
+
+        if (value.type() == QVariant::String)
+            return value.toString().length() >= dataLengthLimit;
+
+        return false;
+    }
+
+    return false; // ROWID columns are never limited
+}
+
+void QueryExecutor::buildKeysetIndex()
+{
+    static_qstring(indexTpl, "SELECT %1 FROM (SELECT %1, row_number() OVER (ORDER BY %2) AS sqlitestudio_keyset_row FROM (%3)) "
+                             "WHERE sqlitestudio_keyset_row % %4 = 0");
+
+    if (!asyncMode || keysetIndexAsyncId != 0)
+        return;
+
+    QMutexLocker lock(&keysetMutex);
+    if (keysetIndexRequested)
+        return;
+
+    keysetIndexRequested = true;
+    keysetIndexKey = keysetKey;
+    lock.unlock();
+
+    QStringList orderBy;
+    for (int i = 0, total = context->keysetColumns.size(); i < total; i++)
+        orderBy << (context->keysetColumns[i] + (context->keysetDescending[i] ? " DESC" : " ASC"));
+
+    // The last row of every KEYSET_INDEX_PAGE_STEP-th page is the boundary of the page that follows
+    QString rowsPerStep = QString::number(resultsPerPage * KEYSET_INDEX_PAGE_STEP);
+    QString sql = indexTpl.arg(context->keysetColumns.join(", "), orderBy.join(", "), context->keysetQuery, rowsPerStep);
+    keysetIndexAsyncId = db->asyncExec(sql, context->queryParameters, Db::Flag::NO_LOCK);
+}
+
+bool QueryExecutor::handleKeysetIndexResults(quint32 asyncId, SqlQueryPtr results)
+{
+    if (keysetIndexAsyncId == 0 || keysetIndexAsyncId != asyncId)
+        return false;
+
+    keysetIndexAsyncId = 0;
+    if (results->isError())
+    {
+        // For example SQLite older than 3.25 doesn't support window functions. Paging works without the index anyway.
+        qDebug() << "Could not build keyset paging index:" << results->getErrorText();
+        return true;
+    }
+
+    QMutexLocker lock(&keysetMutex);
+    if (keysetIndexKey != keysetKey)
+        return true; // query or data has changed in the meantime
+
+    int page = 0;
+    while (results->hasNext())
+    {
+        page += KEYSET_INDEX_PAGE_STEP;
+        keysetBoundaries[page] = results->next()->valueList();
+    }
     return true;
 }
 
@@ -657,6 +1037,25 @@ void QueryExecutor::deregisterStep(QueryExecutor::StepPosition position, QueryEx
     additionalStatefulStepFactories[position].removeOne(stepFactory);
 }
 
+qint64 QueryExecutor::getCountCacheMemoryUsage(int& entries)
+{
+    QMutexLocker lock(&countCacheMutex);
+    QList<QString> keys = countCache.keys();
+    entries = keys.size();
+
+    qint64 size = 0;
+    for (const QString& key : keys)
+        size += sizeof(QString) + key.size() * sizeof(QChar) + sizeof(qint64);
+
+    return size;
+}
+
+void QueryExecutor::clearCountCache()
+{
+    QMutexLocker lock(&countCacheMutex);
+    countCache.clear();
+}
+
 bool QueryExecutor::getForceSimpleMode() const
 {
     return forceSimpleMode;
@@ -820,6 +1219,16 @@ void QueryExecutor::setExplainMode(bool value)
     explainMode = value;
 }
 
+bool QueryExecutor::getEngineProfiling() const
+{
+    return engineProfiling;
+}
+
+void QueryExecutor::setEngineProfiling(bool value)
+{
+    engineProfiling = value;
+}
+
 
 void QueryExecutor::error(int code, const QString& text)
 {
@@ -833,6 +1242,9 @@ Db* QueryExecutor::getDb() const
 
 void QueryExecutor::setDb(Db* value)
 {
+    if (db != value)
+        dropSnapshot();
+
     if (db)
         disconnect(db, SIGNAL(asyncExecFinished(quint32,SqlQueryPtr)), this, SLOT(dbAsyncExecFinished(quint32,SqlQueryPtr)));
 
@@ -852,6 +1264,127 @@ void QueryExecutor::setSkipRowCounting(bool value)
     skipRowCounting = value;
 }
 
+QueryExecutor::CountingMode QueryExecutor::getCountingMode() const
+{
+    return countingMode;
+}
+
+void QueryExecutor::setCountingMode(CountingMode value)
+{
+    countingMode = value;
+}
+
+qint64 QueryExecutor::getLazyCountingLimit() const
+{
+    return lazyCountingLimit;
+}
+
+void QueryExecutor::setLazyCountingLimit(qint64 value)
+{
+    lazyCountingLimit = value;
+}
+
+bool QueryExecutor::getKeysetPaging() const
+{
+    return keysetPaging;
+}
+
+void QueryExecutor::setKeysetPaging(bool value)
+{
+    keysetPaging = value;
+}
+
+bool QueryExecutor::getSnapshotMode() const
+{
+    return snapshotMode;
+}
+
+void QueryExecutor::setSnapshotMode(bool value)
+{
+    snapshotMode = value;
+    if (!snapshotMode)
+        dropSnapshot();
+}
+
+QString QueryExecutor::getSnapshotFilter() const
+{
+    return snapshotFilter;
+}
+
+void QueryExecutor::setSnapshotFilter(const QString& value)
+{
+    snapshotFilter = value;
+}
+
+QString QueryExecutor::getSnapshot(const QString& query, const QHash<QString, QVariant>& params)
+{
+    static_qstring(existsTpl, "SELECT count(*) FROM sqlite_temp_master WHERE type = 'table' AND name = '%1'");
+    static_qstring(createTpl, "CREATE TEMP TABLE %1 AS %2");
+
+    QStringList paramNames = params.keys();
+    paramNames.sort();
+
+    QStringList keyParts = {query};
+    for (const QString& name : paramNames)
+        keyParts << (name + "=" + params[name].typeName() + ":" + params[name].toString());
+
+    QString key = keyParts.join("\n");
+
+    QMutexLocker lock(&snapshotMutex);
+    if (!snapshotTable.isNull() && key == snapshotKey)
+    {
+        // Could be dropped in the meantime, i.e. by the user or by detaching temporary database
+        SqlQueryPtr results = db->exec(existsTpl.arg(snapshotTable));
+        if (!results->isError() && results->getSingleCell().toInt() > 0)
+            return snapshotTable;
+    }
+
+    dropSnapshotInternal();
+
+    QString table = QString("sqlitestudio_snapshot_%1").arg(snapshotSequence.fetchAndAddOrdered(1) + 1);
+    SqlQueryPtr results = db->exec(createTpl.arg(table, query), params);
+    if (results->isError())
+    {
+        qWarning() << "Could not take snapshot of query results:" << results->getErrorText();
+        return QString();
+    }
+
+    snapshotTable = table;
+    snapshotKey = key;
+    snapshotTime = QDateTime::currentDateTime();
+    return snapshotTable;
+}
+
+void QueryExecutor::dropSnapshot()
+{
+    QMutexLocker lock(&snapshotMutex);
+    dropSnapshotInternal();
+}
+
+bool QueryExecutor::isSnapshotResults() const
+{
+    return context->snapshotResults;
+}
+
+QDateTime QueryExecutor::getSnapshotTime() const
+{
+    QMutexLocker lock(&snapshotMutex);
+    return snapshotTime;
+}
+
+void QueryExecutor::dropSnapshotInternal()
+{
+    if (snapshotTable.isNull())
+        return;
+
+    if (db && db->isOpen())
+        db->exec(QString("DROP TABLE IF EXISTS temp.%1").arg(snapshotTable));
+
+    snapshotTable.clear();
+    snapshotKey.clear();
+    snapshotTime = QDateTime();
+}
+
 QString QueryExecutor::getOriginalQuery() const
 {
     return originalQuery;
@@ -2,6 +2,7 @@
 #define QUERYEXECUTOR_H
 
 #include "db/db.h"
+#include "db/executionprofile.h"
 #include "parser/token.h"
 #include "selectresolver.h"
 #include "coreSQLiteStudio_global.h"
@@ -10,7 +11,11 @@
 #include <QObject>
 #include <QHash>
 #include <QMutex>
+#include <QCache>
+#include <QMap>
 #include <QRunnable>
+#include <QDateTime>
+#include <QAtomicInt>
 
 /** @file */
 
@@ -100,11 +105,43 @@ class ChainExecutor;
  * wait for the QueryExecutor::resultsCountingFinished() signal first.
  *
  * Row counting query execution can be disabled with QueryExecutor::setSkipRowCounting(),
+ *
+ * Counting all rows of an expensive query can take as long as the query itself, therefore there are other
+ * counting methods available with QueryExecutor::setCountingMode() - counted numbers can be reused until the database
+ * is modified, estimated for plain table scans, or counted only up to some limit. In the last two cases
+ * the number is not exact, which is reported by QueryExecutor::getTotalRowsAccuracy().
+ *
+ * \section keyset_paging Keyset paging
+ *
+ * With LIMIT and OFFSET the database has to read and skip all rows of previous pages, so reading far pages
+ * of a large table gets slower with every page. When keyset paging is enabled with QueryExecutor::setKeysetPaging(),
+ * the executor remembers key values (sort columns and ROWID) of the last row of each read page and uses them
+ * to seek directly to the next page (see QueryExecutorKeysetPaging). To make far pages (i.e. the last one)
+ * fast as well, a sparse index of page boundaries (every KEYSET_INDEX_PAGE_STEP-th page) is built asynchronously
+ * after the first full page was read. Boundaries are dropped when the query, its parameters, page size,
+ * or the data in the database change.
+ *
+ * Keyset paging applies only to SELECT queries with a single ROWID data source. For other queries
+ * regular OFFSET is used.
+ *
+ * \section result_snapshots Result snapshots
+ *
+ * Paging and sorting results of an expensive query (i.e. with many joins or aggregations) normally executes
+ * the query again for every page and for counting rows. When snapshot mode is enabled with QueryExecutor::setSnapshotMode(),
+ * results of a single SELECT are materialized once into a temporary table (see getSnapshot()) and all following
+ * pages, sorting, counting and filtering (see setSnapshotFilter()) are done against that table
+ * (see QueryExecutorSnapshot). Indexes needed for sorting are created in the snapshot on demand.
+ *
+ * The snapshot is reused as long as the query and its parameters are the same. It doesn't reflect changes
+ * made in the database after it was taken, until it's dropped with dropSnapshot() and taken again.
  */
 class API_EXPORT QueryExecutor : public QObject, public QRunnable
 {
     Q_OBJECT
 
+    friend class QueryExecutorCountingTest;
+    friend class QueryExecutorSnapshotTest;
+
     public:
         /**
          * @brief General reasons for which results data cannot be edited.
@@ -176,6 +213,30 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
                                */
         };
 
+        /**
+         * @brief Method of counting total number of result rows.
+         *
+         * See setCountingMode() and "Counting query" section in class description for details.
+         */
+        enum class CountingMode
+        {
+            EXACT,      /**< Rows are counted with the counting query. Results are cached until the data in database changes. */
+            ESTIMATED,  /**< For plain table scans number of rows is estimated from sqlite_stat1 or ROWID. Otherwise same as EXACT. */
+            LAZY        /**< Rows are counted only up to the limit defined with setLazyCountingLimit(). */
+        };
+
+        /**
+         * @brief Accuracy of the total number of result rows.
+         *
+         * See getTotalRowsAccuracy().
+         */
+        enum class CountAccuracy
+        {
+            EXACT,          /**< The number is exact. */
+            ESTIMATED,      /**< The number is an estimation, real number of rows can be lower or higher. */
+            LOWER_BOUND     /**< There are at least that many rows, but there can be more. */
+        };
+
         /**
          * @brief Sort order definition.
          *
@@ -465,6 +526,14 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             qint64 totalRowsReturned = 0;
 
+            /**
+             * @brief Accuracy of the totalRowsReturned.
+             *
+             * It's other than CountAccuracy::EXACT only if the number was estimated, or the counting was limited
+             * or interrupted (see QueryExecutor::setCountingMode()).
+             */
+            CountAccuracy totalRowsAccuracy = CountAccuracy::EXACT;
+
             /**
              * @brief Total number of pages.
              *
@@ -491,6 +560,14 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             bool explainMode = false;
 
+            /**
+             * @brief Collecting SQLite engine statistics of the last query.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setEngineProfiling().
+             */
+            bool engineProfiling = false;
+
             /**
              * @brief Defines if row counting should be skipped.
              *
@@ -606,6 +683,73 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QString countingQuery;
 
+            /**
+             * @brief Query which rows are counted.
+             *
+             * It's the query wrapped by the #countingQuery. It's used to build the limited counting query
+             * in CountingMode::LAZY.
+             */
+            QString countedQuery;
+
+            /**
+             * @brief Table which all rows are returned by the query.
+             *
+             * Defined by QueryExecutorDataSources step when the query is a plain scan of a single table
+             * (no WHERE, GROUP BY, DISTINCT, LIMIT, joins, etc), so the number of result rows is the number
+             * of rows in the table. It's used by CountingMode::ESTIMATED. Null for any other query.
+             */
+            SourceTablePtr scannedTable;
+
+            /**
+             * @brief Tells if keyset paging should be used.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setKeysetPaging().
+             */
+            bool keysetPaging = false;
+
+            /**
+             * @brief Query executor aliases of columns defining order of rows for keyset paging.
+             *
+             * Defined by QueryExecutorKeysetPaging step. Empty if keyset paging is not applied.
+             */
+            QStringList keysetColumns;
+
+            /**
+             * @brief Sort direction of each of #keysetColumns (true for descending order).
+             */
+            QList<bool> keysetDescending;
+
+            /**
+             * @brief Query which rows are paged with keyset paging.
+             *
+             * It's the query before the keyset condition was applied.
+             */
+            QString keysetQuery;
+
+            /**
+             * @brief Page which boundary was used by QueryExecutorKeysetPaging step.
+             *
+             * Rows before this page are skipped by the keyset condition, so OFFSET is counted from this page.
+             * It's -1 if keyset paging was not applied.
+             */
+            int keysetBoundaryPage = -1;
+
+            /**
+             * @brief Tells if results should be read from a snapshot.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setSnapshotMode().
+             */
+            bool snapshotMode = false;
+
+            /**
+             * @brief Tells if results are read from a snapshot.
+             *
+             * Defined by QueryExecutorSnapshot step. It's false if the snapshot was not applicable for the query.
+             */
+            bool snapshotResults = false;
+
             /**
              * @brief Flag indicating results preloading.
              *
@@ -652,6 +796,14 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              * message from smart execution.
              */
             QString errorMessageFromSmartExecution;
+
+            /**
+             * @brief Timings and counters of the execution.
+             *
+             * Steps are measured by QueryExecutor itself, while the final execution numbers
+             * are provided by QueryExecutorParseQuery and QueryExecutorExecute steps.
+             */
+            ExecutionProfile profile;
         };
 
         /**
@@ -758,6 +910,20 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool countResults();
 
+        /**
+         * @brief Stops results counting started with countResults().
+         *
+         * The counting query is interrupted and resultsCountingFinished() is emitted with number of rows
+         * marked as CountAccuracy::LOWER_BOUND. Does nothing if no counting is in progress.
+         */
+        void cancelResultsCounting();
+
+        /**
+         * @brief Tells if asynchronous results counting is in progress.
+         * @return true if the counting query was started and it didn't finish yet.
+         */
+        bool isResultsCountingInProgress() const;
+
         /**
          * @brief Gets time of how long it took to execute query.
          * @return Execution time in milliseconds.
@@ -766,6 +932,29 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         qint64 getLastExecutionTime() const;
 
+        /**
+         * @brief Provides detailed timings of the last execution.
+         * @return Execution profile.
+         *
+         * The profile includes time spent in each executor step, number of times the query was parsed,
+         * size of SQL produced by steps, time of preparing the final query and time until its first row was available.
+         * Fetching numbers are included only if the results consumer reported them with recordFetch().
+         * With engine profiling enabled the profile also contains engine counters and the query plan
+         * of the last query, annotated with hot spots.
+         */
+        ExecutionProfile getExecutionProfile() const;
+
+        /**
+         * @brief Records time spent on reading rows from the results.
+         * @param time Time in microseconds.
+         * @param rows Number of rows read.
+         *
+         * Rows are read by the code that consumes results (i.e. the data grid), not by the executor,
+         * so it's up to that code to measure it and report it here, if it wants the fetch to be included
+         * in the execution profile.
+         */
+        void recordFetch(qint64 time, qint64 rows);
+
         /**
          * @brief Gets number of rows affected by the query.
          * @return Affected rows number.
@@ -788,6 +977,12 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         qint64 getTotalRowsReturned() const;
 
+        /**
+         * @brief Tells how accurate is the number provided by getTotalRowsReturned().
+         * @return Accuracy of the number.
+         */
+        CountAccuracy getTotalRowsAccuracy() const;
+
         /**
          * @brief Gets type of the SQL statement in the defined query.
          * @param index Index of the SQL statement in the query (statements are separated by semicolon character), or -1 to get the last one.
@@ -1031,6 +1226,135 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setSkipRowCounting(bool value);
 
+        /**
+         * @brief Provides method of counting result rows.
+         * @return Counting mode.
+         */
+        CountingMode getCountingMode() const;
+
+        /**
+         * @brief Defines how countResults() counts result rows.
+         * @param value Counting mode.
+         *
+         * In CountingMode::EXACT the counting query is executed, but its result is cached under the counting query,
+         * its parameters and the state of the database (data_version and schema_version pragmas of all databases
+         * used by the query, together with total_changes() of the connection). Executing the same query again
+         * with no changes made to the database in the meantime doesn't execute the counting query.
+         *
+         * In CountingMode::ESTIMATED queries that return all rows of a single table have the number of rows
+         * read from sqlite_stat1 (if the table was analyzed), or estimated with max(ROWID). Other queries are
+         * counted as in CountingMode::EXACT.
+         *
+         * In CountingMode::LAZY the counting query stops after counting number of rows defined with setLazyCountingLimit().
+         * If there is more rows, the number is provided as CountAccuracy::LOWER_BOUND.
+         *
+         * The default is CountingMode::EXACT.
+         */
+        void setCountingMode(CountingMode value);
+
+        /**
+         * @brief Provides maximum number of rows counted in CountingMode::LAZY.
+         * @return Number of rows.
+         */
+        qint64 getLazyCountingLimit() const;
+
+        /**
+         * @brief Defines maximum number of rows counted in CountingMode::LAZY.
+         * @param value Number of rows.
+         */
+        void setLazyCountingLimit(qint64 value);
+
+        /**
+         * @brief Tells if keyset paging is enabled.
+         * @return true if enabled.
+         */
+        bool getKeysetPaging() const;
+
+        /**
+         * @brief Enables or disables keyset paging.
+         * @param value true to enable.
+         *
+         * See "Keyset paging" section in class description. It's disabled by default.
+         */
+        void setKeysetPaging(bool value);
+
+        /**
+         * @brief Finds the nearest known page boundary for keyset paging.
+         * @param keysetQuery Query which rows are paged.
+         * @param page Requested page.
+         * @param keyValues Filled with values of key columns of the last row before the returned page.
+         * @return Page not greater than \p page, which boundary is known, or 0 if none is known,
+         * or -1 if keyset paging cannot be used.
+         *
+         * Known boundaries are dropped if the query, its parameters, page size or the database state changed
+         * since they were collected.
+         *
+         * This is used by QueryExecutorKeysetPaging step.
+         */
+        int findKeysetBoundary(const QString& keysetQuery, int page, QList<QVariant>& keyValues);
+
+        /**
+         * @brief Tells if snapshot mode is enabled.
+         * @return true if enabled.
+         */
+        bool getSnapshotMode() const;
+
+        /**
+         * @brief Enables or disables snapshot mode.
+         * @param value true to enable.
+         *
+         * See "Result snapshots" section in class description. It's disabled by default.
+         * Disabling it drops the current snapshot.
+         */
+        void setSnapshotMode(bool value);
+
+        /**
+         * @brief Provides filter applied to rows of the snapshot.
+         * @return SQL expression, or empty string if rows are not filtered.
+         */
+        QString getSnapshotFilter() const;
+
+        /**
+         * @brief Defines filter applied to rows of the snapshot.
+         * @param value SQL expression used as WHERE condition for snapshot rows.
+         *
+         * The expression refers to result columns by their display names (see ResultColumn::displayName).
+         * It's used only if results are read from a snapshot.
+         */
+        void setSnapshotFilter(const QString& value);
+
+        /**
+         * @brief Provides snapshot of query results, taking it if necessary.
+         * @param query Query which results are to be materialized.
+         * @param params Parameters bound to the query.
+         * @return Name of temporary table with results, or null string if the snapshot could not be taken.
+         *
+         * The current snapshot is returned if it was taken for the same query and parameters.
+         * Otherwise the current snapshot is dropped and a new one is taken.
+         *
+         * This is used by QueryExecutorSnapshot step.
+         */
+        QString getSnapshot(const QString& query, const QHash<QString, QVariant>& params);
+
+        /**
+         * @brief Drops the current snapshot.
+         *
+         * Next execution in snapshot mode will take a new snapshot, reflecting the current state of the database.
+         */
+        void dropSnapshot();
+
+        /**
+         * @brief Tells if results of the last execution were read from a snapshot.
+         * @return true if they were read from the snapshot.
+         */
+        bool isSnapshotResults() const;
+
+        /**
+         * @brief Provides time when the current snapshot was taken.
+         * @return Time of the snapshot, or invalid time if there is no snapshot.
+         */
+        QDateTime getSnapshotTime() const;
+
         /**
          * @brief Asynchronous executor processing in thread.
          *
@@ -1057,6 +1381,24 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setExplainMode(bool value);
 
+        /**
+         * @brief Tests if SQLite engine statistics are collected during query execution.
+         * @return true if the profiling is enabled, or false otherwise.
+         */
+        bool getEngineProfiling() const;
+
+        /**
+         * @brief Enables collecting SQLite engine statistics for next query execution.
+         * @param value true to enable profiling, or false to disable it.
+         *
+         * With profiling enabled, the query plan of the last query is captured with EXPLAIN QUERY PLAN
+         * just before the query is executed, then the query is executed with Db::Flag::PROFILE,
+         * so its engine counters are available in getExecutionProfile().
+         *
+         * Profiling applies to the smart execution method only.
+         */
+        void setEngineProfiling(bool value);
+
         /**
          * @brief Defines results preloading.
          * @param value true to preload results.
@@ -1137,6 +1479,20 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         static void deregisterStep(StepPosition position, StepFactory* stepFactory);
 
+        /**
+         * @brief Provides size of the cache of counted result rows.
+         * @param entries Filled with number of cached entries.
+         * @return Estimated number of bytes used by the cache.
+         */
+        static qint64 getCountCacheMemoryUsage(int& entries);
+
+        /**
+         * @brief Drops all cached numbers of result rows.
+         *
+         * Rows will be counted again on next execution of each query.
+         */
+        static void clearCountCache();
+
     private:
         /**
          * @brief Executes query.
@@ -1200,6 +1556,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool simpleExecIsSelect();
 
+        /**
+         * @brief Provides name of the step for the execution profile.
+         * @param step Executor step.
+         * @return Class name of the step, followed by its object name, if it has one.
+         */
+        static QString getStepName(QueryExecutorStep* step);
+
         /**
          * @brief Releases resources acquired during query execution.
          *
@@ -1222,8 +1585,95 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool handleRowCountingResults(quint32 asyncId, SqlQueryPtr results);
 
+        /**
+         * @brief Reads number of rows from counting query results.
+         * @param results Results from the counting query execution.
+         * @return true on success, or false if the counting query failed.
+         *
+         * Updates number of rows and pages in the context, caches counted number (if applicable)
+         * and emits resultsCountingFinished().
+         */
+        bool readCountingResults(SqlQueryPtr results);
+
         QStringList applyLimitForSimpleMethod(const QStringList &queries);
 
+        /**
+         * @brief Sets total number of result rows and number of pages.
+         * @param rows Number of rows.
+         * @param accuracy Accuracy of the number.
+         */
+        void setTotalRowsReturned(qint64 rows, CountAccuracy accuracy);
+
+        /**
+         * @brief Estimates number of result rows for plain table scans.
+         * @return true if the number was estimated, or false if the query is not a plain table scan, or estimation failed.
+         *
+         * See setCountingMode() for details.
+         */
+        bool estimateResults();
+
+        /**
+         * @brief Provides state of databases used by the query.
+         * @return String describing state of databases, or null string if the state could not be read.
+         *
+         * The state changes whenever data or schema in any of databases changes, no matter if it was changed
+         * by this or any other connection.
+         */
+        QString getDbStateForCountCache();
+
+        /**
+         * @brief Provides key under which counted rows are cached.
+         * @param dbState State of databases, as returned from getDbStateForCountCache().
+         * @return Cache key.
+         */
+        QString getCountCacheKey(const QString& dbState) const;
+
+        /**
+         * @brief Serializes query parameters of current execution.
+         * @return Parameters as a string, ordered by names.
+         */
+        QString getParamsForCacheKey() const;
+
+        /**
+         * @brief Remembers keyset paging boundary of the next page.
+         *
+         * Called after successful execution. Takes key values from the last row of the results.
+         * If the page was full, it also starts building the index of page boundaries (see buildKeysetIndex()).
+         */
+        void storeKeysetBoundary();
+
+        /**
+         * @brief Drops the current snapshot table.
+         *
+         * It expects #snapshotMutex to be locked already.
+         */
+        void dropSnapshotInternal();
+
+        /**
+         * @brief Tells if the result value could have been limited by QueryExecutorCellSize.
+         * @param alias Query executor alias of the column.
+         * @param value Value from the results.
+         * @return true if the value is possibly not complete, therefore cannot be used as a keyset boundary.
+         */
+        bool isKeysetValueLimited(const QString& alias, const QVariant& value) const;
+
+        /**
+         * @brief Starts asynchronous building of sparse page boundaries index.
+         *
+         * Executes query numbering all rows with row_number() window function and reading key values
+         * of the last row of every KEYSET_INDEX_PAGE_STEP-th page. Results are handled by handleKeysetIndexResults().
+         * Building is done once for given keyset paging state (see findKeysetBoundary()), only in asynchronous mode.
+         */
+        void buildKeysetIndex();
+
+        /**
+         * @brief Handles results of the page boundaries index query.
+         * @param asyncId Asynchronous ID of the execution.
+         * @param results Results from the query.
+         * @return true if the results were from index query, or false otherwise.
+         */
+        bool handleKeysetIndexResults(quint32 asyncId, SqlQueryPtr results);
+
         /**
          * @brief Creates instances of steps for all registered factories for given position.
          * @param position Position for which factories will be used.
@@ -1333,6 +1783,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool explainMode = false;
 
+        /**
+         * @brief Flag indicating that SQLite engine statistics are collected.
+         *
+         * See setEngineProfiling() for details.
+         */
+        bool engineProfiling = false;
+
         /**
          * @brief Flag indicating that the row counting was disabled.
          *
@@ -1371,6 +1828,120 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         quint32 resultsCountingAsyncId = 0;
 
+        /**
+         * @brief Method of counting result rows.
+         *
+         * See setCountingMode() for details.
+         */
+        CountingMode countingMode = CountingMode::EXACT;
+
+        /**
+         * @brief Maximum number of rows counted in CountingMode::LAZY.
+         */
+        qint64 lazyCountingLimit = 100000;
+
+        /**
+         * @brief Cache key of the currently running counting query.
+         *
+         * Empty if the counting results should not be cached.
+         */
+        QString countCacheKey;
+
+        /**
+         * @brief Flag indicating that the currently running counting query was cancelled.
+         */
+        bool resultsCountingCancelled = false;
+
+        /**
+         * @brief Limit of rows counted by the currently running counting query, or -1 if the query is not limited.
+         */
+        qint64 resultsCountingLimit = -1;
+
+        /**
+         * @brief Keyset paging enabled.
+         *
+         * See setKeysetPaging().
+         */
+        bool keysetPaging = false;
+
+        /**
+         * @brief Identifies query, parameters, page size and database state that keyset boundaries were collected for.
+         */
+        QString keysetKey;
+
+        /**
+         * @brief Known keyset paging boundaries.
+         *
+         * Keys are page indexes, values are key column values of the last row of the previous page.
+         */
+        QMap<int, QList<QVariant>> keysetBoundaries;
+
+        /**
+         * @brief Tells if the index of page boundaries was already requested for current #keysetKey.
+         */
+        bool keysetIndexRequested = false;
+
+        /**
+         * @brief Asynchronous ID of the page boundaries index query.
+         *
+         * It's 0 if the index is not being built.
+         */
+        quint32 keysetIndexAsyncId = 0;
+
+        /**
+         * @brief The #keysetKey that the index being built is for.
+         */
+        QString keysetIndexKey;
+
+        /**
+         * @brief Guards keyset paging state, which is accessed from executor and database threads.
+         */
+        QMutex keysetMutex;
+
+        /**
+         * @brief Number of pages between boundaries stored in the index built by buildKeysetIndex().
+         */
+        static const int KEYSET_INDEX_PAGE_STEP = 10;
+
+        /**
+         * @brief Snapshot mode enabled.
+         *
+         * See setSnapshotMode().
+         */
+        bool snapshotMode = false;
+
+        /**
+         * @brief Filter applied to snapshot rows.
+         *
+         * See setSnapshotFilter().
+         */
+        QString snapshotFilter;
+
+        /**
+         * @brief Name of the temporary table with the current snapshot, or null string if there's no snapshot.
+         */
+        QString snapshotTable;
+
+        /**
+         * @brief Identifies query and parameters that the current snapshot was taken for.
+         */
+        QString snapshotKey;
+
+        /**
+         * @brief Time when the current snapshot was taken.
+         */
+        QDateTime snapshotTime;
+
+        /**
+         * @brief Sequence used to name snapshot tables uniquely, as many executors can work on the same database.
+         */
+        static QAtomicInt snapshotSequence;
+
+        /**
+         * @brief Guards snapshot state, which is accessed from executor and main threads.
+         */
+        mutable QMutex snapshotMutex;
+
         /**
          * @brief Flag indicating results preloading.
          *
@@ -1453,6 +2024,19 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         static QHash<StepPosition, QList<StepFactory*>> additionalStatefulStepFactories;
 
+        /**
+         * @brief Cache of counted result rows.
+         *
+         * It's shared by all executors. Keys are provided by getCountCacheKey(), so entries become unused
+         * as soon as the database is modified. Least recently used entries are dropped when the cache is full.
+         */
+        static QCache<QString, qint64> countCache;
+
+        /**
+         * @brief Synchronizes access to the countCache.
+         */
+        static QMutex countCacheMutex;
+
         /**
          * @brief Execution results handler.
          *
@@ -1505,6 +2089,8 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          *
          * The counting query actually counts only \p rowsReturned, while \p rowsAffected and \p totalPages
          * are extracted from original query execution.
+         *
+         * The \p rowsReturned might be not exact, depending on the counting mode. Check getTotalRowsAccuracy() for that.
          */
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
 
@@ -1,5 +1,6 @@
 #include "queryexecutordatasources.h"
 #include "parser/ast/sqliteselect.h"
+#include "parser/ast/sqliteexpr.h"
 #include "selectresolver.h"
 
 bool QueryExecutorDataSources::exec()
@@ -31,5 +32,46 @@ bool QueryExecutorDataSources::exec()
         context->sourceTables << table;
     }
 
+    if (isPlainTableScan(select.data()))
+    {
+        SqliteSelect::Core::SingleSource* source = core->from->singleSource;
+        context->scannedTable = QueryExecutor::SourceTablePtr::create();
+        context->scannedTable->database = source->database;
+        context->scannedTable->table = source->table;
+        context->scannedTable->alias = source->alias;
+    }
+
+    return true;
+}
+
+bool QueryExecutorDataSources::isPlainTableScan(SqliteSelect* select)
+{
+    if (select->with)
+        return false;
+
+    SqliteSelect::Core* core = select->coreSelects.first();
+    if (core->where || core->having || !core->groupBy.isEmpty() || core->distinctKw || core->limit)
+        return false;
+
+    if (!core->from || !core->from->singleSource || !core->from->otherSources.isEmpty())
+        return false;
+
+    SqliteSelect::Core::SingleSource* source = core->from->singleSource;
+    if (source->table.isNull() || source->select || source->joinSource || !source->funcName.isNull())
+        return false;
+
+    // Aggregate functions would change number of rows. There's no cheap way to tell aggregate from other functions, so all are excluded.
+    for (SqliteSelect::Core::ResultColumn* resCol : core->resultColumns)
+    {
+        if (!resCol->expr)
+            continue;
+
+        for (SqliteExpr* expr : resCol->expr->getAllTypedStatements<SqliteExpr>())
+        {
+            if (expr->mode == SqliteExpr::Mode::FUNCTION)
+                return false;
+        }
+    }
+
     return true;
 }
@@ -12,6 +12,8 @@
  *
  * Source tables are tables that result columns come from. If there's multiple columns selected
  * from single table, only single table is resolved.
+ *
+ * If the query is a plain scan of a single table, the table is also stored in QueryExecutor::Context::scannedTable.
  */
 class QueryExecutorDataSources : public QueryExecutorStep
 {
@@ -19,6 +21,8 @@ class QueryExecutorDataSources : public QueryExecutorStep
     public:
         bool exec();
 
+    private:
+        bool isPlainTableScan(SqliteSelect* select);
 };
 
 #endif // QUERYEXECUTORDATASOURCES_H
@@ -17,6 +17,7 @@ bool QueryExecutorExecute::exec()
 //    qDebug() << "q:" << context->processedQuery;
 
     startTime = QDateTime::currentMSecsSinceEpoch();
+    timer.start();
     return executeQueries();
 }
 
@@ -43,13 +44,27 @@ bool QueryExecutorExecute::executeQueries()
         flags |= Db::Flag::PRELOAD;
 
     QString queryStr;
+    qint64 prepareStart;
+    SqliteQueryPtr lastQuery = context->parsedQueries.last();
     for (const SqliteQueryPtr& query : context->parsedQueries)
     {
         queryStr = query->detokenize();
         bindParamsForQuery = getBindParamsForQuery(query);
+        if (context->engineProfiling && query == lastQuery)
+        {
+            // Captured before execution, because the execution might change the schema.
+            if (!query->explain)
+                captureQueryPlan(queryStr, bindParamsForQuery);
+
+            flags |= Db::Flag::PROFILE;
+        }
+
+        prepareStart = timer.nsecsElapsed();
         results = db->prepare(queryStr);
         results->setArgs(bindParamsForQuery);
         results->setFlags(flags);
+        context->profile.prepareTime += (timer.nsecsElapsed() - prepareStart) / 1000;
+        context->profile.queryCount++;
 
         if (isBeginTransaction(query->queryType))
             rowsAffectedBeforeTransaction.push(context->rowsAffected);
@@ -89,6 +104,8 @@ void QueryExecutorExecute::handleSuccessfulResult(SqlQueryPtr results)
     }
 
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - startTime;
+    context->profile.firstRowTime = timer.nsecsElapsed() / 1000;
+    context->profile.rowsAffected = context->rowsAffected;
 
     // For PRAGMA and EXPLAIN we simply count results for rows returned
     SqliteQueryPtr lastQuery = context->parsedQueries.last();
@@ -117,6 +134,29 @@ void QueryExecutorExecute::handleFailResult(SqlQueryPtr results)
     }
 }
 
+void QueryExecutorExecute::captureQueryPlan(const QString& queryStr, const QHash<QString, QVariant>& bindParams)
+{
+    static_qstring(planTpl, "EXPLAIN QUERY PLAN %1");
+
+    SqlQueryPtr results = db->exec(planTpl.arg(queryStr), bindParams);
+    if (results->isError())
+    {
+        qDebug() << "Could not capture query plan for profiling:" << results->getErrorText();
+        return;
+    }
+
+    ExecutionProfile::PlanNode node;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        node.id = row->value("id").toInt();
+        node.parent = row->value("parent").toInt();
+        node.detail = row->value("detail").toString();
+        context->profile.plan << node;
+    }
+}
+
 QHash<QString, QVariant> QueryExecutorExecute::getBindParamsForQuery(SqliteQueryPtr query)
 {
     QHash<QString, QVariant> queryParams;
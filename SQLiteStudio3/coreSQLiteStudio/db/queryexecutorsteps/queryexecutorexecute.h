@@ -3,6 +3,7 @@
 
 #include "queryexecutorstep.h"
 #include <QHash>
+#include <QElapsedTimer>
 
 /**
  * @brief Executes query in current form.
@@ -74,11 +75,26 @@ class QueryExecutorExecute : public QueryExecutorStep
          */
         QHash<QString, QVariant> getBindParamsForQuery(SqliteQueryPtr query);
 
+        /**
+         * @brief Reads query plan of the query into the execution profile.
+         * @param queryStr Query to explain.
+         * @param bindParams Parameters for the query.
+         *
+         * Used only when engine profiling is enabled (see QueryExecutor::setEngineProfiling()).
+         * Failing to explain the query is not an error for the execution, the plan is just left empty then.
+         */
+        void captureQueryPlan(const QString& queryStr, const QHash<QString, QVariant>& bindParams);
+
         /**
          * @brief Number of milliseconds since 1970 at execution start moment.
          */
         qint64 startTime;
 
+        /**
+         * @brief Measures execution stages for the execution profile.
+         */
+        QElapsedTimer timer;
+
         bool isBeginTransaction(SqliteQueryType queryType);
         bool isCommitTransaction(SqliteQueryType queryType);
         bool isRollbackTransaction(SqliteQueryType queryType);
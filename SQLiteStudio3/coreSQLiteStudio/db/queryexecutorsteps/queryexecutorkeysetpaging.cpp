@@ -0,0 +1,127 @@
+#include "queryexecutorkeysetpaging.h"
+#include "parser/parser.h"
+#include <QDebug>
+
+bool QueryExecutorKeysetPaging::exec()
+{
+    if (!context->keysetPaging)
+        return true;
+
+    int page = queryExecutor->getPage();
+    if (page < 0)
+        return true; // no paging requested
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    if (select->tokens.size() < 1)
+        return true; // shouldn't happen, but if happens, leave gracefully
+
+    if (context->rowIdColumns.size() != 1)
+        return true; // rows cannot be identified by a single ROWID
+
+    for (const QueryExecutor::Sort& sort : queryExecutor->getSortOrder())
+    {
+        if (sort.column >= context->resultColumns.size())
+            return true;
+
+        context->keysetColumns << context->resultColumns[sort.column]->queryExecutorAlias;
+        context->keysetDescending << (sort.order == QueryExecutor::Sort::DESC);
+    }
+
+    // ROWID makes the order deterministic, even if sort columns have duplicated values
+    QStringList rowIdAliases = context->rowIdColumns.first()->queryExecutorAliasToColumn.keys();
+    rowIdAliases.sort();
+    for (const QString& alias : rowIdAliases)
+    {
+        context->keysetColumns << alias;
+        context->keysetDescending << false;
+    }
+
+    context->keysetQuery = select->detokenize();
+
+    QList<QVariant> keyValues;
+    int boundaryPage = queryExecutor->findKeysetBoundary(context->keysetQuery, page, keyValues);
+    if (boundaryPage < 0)
+    {
+        context->keysetColumns.clear();
+        context->keysetDescending.clear();
+        return true;
+    }
+
+    QStringList orderBy;
+    for (int i = 0, total = context->keysetColumns.size(); i < total; i++)
+        orderBy << (context->keysetColumns[i] + (context->keysetDescending[i] ? " DESC" : " ASC"));
+
+    QString where;
+    if (boundaryPage > 0)
+        where = " WHERE " + getBoundaryCondition(context->keysetColumns, context->keysetDescending, keyValues, context->queryParameters);
+
+    static_qstring(selectTpl, "SELECT * FROM (%1)%2 ORDER BY %3");
+    QString newSelect = selectTpl.arg(context->keysetQuery, where, orderBy.join(", "));
+
+    Parser parser;
+    if (!parser.parse(newSelect) || parser.getQueries().size() == 0)
+    {
+        qWarning() << "Could not parse SELECT after applying keyset paging. Tried to parse query:\n" << newSelect;
+        context->keysetColumns.clear();
+        context->keysetDescending.clear();
+        return true;
+    }
+
+    context->parsedQueries.removeLast();
+    context->parsedQueries << parser.getQueries().first();
+    context->keysetBoundaryPage = boundaryPage;
+
+    updateQueries();
+    return true;
+}
+
+QString QueryExecutorKeysetPaging::getBoundaryCondition(const QStringList& columns, const QList<bool>& descending, const QList<QVariant>& keyValues,
+                                                        QHash<QString, QVariant>& params)
+{
+    static_qstring(paramTpl, ":sqlitestudio_keyset_%1");
+
+    QStringList paramNames;
+    bool hasNull = false;
+    for (int i = 0, total = keyValues.size(); i < total; i++)
+    {
+        paramNames << paramTpl.arg(i);
+        params[paramNames.last()] = keyValues[i];
+        if (keyValues[i].isNull())
+            hasNull = true;
+    }
+
+    // Row value comparison can use indexes, but it works only for ascending order and non-null boundary values.
+    if (!hasNull && !descending.contains(true))
+        return "(" + columns.join(", ") + ") > (" + paramNames.join(", ") + ")";
+
+    // Otherwise: (k1 > b1) OR (k1 IS b1 AND k2 > b2) OR ..., where NULL is lower than any other value.
+    QStringList alternatives;
+    QStringList equalPrefix;
+    for (int i = 0, total = keyValues.size(); i < total; i++)
+    {
+        const QString& col = columns[i];
+        QString following;
+        if (descending[i])
+        {
+            if (!keyValues[i].isNull()) // nothing follows NULL in descending order
+                following = "(" + col + " < " + paramNames[i] + " OR " + col + " IS NULL)";
+        }
+        else
+        {
+            following = keyValues[i].isNull() ? (col + " IS NOT NULL") : (col + " > " + paramNames[i]);
+        }
+
+        if (!following.isNull())
+            alternatives << "(" + QStringList(equalPrefix + QStringList({following})).join(" AND ") + ")";
+
+        equalPrefix << (col + " IS " + paramNames[i]);
+    }
+
+    if (alternatives.isEmpty())
+        return "0";
+
+    return alternatives.join(" OR ");
+}
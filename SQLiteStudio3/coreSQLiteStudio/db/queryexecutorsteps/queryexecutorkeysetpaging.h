@@ -0,0 +1,43 @@
+#ifndef QUERYEXECUTORKEYSETPAGING_H
+#define QUERYEXECUTORKEYSETPAGING_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Seeks to the requested page using known page boundaries.
+ *
+ * Applies only if keyset paging is enabled (QueryExecutor::setKeysetPaging()) and the SELECT
+ * has exactly one ROWID data source, so every row is identified by the sort columns and the ROWID.
+ *
+ * The SELECT is wrapped with another SELECT, which orders rows by sort columns followed by ROWID columns
+ * (so the order is always deterministic). If the executor knows the boundary (key values of the last row
+ * of the previous page) for the requested page, or for any page before it, the wrapping SELECT also gets
+ * the WHERE clause skipping all rows up to that boundary. This way the QueryExecutorLimit step needs
+ * to apply only the OFFSET relative to the boundary page, instead of the OFFSET from the begining of results.
+ *
+ * Boundary values are bound as additional query parameters.
+ *
+ * The step has to be executed before QueryExecutorCellSize, so it compares full values, not limited ones.
+ */
+class API_EXPORT QueryExecutorKeysetPaging : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+
+        /**
+         * @brief Builds condition for rows that follow the boundary.
+         * @param columns Key columns, in order of sorting.
+         * @param descending Sort direction of each key column (true for descending order).
+         * @param keyValues Boundary values of key columns.
+         * @param params Query parameters, which get boundary values bound to parameters used in the condition.
+         * @return WHERE clause expression.
+         *
+         * Expression respects SQLite's ordering of NULL values (they are the smallest values).
+         */
+        static QString getBoundaryCondition(const QStringList& columns, const QList<bool>& descending, const QList<QVariant>& keyValues,
+                                            QHash<QString, QVariant>& params);
+};
+
+#endif // QUERYEXECUTORKEYSETPAGING_H
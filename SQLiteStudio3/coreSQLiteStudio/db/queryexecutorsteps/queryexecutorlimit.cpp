@@ -17,6 +17,8 @@ bool QueryExecutorLimit::exec()
 
     quint64 limit = queryExecutor->getResultsPerPage();
     quint64 offset = limit * page;
+    if (context->keysetBoundaryPage > -1) // rows before the boundary page are already skipped by QueryExecutorKeysetPaging
+        offset = limit * (page - context->keysetBoundaryPage);
 
     // The original query is last, so if it contained any %N strings,
     // they won't be replaced.
@@ -10,6 +10,9 @@
  * and QueryExecutor::Context::setResultsPerPage), then the SELECT query
  * is wrapped with another SELECT which defines it's own LIMIT and OFFSET
  * basing on the page and the results per page parameters.
+ *
+ * If QueryExecutorKeysetPaging step already skipped rows up to some page boundary,
+ * the OFFSET is counted from that boundary.
  */
 class QueryExecutorLimit : public QueryExecutorStep
 {
@@ -25,6 +25,7 @@ bool QueryExecutorParseQuery::exec()
 
     // Do parsing
     context->parsedQueries.clear();
+    context->profile.parseCount++;
     parser->parse(context->processedQuery);
     if (parser->getErrors().size() > 0)
     {
@@ -0,0 +1,101 @@
+#include "queryexecutorsnapshot.h"
+#include "parser/parser.h"
+#include "db/sqlquery.h"
+#include "common/utils_sql.h"
+#include <QCryptographicHash>
+#include <QDebug>
+
+bool QueryExecutorSnapshot::exec()
+{
+    if (!context->snapshotMode)
+        return true;
+
+    if (context->parsedQueries.size() != 1)
+        return true; // snapshots are made only for single SELECT
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    if (select->tokens.size() < 1)
+        return true; // shouldn't happen, but if happens, leave gracefully
+
+    QString table = queryExecutor->getSnapshot(select->detokenize(), getBindParams(select));
+    if (table.isNull())
+    {
+        qWarning() << "Could not create snapshot of query results. Executing query without snapshot.";
+        return true;
+    }
+
+    QueryExecutor::SortList sortOrder = queryExecutor->getSortOrder();
+    if (sortOrder.size() > 0)
+        createSortIndex(table);
+
+    QString newSelect = QString("SELECT * FROM temp.%1").arg(table);
+    QString filter = queryExecutor->getSnapshotFilter();
+    if (!filter.isEmpty())
+        newSelect += QString(" WHERE %1").arg(getFilterCondition(table, filter));
+
+    // ROWID of the snapshot is the ordinal number of the row in original results
+    if (sortOrder.size() == 0)
+        newSelect += " ORDER BY rowid";
+
+    Parser parser;
+    if (!parser.parse(newSelect) || parser.getQueries().size() == 0)
+    {
+        qWarning() << "Could not parse SELECT reading from snapshot. Tried to parse query:\n" << newSelect;
+        return false;
+    }
+
+    context->parsedQueries.removeLast();
+    context->parsedQueries << parser.getQueries().first();
+    context->snapshotResults = true;
+
+    updateQueries();
+    return true;
+}
+
+void QueryExecutorSnapshot::createSortIndex(const QString& table)
+{
+    static_qstring(indexTpl, "CREATE INDEX IF NOT EXISTS temp.%1_sort_%2 ON %1 (%3);");
+
+    QStringList columns;
+    for (const QueryExecutor::Sort& sort : queryExecutor->getSortOrder())
+    {
+        if (sort.column >= context->resultColumns.size())
+            return; // QueryExecutorOrder will report it
+
+        columns << context->resultColumns[sort.column]->queryExecutorAlias + (sort.order == QueryExecutor::Sort::DESC ? " DESC" : "");
+    }
+
+    QString columnsStr = columns.join(", ");
+    QString hash = QCryptographicHash::hash(columnsStr.toUtf8(), QCryptographicHash::Md5).toHex().left(12);
+    SqlQueryPtr results = db->exec(indexTpl.arg(table, hash, columnsStr));
+    if (results->isError())
+        qWarning() << "Could not create sort index in snapshot:" << results->getErrorText();
+}
+
+QString QueryExecutorSnapshot::getFilterCondition(const QString& table, const QString& filter)
+{
+    static_qstring(conditionTpl, "rowid IN (SELECT sqlitestudio_snapshot_row FROM (SELECT rowid AS sqlitestudio_snapshot_row, %1 FROM temp.%2) WHERE %3)");
+    static_qstring(columnTpl, "%1 AS %2");
+
+    // Filter refers to columns by names visible to the user, not by aliases used in the snapshot
+    QStringList columns;
+    for (const QueryExecutor::ResultColumnPtr& resCol : context->resultColumns)
+        columns << columnTpl.arg(resCol->queryExecutorAlias, wrapObjIfNeeded(resCol->displayName));
+
+    return conditionTpl.arg(columns.join(", "), table, filter);
+}
+
+QHash<QString, QVariant> QueryExecutorSnapshot::getBindParams(SqliteSelectPtr select)
+{
+    QHash<QString, QVariant> queryParams;
+    QStringList bindParams = select->tokens.filter(Token::BIND_PARAM).toValueList();
+    for (const QString& bindParam : bindParams)
+    {
+        if (context->queryParameters.contains(bindParam))
+            queryParams.insert(bindParam, context->queryParameters[bindParam]);
+    }
+    return queryParams;
+}
@@ -0,0 +1,38 @@
+#ifndef QUERYEXECUTORSNAPSHOT_H
+#define QUERYEXECUTORSNAPSHOT_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Replaces the SELECT with reading from the snapshot of its results.
+ *
+ * Applies only if snapshot mode is enabled (QueryExecutor::setSnapshotMode()) and there is a single SELECT
+ * to execute. The SELECT (already with all result and ROWID columns provided by QueryExecutorColumns)
+ * is materialized once into a temporary table (see QueryExecutor::getSnapshot()) and then replaced with
+ * a SELECT from that table, so following steps (ordering, counting, paging) work on the snapshot instead
+ * of executing the original query again.
+ *
+ * Rows are read in the order they were inserted into the snapshot, unless the sort order is defined.
+ * In that case an index for the sort columns is created in the snapshot, so the QueryExecutorOrder step
+ * doesn't need to sort all rows for every page.
+ *
+ * The snapshot filter (QueryExecutor::setSnapshotFilter()) is applied as the WHERE clause. Since snapshot columns
+ * are named with query executor aliases, the filter is evaluated against a subquery exposing result columns
+ * under their display names.
+ *
+ * If the snapshot could not be created, the query is executed as usual.
+ */
+class QueryExecutorSnapshot : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+
+    private:
+        void createSortIndex(const QString& table);
+        QString getFilterCondition(const QString& table, const QString& filter);
+        QHash<QString, QVariant> getBindParams(SqliteSelectPtr select);
+};
+
+#endif // QUERYEXECUTORSNAPSHOT_H
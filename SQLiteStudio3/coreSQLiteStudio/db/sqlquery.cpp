@@ -71,6 +71,11 @@ QVariant SqlQuery::getSingleCell()
     return row->value(0);
 }
 
+EngineStats SqlQuery::getEngineStats()
+{
+    return engineStats;
+}
+
 bool SqlQuery::isError()
 {
     return getErrorCode() != 0;
@@ -4,6 +4,7 @@
 #include "coreSQLiteStudio_global.h"
 #include "db/db.h"
 #include "db/sqlresultsrow.h"
+#include "db/enginestats.h"
 #include <QList>
 #include <QSharedPointer>
 
@@ -176,6 +177,17 @@ class API_EXPORT SqlQuery
          */
         virtual QVariant getSingleCell();
 
+        /**
+         * @brief Provides engine counters of the statement.
+         * @return Statistics collected so far.
+         *
+         * Statistics are collected only if the query was executed with Db::Flag::PROFILE and only by Db implementations
+         * that support it (SQLite 3 based ones). Otherwise EngineStats::collected is false.
+         *
+         * Counters are cumulative for the statement, so they are complete once all rows were read.
+         */
+        virtual EngineStats getEngineStats();
+
         /**
          * @brief Tells if there was an error while query execution.
          * @return true if there was an error, false otherwise.
@@ -304,6 +316,11 @@ class API_EXPORT SqlQuery
 
         int affected = 0;
 
+        /**
+         * @brief Engine counters collected by the implementation.
+         */
+        EngineStats engineStats;
+
         QString query;
         QVariant queryArgs;
         Db::Flags flags;
@@ -1,6 +1,18 @@
 #ifndef STDSQLITE3DRIVER_H
 #define STDSQLITE3DRIVER_H
 
+// Scan status API exists only in SQLite libraries compiled with SQLITE_ENABLE_STMT_SCANSTATUS,
+// so it's linked only if SQLiteStudio is built with the same define.
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+#define STD_SQLITE3_SCANSTATUS(Prefix) \
+        static const bool SCANSTATUS_SUPPORTED = true; \
+        static int stmt_scanstatus(stmt* a1, int a2, int a3, void* a4) {return Prefix##sqlite3_stmt_scanstatus(a1, a2, a3, a4);}
+#else
+#define STD_SQLITE3_SCANSTATUS(Prefix) \
+        static const bool SCANSTATUS_SUPPORTED = false; \
+        static int stmt_scanstatus(stmt*, int, int, void*) {return 1;}
+#endif
+
 #define STD_SQLITE3_DRIVER(Name, Label, Prefix, UppercasePrefix) \
     struct API_EXPORT Name \
     { \
@@ -10,6 +22,7 @@
         static const int ERROR = UppercasePrefix##SQLITE_ERROR; \
         static const int OPEN_READWRITE = UppercasePrefix##SQLITE_OPEN_READWRITE; \
         static const int OPEN_CREATE = UppercasePrefix##SQLITE_OPEN_CREATE; \
+        static const int OPEN_READONLY = UppercasePrefix##SQLITE_OPEN_READONLY; \
         static const int UTF8 = UppercasePrefix##SQLITE_UTF8; \
         static const int DETERMINISTIC = UppercasePrefix##SQLITE_DETERMINISTIC; \
         static const int INTEGER = UppercasePrefix##SQLITE_INTEGER; \
@@ -18,8 +31,28 @@
         static const int BLOB = UppercasePrefix##SQLITE_BLOB; \
         static const int MISUSE = UppercasePrefix##SQLITE_MISUSE; \
         static const int BUSY = UppercasePrefix##SQLITE_BUSY; \
+        static const int LOCKED = UppercasePrefix##SQLITE_LOCKED; \
         static const int ROW = UppercasePrefix##SQLITE_ROW; \
         static const int DONE = UppercasePrefix##SQLITE_DONE; \
+        static const int STMTSTATUS_FULLSCAN_STEP = UppercasePrefix##SQLITE_STMTSTATUS_FULLSCAN_STEP; \
+        static const int STMTSTATUS_SORT = UppercasePrefix##SQLITE_STMTSTATUS_SORT; \
+        static const int STMTSTATUS_AUTOINDEX = UppercasePrefix##SQLITE_STMTSTATUS_AUTOINDEX; \
+        static const int STMTSTATUS_VM_STEP = UppercasePrefix##SQLITE_STMTSTATUS_VM_STEP; \
+        static const int STMTSTATUS_REPREPARE = UppercasePrefix##SQLITE_STMTSTATUS_REPREPARE; \
+        static const int STMTSTATUS_MEMUSED = UppercasePrefix##SQLITE_STMTSTATUS_MEMUSED; \
+        static const int SCANSTAT_NLOOP = UppercasePrefix##SQLITE_SCANSTAT_NLOOP; \
+        static const int SCANSTAT_NVISIT = UppercasePrefix##SQLITE_SCANSTAT_NVISIT; \
+        static const int SCANSTAT_EST = UppercasePrefix##SQLITE_SCANSTAT_EST; \
+        static const int SCANSTAT_NAME = UppercasePrefix##SQLITE_SCANSTAT_NAME; \
+        static const int SCANSTAT_EXPLAIN = UppercasePrefix##SQLITE_SCANSTAT_EXPLAIN; \
+        static const int SCANSTAT_SELECTID = UppercasePrefix##SQLITE_SCANSTAT_SELECTID; \
+        static const int DBSTATUS_LOOKASIDE_USED = UppercasePrefix##SQLITE_DBSTATUS_LOOKASIDE_USED; \
+        static const int DBSTATUS_CACHE_USED = UppercasePrefix##SQLITE_DBSTATUS_CACHE_USED; \
+        static const int DBSTATUS_SCHEMA_USED = UppercasePrefix##SQLITE_DBSTATUS_SCHEMA_USED; \
+        static const int DBSTATUS_STMT_USED = UppercasePrefix##SQLITE_DBSTATUS_STMT_USED; \
+        static const int DBSTATUS_CACHE_HIT = UppercasePrefix##SQLITE_DBSTATUS_CACHE_HIT; \
+        static const int DBSTATUS_CACHE_MISS = UppercasePrefix##SQLITE_DBSTATUS_CACHE_MISS; \
+        static const int DBSTATUS_CACHE_WRITE = UppercasePrefix##SQLITE_DBSTATUS_CACHE_WRITE; \
         \
         typedef Prefix##sqlite3 handle; \
         typedef Prefix##sqlite3_stmt stmt; \
@@ -27,6 +60,8 @@
         typedef Prefix##sqlite3_value value; \
         typedef Prefix##sqlite3_int64 int64; \
         typedef Prefix##sqlite3_destructor_type destructor_type; \
+        typedef Prefix##sqlite3_blob blob; \
+        typedef Prefix##sqlite3_backup backup; \
         \
         static destructor_type TRANSIENT() {return UppercasePrefix##SQLITE_TRANSIENT;} \
         static void interrupt(handle* arg) {Prefix##sqlite3_interrupt(arg);} \
@@ -73,6 +108,10 @@
         static int64 last_insert_rowid(handle* arg) {return Prefix##sqlite3_last_insert_rowid(arg);} \
         static int step(stmt* arg) {return Prefix##sqlite3_step(arg);} \
         static int reset(stmt* arg) {return Prefix##sqlite3_reset(arg);} \
+        static int stmt_status(stmt* a1, int a2, int a3) {return Prefix##sqlite3_stmt_status(a1, a2, a3);} \
+        STD_SQLITE3_SCANSTATUS(Prefix) \
+        static int db_status(handle* a1, int a2, int* a3, int* a4, int a5) {return Prefix##sqlite3_db_status(a1, a2, a3, a4, a5);} \
+        static int db_release_memory(handle* arg) {return Prefix##sqlite3_db_release_memory(arg);} \
         static int close(handle* arg) {return Prefix##sqlite3_close(arg);} \
         static void free(void* arg) {return Prefix##sqlite3_free(arg);} \
         static int enable_load_extension(handle* arg1, int arg2) {return Prefix##sqlite3_enable_load_extension(arg1, arg2);} \
@@ -88,6 +127,18 @@
         static int create_collation_v2(handle* a1, const char *a2, int a3, void *a4, int(*a5)(void*,int,const void*,int,const void*), void(*a6)(void*)) \
             {return Prefix##sqlite3_create_collation_v2(a1, a2, a3, a4, a5, a6);} \
         static int complete(const char* arg) {return Prefix##sqlite3_complete(arg);} \
+        static int blob_open(handle* a1, const char* a2, const char* a3, const char* a4, int64 a5, int a6, blob** a7) \
+            {return Prefix##sqlite3_blob_open(a1, a2, a3, a4, a5, a6, a7);} \
+        static int blob_reopen(blob* a1, int64 a2) {return Prefix##sqlite3_blob_reopen(a1, a2);} \
+        static int blob_close(blob* arg) {return Prefix##sqlite3_blob_close(arg);} \
+        static int blob_bytes(blob* arg) {return Prefix##sqlite3_blob_bytes(arg);} \
+        static int blob_read(blob* a1, void* a2, int a3, int a4) {return Prefix##sqlite3_blob_read(a1, a2, a3, a4);} \
+        static int blob_write(blob* a1, const void* a2, int a3, int a4) {return Prefix##sqlite3_blob_write(a1, a2, a3, a4);} \
+        static backup* backup_init(handle* a1, const char* a2, handle* a3, const char* a4) {return Prefix##sqlite3_backup_init(a1, a2, a3, a4);} \
+        static int backup_step(backup* a1, int a2) {return Prefix##sqlite3_backup_step(a1, a2);} \
+        static int backup_finish(backup* arg) {return Prefix##sqlite3_backup_finish(arg);} \
+        static int backup_remaining(backup* arg) {return Prefix##sqlite3_backup_remaining(arg);} \
+        static int backup_pagecount(backup* arg) {return Prefix##sqlite3_backup_pagecount(arg);} \
     };
 
 #endif // STDSQLITE3DRIVER_H
@@ -0,0 +1,107 @@
+#include "dbbackup.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include <QFile>
+#include <QFileInfo>
+
+DbBackup::DbBackup(Db* db, const QString& filePath, QObject* parent) :
+    QObject(parent), db(db), filePath(filePath)
+{
+}
+
+bool DbBackup::exec()
+{
+    errorText.clear();
+    interrupted = false;
+
+    if (!db->isOpen())
+    {
+        errorText = tr("Database %1 has to be open to copy it.").arg(db->getName());
+        return false;
+    }
+
+    if (QFileInfo(filePath).absoluteFilePath() == QFileInfo(db->getPath()).absoluteFilePath())
+    {
+        errorText = tr("Cannot copy database %1 into its own file.").arg(db->getName());
+        return false;
+    }
+
+    // VACUUM INTO requires new file and the backup API requires valid database file (if it exists)
+    if (QFile::exists(filePath) && !QFile::remove(filePath))
+    {
+        errorText = tr("Could not overwrite file %1.").arg(filePath);
+        return false;
+    }
+
+    if (mode == Mode::VACUUM_INTO)
+    {
+        SqlQueryPtr results = db->exec("VACUUM INTO ?", {filePath});
+        if (results->isError())
+        {
+            errorText = isInterrupted() ? tr("Copying was cancelled.") : tr("Could not copy database %1: %2").arg(db->getName(), results->getErrorText());
+            QFile::remove(filePath);
+            return false;
+        }
+        return true;
+    }
+
+    bool res = db->backupTo(filePath, pagesPerStep, pauseMs, [this](int copiedPages, int totalPages) -> bool
+    {
+        emit progress(copiedPages, totalPages);
+        return !isInterrupted();
+    });
+
+    if (!res)
+        errorText = tr("Could not copy database %1: %2").arg(db->getName(), db->getErrorText());
+
+    return res;
+}
+
+void DbBackup::interrupt()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = true;
+    if (mode == Mode::VACUUM_INTO)
+        db->interrupt();
+}
+
+DbBackup::Mode DbBackup::getMode() const
+{
+    return mode;
+}
+
+void DbBackup::setMode(Mode value)
+{
+    mode = value;
+}
+
+int DbBackup::getPagesPerStep() const
+{
+    return pagesPerStep;
+}
+
+void DbBackup::setPagesPerStep(int value)
+{
+    pagesPerStep = value;
+}
+
+int DbBackup::getPauseMs() const
+{
+    return pauseMs;
+}
+
+void DbBackup::setPauseMs(int value)
+{
+    pauseMs = value;
+}
+
+QString DbBackup::getErrorText() const
+{
+    return errorText;
+}
+
+bool DbBackup::isInterrupted()
+{
+    QMutexLocker locker(&interruptMutex);
+    return interrupted;
+}
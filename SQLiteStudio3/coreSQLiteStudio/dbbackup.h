@@ -0,0 +1,86 @@
+#ifndef DBBACKUP_H
+#define DBBACKUP_H
+
+#include "coreSQLiteStudio_global.h"
+#include "interruptable.h"
+#include <QObject>
+#include <QMutex>
+
+class Db;
+
+/**
+ * @brief Creates a copy of the database file, while the database is in use.
+ *
+ * There are two modes of copying:
+ * <ul>
+ * <li>Mode::BACKUP - uses SQLite online backup API (see Db::backupTo()). Pages are copied in batches
+ * and the database is available for other readers and writers between batches. The copy is an exact
+ * page-by-page copy, including the encryption (for drivers supporting it). This is the fastest way.</li>
+ * <li>Mode::VACUUM_INTO - uses <tt>VACUUM INTO</tt> statement. The copy is compacted (free pages
+ * are dropped and tables and indexes are defragmented), so it can be much smaller, but it takes longer
+ * and no progress is reported.</li>
+ * </ul>
+ *
+ * The exec() blocks until the copy is done, so it's best to call it from a separate thread.
+ * The progress() signal is emitted from that thread.
+ */
+class API_EXPORT DbBackup : public QObject, public Interruptable
+{
+        Q_OBJECT
+
+    public:
+        enum class Mode
+        {
+            BACKUP,
+            VACUUM_INTO
+        };
+
+        /**
+         * @brief Creates backup of the database.
+         * @param db Database to copy.
+         * @param filePath Path of the copy. Existing file is overwritten.
+         * @param parent Parent object.
+         */
+        DbBackup(Db* db, const QString& filePath, QObject* parent = nullptr);
+
+        /**
+         * @brief Copies the database.
+         * @return true on success, or false on failure (see getErrorText()), or if it was interrupted.
+         */
+        bool exec();
+
+        void interrupt();
+
+        Mode getMode() const;
+        void setMode(Mode value);
+
+        int getPagesPerStep() const;
+        void setPagesPerStep(int value);
+
+        int getPauseMs() const;
+        void setPauseMs(int value);
+
+        QString getErrorText() const;
+
+    private:
+        bool isInterrupted();
+
+        Db* db = nullptr;
+        QString filePath;
+        Mode mode = Mode::BACKUP;
+        int pagesPerStep = 1000;
+        int pauseMs = 10;
+        QString errorText;
+        bool interrupted = false;
+        QMutex interruptMutex;
+
+    signals:
+        /**
+         * @brief Emitted after each batch of pages copied in Mode::BACKUP.
+         * @param copiedPages Number of pages copied so far.
+         * @param totalPages Total number of pages in the database.
+         */
+        void progress(int copiedPages, int totalPages);
+};
+
+#endif // DBBACKUP_H
@@ -0,0 +1,743 @@
+#include "dbdiff.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/utils_sql.h"
+#include <QCryptographicHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
+
+DbDiff::DbDiff(Db* srcDb, Db* dstDb) :
+    srcDb(srcDb), dstDb(dstDb)
+{
+}
+
+bool DbDiff::compare()
+{
+    tablesToCompare.clear();
+    tableDiffs.clear();
+    schemaDifferences.clear();
+    dropStatements.clear();
+    createTableStatements.clear();
+    createOtherStatements.clear();
+    dataStatementCount = 0;
+    errorText.clear();
+    interrupted = false;
+
+    if (!srcDb->isOpen() || !dstDb->isOpen())
+    {
+        errorText = QObject::tr("Both databases have to be open to compare them.", "db diff");
+        return false;
+    }
+
+    if (!openDataFile() || !compareSchema())
+        return false;
+
+    for (Table& table : tablesToCompare)
+    {
+        if (!compareData(table))
+            return false;
+    }
+
+    if (dataStream.status() != QDataStream::Ok || !dataFile.flush())
+    {
+        errorText = QObject::tr("Could not write synchronization script to temporary file: %1", "db diff").arg(dataFile.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool DbDiff::apply()
+{
+    if (getStatementCount() == 0)
+        return true;
+
+    if (!dstDb->begin())
+    {
+        errorText = QObject::tr("Could not start transaction on database %1: %2", "db diff").arg(dstDb->getName(), dstDb->getErrorText());
+        return false;
+    }
+
+    dstDb->exec("PRAGMA defer_foreign_keys = 1;");
+
+    bool ok = forEachStatement([this](const QString& statement)
+    {
+        SqlQueryPtr results = dstDb->exec(statement);
+        if (!results->isError())
+            return true;
+
+        errorText = QObject::tr("Could not synchronize database %1: %2\nStatement: %3", "db diff")
+                .arg(dstDb->getName(), results->getErrorText(), statement);
+        return false;
+    });
+
+    if (!ok)
+    {
+        dstDb->rollback();
+        return false;
+    }
+
+    if (!dstDb->commit())
+    {
+        errorText = QObject::tr("Could not commit changes in database %1: %2", "db diff").arg(dstDb->getName(), dstDb->getErrorText());
+        dstDb->rollback();
+        return false;
+    }
+
+    return true;
+}
+
+void DbDiff::interrupt()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = true;
+    srcDb->interrupt();
+    dstDb->interrupt();
+}
+
+const QList<DbDiff::TableDiff>& DbDiff::getTableDiffs() const
+{
+    return tableDiffs;
+}
+
+const QStringList& DbDiff::getSchemaDifferences() const
+{
+    return schemaDifferences;
+}
+
+qint64 DbDiff::getStatementCount() const
+{
+    return dropStatements.size() + createTableStatements.size() + dataStatementCount + createOtherStatements.size();
+}
+
+bool DbDiff::writeScript(QIODevice* output)
+{
+    QTextStream stream(output);
+    stream.setCodec("UTF-8");
+    bool ok = forEachStatement([&stream](const QString& statement)
+    {
+        stream << statement << "\n";
+        return stream.status() == QTextStream::Ok;
+    });
+
+    stream.flush();
+    if (ok && stream.status() == QTextStream::Ok)
+        return true;
+
+    if (errorText.isEmpty())
+        errorText = QObject::tr("Could not write synchronization script: %1", "db diff").arg(output->errorString());
+
+    return false;
+}
+
+QString DbDiff::getErrorText() const
+{
+    return errorText;
+}
+
+bool DbDiff::loadObjects(Db* db, QHash<QString, Object>& objects, QStringList& order)
+{
+    SqlQueryPtr results = db->exec("SELECT type, name, sql FROM sqlite_master WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite_%' ORDER BY rowid");
+    if (results->isError())
+    {
+        errorText = QObject::tr("Could not read schema of database %1: %2", "db diff").arg(db->getName(), results->getErrorText());
+        return false;
+    }
+
+    SqlResultsRowPtr row;
+    Object object;
+    while (results->hasNext())
+    {
+        row = results->next();
+        object.type = row->value("type").toString();
+        object.name = row->value("name").toString();
+        object.ddl = row->value("sql").toString();
+        objects[object.name.toLower()] = object;
+        order << object.name.toLower();
+    }
+    return true;
+}
+
+bool DbDiff::loadColumns(Db* db, Table& table)
+{
+    static_qstring(pragmaTpl, "PRAGMA table_info(%1)");
+
+    SqlQueryPtr results = db->exec(pragmaTpl.arg(wrapObjIfNeeded(table.name)));
+    if (results->isError())
+    {
+        errorText = QObject::tr("Could not read columns of table %1 in database %2: %3", "db diff")
+                .arg(table.name, db->getName(), results->getErrorText());
+        return false;
+    }
+
+    QMap<int, QString> primaryKey;
+    bool nullable = false;
+    bool integerKey = false;
+    SqlResultsRowPtr row;
+    table.columns.clear();
+    while (results->hasNext())
+    {
+        row = results->next();
+        table.columns << row->value("name").toString();
+        if (row->value("pk").toInt() == 0)
+            continue;
+
+        primaryKey[row->value("pk").toInt()] = table.columns.last();
+        integerKey = (row->value("type").toString().toUpper() == "INTEGER");
+
+        // Primary key columns of WITHOUT ROWID table are reported as NOT NULL
+        if (!row->value("notnull").toBool())
+            nullable = true;
+    }
+
+    table.rowIdKey = primaryKey.isEmpty();
+    table.keyColumns = table.rowIdKey ? QStringList({"rowid"}) : primaryKey.values();
+    table.keyExprs = wrapObjNamesIfNeeded(table.keyColumns);
+
+    // INTEGER PRIMARY KEY is an alias for ROWID and it's never NULL.
+    // Otherwise rows with NULL in the key get their ROWID as an additional key column.
+    table.nullableKey = nullable && !(primaryKey.size() == 1 && integerKey);
+    if (table.nullableKey)
+    {
+        QStringList nullChecks;
+        for (const QString& key : table.keyExprs)
+            nullChecks << (key + " IS NULL");
+
+        table.keyExprs << ("CASE WHEN " + nullChecks.join(" OR ") + " THEN rowid END");
+    }
+    return true;
+}
+
+bool DbDiff::compareSchema()
+{
+    QHash<QString, Object> srcObjects;
+    QHash<QString, Object> dstObjects;
+    QStringList srcOrder;
+    QStringList dstOrder;
+    if (!loadObjects(srcDb, srcObjects, srcOrder) || !loadObjects(dstDb, dstObjects, dstOrder))
+        return false;
+
+    static_qstring(dropTpl, "DROP %1 IF EXISTS %2;");
+    for (const QString& key : srcOrder)
+    {
+        const Object& src = srcObjects[key];
+        bool isTable = (src.type == "table");
+        bool isVirtual = isTable && src.ddl.trimmed().startsWith("CREATE VIRTUAL", Qt::CaseInsensitive);
+
+        Table table;
+        table.name = src.name;
+        if (isTable && !loadColumns(srcDb, table))
+            return false;
+
+        if (!dstObjects.contains(key))
+        {
+            schemaDifferences << QObject::tr("%1 exists only in the source database.", "db diff").arg(src.name);
+            if (isTable)
+            {
+                createTableStatements << (src.ddl + ";");
+                table.existsInDst = false;
+                if (!isVirtual)
+                    tablesToCompare << table;
+            }
+            else
+            {
+                createOtherStatements << (src.ddl + ";");
+            }
+            continue;
+        }
+
+        const Object& dst = dstObjects[key];
+        bool sameDdl = (src.type == dst.type && src.ddl.simplified() == dst.ddl.simplified());
+        if (isTable && dst.type == "table" && !sameDdl)
+        {
+            Table dstTable;
+            dstTable.name = dst.name;
+            if (!loadColumns(dstDb, dstTable))
+                return false;
+
+            if (dstTable.columns != table.columns || dstTable.keyColumns != table.keyColumns)
+            {
+                schemaDifferences << QObject::tr("Table %1 has different columns in both databases. It will not be synchronized.", "db diff").arg(src.name);
+                continue;
+            }
+
+            schemaDifferences << QObject::tr("Table %1 has different definition in both databases, but the same columns. Only its data will be synchronized.", "db diff")
+                                 .arg(src.name);
+            sameDdl = true;
+        }
+
+        if (!sameDdl)
+        {
+            schemaDifferences << QObject::tr("%1 is different in both databases.", "db diff").arg(src.name);
+            dropStatements << dropTpl.arg(dst.type.toUpper(), wrapObjIfNeeded(dst.name));
+            if (isTable)
+            {
+                createTableStatements << (src.ddl + ";");
+                table.existsInDst = false;
+            }
+            else
+            {
+                createOtherStatements << (src.ddl + ";");
+            }
+        }
+
+        if (isTable && !isVirtual)
+            tablesToCompare << table;
+    }
+
+    for (const QString& key : dstOrder)
+    {
+        if (srcObjects.contains(key))
+            continue;
+
+        const Object& dst = dstObjects[key];
+        schemaDifferences << QObject::tr("%1 exists only in the target database.", "db diff").arg(dst.name);
+
+        // Tables are dropped as the last ones, as they take their indexes and triggers with them
+        if (dst.type == "table")
+            dropStatements << dropTpl.arg(dst.type.toUpper(), wrapObjIfNeeded(dst.name));
+        else
+            dropStatements.prepend(dropTpl.arg(dst.type.toUpper(), wrapObjIfNeeded(dst.name)));
+    }
+    return true;
+}
+
+bool DbDiff::compareData(Table& table)
+{
+    QList<Chunk> srcChunks;
+    QList<Chunk> dstChunks;
+    QString srcError;
+    QString dstError;
+
+    // Both databases are read at the same time
+    QFuture<bool> srcFuture = QtConcurrent::run([this, &table, &srcChunks, &srcError]()
+    {
+        return hashTable(srcDb, table, srcChunks, srcError);
+    });
+
+    bool dstOk = true;
+    if (table.existsInDst)
+        dstOk = hashTable(dstDb, table, dstChunks, dstError);
+    else
+        dstChunks << Chunk();
+
+    bool srcOk = srcFuture.result();
+    if (isInterrupted())
+        return false;
+
+    if (!srcOk || !dstOk)
+    {
+        errorText = QObject::tr("Could not read data of table %1: %2", "db diff").arg(table.name, srcOk ? dstError : srcError);
+        return false;
+    }
+
+    TableDiff diff;
+    diff.table = table.name;
+    for (const Segment& segment : findDifferentSegments(srcChunks, dstChunks))
+    {
+        if (!syncSegment(table, segment, diff))
+            return false;
+    }
+
+    if (diff.inserted > 0 || diff.updated > 0 || diff.deleted > 0)
+        tableDiffs << diff;
+
+    return true;
+}
+
+bool DbDiff::hashTable(Db* db, const Table& table, QList<Chunk>& chunks, QString& error)
+{
+    static_qstring(selectTpl, "SELECT %1 FROM %2 ORDER BY %3");
+
+    SqlQueryPtr results = db->exec(selectTpl.arg(getSelectColumns(table), wrapObjIfNeeded(table.name), table.keyExprs.join(", ")));
+    if (results->isError())
+    {
+        error = results->getErrorText();
+        return false;
+    }
+
+    int keyCount = table.keyExprs.size();
+    QCryptographicHash digest(QCryptographicHash::Md5);
+    Chunk chunk;
+    QList<QVariant> values;
+    QByteArray keyData;
+    int rowCounter = 0;
+    while (results->hasNext())
+    {
+        if (++rowCounter % CHUNK_ROWS == 0 && isInterrupted())
+            return false;
+
+        values = results->next()->valueList();
+        keyData = serialize(values, 0, keyCount);
+        digest.addData(keyData);
+        digest.addData(serialize(values, keyCount, values.size() - keyCount));
+        chunk.rows++;
+
+        if (qHash(keyData) % CHUNK_ROWS != 0)
+            continue;
+
+        chunk.boundary = values.mid(0, keyCount);
+        chunk.boundaryKey = keyData;
+        chunk.digest = digest.result();
+        chunks << chunk;
+
+        chunk = Chunk();
+        digest.reset();
+    }
+
+    if (results->isError())
+    {
+        error = results->getErrorText();
+        return false;
+    }
+
+    chunk.digest = digest.result();
+    chunks << chunk;
+    return true;
+}
+
+QList<DbDiff::Segment> DbDiff::findDifferentSegments(const QList<Chunk>& srcChunks, const QList<Chunk>& dstChunks)
+{
+    QSet<QByteArray> dstBoundaries;
+    for (const Chunk& chunk : dstChunks)
+        dstBoundaries << chunk.boundaryKey;
+
+    // Both lists are in the key order, so boundaries common to both lists are in the same order.
+    // The last chunk has an empty boundary in both lists, so it's always common.
+    QList<Segment> segments;
+    Segment segment;
+    QCryptographicHash srcDigest(QCryptographicHash::Md5);
+    QCryptographicHash dstDigest(QCryptographicHash::Md5);
+    int dstIdx = 0;
+    for (const Chunk& srcChunk : srcChunks)
+    {
+        segment.srcRows += srcChunk.rows;
+        srcDigest.addData(srcChunk.digest);
+        if (!dstBoundaries.contains(srcChunk.boundaryKey))
+            continue;
+
+        while (dstIdx < dstChunks.size())
+        {
+            const Chunk& dstChunk = dstChunks[dstIdx++];
+            segment.dstRows += dstChunk.rows;
+            dstDigest.addData(dstChunk.digest);
+            if (dstChunk.boundaryKey == srcChunk.boundaryKey)
+                break;
+        }
+
+        bool empty = (segment.srcRows == 0 && segment.dstRows == 0);
+        if (!empty && (segment.srcRows != segment.dstRows || srcDigest.result() != dstDigest.result()))
+            segments << segment;
+
+        segment = Segment();
+        segment.lowerBoundary = srcChunk.boundary;
+        srcDigest.reset();
+        dstDigest.reset();
+    }
+    return segments;
+}
+
+bool DbDiff::syncSegment(const Table& table, const Segment& segment, TableDiff& diff)
+{
+    int keyCount = table.keyExprs.size();
+    QList<QList<QVariant>> dstRows;
+    QHash<QByteArray, int> dstRowIndex;
+    SqlQueryPtr results;
+    if (segment.dstRows > 0)
+    {
+        results = selectRows(dstDb, table, segment.lowerBoundary, segment.dstRows);
+        if (results->isError())
+        {
+            errorText = QObject::tr("Could not read data of table %1 from database %2: %3", "db diff")
+                    .arg(table.name, dstDb->getName(), results->getErrorText());
+            return false;
+        }
+
+        while (results->hasNext())
+        {
+            dstRows << results->next()->valueList();
+            dstRowIndex[serialize(dstRows.last(), 0, keyCount)] = dstRows.size() - 1;
+        }
+    }
+
+    QVector<bool> matched(dstRows.size(), false);
+    if (segment.srcRows > 0)
+    {
+        results = selectRows(srcDb, table, segment.lowerBoundary, segment.srcRows);
+        if (results->isError())
+        {
+            errorText = QObject::tr("Could not read data of table %1 from database %2: %3", "db diff")
+                    .arg(table.name, srcDb->getName(), results->getErrorText());
+            return false;
+        }
+
+        QList<QVariant> values;
+        int dstIdx;
+        while (results->hasNext())
+        {
+            if (isInterrupted())
+                return false;
+
+            values = results->next()->valueList();
+            dstIdx = dstRowIndex.value(serialize(values, 0, keyCount), -1);
+            if (dstIdx < 0)
+            {
+                addDataStatement(getInsert(table, values));
+                diff.inserted++;
+                continue;
+            }
+
+            matched[dstIdx] = true;
+            if (serialize(values, keyCount, values.size() - keyCount) == serialize(dstRows[dstIdx], keyCount, values.size() - keyCount))
+                continue;
+
+            addDataStatement(getUpdate(table, values, dstRows[dstIdx]));
+            diff.updated++;
+        }
+    }
+
+    for (int i = 0, total = dstRows.size(); i < total; i++)
+    {
+        if (matched[i])
+            continue;
+
+        addDataStatement(getDelete(table, dstRows[i]));
+        diff.deleted++;
+    }
+    return true;
+}
+
+bool DbDiff::openDataFile()
+{
+    if ((!dataFile.isOpen() && !dataFile.open()) || !dataFile.resize(0) || !dataFile.seek(0))
+    {
+        errorText = QObject::tr("Could not create temporary file for the synchronization script: %1", "db diff").arg(dataFile.errorString());
+        return false;
+    }
+
+    dataStream.setDevice(&dataFile);
+    dataStream.resetStatus();
+    return true;
+}
+
+void DbDiff::addDataStatement(const QString& statement)
+{
+    dataStream << statement;
+    dataStatementCount++;
+}
+
+bool DbDiff::forEachStatement(std::function<bool(const QString&)> handler)
+{
+    for (const QString& statement : dropStatements + createTableStatements)
+    {
+        if (!handler(statement))
+            return false;
+    }
+
+    if (dataStatementCount > 0)
+    {
+        if (!dataFile.seek(0))
+        {
+            errorText = QObject::tr("Could not read synchronization script from temporary file: %1", "db diff").arg(dataFile.errorString());
+            return false;
+        }
+
+        QDataStream input(&dataFile);
+        QString statement;
+        for (qint64 i = 0; i < dataStatementCount; i++)
+        {
+            input >> statement;
+            if (input.status() != QDataStream::Ok)
+            {
+                errorText = QObject::tr("Could not read synchronization script from temporary file: %1", "db diff").arg(dataFile.errorString());
+                return false;
+            }
+
+            if (!handler(statement))
+                return false;
+        }
+    }
+
+    for (const QString& statement : createOtherStatements)
+    {
+        if (!handler(statement))
+            return false;
+    }
+    return true;
+}
+
+SqlQueryPtr DbDiff::selectRows(Db* db, const Table& table, const QList<QVariant>& lowerBoundary, int limit)
+{
+    static_qstring(selectTpl, "SELECT %1 FROM %2%3 ORDER BY %4 LIMIT %5");
+
+    QString where;
+    QList<QVariant> args;
+    if (!lowerBoundary.isEmpty())
+        where = " WHERE " + getFollowingCondition(table, lowerBoundary, args);
+
+    return db->exec(selectTpl.arg(getSelectColumns(table), wrapObjIfNeeded(table.name), where,
+                                  table.keyExprs.join(", "), QString::number(limit)), args);
+}
+
+QString DbDiff::getSelectColumns(const Table& table)
+{
+    return QStringList(table.keyExprs + wrapObjNamesIfNeeded(table.columns)).join(", ");
+}
+
+QString DbDiff::getFollowingCondition(const Table& table, const QList<QVariant>& boundary, QList<QVariant>& args)
+{
+    QStringList keys = table.keyExprs;
+    int primaryKeyCount = table.keyColumns.size();
+    bool hasNull = false;
+    QStringList params;
+    for (int i = 0; i < primaryKeyCount; i++)
+    {
+        params << "?";
+        if (boundary[i].isNull())
+            hasNull = true;
+    }
+
+    // Row value comparison can seek with the primary key index, but it works only for non-null values.
+    // The ROWID of the nullable key is NULL for such boundary and no other row has the same primary key.
+    if (!hasNull)
+    {
+        args = boundary.mid(0, primaryKeyCount);
+        if (primaryKeyCount == 1)
+            return keys.first() + " > ?";
+
+        return "(" + keys.mid(0, primaryKeyCount).join(", ") + ") > (" + params.join(", ") + ")";
+    }
+
+    // Otherwise: (k1 > b1) OR (k1 IS b1 AND k2 > b2) OR ..., where NULL is lower than any other value.
+    QStringList alternatives;
+    QStringList equalPrefix;
+    QList<QVariant> equalPrefixArgs;
+    for (int i = 0, total = keys.size(); i < total; i++)
+    {
+        alternatives << "(" + QStringList(equalPrefix + QStringList({keys[i] + (boundary[i].isNull() ? " IS NOT NULL" : " > ?")})).join(" AND ") + ")";
+        args += equalPrefixArgs;
+        if (!boundary[i].isNull())
+            args << boundary[i];
+
+        equalPrefix << (keys[i] + " IS ?");
+        equalPrefixArgs << boundary[i];
+    }
+    return alternatives.join(" OR ");
+}
+
+QString DbDiff::getKeyCondition(const Table& table, const QList<QVariant>& row)
+{
+    QStringList keys = table.keyExprs;
+    QStringList values = valueListToSqlList(row.mid(0, keys.size()));
+    QStringList conditions;
+    for (int i = 0, total = keys.size(); i < total; i++)
+        conditions << (keys[i] + " IS " + values[i]);
+
+    return conditions.join(" AND ");
+}
+
+QString DbDiff::getInsert(const Table& table, const QList<QVariant>& row)
+{
+    static_qstring(insertTpl, "INSERT INTO %1 (%2) VALUES (%3);");
+
+    // ROWID is inserted explicitly, so rows are still matched after synchronization
+    int keyCount = table.keyExprs.size();
+    QStringList columns = table.columns;
+    QList<QVariant> values = row.mid(keyCount);
+    if (table.rowIdKey || table.nullableKey)
+    {
+        // For nullable key it's NULL (so generated) unless the key has NULL
+        columns.prepend("rowid");
+        values.prepend(row[keyCount - 1]);
+    }
+    return insertTpl.arg(wrapObjIfNeeded(table.name), wrapObjNamesIfNeeded(columns).join(", "), valueListToSqlList(values).join(", "));
+}
+
+QString DbDiff::getUpdate(const Table& table, const QList<QVariant>& srcRow, const QList<QVariant>& dstRow)
+{
+    static_qstring(updateTpl, "UPDATE %1 SET %2 WHERE %3;");
+
+    int keyCount = table.keyExprs.size();
+    QStringList values = valueListToSqlList(srcRow.mid(keyCount));
+    QStringList assignments;
+    for (int i = 0, total = table.columns.size(); i < total; i++)
+    {
+        if (serialize(srcRow, keyCount + i, 1) == serialize(dstRow, keyCount + i, 1))
+            continue;
+
+        assignments << (wrapObjIfNeeded(table.columns[i]) + " = " + values[i]);
+    }
+    return updateTpl.arg(wrapObjIfNeeded(table.name), assignments.join(", "), getKeyCondition(table, srcRow));
+}
+
+QString DbDiff::getDelete(const Table& table, const QList<QVariant>& row)
+{
+    static_qstring(deleteTpl, "DELETE FROM %1 WHERE %2;");
+    return deleteTpl.arg(wrapObjIfNeeded(table.name), getKeyCondition(table, row));
+}
+
+bool DbDiff::isInterrupted()
+{
+    QMutexLocker locker(&interruptMutex);
+    return interrupted;
+}
+
+void DbDiff::appendValue(QByteArray& data, const QVariant& value)
+{
+    if (!value.isValid() || value.isNull())
+    {
+        data.append('N');
+        return;
+    }
+
+    switch (value.userType())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Bool:
+        {
+            qint64 number = value.toLongLong();
+            data.append('I');
+            data.append(reinterpret_cast<const char*>(&number), sizeof(number));
+            break;
+        }
+        case QVariant::Double:
+        {
+            double number = value.toDouble();
+            data.append('R');
+            data.append(reinterpret_cast<const char*>(&number), sizeof(number));
+            break;
+        }
+        case QVariant::ByteArray:
+        {
+            QByteArray bytes = value.toByteArray();
+            int size = bytes.size();
+            data.append('B');
+            data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            data.append(bytes);
+            break;
+        }
+        default:
+        {
+            QString str = value.toString();
+            int size = str.size();
+            data.append('T');
+            data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            data.append(reinterpret_cast<const char*>(str.utf16()), size * 2);
+            break;
+        }
+    }
+}
+
+QByteArray DbDiff::serialize(const QList<QVariant>& values, int from, int count)
+{
+    QByteArray data;
+    for (int i = from, end = from + count; i < end; i++)
+        appendValue(data, values[i]);
+
+    return data;
+}
@@ -0,0 +1,195 @@
+#ifndef DBDIFF_H
+#define DBDIFF_H
+
+#include "coreSQLiteStudio_global.h"
+#include "interruptable.h"
+#include "db/sqlquery.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVariant>
+#include <QHash>
+#include <QMutex>
+#include <QTemporaryFile>
+#include <QDataStream>
+#include <functional>
+
+class Db;
+
+/**
+ * @brief Compares schema and data of two databases and prepares a script synchronizing them.
+ *
+ * The source database is the reference. The script produced by compare() transforms the target database,
+ * so it has the same schema objects and the same table data as the source database. It can be applied
+ * to the target database with apply(), or executed manually (see getScript()).
+ *
+ * Schema objects are matched by name and compared by their DDL. Objects missing in the target database
+ * are created, objects missing in the source database are dropped and other differing objects are recreated,
+ * except for tables. A table with different DDL, but with the same columns, gets its data synchronized,
+ * while a table with different columns is only reported (see getSchemaDifferences()).
+ *
+ * Rows are matched by the primary key (or by ROWID for tables without the primary key). Columns of a primary key
+ * (other than INTEGER PRIMARY KEY) of a ROWID table may hold NULLs and such keys don't have to be unique,
+ * so rows with NULL in the key are matched by their ROWID too. Comparing data
+ * takes two phases:
+ * <ol>
+ * <li>Both databases are read in parallel in the key order and rows are hashed in chunks. A chunk ends
+ * at a row, whose key hash is divisible by CHUNK_ROWS, so chunk boundaries depend only on keys existing
+ * in the table - a row inserted or deleted in one database changes just one chunk, it doesn't shift
+ * all following chunks. Ranges between boundaries common to both databases are then compared by
+ * the number of rows and digests of their chunks.</li>
+ * <li>Only ranges that differ are read again (seeking to the range by the key of its lower boundary)
+ * and compared row by row to generate INSERT, UPDATE and DELETE statements.</li>
+ * </ol>
+ * Identical tables are therefore read once from each database and no rows are kept in memory.
+ * Data statements of the script are written to a temporary file, so the script size doesn't matter either.
+ *
+ * The comparison can take a long time for large databases, so it's best to call compare() from a separate
+ * thread. It can be interrupted with interrupt().
+ */
+class API_EXPORT DbDiff : public Interruptable
+{
+    friend class DbDiffTest;
+
+    public:
+        /**
+         * @brief Summary of data changes for a single table.
+         */
+        struct API_EXPORT TableDiff
+        {
+            QString table;
+            int inserted = 0;
+            int updated = 0;
+            int deleted = 0;
+        };
+
+        /**
+         * @brief Creates comparison of two databases.
+         * @param srcDb Reference database.
+         * @param dstDb Database to be synchronized with the reference one.
+         */
+        DbDiff(Db* srcDb, Db* dstDb);
+
+        /**
+         * @brief Compares databases and prepares the synchronization script.
+         * @return true on success, or false on error (see getErrorText()), or if it was interrupted.
+         *
+         * Data statements are kept in a temporary file until the DbDiff is deleted, or compare() is called again.
+         */
+        bool compare();
+
+        /**
+         * @brief Executes the synchronization script on the target database.
+         * @return true on success, or false on error (see getErrorText()).
+         *
+         * The script is executed in a single transaction with foreign keys checks deferred till the commit,
+         * so the order of data changes doesn't matter. Triggers of the target database are fired as usual.
+         */
+        bool apply();
+
+        void interrupt();
+
+        /**
+         * @brief Provides data changes of tables that were compared.
+         * @return Tables with any data difference.
+         */
+        const QList<TableDiff>& getTableDiffs() const;
+
+        /**
+         * @brief Provides schema differences.
+         * @return List of localized messages, one per different object.
+         */
+        const QStringList& getSchemaDifferences() const;
+
+        /**
+         * @brief Provides number of statements in the synchronization script.
+         * @return Number of statements. Zero means that databases are synchronized already.
+         */
+        qint64 getStatementCount() const;
+
+        /**
+         * @brief Writes the synchronization script, so it can be executed manually.
+         * @param output Device open for writing.
+         * @return true on success, or false on error (see getErrorText()).
+         *
+         * Statements are terminated with a semicolon and written one per line, encoded in UTF-8.
+         */
+        bool writeScript(QIODevice* output);
+
+        QString getErrorText() const;
+
+    private:
+        struct Object
+        {
+            QString type;
+            QString name;
+            QString ddl;
+        };
+
+        struct Table
+        {
+            QString name;
+            QStringList columns;
+            QStringList keyColumns;
+            QStringList keyExprs;       /**< Key columns as used in queries, including ROWID for nullable key. */
+            bool rowIdKey = false;
+            bool nullableKey = false;   /**< Primary key of a ROWID table that can hold NULLs. */
+            bool existsInDst = true;
+        };
+
+        struct Chunk
+        {
+            QList<QVariant> boundary;   /**< Key of the last row in the chunk. Empty for the last chunk. */
+            QByteArray boundaryKey;     /**< Serialized boundary, to be compared quickly. */
+            QByteArray digest;
+            int rows = 0;
+        };
+
+        struct Segment
+        {
+            QList<QVariant> lowerBoundary; /**< Key of the last row before the segment. Empty for the first segment. */
+            int srcRows = 0;
+            int dstRows = 0;
+        };
+
+        bool loadObjects(Db* db, QHash<QString, Object>& objects, QStringList& order);
+        bool loadColumns(Db* db, Table& table);
+        bool compareSchema();
+        bool compareData(Table& table);
+        bool hashTable(Db* db, const Table& table, QList<Chunk>& chunks, QString& error);
+        QList<Segment> findDifferentSegments(const QList<Chunk>& srcChunks, const QList<Chunk>& dstChunks);
+        bool syncSegment(const Table& table, const Segment& segment, TableDiff& diff);
+        bool openDataFile();
+        void addDataStatement(const QString& statement);
+        bool forEachStatement(std::function<bool(const QString&)> handler);
+        SqlQueryPtr selectRows(Db* db, const Table& table, const QList<QVariant>& lowerBoundary, int limit);
+        QString getSelectColumns(const Table& table);
+        QString getFollowingCondition(const Table& table, const QList<QVariant>& boundary, QList<QVariant>& args);
+        QString getKeyCondition(const Table& table, const QList<QVariant>& row);
+        QString getInsert(const Table& table, const QList<QVariant>& row);
+        QString getUpdate(const Table& table, const QList<QVariant>& srcRow, const QList<QVariant>& dstRow);
+        QString getDelete(const Table& table, const QList<QVariant>& row);
+        bool isInterrupted();
+
+        static void appendValue(QByteArray& data, const QVariant& value);
+        static QByteArray serialize(const QList<QVariant>& values, int from, int count);
+
+        static const int CHUNK_ROWS = 1024;
+
+        Db* srcDb = nullptr;
+        Db* dstDb = nullptr;
+        QList<Table> tablesToCompare;
+        QList<TableDiff> tableDiffs;
+        QStringList schemaDifferences;
+        QStringList dropStatements;
+        QStringList createTableStatements;
+        QTemporaryFile dataFile;
+        QDataStream dataStream;
+        qint64 dataStatementCount = 0;
+        QStringList createOtherStatements;
+        QString errorText;
+        bool interrupted = false;
+        QMutex interruptMutex;
+};
+
+#endif // DBDIFF_H
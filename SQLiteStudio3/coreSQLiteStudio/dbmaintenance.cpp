@@ -0,0 +1,387 @@
+#include "dbmaintenance.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "services/config.h"
+#include "common/utils_sql.h"
+#include <QThreadPool>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+DbMaintenance::DbMaintenance(QObject* parent) :
+    QObject(parent)
+{
+    qRegisterMetaType<DbMaintenance::Result>();
+}
+
+void DbMaintenance::addDb(Db* db)
+{
+    workerConnections.addDb(db);
+}
+
+QList<DbMaintenance::Operation> DbMaintenance::getOperations() const
+{
+    return operations;
+}
+
+void DbMaintenance::setOperations(const QList<Operation>& value)
+{
+    operations = value;
+}
+
+int DbMaintenance::getThreads() const
+{
+    return threads;
+}
+
+void DbMaintenance::setThreads(int value)
+{
+    threads = qMax(1, value);
+}
+
+bool DbMaintenance::exec()
+{
+    workerConnections.reset();
+    results.clear();
+    pendingTasks.clear();
+    targetsBeingAnalyzed.clear();
+
+    prepareTasks();
+    totalTasks = results.size() + pendingTasks.size();
+    emit started(totalTasks);
+
+    // Databases that could not be opened are already reported
+    for (int i = 0, total = results.size(); i < total; i++)
+        emit taskFinished(results[i], i + 1, totalTasks);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    QList<QFuture<void>> workers;
+    for (int i = 0, total = qMin(threads, pendingTasks.size()); i < total; i++)
+        workers << QtConcurrent::run(&pool, this, &DbMaintenance::runWorker);
+
+    for (QFuture<void>& worker : workers)
+        worker.waitForFinished();
+
+    return !workerConnections.isInterrupted();
+}
+
+void DbMaintenance::interrupt()
+{
+    workerConnections.interrupt();
+
+    // Wake up workers waiting for ANALYZE of their database to finish
+    QMutexLocker tasksLocker(&tasksMutex);
+    taskReleased.wakeAll();
+}
+
+QList<DbMaintenance::Result> DbMaintenance::getResults() const
+{
+    QMutexLocker locker(&tasksMutex);
+    return results;
+}
+
+QString DbMaintenance::toString(Operation operation)
+{
+    switch (operation)
+    {
+        case Operation::QUICK_CHECK:
+            return tr("Quick check");
+        case Operation::INTEGRITY_CHECK:
+            return tr("Integrity check");
+        case Operation::FOREIGN_KEY_CHECK:
+            return tr("Foreign key check");
+        case Operation::ANALYZE:
+            return tr("Analyze");
+    }
+    return QString();
+}
+
+void DbMaintenance::storeHistory(const QList<Result>& results)
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QList<HistoryEntry> entries;
+    for (const Result& result : results)
+    {
+        HistoryEntry* entry = nullptr;
+        for (HistoryEntry& existing : entries)
+        {
+            if (existing.database == result.database && existing.operation == result.operation)
+            {
+                entry = &existing;
+                break;
+            }
+        }
+
+        if (!entry)
+        {
+            entries << HistoryEntry();
+            entry = &entries.last();
+            entry->date = now;
+            entry->database = result.database;
+            entry->operation = result.operation;
+        }
+
+        entry->objects++;
+        entry->issues += result.issues.size();
+        entry->duration += result.duration;
+    }
+
+    QList<QVariant> history = CFG->get(CONFIG_GROUP, CONFIG_HISTORY_KEY).toList();
+    for (const HistoryEntry& entry : entries)
+    {
+        QHash<QString, QVariant> hash;
+        hash["date"] = entry.date;
+        hash["database"] = entry.database;
+        hash["operation"] = static_cast<int>(entry.operation);
+        hash["objects"] = entry.objects;
+        hash["issues"] = entry.issues;
+        hash["duration"] = entry.duration;
+        history << hash;
+    }
+
+    while (history.size() > HISTORY_SIZE)
+        history.removeFirst();
+
+    CFG->set(CONFIG_GROUP, CONFIG_HISTORY_KEY, history);
+}
+
+QList<DbMaintenance::HistoryEntry> DbMaintenance::getHistory()
+{
+    QList<HistoryEntry> entries;
+    for (const QVariant& value : CFG->get(CONFIG_GROUP, CONFIG_HISTORY_KEY).toList())
+    {
+        QHash<QString, QVariant> hash = value.toHash();
+        HistoryEntry entry;
+        entry.date = hash["date"].toDateTime();
+        entry.database = hash["database"].toString();
+        entry.operation = static_cast<Operation>(hash["operation"].toInt());
+        entry.objects = hash["objects"].toInt();
+        entry.issues = hash["issues"].toInt();
+        entry.duration = hash["duration"].toLongLong();
+        entries << entry;
+    }
+    return entries;
+}
+
+void DbMaintenance::prepareTasks()
+{
+    QString errorText;
+    for (int i = 0, total = workerConnections.count(); i < total && !workerConnections.isInterrupted(); i++)
+    {
+        QStringList tables = readTables(i, errorText);
+        for (Operation operation : operations)
+        {
+            if (!errorText.isNull())
+            {
+                Result result;
+                result.database = workerConnections.getName(i);
+                result.operation = operation;
+                result.success = false;
+                result.issues << errorText;
+                results << result;
+                continue;
+            }
+
+            for (const QString& table : tables)
+            {
+                Task task;
+                task.target = i;
+                task.operation = operation;
+                task.table = table;
+                pendingTasks << task;
+            }
+        }
+    }
+}
+
+QStringList DbMaintenance::readTables(int target, QString& errorText)
+{
+    static_qstring(tablesSql, "SELECT name FROM sqlite_master WHERE type = 'table' AND lower(sql) NOT LIKE 'create virtual%' ORDER BY name");
+
+    errorText = QString();
+    Db* db = workerConnections.open(target, true, errorText);
+    if (!db)
+        return QStringList();
+
+    QStringList tables;
+    SqlQueryPtr results = db->exec(tablesSql);
+    if (results->isError())
+        errorText = tr("Could not read tables of database %1: %2").arg(workerConnections.getName(target), results->getErrorText());
+    else
+        for (const SqlResultsRowPtr& row : results->getAll())
+            tables << row->value(0).toString();
+
+    workerConnections.close(db);
+    return tables;
+}
+
+void DbMaintenance::runWorker()
+{
+    Connections connections;
+    Task task;
+    while (takeTask(task))
+    {
+        Result result = execTask(task, connections);
+        finishTask(task, result);
+    }
+    closeConnections(connections);
+}
+
+bool DbMaintenance::takeTask(Task& task)
+{
+    QMutexLocker locker(&tasksMutex);
+    while (!pendingTasks.isEmpty() && !workerConnections.isInterrupted())
+    {
+        // Only one ANALYZE per database at a time, as it writes to the database
+        QMutableListIterator<Task> it(pendingTasks);
+        while (it.hasNext())
+        {
+            Task& candidate = it.next();
+            if (candidate.operation == Operation::ANALYZE && targetsBeingAnalyzed.contains(candidate.target))
+                continue;
+
+            task = candidate;
+            it.remove();
+            if (task.operation == Operation::ANALYZE)
+                targetsBeingAnalyzed << task.target;
+
+            return true;
+        }
+
+        taskReleased.wait(&tasksMutex);
+    }
+    return false;
+}
+
+void DbMaintenance::finishTask(const Task& task, const Result& result)
+{
+    QMutexLocker locker(&tasksMutex);
+    if (task.operation == Operation::ANALYZE)
+    {
+        targetsBeingAnalyzed.remove(task.target);
+        taskReleased.wakeAll();
+    }
+
+    results << result;
+    int finishedTasks = results.size();
+    locker.unlock();
+
+    emit taskFinished(result, finishedTasks, totalTasks);
+}
+
+DbMaintenance::Result DbMaintenance::execTask(const Task& task, Connections& connections)
+{
+    static_qstring(quickCheckTpl, "PRAGMA quick_check(%1);");
+    static_qstring(integrityCheckTpl, "PRAGMA integrity_check(%1);");
+    static_qstring(analyzeTpl, "ANALYZE %1;");
+
+    Result result;
+    result.database = workerConnections.getName(task.target);
+    result.operation = task.operation;
+    result.object = task.table;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString errorText;
+    Db* db = getConnection(task, connections, errorText);
+    if (!db)
+    {
+        result.success = false;
+        result.issues << errorText;
+        result.duration = timer.elapsed();
+        return result;
+    }
+
+    QString table = wrapObjIfNeeded(task.table);
+    switch (task.operation)
+    {
+        case Operation::QUICK_CHECK:
+            execCheck(db, quickCheckTpl.arg(table), result);
+            break;
+        case Operation::INTEGRITY_CHECK:
+            execCheck(db, integrityCheckTpl.arg(table), result);
+            break;
+        case Operation::FOREIGN_KEY_CHECK:
+            execForeignKeyCheck(db, table, result);
+            break;
+        case Operation::ANALYZE:
+        {
+            SqlQueryPtr results = db->exec(analyzeTpl.arg(table));
+            if (results->isError())
+            {
+                result.success = false;
+                result.issues << results->getErrorText();
+            }
+            break;
+        }
+    }
+
+    result.duration = timer.elapsed();
+    return result;
+}
+
+void DbMaintenance::execCheck(Db* db, const QString& sql, Result& result)
+{
+    SqlQueryPtr results = db->exec(sql);
+    if (results->isError())
+    {
+        result.success = false;
+        result.issues << results->getErrorText();
+        return;
+    }
+
+    QString message;
+    for (const SqlResultsRowPtr& row : results->getAll())
+    {
+        message = row->value(0).toString();
+        if (message != "ok")
+            result.issues << message;
+    }
+}
+
+void DbMaintenance::execForeignKeyCheck(Db* db, const QString& table, Result& result)
+{
+    static_qstring(fkCheckTpl, "PRAGMA foreign_key_check(%1);");
+
+    SqlQueryPtr results = db->exec(fkCheckTpl.arg(table));
+    if (results->isError())
+    {
+        result.success = false;
+        result.issues << results->getErrorText();
+        return;
+    }
+
+    // Columns: table, rowid, parent, fkid
+    for (const SqlResultsRowPtr& row : results->getAll())
+    {
+        result.issues << tr("Row with ROWID %1 in table %2 has no matching row in table %3 (foreign key #%4).")
+                         .arg(row->value(1).toString(), row->value(0).toString(), row->value(2).toString(), row->value(3).toString());
+    }
+}
+
+Db* DbMaintenance::getConnection(const Task& task, Connections& connections, QString& errorText)
+{
+    if (connections.target != task.target)
+    {
+        closeConnections(connections);
+        connections.target = task.target;
+    }
+
+    bool readOnly = (task.operation != Operation::ANALYZE);
+    Db*& db = readOnly ? connections.readDb : connections.writeDb;
+    if (!db)
+        db = workerConnections.open(task.target, readOnly, errorText);
+
+    return db;
+}
+
+void DbMaintenance::closeConnections(Connections& connections)
+{
+    workerConnections.close(connections.readDb);
+    workerConnections.close(connections.writeDb);
+    connections.target = -1;
+}
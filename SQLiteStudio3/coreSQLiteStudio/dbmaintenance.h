@@ -0,0 +1,212 @@
+#ifndef DBMAINTENANCE_H
+#define DBMAINTENANCE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include "interruptable.h"
+#include "dbworkerconnections.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QVariant>
+#include <QDateTime>
+#include <QMutex>
+#include <QWaitCondition>
+
+class Db;
+
+/**
+ * @brief Runs integrity checks and ANALYZE over many databases in parallel.
+ *
+ * Each requested operation is split into tasks per table (a table is checked and analyzed together
+ * with its indexes, which is the smallest unit supported by SQLite pragmas), so progress can be reported
+ * and the work can be spread over threads. Tasks are executed by a bounded number of workers, each using its own
+ * connections to the database, opened with the same driver and options as the registered database:
+ * <ul>
+ * <li>checks (Operation::QUICK_CHECK, Operation::INTEGRITY_CHECK, Operation::FOREIGN_KEY_CHECK)
+ * use read-only connections (see DB_READ_ONLY), so they can run in parallel, even on the same database,</li>
+ * <li>Operation::ANALYZE writes statistics, so only one worker at a time analyzes the given database.</li>
+ * </ul>
+ * The registered Db objects are not used for the execution, so databases don't need to be open
+ * and the application can work with them in the meantime.
+ *
+ * The exec() blocks until all tasks are done, so it's best to call it from a separate thread.
+ * Results are streamed with the taskFinished() signal, which is emitted from worker threads.
+ *
+ * Summaries of runs can be stored in the configuration with storeHistory(), so durations can be compared
+ * between runs.
+ */
+class API_EXPORT DbMaintenance : public QObject, public Interruptable
+{
+        Q_OBJECT
+
+    friend class DbMaintenanceTest;
+
+    public:
+        enum class Operation
+        {
+            QUICK_CHECK,
+            INTEGRITY_CHECK,
+            FOREIGN_KEY_CHECK,
+            ANALYZE
+        };
+
+        /**
+         * @brief Result of a single task - one operation on one table.
+         */
+        struct API_EXPORT Result
+        {
+            QString database;
+            Operation operation = Operation::QUICK_CHECK;
+
+            /**
+             * @brief Table name, or empty string if the operation could not be split into tables (i.e. the database could not be opened).
+             */
+            QString object;
+
+            /**
+             * @brief Tells if the operation was executed. Problems found by checks don't make it false, they're listed in #issues.
+             */
+            bool success = true;
+
+            /**
+             * @brief Problems found by the check, or the error message if the operation failed.
+             */
+            QStringList issues;
+
+            /**
+             * @brief Time of execution in milliseconds.
+             */
+            qint64 duration = 0;
+        };
+
+        /**
+         * @brief Summary of one operation on one database in a past run.
+         */
+        struct API_EXPORT HistoryEntry
+        {
+            QDateTime date;
+            QString database;
+            Operation operation = Operation::QUICK_CHECK;
+            int objects = 0;
+            int issues = 0;
+            qint64 duration = 0;
+        };
+
+        explicit DbMaintenance(QObject* parent = nullptr);
+
+        /**
+         * @brief Adds database to be maintained.
+         * @param db Registered database.
+         *
+         * Only the name, path, driver and connection options of the database are remembered.
+         */
+        void addDb(Db* db);
+
+        QList<Operation> getOperations() const;
+        void setOperations(const QList<Operation>& value);
+
+        int getThreads() const;
+        void setThreads(int value);
+
+        /**
+         * @brief Executes all operations on all added databases.
+         * @return true if all tasks were executed, or false if it was interrupted.
+         *
+         * Failures of single tasks don't stop the execution, they're reported in results.
+         */
+        bool exec();
+
+        void interrupt();
+
+        /**
+         * @brief Provides results of all finished tasks.
+         * @return Results in order of finishing.
+         */
+        QList<Result> getResults() const;
+
+        /**
+         * @brief Provides localized name of the operation.
+         */
+        static QString toString(Operation operation);
+
+        /**
+         * @brief Stores summary of results in the configuration.
+         * @param results Results of a run.
+         *
+         * Results are summed up per database and operation. Only the latest HISTORY_SIZE entries are kept.
+         */
+        static void storeHistory(const QList<Result>& results);
+
+        /**
+         * @brief Provides summaries of past runs.
+         * @return History entries, the oldest first.
+         */
+        static QList<HistoryEntry> getHistory();
+
+        static const int HISTORY_SIZE = 1000;
+
+    private:
+        struct Task
+        {
+            int target = -1;
+            Operation operation = Operation::QUICK_CHECK;
+            QString table;
+        };
+
+        /**
+         * @brief Connections of a single worker. They're kept only for one database at a time.
+         */
+        struct Connections
+        {
+            int target = -1;
+            Db* readDb = nullptr;
+            Db* writeDb = nullptr;
+        };
+
+        void prepareTasks();
+        QStringList readTables(int target, QString& errorText);
+        void runWorker();
+        bool takeTask(Task& task);
+        void finishTask(const Task& task, const Result& result);
+        Result execTask(const Task& task, Connections& connections);
+        void execCheck(Db* db, const QString& sql, Result& result);
+        void execForeignKeyCheck(Db* db, const QString& table, Result& result);
+        Db* getConnection(const Task& task, Connections& connections, QString& errorText);
+        void closeConnections(Connections& connections);
+
+        static_char* CONFIG_GROUP = "DbMaintenance";
+        static_char* CONFIG_HISTORY_KEY = "History";
+
+        DbWorkerConnections workerConnections;
+        QList<Operation> operations = {Operation::QUICK_CHECK};
+        int threads = 4;
+
+        QList<Task> pendingTasks;
+        QSet<int> targetsBeingAnalyzed;
+        QList<Result> results;
+        int totalTasks = 0;
+        mutable QMutex tasksMutex;
+        QWaitCondition taskReleased;
+
+    signals:
+        /**
+         * @brief Emitted when operations were split into tasks, before they're executed.
+         * @param totalTasks Number of tasks to execute.
+         */
+        void started(int totalTasks);
+
+        /**
+         * @brief Emitted after each task (from the worker thread).
+         * @param result Result of the task.
+         * @param finishedTasks Number of tasks finished so far.
+         * @param totalTasks Number of all tasks.
+         */
+        void taskFinished(const DbMaintenance::Result& result, int finishedTasks, int totalTasks);
+};
+
+Q_DECLARE_METATYPE(DbMaintenance::Result)
+
+#endif // DBMAINTENANCE_H
@@ -0,0 +1,96 @@
+#include "dbworkerconnections.h"
+#include "db/db.h"
+#include "plugins/dbplugin.h"
+#include "services/pluginmanager.h"
+#include <QMutexLocker>
+
+int DbWorkerConnections::addDb(Db* db)
+{
+    Target target;
+    target.name = db->getName();
+    target.path = db->getPath();
+    target.options = db->getConnectionOptions();
+    target.plugin = dynamic_cast<DbPlugin*>(PLUGINS->getLoadedPlugin(target.options[DB_PLUGIN].toString()));
+    targets << target;
+    return targets.size() - 1;
+}
+
+int DbWorkerConnections::count() const
+{
+    return targets.size();
+}
+
+QString DbWorkerConnections::getName(int target) const
+{
+    return targets[target].name;
+}
+
+Db* DbWorkerConnections::open(int target, bool readOnly, QString& errorText)
+{
+    const Target& tgt = targets[target];
+    if (!tgt.plugin)
+    {
+        errorText = QObject::tr("Could not find database driver for database %1.", "worker connections").arg(tgt.name);
+        return nullptr;
+    }
+
+    QHash<QString, QVariant> options = tgt.options;
+    options[DB_SECONDARY_CONNECTION] = true;
+    if (readOnly)
+        options[DB_READ_ONLY] = true;
+
+    QString pluginError;
+    Db* db = tgt.plugin->getInstance(tgt.name, tgt.path, options, &pluginError);
+    if (!db)
+    {
+        errorText = QObject::tr("Could not open database %1: %2", "worker connections").arg(tgt.name, pluginError);
+        return nullptr;
+    }
+
+    if (!db->initAfterCreated() || !db->openQuiet())
+    {
+        errorText = QObject::tr("Could not open database %1: %2", "worker connections").arg(tgt.name, db->getErrorText());
+        delete db;
+        return nullptr;
+    }
+
+    db->exec(QString("PRAGMA busy_timeout = %1;").arg(BUSY_TIMEOUT_MS));
+
+    QMutexLocker locker(&mutex);
+    activeConnections << db;
+    return db;
+}
+
+void DbWorkerConnections::close(Db*& db)
+{
+    if (!db)
+        return;
+
+    mutex.lock();
+    activeConnections.remove(db);
+    mutex.unlock();
+
+    db->closeQuiet();
+    delete db;
+    db = nullptr;
+}
+
+void DbWorkerConnections::reset()
+{
+    QMutexLocker locker(&mutex);
+    interrupted = false;
+}
+
+void DbWorkerConnections::interrupt()
+{
+    QMutexLocker locker(&mutex);
+    interrupted = true;
+    for (Db* db : activeConnections)
+        db->interrupt();
+}
+
+bool DbWorkerConnections::isInterrupted()
+{
+    QMutexLocker locker(&mutex);
+    return interrupted;
+}
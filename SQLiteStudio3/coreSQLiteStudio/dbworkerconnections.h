@@ -0,0 +1,85 @@
+#ifndef DBWORKERCONNECTIONS_H
+#define DBWORKERCONNECTIONS_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QVariant>
+#include <QMutex>
+
+class Db;
+class DbPlugin;
+
+/**
+ * @brief Opens private connections to registered databases for worker threads.
+ *
+ * Only the name, path, driver and connection options of added databases are remembered, so the registered
+ * Db objects are never used by workers and the application can work with them in the meantime.
+ * Each call to open() creates a new connection, owned by the caller until it's passed to close().
+ *
+ * All open connections are tracked, so they can be interrupted from another thread with interrupt().
+ * All methods are thread-safe, except for addDb(), which has to be called before workers are started.
+ */
+class API_EXPORT DbWorkerConnections
+{
+    public:
+        /**
+         * @brief Adds database to open connections to.
+         * @param db Registered database.
+         * @return Index of the database, to be passed to other methods.
+         */
+        int addDb(Db* db);
+
+        int count() const;
+        QString getName(int target) const;
+
+        /**
+         * @brief Opens a new connection to the database.
+         * @param target Index of the database, as returned from addDb().
+         * @param readOnly If true, the connection is opened with DB_READ_ONLY option.
+         * @param errorText Filled with the error message if the connection could not be opened.
+         * @return Open connection, or null if it could not be opened.
+         */
+        Db* open(int target, bool readOnly, QString& errorText);
+
+        /**
+         * @brief Closes and deletes the connection opened with open().
+         * @param db Connection to close. It's set to null afterwards. Null is accepted and ignored.
+         */
+        void close(Db*& db);
+
+        /**
+         * @brief Clears the interrupted state, so connections can be used for a next run.
+         */
+        void reset();
+
+        /**
+         * @brief Interrupts queries on all open connections and marks the run as interrupted.
+         */
+        void interrupt();
+
+        bool isInterrupted();
+
+        /**
+         * @brief Time to wait for locks held by the application or other programs, instead of failing immediately.
+         */
+        static const int BUSY_TIMEOUT_MS = 10000;
+
+    private:
+        struct Target
+        {
+            QString name;
+            QString path;
+            QHash<QString, QVariant> options;
+            DbPlugin* plugin = nullptr;
+        };
+
+        QList<Target> targets;
+        QSet<Db*> activeConnections;
+        bool interrupted = false;
+        QMutex mutex;
+};
+
+#endif // DBWORKERCONNECTIONS_H
@@ -7,6 +7,7 @@
 #include "db/sqlresultsrow.h"
 #include "common/compatibility.h"
 #include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QDebug>
 
 ExportWorker::ExportWorker(ExportPlugin* plugin, ExportManager::StandardExportConfig* config, QIODevice* output, QObject *parent) :
@@ -97,11 +98,21 @@ void ExportWorker::interrupt()
         executor->interrupt();
 }
 
+const ExportWorker::Statistics& ExportWorker::getStatistics() const
+{
+    return statistics;
+}
+
 bool ExportWorker::exportQueryResults()
 {
+    statistics = Statistics();
+    QElapsedTimer timer;
+    timer.start();
+
     executor->setDb(db);
     executor->exec(query);
     SqlQueryPtr results = executor->getResults();
+    statistics.executionTime = timer.elapsed();
     if (!results)
     {
         qCritical() << "Null results from executor in ExportWorker.";
@@ -143,14 +154,22 @@ bool ExportWorker::exportQueryResults()
     }
 
     SqlResultsRowPtr row;
+    qint64 fetchNsecs = 0;
+    qint64 exportNsecs = 0;
     while (results->hasNext())
     {
+        timer.restart();
         row = results->next();
+        fetchNsecs += timer.nsecsElapsed();
+
+        timer.restart();
         if (!plugin->exportQueryResultsRow(row))
         {
             logExportFail("exportQueryResultsRow()");
             return false;
         }
+        exportNsecs += timer.nsecsElapsed();
+        statistics.rowCount++;
 
         if (isInterrupted())
         {
@@ -158,6 +177,8 @@ bool ExportWorker::exportQueryResults()
             return false;
         }
     }
+    statistics.fetchTime = fetchNsecs / 1000000;
+    statistics.exportTime = exportNsecs / 1000000;
 
     if (!plugin->afterExportQueryResults())
     {
@@ -14,6 +14,20 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
 {
         Q_OBJECT
     public:
+        /**
+         * @brief Timing statistics of the query results export.
+         *
+         * Times are in milliseconds. Fetch and export times are accumulated across all exported rows,
+         * so they tell how much was spent in reading rows from database and how much in the export plugin.
+         */
+        struct Statistics
+        {
+            qint64 executionTime = 0;
+            qint64 fetchTime = 0;
+            qint64 exportTime = 0;
+            qint64 rowCount = 0;
+        };
+
         ExportWorker(ExportPlugin* plugin, ExportManager::StandardExportConfig* config, QIODevice* output, QObject *parent = 0);
         ~ExportWorker();
 
@@ -21,6 +35,7 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         void prepareExportQueryResults(Db* db, const QString& query);
         void prepareExportDatabase(Db* db, const QStringList& objectListToExport);
         void prepareExportTable(Db* db, const QString& database, const QString& table);
+        const Statistics& getStatistics() const;
 
     private:
         void prepareParser();
@@ -50,6 +65,7 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         bool interrupted = false;
         QMutex interruptMutex;
         Parser* parser = nullptr;
+        Statistics statistics;
 
     public slots:
         void interrupt();
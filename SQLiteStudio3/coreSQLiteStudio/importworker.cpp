@@ -2,6 +2,7 @@
 #include "schemaresolver.h"
 #include "services/notifymanager.h"
 #include "db/db.h"
+#include "db/dbperformanceprofile.h"
 #include "plugins/importplugin.h"
 #include "common/utils.h"
 
@@ -25,6 +26,7 @@ void ImportWorker::run()
         return;
     }
 
+    DbPerformanceProfile::BulkModeGuard bulkMode(db);
     if (!config->skipTransaction && !db->begin())
     {
         error(tr("Could not start transaction in order to import a data: %1").arg(db->getErrorText()));
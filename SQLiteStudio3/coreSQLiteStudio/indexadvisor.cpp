@@ -0,0 +1,552 @@
+#include "indexadvisor.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "parser/parser.h"
+#include "parser/ast/sqliteexpr.h"
+#include "parser/ast/sqliteupdate.h"
+#include "parser/ast/sqlitedelete.h"
+#include "parser/ast/sqliteorderby.h"
+#include "selectresolver.h"
+#include "schemaresolver.h"
+#include "services/config.h"
+#include "services/dbmanager.h"
+#include "sqlitestudio.h"
+#include "common/utils_sql.h"
+#include <QDebug>
+#include <algorithm>
+
+IndexAdvisor::IndexAdvisor(Db* db) :
+    db(db)
+{
+    SchemaResolver resolver(db);
+    for (const QString& name : resolver.getAllObjects())
+        existingNames << name.toLower();
+}
+
+bool IndexAdvisor::addQueries(const QString& sql, double weight)
+{
+    Parser parser;
+    if (!parser.parse(sql))
+    {
+        errors << QObject::tr("Could not parse query, it will be skipped: %1", "index advisor").arg(sql.trimmed().left(200));
+        return false;
+    }
+
+    for (const SqliteQueryPtr& query : parser.getQueries())
+    {
+        if (query->explain)
+            continue;
+
+        switch (query->queryType)
+        {
+            case SqliteQueryType::Select:
+            case SqliteQueryType::Update:
+            case SqliteQueryType::Delete:
+                break;
+            default:
+                continue;
+        }
+
+        Statement stmt;
+        stmt.query = query;
+        stmt.sql = query->detokenize().trimmed();
+        stmt.weight = weight;
+        statements << stmt;
+    }
+    return true;
+}
+
+void IndexAdvisor::addHistory(int limit)
+{
+    for (const Config::SqlHistoryEntryPtr& entry : CFG->getMostExpensiveSqlHistory(db->getName(), limit))
+        addQueries(entry->query, qMax(entry->timeSpent, static_cast<qint64>(1)));
+}
+
+QList<IndexAdvisor::RecommendationPtr> IndexAdvisor::advise()
+{
+    QList<RecommendationPtr> recommendations;
+    candidates.clear();
+    usedIndexNames = existingNames;
+
+    memDb = DBLIST->createInMemDb();
+    if (!memDb || !memDb->openQuiet())
+    {
+        errors << QObject::tr("Could not create in-memory database for analyzing indexes.", "index advisor");
+        safe_delete(memDb);
+        return recommendations;
+    }
+
+    if (copySchema())
+    {
+        for (int i = 0; i < statements.size(); i++)
+        {
+            statements[i].cost = getQueryCost(statements[i].sql);
+            if (statements[i].cost < 0)
+                continue;
+
+            collectCandidates(i);
+        }
+
+        for (const Candidate& candidate : candidates)
+        {
+            RecommendationPtr recommendation = evaluate(candidate);
+            if (recommendation)
+                recommendations << recommendation;
+        }
+    }
+
+    memDb->closeQuiet();
+    safe_delete(memDb);
+
+    std::sort(recommendations.begin(), recommendations.end(), [](const RecommendationPtr& r1, const RecommendationPtr& r2)
+    {
+        return r1->estimatedBenefit > r2->estimatedBenefit;
+    });
+
+    // Index on (a, b) serves queries by (a) as well, so the narrower one is redundant if it has lower benefit.
+    QList<RecommendationPtr> results;
+    Candidate candidate;
+    for (const RecommendationPtr& recommendation : recommendations)
+    {
+        candidate.table = recommendation->table;
+        candidate.columns = recommendation->columns;
+        if (isCoveredBy(candidate, results))
+            continue;
+
+        recommendation->indexName = generateIndexName(recommendation->table, recommendation->columns);
+        recommendation->ddl = QString("CREATE INDEX %1 ON %2 (%3);").arg(wrapObjIfNeeded(recommendation->indexName),
+                                                                          wrapObjIfNeeded(recommendation->table),
+                                                                          wrapObjNamesIfNeeded(recommendation->columns).join(", "));
+        results << recommendation;
+    }
+    return results;
+}
+
+const QStringList& IndexAdvisor::getErrors() const
+{
+    return errors;
+}
+
+int IndexAdvisor::getQueryCount() const
+{
+    return statements.size();
+}
+
+double IndexAdvisor::getPlanCost(const QStringList& planDetails)
+{
+    double cost = 0;
+    for (const QString& detail : planDetails)
+    {
+        if (detail.startsWith("SCAN "))
+        {
+            if (detail.contains("COVERING INDEX"))
+                cost += 40;
+            else if (detail.contains("INDEX"))
+                cost += 50;
+            else
+                cost += 100;
+        }
+        else if (detail.startsWith("SEARCH "))
+        {
+            if (detail.contains("AUTOMATIC"))
+                cost += 60;
+            else if (detail.contains("PRIMARY KEY") || detail.contains("rowid"))
+                cost += 1;
+            else if (detail.contains("COVERING INDEX"))
+                cost += 3;
+            else
+                cost += 5;
+
+            // Range searches visit more rows than equality ones
+            if (detail.contains('<') || detail.contains('>'))
+                cost += 5;
+        }
+        else if (detail.startsWith("USE TEMP B-TREE"))
+        {
+            cost += 30;
+        }
+    }
+    return cost;
+}
+
+bool IndexAdvisor::copySchema()
+{
+    static_qstring(schemaSql, "SELECT type, name, sql FROM sqlite_master WHERE sql IS NOT NULL AND type IN ('table', 'index', 'view') "
+                              "ORDER BY CASE type WHEN 'table' THEN 1 WHEN 'index' THEN 2 ELSE 3 END");
+
+    SqlQueryPtr results = db->exec(schemaSql);
+    if (results->isError())
+    {
+        errors << QObject::tr("Could not read schema of database %1: %2", "index advisor").arg(db->getName(), results->getErrorText());
+        return false;
+    }
+
+    SqlResultsRowPtr row;
+    SqlQueryPtr createResults;
+    while (results->hasNext())
+    {
+        row = results->next();
+        if (isSystemTable(row->value("name").toString()))
+            continue;
+
+        // Objects that cannot be created (i.e. virtual tables of unknown modules) make only queries using them fail to plan.
+        createResults = memDb->exec(row->value("sql").toString());
+        if (createResults->isError())
+            qDebug() << "Index advisor could not copy" << row->value("name").toString() << "to in-memory database:" << createResults->getErrorText();
+    }
+
+    copyStats();
+    return true;
+}
+
+void IndexAdvisor::copyStats()
+{
+    SqlQueryPtr results = db->exec("SELECT tbl, idx, stat FROM sqlite_stat1");
+    if (results->isError())
+        return; // no statistics in database
+
+    // ANALYZE creates the sqlite_stat1 table, then another ANALYZE of sqlite_master makes planner load copied statistics.
+    memDb->exec("ANALYZE sqlite_master");
+
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        memDb->exec("INSERT INTO sqlite_stat1 (tbl, idx, stat) VALUES (?, ?, ?)", row->valueList());
+    }
+
+    memDb->exec("ANALYZE sqlite_master");
+}
+
+void IndexAdvisor::collectCandidates(int statementIdx)
+{
+    SqliteQueryPtr query = statements[statementIdx].query;
+
+    QString table;
+    SqliteExpr* where = nullptr;
+    SqliteUpdatePtr update = query.dynamicCast<SqliteUpdate>();
+    SqliteDeletePtr del = query.dynamicCast<SqliteDelete>();
+    if (update)
+    {
+        table = update->table;
+        where = update->where;
+    }
+    else if (del)
+    {
+        table = del->table;
+        where = del->where;
+    }
+
+    if (where && (update ? update->database : del->database).isEmpty())
+    {
+        QList<SqliteExpr*> equality;
+        QList<SqliteExpr*> range;
+        collectPredicateColumns(where, equality, range);
+
+        TableColumns columns;
+        for (SqliteExpr* expr : equality)
+        {
+            if (expr->table.isEmpty() || expr->table.compare(table, Qt::CaseInsensitive) == 0)
+                appendColumn(columns.equality, expr->column);
+        }
+
+        for (SqliteExpr* expr : range)
+        {
+            if (expr->table.isEmpty() || expr->table.compare(table, Qt::CaseInsensitive) == 0)
+                appendColumn(columns.range, expr->column);
+        }
+
+        addCandidates(statementIdx, {{table, columns}});
+    }
+
+    SelectResolver resolver(memDb, statements[statementIdx].sql);
+    resolver.ignoreInvalidNames = true;
+    for (SqliteSelect::Core* core : query->getAllTypedStatements<SqliteSelect::Core>())
+        collectCandidates(statementIdx, core, resolver);
+}
+
+void IndexAdvisor::collectCandidates(int statementIdx, SqliteSelect::Core* core, SelectResolver& resolver)
+{
+    SqliteSelect* select = dynamic_cast<SqliteSelect*>(core->parentStatement());
+    if (!select || !core->from)
+        return;
+
+    QList<SqliteExpr*> equality;
+    QList<SqliteExpr*> range;
+    if (core->where)
+        collectPredicateColumns(core->where, equality, range);
+
+    for (SqliteSelect::Core::JoinSourceOther* otherSrc : core->from->otherSources)
+    {
+        if (otherSrc->joinConstraint && otherSrc->joinConstraint->expr)
+            collectPredicateColumns(otherSrc->joinConstraint->expr, equality, range);
+    }
+
+    // Index can provide order only if there's a single table and the order applies to this core only.
+    QList<SqliteExpr*> ordering;
+    if (core->from->otherSources.isEmpty() && select->coreSelects.size() == 1)
+    {
+        for (SqliteExpr* expr : core->groupBy)
+        {
+            if (expr->mode == SqliteExpr::Mode::ID)
+                ordering << expr;
+        }
+
+        if (core->groupBy.isEmpty())
+        {
+            for (SqliteOrderBy* orderBy : core->orderBy)
+            {
+                if (orderBy->expr && orderBy->expr->mode == SqliteExpr::Mode::ID)
+                    ordering << orderBy->expr;
+            }
+        }
+    }
+
+    QHash<QString, TableColumns> columnsPerTable;
+    QString table;
+    for (SqliteExpr* expr : equality)
+    {
+        table = resolveTable(expr, select, resolver);
+        if (!table.isNull())
+            appendColumn(columnsPerTable[table].equality, expr->column);
+    }
+
+    for (SqliteExpr* expr : range)
+    {
+        table = resolveTable(expr, select, resolver);
+        if (!table.isNull())
+            appendColumn(columnsPerTable[table].range, expr->column);
+    }
+
+    for (SqliteExpr* expr : ordering)
+    {
+        table = resolveTable(expr, select, resolver);
+        if (!table.isNull())
+            appendColumn(columnsPerTable[table].ordering, expr->column);
+    }
+
+    addCandidates(statementIdx, columnsPerTable);
+}
+
+void IndexAdvisor::collectPredicateColumns(SqliteExpr* expr, QList<SqliteExpr*>& equality, QList<SqliteExpr*>& range)
+{
+    static const QStringList equalityOps = {"=", "==", "IS"};
+    static const QStringList rangeOps = {"<", "<=", ">", ">="};
+
+    if (!expr)
+        return;
+
+    switch (expr->mode)
+    {
+        case SqliteExpr::Mode::SUB_EXPR:
+            collectPredicateColumns(expr->expr1, equality, range);
+            break;
+        case SqliteExpr::Mode::BINARY_OP:
+        {
+            QString op = expr->binaryOp.toUpper();
+            if (op == "AND")
+            {
+                collectPredicateColumns(expr->expr1, equality, range);
+                collectPredicateColumns(expr->expr2, equality, range);
+                break;
+            }
+
+            QList<SqliteExpr*>* target = nullptr;
+            if (equalityOps.contains(op))
+                target = &equality;
+            else if (rangeOps.contains(op))
+                target = &range;
+            else
+                break;
+
+            // Both sides are checked, because it's either "col = value" or "value = col", or join condition "t1.col = t2.col".
+            if (expr->expr1->mode == SqliteExpr::Mode::ID)
+                *target << expr->expr1;
+
+            if (expr->expr2->mode == SqliteExpr::Mode::ID)
+                *target << expr->expr2;
+
+            break;
+        }
+        case SqliteExpr::Mode::IS:
+        case SqliteExpr::Mode::IN:
+            if (!expr->notKw && expr->expr1 && expr->expr1->mode == SqliteExpr::Mode::ID)
+                equality << expr->expr1;
+
+            break;
+        case SqliteExpr::Mode::BETWEEN:
+            if (!expr->notKw && expr->expr1 && expr->expr1->mode == SqliteExpr::Mode::ID)
+                range << expr->expr1;
+
+            break;
+        default:
+            break;
+    }
+}
+
+void IndexAdvisor::addCandidates(int statementIdx, const QHash<QString, TableColumns>& columnsPerTable)
+{
+    QHashIterator<QString, TableColumns> it(columnsPerTable);
+    while (it.hasNext())
+    {
+        it.next();
+        const QString& table = it.key();
+        const TableColumns& columns = it.value();
+        if (!columns.equality.isEmpty())
+        {
+            QStringList indexColumns = columns.equality;
+            if (!columns.range.isEmpty())
+                appendColumn(indexColumns, columns.range.first());
+
+            addCandidate(statementIdx, table, indexColumns);
+
+            if (!columns.ordering.isEmpty())
+            {
+                indexColumns = columns.equality;
+                for (const QString& column : columns.ordering)
+                    appendColumn(indexColumns, column);
+
+                addCandidate(statementIdx, table, indexColumns);
+            }
+            continue;
+        }
+
+        for (const QString& column : columns.range)
+            addCandidate(statementIdx, table, {column});
+
+        if (!columns.ordering.isEmpty())
+            addCandidate(statementIdx, table, columns.ordering);
+    }
+}
+
+void IndexAdvisor::addCandidate(int statementIdx, const QString& table, const QStringList& columns)
+{
+    if (table.isEmpty() || columns.isEmpty())
+        return;
+
+    QStringList indexColumns = columns.mid(0, MAX_INDEX_COLUMNS);
+    QString key = (table + "(" + indexColumns.join(",") + ")").toLower();
+    Candidate& candidate = candidates[key];
+    candidate.table = table;
+    candidate.columns = indexColumns;
+    candidate.statements << statementIdx;
+}
+
+QString IndexAdvisor::resolveTable(SqliteExpr* expr, SqliteSelect* select, SelectResolver& resolver)
+{
+    static const QStringList rowIdNames = {"rowid", "oid", "_rowid_"};
+
+    if (rowIdNames.contains(expr->column, Qt::CaseInsensitive))
+        return QString();
+
+    TokenList columnTokens = expr->getContextColumnTokens(false, false);
+    if (columnTokens.size() != 1)
+        return QString();
+
+    SelectResolver::Column column = resolver.translateToColumns(select, columnTokens.first());
+    if (column.type != SelectResolver::Column::COLUMN || column.table.isEmpty())
+        return QString();
+
+    // Columns from subqueries and CTEs are not columns of real tables.
+    if (column.flags & (SelectResolver::FROM_ANONYMOUS_SELECT | SelectResolver::FROM_CTE_SELECT))
+        return QString();
+
+    if (!column.database.isEmpty() && column.database.compare("main", Qt::CaseInsensitive) != 0)
+        return QString();
+
+    return column.table;
+}
+
+double IndexAdvisor::getQueryCost(const QString& sql)
+{
+    static_qstring(planTpl, "EXPLAIN QUERY PLAN %1");
+
+    // Bind parameters are left unbound, they don't change the plan.
+    SqlQueryPtr results = memDb->exec(planTpl.arg(sql), Db::Flag::SKIP_PARAM_COUNTING);
+    if (results->isError())
+    {
+        errors << QObject::tr("Could not get query plan, query will be skipped: %1\nError: %2", "index advisor")
+                  .arg(sql.left(200), results->getErrorText());
+        return -1;
+    }
+
+    QStringList details;
+    while (results->hasNext())
+        details << results->next()->value("detail").toString();
+
+    return getPlanCost(details);
+}
+
+IndexAdvisor::RecommendationPtr IndexAdvisor::evaluate(const IndexAdvisor::Candidate& candidate)
+{
+    static_qstring(createTpl, "CREATE INDEX %1 ON %2 (%3)");
+    static_qstring(dropTpl, "DROP INDEX %1");
+    static_qstring(tmpIndexName, "sqlitestudio_index_advisor_candidate");
+
+    SqlQueryPtr results = memDb->exec(createTpl.arg(tmpIndexName, wrapObjIfNeeded(candidate.table),
+                                                    wrapObjNamesIfNeeded(candidate.columns).join(", ")));
+    if (results->isError())
+    {
+        qDebug() << "Index advisor could not create candidate index on" << candidate.table << candidate.columns << ":" << results->getErrorText();
+        return RecommendationPtr();
+    }
+
+    RecommendationPtr recommendation = RecommendationPtr::create();
+    double cost;
+    for (int idx : candidate.statements)
+    {
+        const Statement& stmt = statements[idx];
+        cost = getQueryCost(stmt.sql);
+        if (cost < 0 || cost >= stmt.cost)
+            continue;
+
+        recommendation->estimatedBenefit += stmt.weight * (stmt.cost - cost) / stmt.cost;
+        recommendation->queries << stmt.sql;
+    }
+
+    memDb->exec(dropTpl.arg(tmpIndexName));
+
+    if (recommendation->queries.isEmpty())
+        return RecommendationPtr();
+
+    recommendation->table = candidate.table;
+    recommendation->columns = candidate.columns;
+    return recommendation;
+}
+
+QString IndexAdvisor::generateIndexName(const QString& table, const QStringList& columns)
+{
+    QString baseName = "idx_" + table + "_" + columns.join("_");
+    QString name = baseName;
+    for (int i = 2; usedIndexNames.contains(name.toLower()); i++)
+        name = baseName + "_" + QString::number(i);
+
+    usedIndexNames << name.toLower();
+    return name;
+}
+
+bool IndexAdvisor::isCoveredBy(const IndexAdvisor::Candidate& candidate, const QList<IndexAdvisor::RecommendationPtr>& recommendations)
+{
+    for (const RecommendationPtr& recommendation : recommendations)
+    {
+        if (recommendation->table.compare(candidate.table, Qt::CaseInsensitive) != 0)
+            continue;
+
+        if (recommendation->columns.size() < candidate.columns.size())
+            continue;
+
+        bool covered = true;
+        for (int i = 0; i < candidate.columns.size() && covered; i++)
+            covered = (recommendation->columns[i].compare(candidate.columns[i], Qt::CaseInsensitive) == 0);
+
+        if (covered)
+            return true;
+    }
+    return false;
+}
+
+void IndexAdvisor::appendColumn(QStringList& list, const QString& column)
+{
+    if (!list.contains(column, Qt::CaseInsensitive))
+        list << column;
+}
@@ -0,0 +1,160 @@
+#ifndef INDEXADVISOR_H
+#define INDEXADVISOR_H
+
+#include "coreSQLiteStudio_global.h"
+#include "parser/ast/sqlitequery.h"
+#include "parser/ast/sqliteselect.h"
+#include <QString>
+#include <QStringList>
+#include <QSharedPointer>
+#include <QHash>
+#include <QSet>
+
+class Db;
+class SqliteExpr;
+class SelectResolver;
+
+/**
+ * @brief Proposes indexes that would speed up given queries.
+ *
+ * Queries are provided either explicitly with addQueries(), or taken from the SQL history with addHistory().
+ * The advisor works on an in-memory copy of the database schema (data is not copied, but sqlite_stat1 is),
+ * so the analyzed database is not modified and analysis does not depend on the amount of data.
+ *
+ * For each SELECT, UPDATE and DELETE (including subqueries) the advisor collects columns used
+ * in WHERE and JOIN constraints (equality and range comparisons), as well as in ORDER BY and GROUP BY
+ * of single-source selects. Columns are resolved to their tables with SelectResolver.
+ * From those columns candidate indexes are built per table: equality columns first, followed
+ * by a range or ordering column.
+ *
+ * Each candidate is then created in the in-memory copy and queries are re-planned with EXPLAIN QUERY PLAN.
+ * Plans are compared with a simple cost model (see getPlanCost()) and candidates that don't improve
+ * any query are dropped. The estimated benefit of a candidate is a sum of relative plan cost reductions
+ * of improved queries, each multiplied by the query weight. For queries from the history the weight
+ * is total time spent on executing them (in milliseconds), so slow and frequent queries matter most.
+ *
+ * The advise() can take a while for many queries, so it's best to call it from a separate thread.
+ */
+class API_EXPORT IndexAdvisor
+{
+    public:
+        /**
+         * @brief Single proposed index.
+         */
+        struct API_EXPORT Recommendation
+        {
+            QString table;              /**< Table to be indexed. */
+            QStringList columns;        /**< Indexed columns, in order. */
+            QString indexName;          /**< Proposed name for the index, not conflicting with existing objects. */
+            QString ddl;                /**< CREATE INDEX statement for the analyzed database. */
+            QStringList queries;        /**< Queries that got a cheaper plan with this index. */
+            double estimatedBenefit = 0;
+        };
+
+        typedef QSharedPointer<Recommendation> RecommendationPtr;
+
+        /**
+         * @brief Creates advisor for the database.
+         * @param db Open database to be analyzed.
+         *
+         * Names of existing database objects are read right away, in the calling thread,
+         * so proposed index names don't conflict with them and advise() doesn't need to resolve the schema.
+         */
+        explicit IndexAdvisor(Db* db);
+
+        /**
+         * @brief Adds queries to analyze.
+         * @param sql One or more queries.
+         * @param weight Importance of queries, i.e. how much time is spent on them.
+         * @return true if queries were parsed successfully. Otherwise they're skipped and the error is available in getErrors().
+         */
+        bool addQueries(const QString& sql, double weight = 1.0);
+
+        /**
+         * @brief Adds the most expensive queries executed on the database, according to the SQL history.
+         * @param limit Maximum number of history entries to use.
+         *
+         * See Config::getMostExpensiveSqlHistory() for how entries are picked.
+         */
+        void addHistory(int limit);
+
+        /**
+         * @brief Analyzes added queries and proposes indexes.
+         * @return Recommendations ordered by estimated benefit, the best first.
+         */
+        QList<RecommendationPtr> advise();
+
+        /**
+         * @brief Provides problems encountered while analyzing.
+         * @return List of localized error messages.
+         *
+         * Errors are not fatal, problematic queries are just skipped.
+         */
+        const QStringList& getErrors() const;
+
+        /**
+         * @brief Provides number of queries that will be analyzed.
+         * @return Number of SELECT, UPDATE and DELETE statements added so far.
+         */
+        int getQueryCount() const;
+
+        /**
+         * @brief Estimates cost of the query plan.
+         * @param planDetails "detail" column values of EXPLAIN QUERY PLAN.
+         * @return Cost in arbitrary units.
+         *
+         * Full table scans are the most expensive, followed by automatic indexes, temporary b-trees (sorting)
+         * and full index scans. Searches by an index are cheap and searches by the primary key are the cheapest.
+         */
+        static double getPlanCost(const QStringList& planDetails);
+
+    private:
+        struct Statement
+        {
+            SqliteQueryPtr query;
+            QString sql;
+            double weight = 1.0;
+            double cost = -1;
+        };
+
+        struct Candidate
+        {
+            QString table;
+            QStringList columns;
+            QSet<int> statements;
+        };
+
+        struct TableColumns
+        {
+            QStringList equality;
+            QStringList range;
+            QStringList ordering;
+        };
+
+        bool copySchema();
+        void copyStats();
+        void collectCandidates(int statementIdx);
+        void collectCandidates(int statementIdx, SqliteSelect::Core* core, SelectResolver& resolver);
+        void collectPredicateColumns(SqliteExpr* expr, QList<SqliteExpr*>& equality, QList<SqliteExpr*>& range);
+        void addCandidates(int statementIdx, const QHash<QString, TableColumns>& columnsPerTable);
+        void addCandidate(int statementIdx, const QString& table, const QStringList& columns);
+        QString resolveTable(SqliteExpr* expr, SqliteSelect* select, SelectResolver& resolver);
+        double getQueryCost(const QString& sql);
+        RecommendationPtr evaluate(const Candidate& candidate);
+        QString generateIndexName(const QString& table, const QStringList& columns);
+        bool isCoveredBy(const Candidate& candidate, const QList<RecommendationPtr>& recommendations);
+
+        static void appendColumn(QStringList& list, const QString& column);
+
+        static const int MAX_INDEX_COLUMNS = 5;
+
+        Db* db = nullptr;
+        Db* memDb = nullptr;
+        QList<Statement> statements;
+        QHash<QString, Candidate> candidates;
+        QSet<QString> existingNames;
+        QSet<QString> usedIndexNames;
+        QStringList errors;
+};
+
+#endif // INDEXADVISOR_H
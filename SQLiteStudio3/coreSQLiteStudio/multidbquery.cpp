@@ -0,0 +1,279 @@
+#include "multidbquery.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include <QThreadPool>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <limits>
+
+MultiDbQuery::MultiDbQuery(const QString& query, QObject* parent) :
+    QObject(parent), query(query)
+{
+    qRegisterMetaType<MultiDbQuery::Result>();
+    qRegisterMetaType<QList<QList<QVariant>>>("QList<QList<QVariant>>");
+}
+
+void MultiDbQuery::addDb(Db* db)
+{
+    workerConnections.addDb(db);
+}
+
+MultiDbQuery::Merge MultiDbQuery::getMerge() const
+{
+    return merge;
+}
+
+void MultiDbQuery::setMerge(Merge value)
+{
+    merge = value;
+}
+
+int MultiDbQuery::getThreads() const
+{
+    return threads;
+}
+
+void MultiDbQuery::setThreads(int value)
+{
+    threads = qMax(1, value);
+}
+
+bool MultiDbQuery::exec()
+{
+    workerConnections.reset();
+    nextTarget = 0;
+    results.clear();
+    columns.clear();
+    columnsDefined = false;
+    totals.clear();
+
+    emit started(workerConnections.count());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    QList<QFuture<void>> workers;
+    for (int i = 0, total = qMin(threads, workerConnections.count()); i < total; i++)
+        workers << QtConcurrent::run(&pool, this, &MultiDbQuery::runWorker);
+
+    for (QFuture<void>& worker : workers)
+        worker.waitForFinished();
+
+    return !workerConnections.isInterrupted();
+}
+
+void MultiDbQuery::interrupt()
+{
+    workerConnections.interrupt();
+}
+
+QList<MultiDbQuery::Result> MultiDbQuery::getResults() const
+{
+    QMutexLocker locker(&resultsMutex);
+    return results;
+}
+
+QStringList MultiDbQuery::getColumns() const
+{
+    QMutexLocker locker(&resultsMutex);
+    return columns;
+}
+
+QList<QVariant> MultiDbQuery::getTotals() const
+{
+    QMutexLocker locker(&resultsMutex);
+    return totals;
+}
+
+QString MultiDbQuery::toString(Merge merge)
+{
+    switch (merge)
+    {
+        case Merge::UNION:
+            return tr("All rows");
+        case Merge::SUM:
+            return tr("Sum of columns");
+        case Merge::COUNT:
+            return tr("Row count per database");
+    }
+    return QString();
+}
+
+void MultiDbQuery::runWorker()
+{
+    int target;
+    while (takeTarget(target))
+    {
+        Result result = execOnTarget(target);
+
+        QMutexLocker locker(&resultsMutex);
+        results << result;
+        int finishedDbs = results.size();
+        locker.unlock();
+
+        emit dbFinished(result, finishedDbs, workerConnections.count());
+    }
+}
+
+bool MultiDbQuery::takeTarget(int& target)
+{
+    if (workerConnections.isInterrupted())
+        return false;
+
+    QMutexLocker locker(&resultsMutex);
+    if (nextTarget >= workerConnections.count())
+        return false;
+
+    target = nextTarget++;
+    return true;
+}
+
+MultiDbQuery::Result MultiDbQuery::execOnTarget(int target)
+{
+    Result result;
+    result.database = workerConnections.getName(target);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString errorText;
+    Db* db = workerConnections.open(target, false, errorText);
+    if (!db)
+    {
+        result.success = false;
+        result.errorText = errorText;
+        result.duration = timer.elapsed();
+        return result;
+    }
+
+    SqlQueryPtr dbResults = db->exec(query);
+    if (!dbResults->isError() && dbResults->columnCount() > 0 && !checkColumns(dbResults->getColumnNames(), errorText))
+    {
+        result.success = false;
+        result.errorText = errorText;
+        result.duration = timer.elapsed();
+        workerConnections.close(db);
+        return result;
+    }
+
+    QList<QList<QVariant>> rows;
+    while (!dbResults->isError() && dbResults->hasNext() && !workerConnections.isInterrupted())
+    {
+        SqlResultsRowPtr row = dbResults->next();
+        if (!row)
+            break;
+
+        result.rows++;
+        if (merge == Merge::COUNT)
+            continue;
+
+        rows << row->valueList();
+        if (rows.size() >= ROWS_PER_BATCH)
+            flushRows(result.database, rows);
+    }
+    flushRows(result.database, rows);
+
+    // Errors may also occur while reading rows, i.e. when interrupted
+    if (dbResults->isError())
+    {
+        result.success = false;
+        result.errorText = dbResults->getErrorText();
+    }
+    else
+    {
+        result.rowsAffected = dbResults->rowsAffected();
+    }
+
+    result.duration = timer.elapsed();
+    workerConnections.close(db);
+    return result;
+}
+
+bool MultiDbQuery::checkColumns(const QStringList& dbColumns, QString& errorText)
+{
+    QMutexLocker locker(&resultsMutex);
+    if (!columnsDefined)
+    {
+        columns = dbColumns;
+        columnsDefined = true;
+        for (int i = 0, total = columns.size(); i < total; i++)
+            totals << QVariant();
+
+        // Emitted under the lock, so it's queued before rows of any other database
+        emit columnsFetched(columns);
+        return true;
+    }
+
+    if (dbColumns.size() != columns.size())
+    {
+        errorText = tr("The query returned %1 column(s), while other databases returned %2 column(s).").arg(dbColumns.size()).arg(columns.size());
+        return false;
+    }
+    return true;
+}
+
+void MultiDbQuery::flushRows(const QString& database, QList<QList<QVariant>>& rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    if (merge == Merge::UNION)
+        emit rowsFetched(database, rows);
+    else if (merge == Merge::SUM)
+        sumUp(rows);
+
+    rows.clear();
+}
+
+void MultiDbQuery::sumUp(const QList<QList<QVariant>>& rows)
+{
+    // Sum up the batch locally first, to hold the lock shortly
+    QList<QVariant> batchTotals;
+    for (const QList<QVariant>& row : rows)
+    {
+        for (int i = 0, total = row.size(); i < total; i++)
+        {
+            if (batchTotals.size() <= i)
+                batchTotals << QVariant();
+
+            addToTotal(batchTotals[i], row[i]);
+        }
+    }
+
+    QMutexLocker locker(&resultsMutex);
+    for (int i = 0, total = qMin(batchTotals.size(), totals.size()); i < total; i++)
+        addToTotal(totals[i], batchTotals[i]);
+}
+
+void MultiDbQuery::addToTotal(QVariant& total, const QVariant& value)
+{
+    // Only values stored as numbers are summed up, like the SQL sum() does with integers and reals
+    QVariant::Type type = value.type();
+    bool isInt = (type == QVariant::Int || type == QVariant::LongLong || type == QVariant::UInt || type == QVariant::ULongLong);
+    if (!isInt && type != QVariant::Double)
+        return;
+
+    if (total.isNull())
+    {
+        total = (isInt && !isSumOverflowing(0, value)) ? QVariant(value.toLongLong()) : QVariant(value.toDouble());
+        return;
+    }
+
+    if (isInt && total.type() == QVariant::LongLong && !isSumOverflowing(total.toLongLong(), value))
+        total = total.toLongLong() + value.toLongLong();
+    else
+        total = total.toDouble() + value.toDouble(); // once overflowed, the sum stays approximate, like the SQL total()
+}
+
+bool MultiDbQuery::isSumOverflowing(qint64 total, const QVariant& value)
+{
+    if (value.type() == QVariant::ULongLong && value.toULongLong() > static_cast<quint64>(std::numeric_limits<qint64>::max()))
+        return true;
+
+    qint64 intValue = value.toLongLong();
+    if (intValue > 0)
+        return total > std::numeric_limits<qint64>::max() - intValue;
+
+    return total < std::numeric_limits<qint64>::min() - intValue;
+}
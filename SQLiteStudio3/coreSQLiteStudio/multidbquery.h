@@ -0,0 +1,186 @@
+#ifndef MULTIDBQUERY_H
+#define MULTIDBQUERY_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include "interruptable.h"
+#include "dbworkerconnections.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVariant>
+#include <QMutex>
+
+class Db;
+
+/**
+ * @brief Executes the same query on many databases in parallel.
+ *
+ * It's meant for databases sharing the same schema (i.e. a database per customer), where the same
+ * query has to be checked on all of them. Unlike attaching databases (see DbAttacher), it's not limited
+ * by the number of databases that can be attached to a single connection and databases are queried concurrently.
+ *
+ * Each database is queried by a worker from a bounded pool, using its own connection, opened with the same
+ * driver and options as the registered database. The registered Db objects are not used for the execution,
+ * so databases don't need to be open and the application can work with them in the meantime.
+ *
+ * Results of databases are merged according to the Merge mode:
+ * <ul>
+ * <li>Merge::UNION - rows of all databases are streamed with rowsFetched() as they're read,</li>
+ * <li>Merge::SUM - numeric values of each column are summed up over all rows of all databases, see getTotals(),</li>
+ * <li>Merge::COUNT - only number of rows returned by each database is reported in Result::rows.</li>
+ * </ul>
+ * All databases have to return the same number of columns. Column names are taken from the first database
+ * that returned results.
+ *
+ * The query has to be a single statement. Bind parameters are not supported.
+ *
+ * The exec() blocks until all databases are done, so it's best to call it from a separate thread.
+ * Signals are emitted from worker threads.
+ */
+class API_EXPORT MultiDbQuery : public QObject, public Interruptable
+{
+        Q_OBJECT
+
+    public:
+        enum class Merge
+        {
+            UNION,
+            SUM,
+            COUNT
+        };
+
+        /**
+         * @brief Result of the query on a single database.
+         */
+        struct API_EXPORT Result
+        {
+            QString database;
+            bool success = true;
+            QString errorText;
+
+            /**
+             * @brief Number of rows returned by the query.
+             */
+            qint64 rows = 0;
+
+            /**
+             * @brief Number of rows affected by the query, if it was a data modifying query.
+             */
+            qint64 rowsAffected = 0;
+
+            /**
+             * @brief Time of execution (including reading all rows) in milliseconds.
+             */
+            qint64 duration = 0;
+        };
+
+        explicit MultiDbQuery(const QString& query, QObject* parent = nullptr);
+
+        /**
+         * @brief Adds database to execute the query on.
+         * @param db Registered database.
+         *
+         * Only the name, path, driver and connection options of the database are remembered.
+         */
+        void addDb(Db* db);
+
+        Merge getMerge() const;
+        void setMerge(Merge value);
+
+        int getThreads() const;
+        void setThreads(int value);
+
+        /**
+         * @brief Executes the query on all added databases.
+         * @return true if the query was executed on all databases, or false if it was interrupted.
+         *
+         * Failures on single databases don't stop the execution, they're reported in results.
+         */
+        bool exec();
+
+        void interrupt();
+
+        /**
+         * @brief Provides results of all finished databases.
+         * @return Results in order of finishing.
+         */
+        QList<Result> getResults() const;
+
+        /**
+         * @brief Provides column names of results.
+         * @return Names of columns returned by the first database that returned results.
+         */
+        QStringList getColumns() const;
+
+        /**
+         * @brief Provides sums of columns for Merge::SUM.
+         * @return Sum per column, or null value for columns with no numeric values.
+         *
+         * Sums of integers are integers, unless they exceed the 64-bit integer range. Such sums are provided as doubles.
+         */
+        QList<QVariant> getTotals() const;
+
+        /**
+         * @brief Provides localized name of the merge mode.
+         */
+        static QString toString(Merge merge);
+
+    private:
+        void runWorker();
+        bool takeTarget(int& target);
+        Result execOnTarget(int target);
+        bool checkColumns(const QStringList& dbColumns, QString& errorText);
+        void flushRows(const QString& database, QList<QList<QVariant>>& rows);
+        void sumUp(const QList<QList<QVariant>>& rows);
+
+        static void addToTotal(QVariant& total, const QVariant& value);
+        static bool isSumOverflowing(qint64 total, const QVariant& value);
+
+        static const int ROWS_PER_BATCH = 500;
+
+        QString query;
+        DbWorkerConnections workerConnections;
+        Merge merge = Merge::UNION;
+        int threads = 8;
+
+        int nextTarget = 0;
+        QList<Result> results;
+        QStringList columns;
+        bool columnsDefined = false;
+        QList<QVariant> totals;
+        mutable QMutex resultsMutex;
+
+    signals:
+        /**
+         * @brief Emitted before the query is executed.
+         * @param totalDbs Number of databases to execute the query on.
+         */
+        void started(int totalDbs);
+
+        /**
+         * @brief Emitted once, when the first database returned results.
+         * @param columns Column names.
+         */
+        void columnsFetched(const QStringList& columns);
+
+        /**
+         * @brief Emitted with batches of rows read from a database, only for Merge::UNION.
+         * @param database Name of the source database.
+         * @param rows Rows read from the database.
+         */
+        void rowsFetched(const QString& database, const QList<QList<QVariant>>& rows);
+
+        /**
+         * @brief Emitted after the query is finished on a database (from the worker thread).
+         * @param result Result of the database.
+         * @param finishedDbs Number of databases finished so far.
+         * @param totalDbs Number of all databases.
+         */
+        void dbFinished(const MultiDbQuery::Result& result, int finishedDbs, int totalDbs);
+};
+
+Q_DECLARE_METATYPE(MultiDbQuery::Result)
+
+#endif // MULTIDBQUERY_H
@@ -560,6 +560,44 @@ static int yy_find_reduce_action(
   return yy_action[i];
 }
 
+/*
+** Find the shift action for the given state and the terminal look-ahead
+** token iLookAhead. It's the same as yy_find_shift_action(), except it works
+** with any state (not only the one on top of the stack) and never follows
+** fallback tokens.
+*/
+static int yy_find_state_shift_action(
+  int stateno,              /* The state */
+  YYCODETYPE iLookAhead     /* The look-ahead token */
+){
+  int i;
+  if( stateno>YY_SHIFT_COUNT
+   || (i = yy_shift_ofst[stateno])==YY_SHIFT_USE_DFLT ){
+    return yy_default[stateno];
+  }
+  i += iLookAhead;
+  if( i<0 || i>=YY_ACTTAB_COUNT || yy_lookahead[i]!=iLookAhead ){
+#ifdef YYWILDCARD
+    if( iLookAhead>0 ){
+      int j = i - iLookAhead + YYWILDCARD;
+      if(
+#if YY_SHIFT_MIN+YYWILDCARD<0
+        j>=0 &&
+#endif
+#if YY_SHIFT_MAX+YYWILDCARD>=YY_ACTTAB_COUNT
+        j<YY_ACTTAB_COUNT &&
+#endif
+        yy_lookahead[j]==YYWILDCARD
+      ){
+        return yy_action[j];
+      }
+    }
+#endif /* YYWILDCARD */
+    return yy_default[stateno];
+  }
+  return yy_action[i];
+}
+
 /*
 ** The following routine is called if the stack overflows.
 */
@@ -636,6 +674,75 @@ static const struct {
 %%
 };
 
+/*
+** Checks whether the parser in its current state would accept the given
+** terminal as the next token, without parsing it and without modifying
+** the parser. The action tables are walked just like Parse() would do it,
+** including the chain of reductions triggered by the token, but only state
+** numbers are tracked and no reduction code is executed. Fallback tokens
+** are not considered.
+**
+** Returns 1 if the token would be shifted (or would complete the input),
+** 0 if it would cause a syntax error, or -1 if it cannot be determined
+** from the tables, which is the case while the parser recovers from
+** a previous syntax error (no errors are reported in that state).
+*/
+int ParseIsTokenAccepted(void* yyp, int yymajor)
+{
+  yyParser *pParser = (yyParser*)yyp;
+  int states[100];                  /* States pushed by the simulated reductions */
+  int statesCnt = 0;                /* Number of entries in states[] */
+  int baseIdx = pParser->yyidx;     /* Top of the remaining part of the real stack */
+  int stateno;
+  int yyact;
+  int yyruleno;
+  int yysize;
+
+  if( pParser->yyidx<0 ){
+    states[statesCnt++] = 0;
+#ifdef YYERRORSYMBOL
+  }else if( pParser->yyerrcnt>=0 ){
+#else
+  }else if( pParser->yyerrcnt>0 ){
+#endif
+    return -1;
+  }
+
+  while( 1 ){
+    stateno = statesCnt>0 ? states[statesCnt-1] : pParser->yystack[baseIdx].stateno;
+    yyact = yy_find_state_shift_action(stateno, (YYCODETYPE)yymajor);
+    if( yyact<YYNSTATE ){
+#if YYSTACKDEPTH>0
+      if( baseIdx+statesCnt+1>=YYSTACKDEPTH ){
+        return 0; /* would overflow the stack */
+      }
+#endif
+      return 1;
+    }
+    if( yyact>=YYNSTATE+YYNRULE ){
+      return 0;
+    }
+
+    yyruleno = yyact-YYNSTATE;
+    yysize = yyRuleInfo[yyruleno].nrhs;
+    if( yysize<=statesCnt ){
+      statesCnt -= yysize;
+    }else{
+      baseIdx -= yysize-statesCnt;
+      statesCnt = 0;
+    }
+    stateno = statesCnt>0 ? states[statesCnt-1] : pParser->yystack[baseIdx].stateno;
+    yyact = yy_find_reduce_action(stateno, yyRuleInfo[yyruleno].lhs);
+    if( yyact>=YYNSTATE ){
+      return 1; /* accepted */
+    }
+    if( statesCnt>=(int)(sizeof(states)/sizeof(states[0])) ){
+      return -1;
+    }
+    states[statesCnt++] = yyact;
+  }
+}
+
 static void yy_accept(yyParser*);  /* Forward Declaration */
 
 /*
@@ -53,10 +53,10 @@ TokenList Lexer::process(const QString &sql)
     return resultList;
 }
 
-void Lexer::prepare(const QString &sql)
+void Lexer::prepare(const QString &sql, quint64 startPosition)
 {
     sqlToTokenize = sql;
-    tokenPosition = 0;
+    tokenPosition = startPosition;
 }
 
 TokenPtr Lexer::getToken()
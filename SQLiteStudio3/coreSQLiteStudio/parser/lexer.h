@@ -42,10 +42,11 @@ class API_EXPORT Lexer
         /**
          * @brief Stores given SQL query internally for further processing by the lexer.
          * @param sql Query to remember.
+         * @param startPosition Position of the query in the original text. It's added to positions of produced tokens.
          *
          * This method should be followed by calls to getToken().
          */
-        void prepare(const QString& sql);
+        void prepare(const QString& sql, quint64 startPosition = 0);
 
         /**
          * @brief Gets next token from query defined with prepare().
@@ -2,6 +2,7 @@
 #include "parsercontext.h"
 #include "parsererror.h"
 #include "lexer.h"
+#include "parsercheckpoints.h"
 #include "../db/db.h"
 #include "ast/sqliteselect.h"
 #include <QStringList>
@@ -17,6 +18,7 @@ void* sqlite3_parseCopyParserState(void* other);
 void  sqlite3_parseRestoreParserState(void* saved, void* target);
 void  sqlite3_parseFreeSavedState(void* other);
 void  sqlite3_parseAddToken(void* other, Token* token);
+int   sqlite3_parseIsTokenAccepted(void* yyp, int yymajor);
 
 Parser::Parser()
 {
@@ -83,13 +85,18 @@ void Parser::parseAddToken(void *other, TokenPtr token)
     sqlite3_parseAddToken(other, token.data());
 }
 
+int Parser::parseIsTokenAccepted(void *yyp, int yymajor)
+{
+    return sqlite3_parseIsTokenAccepted(yyp, yymajor);
+}
+
 bool Parser::parse(const QString &sql, bool ignoreMinorErrors)
 {
     context->ignoreMinorErrors = ignoreMinorErrors;
     return parseInternal(sql, false);
 }
 
-bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken)
+bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken, ParserCheckpoints* checkpoints)
 {
     void* pParser = parseAlloc( malloc );
     if (debugLemon)
@@ -101,16 +108,34 @@ bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken)
         parseTrace(nullptr, nullptr);
 
     reset();
-    lexer->prepare(sql);
     context->setupTokens = !lookForExpectedToken;
     context->executeRules = !lookForExpectedToken;
     context->doFallbacks = !lookForExpectedToken;
 
+    // Checkpoints contain states of parser in expected token lookup mode, so they cannot be used for regular parsing.
+    if (!lookForExpectedToken)
+        checkpoints = nullptr;
+
+    ParserCheckpoints::Checkpoint checkpoint;
+    if (checkpoints && checkpoints->findFor(sql, checkpoint))
+    {
+        parseRestoreParserState(checkpoint.state, pParser);
+        for (const TokenPtr& parsedToken : checkpoints->tokens.mid(0, checkpoint.tokenCount))
+            context->addManagedToken(parsedToken);
+
+        lexer->prepare(sql.mid(checkpoint.position), checkpoint.position);
+    }
+    else
+    {
+        lexer->prepare(sql);
+    }
+
     TokenPtr token = lexer->getToken();
     if (!token.isNull())
         context->addManagedToken(token);
 
     bool endsWithSemicolon = false;
+    int tokensSinceCheckpoint = 0;
 
     while (token)
     {
@@ -126,6 +151,15 @@ bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken)
             continue;
         }
 
+        // Save parser state at the beginning of each statement and every few tokens, but never for the last token,
+        // as it might be still incomplete (the user is typing it) and it will be lexed differently next time.
+        if (checkpoints && !lexer->isEnd() && (endsWithSemicolon || tokensSinceCheckpoint >= ParserCheckpoints::CHECKPOINT_INTERVAL))
+        {
+            checkpoints->add(parseCopyParserState(pParser), token, context->managedTokens.size() - 1);
+            tokensSinceCheckpoint = 0;
+        }
+        tokensSinceCheckpoint++;
+
         endsWithSemicolon = (token->type == Token::OPERATOR && token->value == ";");
 
         parse(pParser, token->lemonType, token, context);
@@ -137,6 +171,8 @@ bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken)
     if (lookForExpectedToken)
     {
         expectedTokenLookup(pParser);
+        if (checkpoints)
+            checkpoints->setParsed(sql, context->managedTokens);
     }
     else
     {
@@ -165,10 +201,10 @@ bool Parser::parseInternal(const QString &sql, bool lookForExpectedToken)
     return context->isSuccessful();
 }
 
-TokenList Parser::getNextTokenCandidates(const QString &sql)
+TokenList Parser::getNextTokenCandidates(const QString &sql, ParserCheckpoints* checkpoints)
 {
     context->ignoreMinorErrors = true;
-    parseInternal(sql, true);
+    parseInternal(sql, true, checkpoints);
     TokenList results = acceptedTokens;
     acceptedTokens.clear();
     return results;
@@ -199,25 +235,47 @@ SqliteExpr *Parser::parseExpr(const QString &sql)
 
 void Parser::expectedTokenLookup(void* pParser)
 {
+    static const QSet<Token::Type> regularTypes = {
+        Token::KEYWORD, Token::OTHER, Token::PAR_LEFT, Token::PAR_RIGHT, Token::OPERATOR, Token::INVALID
+    };
+    static const QSet<Token::Type> contextTypes = {
+        Token::CTX_COLLATION, Token::CTX_COLUMN, Token::CTX_DATABASE, Token::CTX_FUNCTION,
+        Token::CTX_INDEX, Token::CTX_JOIN_OPTS, Token::CTX_TABLE, Token::CTX_TRIGGER,
+        Token::CTX_VIEW, Token::CTX_FK_MATCH, Token::CTX_ERROR_MESSAGE, Token::CTX_PRAGMA,
+        Token::CTX_ALIAS, Token::CTX_TABLE_NEW, Token::CTX_INDEX_NEW, Token::CTX_TRIGGER_NEW,
+        Token::CTX_VIEW_NEW, Token::CTX_COLUMN_NEW, Token::CTX_TRANSACTION,
+        Token::CTX_CONSTRAINT, Token::CTX_COLUMN_TYPE, Token::CTX_OLD_KW, Token::CTX_NEW_KW,
+        Token::CTX_ROWID_KW
+    };
+
+    // Regular tokens are checked against Lemon's tables, which is way faster than parsing each of them.
+    QList<TokenPtr> tokensToProbe;
+    for (const TokenPtr& token : lexer->getEveryTokenType(regularTypes))
+    {
+        switch (tokenTableLookup ? parseIsTokenAccepted(pParser, token->lemonType) : -1)
+        {
+            case 1:
+                acceptedTokens += token;
+                break;
+            case 0:
+                break;
+            default:
+                tokensToProbe += token;
+                break;
+        }
+    }
+
+    // Context tokens (some of which share Lemon type with regular tokens) and tokens undetermined
+    // by the tables are probed with the actual parsing.
+    for (const TokenPtr& token : lexer->getEveryTokenType(contextTypes))
+        tokensToProbe += token;
+
     void* savedParser = parseCopyParserState(pParser);
 
     ParserContext tempContext;
     tempContext.executeRules = false;
-    tempContext.executeRules = false;
     tempContext.doFallbacks = false;
-    QSet<TokenPtr> tokenSet =
-            lexer->getEveryTokenType({
-                Token::KEYWORD, Token::OTHER, Token::PAR_LEFT, Token::PAR_RIGHT, Token::OPERATOR,
-                Token::CTX_COLLATION, Token::CTX_COLUMN, Token::CTX_DATABASE, Token::CTX_FUNCTION,
-                Token::CTX_INDEX, Token::CTX_JOIN_OPTS, Token::CTX_TABLE, Token::CTX_TRIGGER,
-                Token::CTX_VIEW, Token::CTX_FK_MATCH, Token::CTX_ERROR_MESSAGE, Token::CTX_PRAGMA,
-                Token::CTX_ALIAS, Token::CTX_TABLE_NEW, Token::CTX_INDEX_NEW, Token::CTX_TRIGGER_NEW,
-                Token::CTX_VIEW_NEW, Token::CTX_COLUMN_NEW, Token::CTX_TRANSACTION,
-                Token::CTX_CONSTRAINT, Token::CTX_COLUMN_TYPE, Token::CTX_OLD_KW, Token::CTX_NEW_KW,
-                Token::CTX_ROWID_KW, Token::INVALID
-            });
-
-    for (TokenPtr token : tokenSet)
+    for (const TokenPtr& token : tokensToProbe)
     {
         parse(pParser, token->lemonType, token, &tempContext);
 
@@ -261,6 +319,11 @@ void Parser::setLemonDebug(bool enabled)
     debugLemon = enabled;
 }
 
+void Parser::setTokenTableLookup(bool enabled)
+{
+    tokenTableLookup = enabled;
+}
+
 const QList<SqliteQueryPtr>& Parser::getQueries()
 {
     return context->getQueries();
@@ -9,6 +9,7 @@
 class Lexer;
 class ParserContext;
 class ParserError;
+class ParserCheckpoints;
 
 /**
  * @brief SQL parser.
@@ -74,6 +75,14 @@ class API_EXPORT Parser
          */
         void setLemonDebug(bool enabled);
 
+        /**
+         * @brief Enables or disables checking regular tokens against Lemon's tables in getNextTokenCandidates().
+         * @param enabled true to check tables (the default), false to probe every token by parsing it.
+         *
+         * Both ways give the same candidates, but probing is much slower. It's meant for verifying the table lookup.
+         */
+        void setTokenTableLookup(bool enabled);
+
         /**
          * @brief Parses given query string.
          * @param sql SQL query string to parse. Can be multiple queries separated with semicolon.
@@ -139,18 +148,23 @@ class API_EXPORT Parser
         /**
          * @brief Tests what are possible valid candidates for the next token.
          * @param sql Part of the SQL query to check for the next token.
+         * @param checkpoints Optional parser states saved by previous calls for the same text.
          * @return List of token candidates.
          *
          * This method gets list of all token types from Lexer::getEveryTokenType() and tests which of them does the parser
          * accept for the next token after the given query.
          *
+         * If checkpoints are given, parsing is resumed from the last saved state that is still valid for the query,
+         * instead of parsing the query from the beginning. New states are saved in checkpoints while parsing.
+         * This is useful when the method is called repeatedly for a text being edited (see ParserCheckpoints).
+         *
          * You should treat the results of this method as a list of token <b>types</b>, rather than explicit tokens.
          * Each token in the results represents a logical grammar entity. You should look at the Token::type and Token::value,
          * while the Token::value is meaningful only for Token::KEYWORD, or Token::OPERATOR. For other token types, the value
          * is just an example value (like for Token::INTEGER all numbers are valid candidates, not just one returned
          * from this method).
          */
-        TokenList getNextTokenCandidates(const QString& sql);
+        TokenList getNextTokenCandidates(const QString& sql, ParserCheckpoints* checkpoints = nullptr);
 
         /**
          * @brief Provides list of queries parsed recently by the parser.
@@ -215,18 +229,21 @@ class API_EXPORT Parser
          * @param sql Query to be parsed.
          * @param lookForExpectedToken true if the parsing should be in "look for valid token candidates" mode,
          * or false for regular mode.
+         * @param checkpoints Parser states to resume from and to save new states into. Used only in "look for valid token candidates" mode.
          * @return true on success, or false on failure.
          *
          * Both parse() and getNextTokenCandidates() call this method.
          */
-        bool parseInternal(const QString &sql, bool lookForExpectedToken);
+        bool parseInternal(const QString &sql, bool lookForExpectedToken, ParserCheckpoints* checkpoints = nullptr);
 
         /**
          * @brief Probes token types against the current parser state.
          * @param pParser Pointer to Lemon parser.
          *
-         * Probes all token types against current state of the parser. After each probe, the result is stored
-         * and the parser state is restored to as what it was before the probe.
+         * Probes all token types against current state of the parser. Keywords, operators and other regular tokens
+         * are checked directly against Lemon's action tables (see parseIsTokenAccepted()). Context tokens
+         * and tokens that cannot be checked with tables are probed by parsing them. After each such probe,
+         * the result is stored and the parser state is restored to as what it was before the probe.
          *
          * After all tokens were probed, we have the full information on what tokens are welcome
          * at this parser state. This information is stored in the acceptedTokens member.
@@ -308,11 +325,27 @@ class API_EXPORT Parser
          */
         void  parseAddToken(void* other, TokenPtr token);
 
+        /**
+         * @brief Checks if the token would be accepted by Lemon parser in its current state.
+         * @param yyp Pointer to the Lemon parser.
+         * @param yymajor Lemon token ID (Token::lemonType) to check.
+         * @return 1 if the token is accepted, 0 if it's not, or -1 if it cannot be determined without parsing the token.
+         *
+         * The check follows Lemon's action tables (including all reductions that the token would trigger)
+         * without modifying the parser. Token fallbacks are not considered.
+         */
+        int   parseIsTokenAccepted(void* yyp, int yymajor);
+
         /**
          * @brief Flag indicating if the Lemon low-level debug messages are enabled.
          */
         bool debugLemon = false;
 
+        /**
+         * @brief Flag indicating if regular tokens are checked against Lemon's tables.
+         */
+        bool tokenTableLookup = true;
+
         /**
          * @brief Parser's internal Lexer.
          */
@@ -0,0 +1,91 @@
+#include "parsercheckpoints.h"
+
+// Generated in sqlite*_parse.c by lemon,
+// but not exported in any header
+void  sqlite3_parseFreeSavedState(void* other);
+
+ParserCheckpoints::ParserCheckpoints()
+{
+}
+
+ParserCheckpoints::~ParserCheckpoints()
+{
+    clear();
+}
+
+void ParserCheckpoints::invalidateFrom(qint64 position)
+{
+    int idx = 0;
+    for (const Checkpoint& checkpoint : checkpoints)
+    {
+        if (checkpoint.validUntil > position)
+            break;
+
+        idx++;
+    }
+    freeCheckpoints(idx);
+
+    if (position < sql.length())
+        sql.truncate(position);
+}
+
+void ParserCheckpoints::clear()
+{
+    freeCheckpoints(0);
+    sql.clear();
+    tokens.clear();
+}
+
+int ParserCheckpoints::count() const
+{
+    return checkpoints.size();
+}
+
+qint64 ParserCheckpoints::getMemoryUsage() const
+{
+    qint64 size = sql.size() * sizeof(QChar);
+    for (const TokenPtr& token : tokens)
+        size += sizeof(Token) + token->value.size() * sizeof(QChar);
+
+    size += checkpoints.size() * (sizeof(Checkpoint) + ESTIMATED_STATE_SIZE);
+    return size;
+}
+
+bool ParserCheckpoints::findFor(const QString& newSql, Checkpoint& checkpoint)
+{
+    qint64 commonLength = 0;
+    qint64 maxLength = qMin(sql.length(), newSql.length());
+    const QChar* oldChars = sql.constData();
+    const QChar* newChars = newSql.constData();
+    while (commonLength < maxLength && oldChars[commonLength] == newChars[commonLength])
+        commonLength++;
+
+    invalidateFrom(commonLength);
+    if (checkpoints.isEmpty())
+        return false;
+
+    checkpoint = checkpoints.last();
+    return true;
+}
+
+void ParserCheckpoints::add(void* state, const TokenPtr& nextToken, int tokenCount)
+{
+    Checkpoint checkpoint;
+    checkpoint.position = nextToken->start;
+    checkpoint.validUntil = nextToken->end + 1;
+    checkpoint.tokenCount = tokenCount;
+    checkpoint.state = state;
+    checkpoints << checkpoint;
+}
+
+void ParserCheckpoints::setParsed(const QString& parsedSql, const TokenList& parsedTokens)
+{
+    sql = parsedSql;
+    tokens = parsedTokens;
+}
+
+void ParserCheckpoints::freeCheckpoints(int fromIdx)
+{
+    while (checkpoints.size() > fromIdx)
+        sqlite3_parseFreeSavedState(checkpoints.takeLast().state);
+}
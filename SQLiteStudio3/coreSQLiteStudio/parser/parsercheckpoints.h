@@ -0,0 +1,117 @@
+#ifndef PARSERCHECKPOINTS_H
+#define PARSERCHECKPOINTS_H
+
+#include "token.h"
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Saved states of the Lemon parser for the text being edited.
+ *
+ * It's used by Parser::getNextTokenCandidates() to avoid parsing the text from its very beginning
+ * each time the completion is requested for the same (or slightly modified) text, which is the case
+ * when user types in the SQL editor.
+ *
+ * While parsing, the state of the Lemon parser is saved every CHECKPOINT_INTERVAL tokens
+ * and at the beginning of each statement. Next time the parsing is resumed from the last checkpoint
+ * that precedes the first difference between the previous and the current text, so only newly typed
+ * tokens are parsed.
+ *
+ * The object is meant to be owned by the editor and kept for as long as the editor exists.
+ * It's not thread-safe.
+ */
+class API_EXPORT ParserCheckpoints
+{
+    friend class Parser;
+
+    public:
+        ParserCheckpoints();
+        ~ParserCheckpoints();
+
+        /**
+         * @brief Drops checkpoints affected by modification of the text.
+         * @param position Position of the first modified character.
+         *
+         * It's not mandatory to call it, as the parser compares texts anyway,
+         * but it releases memory of states that will never be used again.
+         */
+        void invalidateFrom(qint64 position);
+
+        /**
+         * @brief Drops all checkpoints.
+         */
+        void clear();
+
+        /**
+         * @brief Provides number of stored checkpoints.
+         * @return Number of checkpoints.
+         */
+        int count() const;
+
+        /**
+         * @brief Estimates memory held by checkpoints.
+         * @return Estimated number of bytes.
+         *
+         * It includes the remembered text and tokens. Saved parser states are estimated roughly,
+         * as their structure is private to the generated parser.
+         */
+        qint64 getMemoryUsage() const;
+
+        /**
+         * @brief Number of tokens parsed between two consecutive checkpoints.
+         *
+         * Whitespaces and comments are not counted.
+         */
+        static const int CHECKPOINT_INTERVAL = 100;
+
+        /**
+         * @brief Rough size of a single saved parser state.
+         */
+        static const int ESTIMATED_STATE_SIZE = 4096;
+
+    private:
+        struct Checkpoint
+        {
+            qint64 position = 0;      /**< Position of the first token to be parsed after the state is restored. */
+            qint64 validUntil = 0;    /**< Position right after that token. Text up to here must remain unchanged. */
+            int tokenCount = 0;       /**< Number of tokens (including whitespaces) parsed before the checkpoint. */
+            void* state = nullptr;    /**< Copy of the Lemon parser. */
+        };
+
+        /**
+         * @brief Finds checkpoint to resume parsing of the given text from.
+         * @param newSql Text to be parsed.
+         * @param checkpoint Filled with the last checkpoint still valid for the text.
+         * @return true if the valid checkpoint was found, false otherwise.
+         *
+         * All checkpoints that are not valid for the new text are dropped.
+         * The state in the returned checkpoint remains owned by this object.
+         */
+        bool findFor(const QString& newSql, Checkpoint& checkpoint);
+
+        /**
+         * @brief Stores parser state.
+         * @param state Copy of the Lemon parser. The ownership is taken over.
+         * @param nextToken Token that is about to be parsed with the given state.
+         * @param tokenCount Number of tokens parsed before.
+         */
+        void add(void* state, const TokenPtr& nextToken, int tokenCount);
+
+        /**
+         * @brief Remembers text and tokens that were parsed to create checkpoints.
+         * @param parsedSql Parsed text.
+         * @param parsedTokens All tokens produced by the lexer for the text.
+         *
+         * Tokens have to be kept, because saved parser states refer to them.
+         */
+        void setParsed(const QString& parsedSql, const TokenList& parsedTokens);
+
+        void freeCheckpoints(int fromIdx);
+
+        QString sql;
+        TokenList tokens;
+        QList<Checkpoint> checkpoints;
+};
+
+#endif // PARSERCHECKPOINTS_H
@@ -25,6 +25,22 @@ class API_EXPORT DbPlugin : virtual public Plugin
          */
         virtual Db* getInstance(const QString& name, const QString& path, const QHash<QString,QVariant> &options, QString* errorMessage = 0) = 0;
 
+        /**
+         * @brief Creates database instance without verifying that the database can actually be opened.
+         * @param name Name for the database.
+         * @param path Path to the database file.
+         * @param options Options for the database passed while registering the database in the application.
+         * @return Database instance on success, or null pointer on failure.
+         *
+         * DbManager uses it for databases that were successfully served by this plugin before and their files
+         * did not change since then, so probing them again (which means opening the file and reading the schema)
+         * would only slow down the startup. The default implementation simply calls getInstance().
+         */
+        virtual Db* getInstanceWithoutProbing(const QString& name, const QString& path, const QHash<QString,QVariant> &options)
+        {
+            return getInstance(name, path, options);
+        }
+
         /**
          * @brief Provides label of what type is the database.
          * @return Type label.
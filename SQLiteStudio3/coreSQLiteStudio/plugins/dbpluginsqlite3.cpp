@@ -1,5 +1,6 @@
 #include "dbpluginsqlite3.h"
 #include "db/dbsqlite3.h"
+#include "db/dbperformanceprofile.h"
 #include "common/unused.h"
 #include <QFileInfo>
 
@@ -25,6 +26,11 @@ Db* DbPluginSqlite3::getInstance(const QString& name, const QString& path, const
     return db;
 }
 
+Db* DbPluginSqlite3::getInstanceWithoutProbing(const QString& name, const QString& path, const QHash<QString, QVariant>& options)
+{
+    return new DbSqlite3(name, path, options);
+}
+
 QString DbPluginSqlite3::getLabel() const
 {
     return "SQLite 3";
@@ -32,7 +38,7 @@ QString DbPluginSqlite3::getLabel() const
 
 QList<DbPluginOption> DbPluginSqlite3::getOptionsList() const
 {
-    return QList<DbPluginOption>();
+    return DbPerformanceProfile::getOptionsList();
 }
 
 QString DbPluginSqlite3::generateDbName(const QVariant& baseValue)
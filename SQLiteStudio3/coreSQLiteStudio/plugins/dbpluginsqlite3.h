@@ -15,6 +15,7 @@ class DbPluginSqlite3 : public BuiltInPlugin, public DbPlugin
 
     public:
         Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString* errorMessage);
+        Db* getInstanceWithoutProbing(const QString& name, const QString& path, const QHash<QString, QVariant>& options);
         QString getLabel() const;
         QList<DbPluginOption> getOptionsList() const;
         QString generateDbName(const QVariant& baseValue);
@@ -26,6 +26,11 @@ Db *DbPluginStdFileBase::getInstance(const QString &name, const QString &path, c
     return db;
 }
 
+Db* DbPluginStdFileBase::getInstanceWithoutProbing(const QString& name, const QString& path, const QHash<QString, QVariant>& options)
+{
+    return newInstance(name, path, options);
+}
+
 QString DbPluginStdFileBase::generateDbName(const QVariant &baseValue)
 {
     QFileInfo file(baseValue.toString());
@@ -7,6 +7,7 @@ class API_EXPORT DbPluginStdFileBase : public DbPlugin
 {
     public:
         Db *getInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options, QString *errorMessage);
+        Db *getInstanceWithoutProbing(const QString &name, const QString &path, const QHash<QString, QVariant> &options);
         QString generateDbName(const QVariant &baseValue);
 
     protected:
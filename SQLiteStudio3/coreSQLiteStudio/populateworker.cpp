@@ -1,6 +1,7 @@
 #include "populateworker.h"
 #include "common/utils_sql.h"
 #include "db/db.h"
+#include "db/dbperformanceprofile.h"
 #include "db/sqlquery.h"
 #include "plugins/populateplugin.h"
 #include "services/notifymanager.h"
@@ -18,6 +19,7 @@ void PopulateWorker::run()
 {
     static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3);");
 
+    DbPerformanceProfile::BulkModeGuard bulkMode(db);
     if (!db->begin())
     {
         notifyError(tr("Could not start transaction in order to perform table populating. Error details: %1").arg(db->getErrorText()));
@@ -1,4 +1,5 @@
 #include "schemaresolver.h"
+#include "common/memoryusage.h"
 #include "db/db.h"
 #include "db/sqlresultsrow.h"
 #include "parser/parsererror.h"
@@ -9,6 +10,7 @@
 #include "parser/ast/sqlitecreatevirtualtable.h"
 #include "parser/ast/sqlitetablerelatedddl.h"
 #include <QDebug>
+#include <QMutexLocker>
 
 const char* sqliteMasterDdl =
     "CREATE TABLE sqlite_master (type text, name text, tbl_name text, rootpage integer, sql text)";
@@ -17,6 +19,7 @@ const char* sqliteTempMasterDdl =
 
 ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
 ExpiringCache<QString, QString> SchemaResolver::autoIndexDdlCache;
+QMutex SchemaResolver::cacheMutex;
 
 SchemaResolver::SchemaResolver(Db *db)
     : db(db)
@@ -327,8 +330,9 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
     QString typeStr = objectTypeToString(type);
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DDL, db, dbName, lowerName, typeStr);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toString();
+    QVariant cachedValue;
+    if (useCache && getCached(key, cachedValue))
+        return cachedValue.toString();
 
     // Get the DDL
     QString resStr = getObjectDdlWithSimpleName(dbName, lowerName, targetTable, type);
@@ -340,7 +344,7 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
         resStr += ";";
 
     if (useCache)
-        cache.insert(key, new QVariant(resStr));
+        putCached(key, resStr);
 
     // Return the DDL
     return resStr;
@@ -611,10 +615,13 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
     // First, let's try to use cached value
     static_qstring(cacheKeyTpl, "%1.%2");
     QString cacheKey = cacheKeyTpl.arg(database, index).toLower();
+    QMutexLocker locker(&cacheMutex);
     QString* cachedDdlPtr = autoIndexDdlCache[cacheKey];
     if (cachedDdlPtr)
         return *(cachedDdlPtr);
 
+    locker.unlock();
+
     // Not in cache. We need to find out indexed table.
     // Let's try to find it in sqlite_master.
     // If it's there, we will at least know it's referenced table.
@@ -677,6 +684,7 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
                 columns.join(", ")
                 );
 
+    locker.relock();
     autoIndexDdlCache.insert(cacheKey, new QString(ddl));
     return ddl;
 }
@@ -715,8 +723,9 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database, type);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    QVariant cachedValue;
+    if (useCache && getCached(key, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
@@ -732,7 +741,7 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        putCached(key, resList);
 
     return resList;
 }
@@ -746,8 +755,9 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    QVariant cachedValue;
+    if (useCache && getCached(key, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
@@ -765,7 +775,7 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        putCached(key, resList);
 
     return resList;
 }
@@ -928,9 +938,10 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
     QList<QVariant> rows;
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DETAILS, db, database);
-    if (useCache && cache.contains(key))
+    QVariant cachedValue;
+    if (useCache && getCached(key, cachedValue))
     {
-        rows = cache.object(key, true)->toList();
+        rows = cachedValue.toList();
     }
     else
     {
@@ -945,7 +956,7 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
             rows << row->valueMap();
 
         if (useCache)
-            cache.insert(key, new QVariant(rows));
+            putCached(key, rows);
     }
 
     QHash<QString, QVariant> row;
@@ -1089,6 +1100,59 @@ void SchemaResolver::staticInit()
     cache.setExpireTime(3000);
 }
 
+qint64 SchemaResolver::getCacheMemoryUsage(int& entries)
+{
+    QMutexLocker locker(&cacheMutex);
+    entries = 0;
+    qint64 size = 0;
+    for (const ObjectCacheKey& key : cache.keys())
+    {
+        QVariant* value = cache.object(key, true);
+        if (!value)
+            continue;
+
+        size += sizeof(ObjectCacheKey) + (key.value1.size() + key.value2.size() + key.value3.size()) * sizeof(QChar);
+        size += estimateMemoryUsage(*value);
+        entries++;
+    }
+
+    for (const QString& key : autoIndexDdlCache.keys())
+    {
+        QString* value = autoIndexDdlCache.object(key, true);
+        if (!value)
+            continue;
+
+        size += (key.size() + value->size()) * sizeof(QChar) + sizeof(QString) * 2;
+        entries++;
+    }
+
+    return size;
+}
+
+void SchemaResolver::clearCache()
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.clear();
+    autoIndexDdlCache.clear();
+}
+
+bool SchemaResolver::getCached(const ObjectCacheKey& key, QVariant& value)
+{
+    QMutexLocker locker(&cacheMutex);
+    QVariant* cachedValue = cache.object(key);
+    if (!cachedValue)
+        return false;
+
+    value = *cachedValue;
+    return true;
+}
+
+void SchemaResolver::putCached(const ObjectCacheKey& key, const QVariant& value)
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(key, new QVariant(value));
+}
+
 bool SchemaResolver::usesCache()
 {
     return db->getConnectionOptions().contains(USE_SCHEMA_CACHING) && db->getConnectionOptions()[USE_SCHEMA_CACHING].toBool();
@@ -16,6 +16,7 @@
 #include "common/strhash.h"
 #include "common/expiringcache.h"
 #include <QStringList>
+#include <QMutex>
 
 class SqliteCreateTable;
 
@@ -191,10 +192,26 @@ class API_EXPORT SchemaResolver
         static ObjectType stringToObjectType(const QString& type);
         static void staticInit();
 
+        /**
+         * @brief Provides size of cached schema objects (shared by all resolvers).
+         * @param entries Filled with number of cached entries.
+         * @return Estimated number of bytes used by the cache.
+         */
+        static qint64 getCacheMemoryUsage(int& entries);
+
+        /**
+         * @brief Drops all cached schema objects.
+         *
+         * Objects will be read again from databases when they are needed.
+         */
+        static void clearCache();
+
         static_char* USE_SCHEMA_CACHING = "useSchemaCaching";
 
     private:
         bool usesCache();
+        static bool getCached(const ObjectCacheKey& key, QVariant& value);
+        static void putCached(const ObjectCacheKey& key, const QVariant& value);
         SqliteQueryPtr getParsedDdl(const QString& ddl);
         SqliteCreateTablePtr virtualTableAsRegularTable(const QString& database, const QString& table);
         StrHash< QStringList> getGroupedObjects(const QString &database, const QStringList& inputList, SqliteQueryType type);
@@ -215,6 +232,11 @@ class API_EXPORT SchemaResolver
 
         static ExpiringCache<ObjectCacheKey,QVariant> cache;
         static ExpiringCache<QString, QString> autoIndexDdlCache;
+
+        /**
+         * @brief Guards both caches, as resolvers are used from executor threads, while the cache is cleared from the main thread.
+         */
+        static QMutex cacheMutex;
 };
 
 int qHash(const SchemaResolver::ObjectCacheKey& key);
@@ -15,11 +15,20 @@ class API_EXPORT CollationManager : public QObject
     Q_OBJECT
 
     public:
+        enum class CollationType
+        {
+            FUNCTION_BASED = 0, /**< Code compares two values and returns -1, 0 or 1. */
+            SORT_KEY_BASED = 1, /**< Code returns sort key for a single value. Keys are compared byte by byte. */
+            LOCALE_BASED = 2    /**< There is no code. Values are compared by QCollator for the configured locale. */
+        };
+
         struct API_EXPORT Collation
         {
             QString name;
+            CollationType type = CollationType::FUNCTION_BASED;
             QString lang;
             QString code;
+            QString locale;
             QStringList databases;
             bool allDatabases = true;
         };
@@ -29,9 +38,22 @@ class API_EXPORT CollationManager : public QObject
         virtual void setCollations(const QList<CollationPtr>& newCollations) = 0;
         virtual QList<CollationPtr> getAllCollations() const = 0;
         virtual QList<CollationPtr> getCollationsForDatabase(const QString& dbName) const = 0;
+        virtual CollationPtr getCollation(const QString& name) const = 0;
         virtual int evaluate(const QString& name, const QString& value1, const QString& value2) = 0;
         virtual int evaluateDefault(const QString& value1, const QString& value2) = 0;
 
+        /**
+         * @brief Evaluates sort key of the value for the collation of CollationType::SORT_KEY_BASED type.
+         * @param name Name of the collation.
+         * @param value Value to get the key for.
+         * @return Sort key. If the collation code could not be evaluated, the key for the default collation is returned.
+         *
+         * Keys of two values are compared byte by byte, so this is called only once per distinct value,
+         * instead of calling evaluate() for every comparison.
+         */
+        virtual QByteArray evaluateSortKey(const QString& name, const QString& value) = 0;
+        virtual QByteArray evaluateDefaultSortKey(const QString& value) = 0;
+
     signals:
         void collationListChanged();
 };
@@ -14,7 +14,7 @@
 #include <QSharedPointer>
 #include <QDateTime>
 
-const int SQLITESTUDIO_CONFIG_VERSION = 3;
+const int SQLITESTUDIO_CONFIG_VERSION = 4;
 
 CFG_CATEGORIES(Core,
     CFG_CATEGORY(General,
@@ -26,6 +26,7 @@ CFG_CATEGORIES(Core,
         CFG_ENTRY(QVariantHash, ActiveCodeFormatter,     QVariantHash())
         CFG_ENTRY(bool,         CheckUpdatesOnStartup,   true)
         CFG_ENTRY(QString,      Language,                "en")
+        CFG_ENTRY(int,          MemorySoftLimit,         0)
     )
     CFG_CATEGORY(Console,
         CFG_ENTRY(int,          HistorySize,             100)
@@ -46,6 +47,7 @@ CFG_CATEGORIES(Core,
 
 class QAbstractItemModel;
 class DdlHistoryModel;
+class SqlHistoryModel;
 
 class API_EXPORT Config : public QObject
 {
@@ -83,6 +85,8 @@ class API_EXPORT Config : public QObject
             QString dbName;
             int rowsAffected;
             int unixtime;
+            qint64 timeSpent = 0;
+            int executions = 1;
         };
 
         typedef QSharedPointer<SqlHistoryEntry> SqlHistoryEntryPtr;
@@ -150,11 +154,21 @@ class API_EXPORT Config : public QObject
         virtual QList<DbGroupPtr> getGroups() = 0;
         virtual DbGroupPtr getDbGroup(const QString& dbName) = 0;
 
-        virtual qint64 addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected) = 0;
-        virtual void updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected) = 0;
+        virtual qint64 addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile) = 0;
+        virtual void updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile) = 0;
         virtual void clearSqlHistory() = 0;
         virtual void deleteSqlHistory(const QList<qint64>& ids) = 0;
-        virtual QAbstractItemModel* getSqlHistoryModel() = 0;
+        virtual void applySqlHistoryLimit() = 0;
+
+        /**
+         * @brief Creates model of SQL history.
+         * @param parent Parent object for the model.
+         * @return New model, which follows changes in the history.
+         *
+         * Each view gets its own model, so it can have its own filter.
+         */
+        virtual SqlHistoryModel* createSqlHistoryModel(QObject* parent) = 0;
+        virtual QList<SqlHistoryEntryPtr> getMostExpensiveSqlHistory(const QString& dbName, int limit) = 0;
 
         virtual void addCliHistory(const QString& text) = 0;
         virtual void applyCliHistoryLimit() = 0;
@@ -190,6 +204,8 @@ class API_EXPORT Config : public QObject
         void massSaveBegins();
         void massSaveCommitted();
         void sqlHistoryRefreshNeeded();
+        void sqlHistoryEntryAdded(qint64 id);
+        void sqlHistoryEntryUpdated(qint64 id);
         void ddlHistoryRefreshNeeded();
         void reportsHistoryRefreshNeeded();
 
@@ -14,7 +14,16 @@ class CollationFunctionInfoImpl : public ScriptingPlugin::FunctionInfo
         bool getUndefinedArgs() const {return false;}
 };
 
+class CollationSortKeyFunctionInfoImpl : public ScriptingPlugin::FunctionInfo
+{
+    public:
+        QString getName() const {return QString();}
+        QStringList getArguments() const {return {"value"};}
+        bool getUndefinedArgs() const {return false;}
+};
+
 CollationFunctionInfoImpl collationFunctionInfo;
+CollationSortKeyFunctionInfoImpl collationSortKeyFunctionInfo;
 
 CollationManagerImpl::CollationManagerImpl()
 {
@@ -45,6 +54,11 @@ QList<CollationManager::CollationPtr> CollationManagerImpl::getCollationsForData
     return results;
 }
 
+CollationManager::CollationPtr CollationManagerImpl::getCollation(const QString& name) const
+{
+    return collationsByKey.value(name);
+}
+
 int CollationManagerImpl::evaluate(const QString& name, const QString& value1, const QString& value2)
 {
     if (!collationsByKey.contains(name))
@@ -85,6 +99,41 @@ int CollationManagerImpl::evaluateDefault(const QString& value1, const QString&
     return value1.compare(value2, Qt::CaseInsensitive);
 }
 
+QByteArray CollationManagerImpl::evaluateSortKey(const QString& name, const QString& value)
+{
+    if (!collationsByKey.contains(name))
+    {
+        qWarning() << "Could not find requested collation" << name << ", so using default collation.";
+        return evaluateDefaultSortKey(value);
+    }
+
+    ScriptingPlugin* plugin = PLUGINS->getScriptingPlugin(collationsByKey[name]->lang);
+    if (!plugin)
+    {
+        qWarning() << "Plugin for collation" << name << ", not loaded, so using default collation.";
+        return evaluateDefaultSortKey(value);
+    }
+
+    QString err;
+    QVariant result = plugin->evaluate(collationsByKey[name]->code, collationSortKeyFunctionInfo, {value}, &err);
+
+    if (!err.isNull())
+    {
+        qWarning() << "Error while evaluating collation sort key:" << err;
+        return evaluateDefaultSortKey(value);
+    }
+
+    if (result.type() == QVariant::ByteArray)
+        return result.toByteArray();
+
+    return result.toString().toUtf8();
+}
+
+QByteArray CollationManagerImpl::evaluateDefaultSortKey(const QString& value)
+{
+    return value.toLower().toUtf8();
+}
+
 void CollationManagerImpl::init()
 {
     loadFromConfig();
@@ -98,8 +147,10 @@ void CollationManagerImpl::storeInConfig()
     for (CollationPtr coll : collations)
     {
         collHash["name"] = coll->name;
+        collHash["type"] = static_cast<int>(coll->type);
         collHash["lang"] = coll->lang;
         collHash["code"] = coll->code;
+        collHash["locale"] = coll->locale;
         collHash["allDatabases"] = coll->allDatabases;
         collHash["databases"] =common(DBLIST->getDbNames(),  coll->databases);
         list << collHash;
@@ -119,8 +170,10 @@ void CollationManagerImpl::loadFromConfig()
         collHash = var.toHash();
         coll = CollationPtr::create();
         coll->name = collHash["name"].toString();
+        coll->type = static_cast<CollationType>(collHash["type"].toInt());
         coll->lang = updateScriptingQtLang(collHash["lang"].toString());
         coll->code = collHash["code"].toString();
+        coll->locale = collHash["locale"].toString();
         coll->databases = collHash["databases"].toStringList();
         coll->allDatabases = collHash["allDatabases"].toBool();
         collations << coll;
@@ -15,8 +15,11 @@ class API_EXPORT CollationManagerImpl : public CollationManager
         void setCollations(const QList<CollationPtr>& newCollations);
         QList<CollationPtr> getAllCollations() const;
         QList<CollationPtr> getCollationsForDatabase(const QString& dbName) const;
+        CollationPtr getCollation(const QString& name) const;
         int evaluate(const QString& name, const QString& value1, const QString& value2);
         int evaluateDefault(const QString& value1, const QString& value2);
+        QByteArray evaluateSortKey(const QString& name, const QString& value);
+        QByteArray evaluateDefaultSortKey(const QString& value);
 
     private:
         void init();
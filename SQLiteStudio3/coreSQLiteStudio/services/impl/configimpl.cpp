@@ -17,6 +17,7 @@
 #include <QCoreApplication>
 #include <QStandardPaths>
 #include <QSettings>
+#include <QMutexLocker>
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtWidgets/QFileDialog>
 
@@ -36,11 +37,17 @@ void ConfigImpl::init()
     initTables();
     updateConfigDb();
     mergeMasterConfig();
+    initSqlHistoryFts();
 
     sqlite3Version = db->exec("SELECT sqlite_version()")->getSingleCell().toString();
 
-    connect(this, SIGNAL(sqlHistoryRefreshNeeded()), this, SLOT(refreshSqlHistory()));
     connect(this, SIGNAL(ddlHistoryRefreshNeeded()), this, SLOT(refreshDdlHistory()));
+
+    sqlHistoryLimitTimer = new QTimer(this);
+    sqlHistoryLimitTimer->setInterval(SQL_HISTORY_LIMIT_INTERVAL);
+    connect(sqlHistoryLimitTimer, &QTimer::timeout, this, &ConfigImpl::applySqlHistoryLimit);
+    sqlHistoryLimitTimer->start();
+    applySqlHistoryLimit();
 }
 
 void ConfigImpl::cleanUp()
@@ -288,7 +295,7 @@ ConfigImpl::DbGroupPtr ConfigImpl::getDbGroup(const QString& dbName)
     return group;
 }
 
-qint64 ConfigImpl::addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected)
+qint64 ConfigImpl::addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile)
 {
     if (sqlHistoryId < 0)
     {
@@ -305,15 +312,23 @@ qint64 ConfigImpl::addSqlHistory(const QString& sql, const QString& dbName, int
             sqlHistoryId = 0;
     }
 
+    // QtConcurrent::run() accepts up to 5 arguments for a member function, hence the lambda.
+    qint64 id = sqlHistoryId++;
     sqlHistoryMutex.lock();
-    QtConcurrent::run(this, &ConfigImpl::asyncAddSqlHistory, sqlHistoryId, sql, dbName, timeSpentMillis, rowsAffected);
-    return sqlHistoryId++;
+    QtConcurrent::run([=]()
+    {
+        asyncAddSqlHistory(id, sql, dbName, timeSpentMillis, rowsAffected, profile);
+    });
+    return id;
 }
 
-void ConfigImpl::updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected)
+void ConfigImpl::updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile)
 {
     sqlHistoryMutex.lock();
-    QtConcurrent::run(this, &ConfigImpl::asyncUpdateSqlHistory, id, sql, dbName, timeSpentMillis, rowsAffected);
+    QtConcurrent::run([=]()
+    {
+        asyncUpdateSqlHistory(id, sql, dbName, timeSpentMillis, rowsAffected, profile);
+    });
 }
 
 void ConfigImpl::clearSqlHistory()
@@ -326,12 +341,53 @@ void ConfigImpl::deleteSqlHistory(const QList<qint64>& ids)
     QtConcurrent::run(this, &ConfigImpl::asyncDeleteSqlHistory, ids);
 }
 
-QAbstractItemModel* ConfigImpl::getSqlHistoryModel()
+void ConfigImpl::applySqlHistoryLimit()
 {
-    if (!sqlHistoryModel)
-        sqlHistoryModel = new SqlHistoryModel(db, this);
+    QtConcurrent::run(this, &ConfigImpl::asyncApplySqlHistoryLimit);
+}
 
-    return sqlHistoryModel;
+SqlHistoryModel* ConfigImpl::createSqlHistoryModel(QObject* parent)
+{
+    SqlHistoryModel* model = new SqlHistoryModel(db, sqlHistoryFts, parent);
+    connect(this, SIGNAL(sqlHistoryRefreshNeeded()), model, SLOT(refresh()));
+    connect(this, SIGNAL(sqlHistoryEntryAdded(qint64)), model, SLOT(entryAdded(qint64)));
+    connect(this, SIGNAL(sqlHistoryEntryUpdated(qint64)), model, SLOT(entryUpdated(qint64)));
+    return model;
+}
+
+QList<Config::SqlHistoryEntryPtr> ConfigImpl::getMostExpensiveSqlHistory(const QString& dbName, int limit)
+{
+    // Same SQL executed many times is summed up, so both slow and frequent queries come first.
+    static_qstring(sql,
+            "SELECT sql,"
+            "       count(*) AS executions,"
+            "       sum(time_spent) AS time_spent,"
+            "       max(rows) AS rows,"
+            "       max(date) AS date"
+            "  FROM sqleditor_history"
+            " WHERE dbname = ?"
+            " GROUP BY sql"
+            " ORDER BY time_spent DESC, executions DESC"
+            " LIMIT ?");
+
+    SqlQueryPtr results = db->exec(sql, {dbName, limit});
+
+    QList<SqlHistoryEntryPtr> entries;
+    SqlHistoryEntryPtr entry;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        entry = SqlHistoryEntryPtr::create();
+        entry->query = row->value("sql").toString();
+        entry->dbName = dbName;
+        entry->rowsAffected = row->value("rows").toInt();
+        entry->unixtime = row->value("date").toInt();
+        entry->timeSpent = row->value("time_spent").toLongLong();
+        entry->executions = row->value("executions").toInt();
+        entries << entry;
+    }
+    return entries;
 }
 
 void ConfigImpl::addCliHistory(const QString& text)
@@ -678,7 +734,8 @@ void ConfigImpl::initTables()
         db->exec("CREATE TABLE settings ([group] TEXT, [key] TEXT, value, PRIMARY KEY([group], [key]))");
 
     if (!tables.contains("sqleditor_history"))
-        db->exec("CREATE TABLE sqleditor_history (id INTEGER PRIMARY KEY, dbname TEXT, date INTEGER, time_spent INTEGER, rows INTEGER, sql TEXT)");
+        db->exec("CREATE TABLE sqleditor_history (id INTEGER PRIMARY KEY, dbname TEXT, date INTEGER, time_spent INTEGER, rows INTEGER, sql TEXT, "
+                 "profile TEXT)");
 
     if (!tables.contains("dblist"))
         db->exec("CREATE TABLE dblist (name TEXT PRIMARY KEY, path TEXT UNIQUE, options TEXT)");
@@ -727,6 +784,70 @@ void ConfigImpl::initTables()
         db->exec("CREATE TABLE reports_history (id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp INTEGER, feature_request BOOLEAN, title TEXT, url TEXT)");
 }
 
+void ConfigImpl::initSqlHistoryFts()
+{
+    static_qstring(probeQuery, "CREATE VIRTUAL TABLE temp.sqleditor_history_fts_probe USING fts5(sql)");
+    static_qstring(dropProbeQuery, "DROP TABLE temp.sqleditor_history_fts_probe");
+    static_qstring(triggerExistsQuery, "SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = 'sqleditor_history_fts_ai'");
+    static_qstring(dropTriggerTpl, "DROP TRIGGER IF EXISTS %1");
+    static_qstring(createTableQuery, "CREATE VIRTUAL TABLE IF NOT EXISTS sqleditor_history_fts USING fts5(sql, content='sqleditor_history', content_rowid='id')");
+    static_qstring(insertTriggerQuery, "CREATE TRIGGER sqleditor_history_fts_ai AFTER INSERT ON sqleditor_history BEGIN "
+                                       "INSERT INTO sqleditor_history_fts (rowid, sql) VALUES (new.id, new.sql); "
+                                       "END");
+    static_qstring(deleteTriggerQuery, "CREATE TRIGGER sqleditor_history_fts_ad AFTER DELETE ON sqleditor_history BEGIN "
+                                       "INSERT INTO sqleditor_history_fts (sqleditor_history_fts, rowid, sql) VALUES ('delete', old.id, old.sql); "
+                                       "END");
+    static_qstring(updateTriggerQuery, "CREATE TRIGGER sqleditor_history_fts_au AFTER UPDATE OF sql ON sqleditor_history BEGIN "
+                                       "INSERT INTO sqleditor_history_fts (sqleditor_history_fts, rowid, sql) VALUES ('delete', old.id, old.sql); "
+                                       "INSERT INTO sqleditor_history_fts (rowid, sql) VALUES (new.id, new.sql); "
+                                       "END");
+    static_qstring(rebuildQuery, "INSERT INTO sqleditor_history_fts (sqleditor_history_fts) VALUES ('rebuild')");
+
+    static const QStringList triggers = {"sqleditor_history_fts_ai", "sqleditor_history_fts_ad", "sqleditor_history_fts_au"};
+
+    // Without FTS5 the history is searched with LIKE
+    if (db->exec(probeQuery)->isError())
+    {
+        for (const QString& trigger : triggers)
+            db->exec(dropTriggerTpl.arg(trigger));
+
+        return;
+    }
+    db->exec(dropProbeQuery);
+
+    if (db->exec(triggerExistsQuery)->hasNext())
+    {
+        sqlHistoryFts = true;
+        return;
+    }
+
+    // Index is missing, or it was not maintained while FTS5 was not available
+    if (!db->begin())
+        return;
+
+    for (const QString& trigger : triggers)
+        db->exec(dropTriggerTpl.arg(trigger));
+
+    for (const QString& query : {createTableQuery, insertTriggerQuery, deleteTriggerQuery, updateTriggerQuery, rebuildQuery})
+    {
+        SqlQueryPtr results = db->exec(query);
+        if (results->isError())
+        {
+            qWarning() << "Could not create SQL history full-text index:" << results->getErrorText();
+            db->rollback();
+            return;
+        }
+    }
+
+    if (!db->commit())
+    {
+        db->rollback();
+        return;
+    }
+
+    sqlHistoryFts = true;
+}
+
 void ConfigImpl::initDbFile()
 {
     QList<QPair<QString,bool>> paths;
@@ -854,11 +975,11 @@ QVariant ConfigImpl::deserializeValue(const QVariant &value) const
     return deserializeFromBytes(bytes);
 }
 
-void ConfigImpl::asyncAddSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected)
+void ConfigImpl::asyncAddSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile)
 {
     db->begin();
-    SqlQueryPtr results = db->exec("INSERT INTO sqleditor_history (id, dbname, date, time_spent, rows, sql) VALUES (?, ?, ?, ?, ?, ?)",
-                                    {id, dbName, (QDateTime::currentMSecsSinceEpoch() / 1000), timeSpentMillis, rowsAffected, sql});
+    SqlQueryPtr results = db->exec("INSERT INTO sqleditor_history (id, dbname, date, time_spent, rows, sql, profile) VALUES (?, ?, ?, ?, ?, ?, ?)",
+                                    {id, dbName, (QDateTime::currentMSecsSinceEpoch() / 1000), timeSpentMillis, rowsAffected, sql, profile});
 
     if (results->isError())
     {
@@ -868,31 +989,19 @@ void ConfigImpl::asyncAddSqlHistory(qint64 id, const QString& sql, const QString
         return;
     }
 
-    int maxHistorySize = CFG_CORE.General.SqlHistorySize.get();
-
-    results = db->exec("SELECT count(*) FROM sqleditor_history");
-    if (results->hasNext() && results->getSingleCell().toInt() > maxHistorySize)
-    {
-        results = db->exec(QString("SELECT id FROM sqleditor_history ORDER BY id DESC LIMIT 1 OFFSET %1").arg(maxHistorySize));
-        if (results->hasNext())
-        {
-            int id = results->getSingleCell().toInt();
-            if (id > 0) // it will be 0 on fail conversion, but we won't delete id <= 0 ever.
-                db->exec("DELETE FROM sqleditor_history WHERE id <= ?", {id});
-        }
-    }
+    // The history size limit is applied periodically, see applySqlHistoryLimit()
     db->commit();
 
-    emit sqlHistoryRefreshNeeded();
+    emit sqlHistoryEntryAdded(id);
     sqlHistoryMutex.unlock();
 }
 
-void ConfigImpl::asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected)
+void ConfigImpl::asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile)
 {
-    db->exec("UPDATE sqleditor_history SET dbname = ?, time_spent = ?, rows = ?, sql = ? WHERE id = ?",
-            {dbName, timeSpentMillis, rowsAffected, sql, id});
+    db->exec("UPDATE sqleditor_history SET dbname = ?, time_spent = ?, rows = ?, sql = ?, profile = ? WHERE id = ?",
+            {dbName, timeSpentMillis, rowsAffected, sql, profile, id});
 
-    emit sqlHistoryRefreshNeeded();
+    emit sqlHistoryEntryUpdated(id);
     sqlHistoryMutex.unlock();
 }
 
@@ -919,6 +1028,23 @@ void ConfigImpl::asyncDeleteSqlHistory(const QList<qint64>& ids)
     emit sqlHistoryRefreshNeeded();
 }
 
+void ConfigImpl::asyncApplySqlHistoryLimit()
+{
+    static_qstring(limitQuery, "DELETE FROM sqleditor_history WHERE id <= (SELECT id FROM sqleditor_history ORDER BY id DESC LIMIT 1 OFFSET %1)");
+
+    // Waits for any entry being added, so it's not deleted in the middle of its transaction.
+    QMutexLocker locker(&sqlHistoryMutex);
+    SqlQueryPtr results = db->exec(limitQuery.arg(CFG_CORE.General.SqlHistorySize.get()));
+    if (results->isError())
+    {
+        qWarning() << "Error while limiting SQL history:" << results->getErrorText();
+        return;
+    }
+
+    if (results->rowsAffected() > 0)
+        emit sqlHistoryRefreshNeeded();
+}
+
 void ConfigImpl::asyncAddCliHistory(const QString& text)
 {
     static_qstring(insertQuery, "INSERT INTO cli_history (text) VALUES (?)");
@@ -1169,6 +1295,12 @@ void ConfigImpl::updateConfigDb()
         {
             // 2->3
             db->exec("ALTER TABLE groups ADD db_expanded INTEGER DEFAULT 0");
+            __attribute__((__fallthrough__));
+        }
+        case 3:
+        {
+            // 3->4
+            db->exec("ALTER TABLE sqleditor_history ADD profile TEXT");
         }
         // Add cases here for next versions,
         // without a "break" instruction,
@@ -1206,8 +1338,7 @@ bool ConfigImpl::tryToMigrateOldGlobalPath(const QString& oldPath, const QString
 
 void ConfigImpl::refreshSqlHistory()
 {
-    if (sqlHistoryModel)
-        sqlHistoryModel->refresh();
+    emit sqlHistoryRefreshNeeded();
 }
 
 void ConfigImpl::refreshDdlHistory()
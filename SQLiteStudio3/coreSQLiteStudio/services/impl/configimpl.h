@@ -5,6 +5,7 @@
 #include "services/config.h"
 #include "db/sqlquery.h"
 #include <QMutex>
+#include <QTimer>
 
 class AsyncConfigHandler;
 class SqlHistoryModel;
@@ -55,11 +56,13 @@ class API_EXPORT ConfigImpl : public Config
         QList<DbGroupPtr> getGroups();
         DbGroupPtr getDbGroup(const QString& dbName);
 
-        qint64 addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
-        void updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
+        qint64 addSqlHistory(const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile);
+        void updateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile);
         void clearSqlHistory();
         void deleteSqlHistory(const QList<qint64>& ids);
-        QAbstractItemModel* getSqlHistoryModel();
+        void applySqlHistoryLimit();
+        SqlHistoryModel* createSqlHistoryModel(QObject* parent);
+        QList<SqlHistoryEntryPtr> getMostExpensiveSqlHistory(const QString& dbName, int limit);
 
         void addCliHistory(const QString& text);
         void applyCliHistoryLimit();
@@ -104,15 +107,25 @@ class API_EXPORT ConfigImpl : public Config
         QString getConfigPath();
         QString getPortableConfigPath();
         void initTables();
+
+        /**
+         * @brief Creates full-text search index of SQL history, if FTS5 is available.
+         *
+         * The index is an external content FTS5 table, kept up to date by triggers on sqleditor_history.
+         * If FTS5 is not available (i.e. SQLite library was compiled without it), triggers are dropped,
+         * so they don't break modifications of the history.
+         */
+        void initSqlHistoryFts();
         void initDbFile();
         QList<QPair<QString, bool> > getStdDbPaths();
         bool tryInitDbFile(const QPair<QString, bool>& dbPath);
         QVariant deserializeValue(const QVariant& value) const;
 
-        void asyncAddSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
-        void asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
+        void asyncAddSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile);
+        void asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected, const QString& profile);
         void asyncClearSqlHistory();
         void asyncDeleteSqlHistory(const QList<qint64> &ids);
+        void asyncApplySqlHistoryLimit();
 
         void asyncAddCliHistory(const QString& text);
         void asyncApplyCliHistoryLimit();
@@ -144,9 +157,17 @@ class API_EXPORT ConfigImpl : public Config
         QString configDir;
         QString lastQueryError;
         bool massSaving = false;
-        SqlHistoryModel* sqlHistoryModel = nullptr;
         DdlHistoryModel* ddlHistoryModel = nullptr;
         QMutex sqlHistoryMutex;
+        QTimer* sqlHistoryLimitTimer = nullptr;
+        bool sqlHistoryFts = false;
+
+        /**
+         * @brief Interval of applying SQL history size limit, in milliseconds.
+         *
+         * The limit is not applied with every added entry, as it's not cheap for large history.
+         */
+        static const int SQL_HISTORY_LIMIT_INTERVAL = 5 * 60 * 1000;
         QString sqlite3Version;
 
     public slots:
@@ -13,8 +13,15 @@
 #include <QDebug>
 #include <QUrl>
 #include <QDir>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QThread>
+#include <QEventLoop>
+#include <QtConcurrent/QtConcurrentRun>
 #include <db/invaliddb.h>
 
+static const QString PROBE_CACHE_CFG_GROUP = QStringLiteral("DbProbeCache");
+
 DbManagerImpl::DbManagerImpl(QObject *parent) :
     DbManager(parent)
 {
@@ -24,6 +31,11 @@ DbManagerImpl::DbManagerImpl(QObject *parent) :
 DbManagerImpl::~DbManagerImpl()
 {
 //    qDebug() << "DbManagerImpl::~DbManagerImpl()";
+    if (abandonedProbes.values().contains(true))
+        qWarning() << "Some database probes still hang, so their threads are left behind.";
+    else
+        delete probeThreadPool;
+
     for (Db* db : dbList)
     {
         disconnect(db, SIGNAL(disconnected()), this, SLOT(dbDisconnectedSlot()));
@@ -332,10 +344,21 @@ void DbManagerImpl::setInMemDbCreatorPlugin(DbPlugin* plugin)
     inMemDbCreatorPlugin = plugin;
 }
 
+void DbManagerImpl::setProbeTimeout(int msecs)
+{
+    probeTimeout = msecs;
+}
+
 void DbManagerImpl::init()
 {
     Q_ASSERT(PLUGINS);
 
+    probeThreadPool = new QThreadPool();
+    probeThreadPool->setMaxThreadCount(PROBE_THREADS);
+    probeClock.start();
+    probeTimeoutTimer.setInterval(1000);
+    connect(&probeTimeoutTimer, SIGNAL(timeout()), this, SLOT(checkProbeTimeouts()));
+
     loadInitialDbList();
 
     connect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(aboutToUnload(Plugin*,PluginType*)));
@@ -362,7 +385,10 @@ void DbManagerImpl::loadInitialDbList()
 
 void DbManagerImpl::notifyDatabasesAreLoaded()
 {
-    // Any databases were already loaded by loaded() slot, which is called when DbPlugin was loaded.
+    // Any databases were already loaded by loaded() slot, which is called when DbPlugin was loaded,
+    // or they are still being probed in threads. In the latter case we need to wait for them,
+    // so the list is complete for whoever reacts to the signal (like session restoring).
+    waitForProbes();
     emit dbListLoaded();
 }
 
@@ -398,56 +424,270 @@ void DbManagerImpl::rescanInvalidDatabasesForPlugin(DbPlugin* dbPlugin)
         return;
     }
 
-    Db* db = nullptr;
-
-    QUrl url;
-    QString errorMessages;
+    QList<PendingProbe> alreadyProbed = pendingProbes.values();
     for (Db* invalidDb : getInvalidDatabases())
     {
         if (invalidDb->getConnectionOptions().contains(DB_PLUGIN) && invalidDb->getConnectionOptions()[DB_PLUGIN].toString() != dbPlugin->getName())
             continue;
 
-        url = QUrl::fromUserInput(invalidDb->getPath());
-        if (url.isLocalFile() && !QFile::exists(invalidDb->getPath()))
+        bool probing = false;
+        for (const PendingProbe& probe : alreadyProbed)
+        {
+            if (probe.dbName == invalidDb->getName() && probe.dbPlugin == dbPlugin)
+            {
+                probing = true;
+                break;
+            }
+        }
+
+        if (probing)
             continue;
 
-        errorMessages = QString();
-        db = createDb(invalidDb->getName(), invalidDb->getPath(), invalidDb->getConnectionOptions(), &errorMessages);
+        startProbing(invalidDb, dbPlugin);
+    }
+}
+
+void DbManagerImpl::startProbing(Db* invalidDb, DbPlugin* dbPlugin)
+{
+    QUrl url = QUrl::fromUserInput(invalidDb->getPath());
+    if (!url.isLocalFile())
+    {
+        QString errorMessages;
+        Db* db = createDb(invalidDb->getName(), invalidDb->getPath(), invalidDb->getConnectionOptions(), &errorMessages);
         if (!db)
         {
             if (!errorMessages.isNull())
-            {
                 dynamic_cast<InvalidDb*>(invalidDb)->setError(errorMessages);
-            }
-            continue; // For this db driver was not loaded yet.
+
+            return; // For this db driver was not loaded yet.
         }
 
-        if (!dbPlugin->checkIfDbServedByPlugin(db))
-        {
-            qDebug().noquote() << "Managed to load database" << toNativePath(db->getPath()) << " (" << db->getName() << ")"
-                     << "but it doesn't use DbPlugin that was just loaded, so it will not be loaded to the db manager";
+        acceptLoadedDb(invalidDb, db, dbPlugin);
+        return;
+    }
 
-            delete db;
-            continue;
-        }
+    QVariantHash cached = CFG->get(PROBE_CACHE_CFG_GROUP, invalidDb->getPath()).toHash();
+
+    ProbeRequest request;
+    request.name = invalidDb->getName();
+    request.path = invalidDb->getPath();
+    request.options = invalidDb->getConnectionOptions();
+    request.dbPlugins = PLUGINS->getLoadedPlugins<DbPlugin>();
+    request.cachedPluginName = cached["plugin"].toString();
+    request.cachedSignature = cached["signature"].toByteArray();
+    request.targetThread = thread();
+    request.state = QSharedPointer<QAtomicInt>::create(PROBE_QUEUED);
+
+    PendingProbe pending;
+    pending.dbName = request.name;
+    pending.path = request.path;
+    pending.dbPlugin = dbPlugin;
+    pending.queuedAt = probeClock.elapsed();
+    pending.state = request.state;
+
+    ProbeWatcher* watcher = new ProbeWatcher(this);
+    pendingProbes[watcher] = pending;
+    connect(watcher, &ProbeWatcher::finished, this, [this, watcher]()
+    {
+        handleProbeResult(watcher);
+    });
+    watcher->setFuture(QtConcurrent::run(probeThreadPool, &DbManagerImpl::probeDb, request));
 
-        removeDbInternal(invalidDb, false);
-        delete invalidDb;
+    if (!probeTimeoutTimer.isActive())
+        probeTimeoutTimer.start();
+}
 
-        addDbInternal(db, false);
+DbManagerImpl::ProbeResult DbManagerImpl::probeDb(const ProbeRequest& request)
+{
+    ProbeResult result;
+    if (!request.state->testAndSetOrdered(PROBE_QUEUED, PROBE_RUNNING))
+        return result; // Abandoned while waiting in the queue
+    if (!QFile::exists(request.path))
+    {
+        result.fileMissing = true;
+        return result;
+    }
 
-        if (!db->getConnectionOptions().contains(DB_PLUGIN))
+    result.signature = readProbeSignature(request.path, request.options);
+    if (!result.signature.isEmpty() && result.signature == request.cachedSignature)
+    {
+        for (DbPlugin* dbPlugin : request.dbPlugins)
         {
-            db->getConnectionOptions()[DB_PLUGIN] = dbPlugin->getName();
-            if (!CFG->updateDb(db->getName(), db->getName(), db->getPath(), db->getConnectionOptions()))
-                qWarning() << "Could not store handling plugin in options for database" << db->getName();
+            if (dbPlugin->getName() != request.cachedPluginName)
+                continue;
+
+            result.db = dbPlugin->getInstanceWithoutProbing(request.name, QDir(request.path).absolutePath(), request.options);
+            if (result.db && !result.db->initAfterCreated())
+                safe_delete(result.db);
+
+            break;
         }
+    }
 
-        if (CFG->getDbGroup(db->getName())->open)
-            db->open();
+    if (!result.db)
+        result.db = createDb(request.dbPlugins, request.name, request.path, request.options, &result.errorMessage);
 
-        emit dbLoaded(db);
+    if (result.db)
+        result.db->moveToThread(request.targetThread);
+
+    return result;
+}
+
+QByteArray DbManagerImpl::readProbeSignature(const QString& path, const QHash<QString, QVariant>& options)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    // SQLite header (first 100 bytes) contains the change counter, page size, schema cookie, etc.
+    // Together with size and modification time it's a reliable indicator of the file being unchanged.
+    QByteArray header = file.read(100);
+    QFileInfo fileInfo(file);
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << fileInfo.size() << fileInfo.lastModified() << header;
+
+    // QHash order differs between runs, so options are sorted. DB_PLUGIN is added to options after the first successful probing,
+    // so it's not a part of the signature.
+    QStringList keys = options.keys();
+    keys.removeOne(DB_PLUGIN);
+    keys.sort();
+    for (const QString& key : keys)
+        stream << key << options[key];
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+bool DbManagerImpl::acceptLoadedDb(Db* invalidDb, Db* db, DbPlugin* dbPlugin)
+{
+    if (!dbPlugin->checkIfDbServedByPlugin(db))
+    {
+        qDebug().noquote() << "Managed to load database" << toNativePath(db->getPath()) << " (" << db->getName() << ")"
+                 << "but it doesn't use DbPlugin that was just loaded, so it will not be loaded to the db manager";
+
+        delete db;
+        return false;
     }
+
+    removeDbInternal(invalidDb, false);
+    delete invalidDb;
+
+    addDbInternal(db, false);
+
+    if (!db->getConnectionOptions().contains(DB_PLUGIN))
+    {
+        db->getConnectionOptions()[DB_PLUGIN] = dbPlugin->getName();
+        if (!CFG->updateDb(db->getName(), db->getName(), db->getPath(), db->getConnectionOptions()))
+            qWarning() << "Could not store handling plugin in options for database" << db->getName();
+    }
+
+    if (CFG->getDbGroup(db->getName())->open)
+        db->open();
+
+    emit dbLoaded(db);
+    return true;
+}
+
+void DbManagerImpl::handleProbeResult(ProbeWatcher* watcher)
+{
+    // Results of abandoned probes arrive eventually and they are just dropped.
+    if (abandonedProbes.contains(watcher))
+    {
+        if (abandonedProbes.take(watcher))
+            probeThreadPool->setMaxThreadCount(probeThreadPool->maxThreadCount() - 1);
+
+        delete watcher->result().db;
+        watcher->deleteLater();
+        return;
+    }
+
+    if (!pendingProbes.contains(watcher))
+        return;
+
+    PendingProbe pending = pendingProbes.take(watcher);
+    ProbeResult result = watcher->result();
+    watcher->deleteLater();
+    probesUpdated();
+
+    // The database might have been removed, edited, or loaded by other means in the meantime.
+    Db* invalidDb = getByName(pending.dbName);
+    if (!invalidDb || invalidDb->isValid() || invalidDb->getPath() != pending.path)
+    {
+        delete result.db;
+        return;
+    }
+
+    if (result.fileMissing)
+        return;
+
+    if (!result.db)
+    {
+        if (!result.errorMessage.isNull())
+            dynamic_cast<InvalidDb*>(invalidDb)->setError(result.errorMessage);
+
+        return; // For this db driver was not loaded yet.
+    }
+
+    QString pluginName = pending.dbPlugin->getName();
+    if (!acceptLoadedDb(invalidDb, result.db, pending.dbPlugin) || result.signature.isEmpty())
+        return;
+
+    QVariantHash cached;
+    cached["plugin"] = pluginName;
+    cached["signature"] = result.signature;
+    CFG->set(PROBE_CACHE_CFG_GROUP, pending.path, cached);
+}
+
+void DbManagerImpl::waitForProbes()
+{
+    if (pendingProbes.isEmpty())
+        return;
+
+    // Results and timeouts are handled by the watchers and the timeout timer, just like without waiting.
+    // The local loop only keeps them going, until probesUpdated() finds no pending probe.
+    QEventLoop loop;
+    probesWaitLoop = &loop;
+    loop.exec(QEventLoop::ExcludeUserInputEvents);
+    probesWaitLoop = nullptr;
+}
+
+void DbManagerImpl::probesUpdated()
+{
+    if (!pendingProbes.isEmpty())
+        return;
+
+    probeTimeoutTimer.stop();
+    if (probesWaitLoop)
+        probesWaitLoop->quit();
+}
+
+void DbManagerImpl::checkProbeTimeouts()
+{
+    // Probes waiting in the queue are timed out too, otherwise hanging workers would block all probes queued after them.
+    qint64 now = probeClock.elapsed();
+    QMutableHashIterator<ProbeWatcher*,PendingProbe> it(pendingProbes);
+    while (it.hasNext())
+    {
+        it.next();
+        if (now - it.value().queuedAt < probeTimeout)
+            continue;
+
+        Db* invalidDb = getByName(it.value().dbName);
+        if (invalidDb && !invalidDb->isValid())
+            dynamic_cast<InvalidDb*>(invalidDb)->setError(tr("Database file could not be read in %1 seconds.").arg(qMax(1, probeTimeout / 1000)));
+
+        qWarning() << "Probing of database" << it.value().dbName << "timed out.";
+        // A running worker may hang forever, so the pool gets a spare thread for other probes
+        bool running = !it.value().state->testAndSetOrdered(PROBE_QUEUED, PROBE_ABANDONED);
+        if (running)
+            probeThreadPool->setMaxThreadCount(probeThreadPool->maxThreadCount() + 1);
+
+        abandonedProbes[it.key()] = running;
+        it.remove();
+    }
+
+    probesUpdated();
 }
 
 void DbManagerImpl::addDbInternal(Db* db, bool alsoToConfig)
@@ -497,7 +737,12 @@ Db* DbManagerImpl::tryToLoadDb(InvalidDb* invalidDb, bool emitNotifySignal)
 
 Db* DbManagerImpl::createDb(const QString &name, const QString &path, const QHash<QString,QVariant> &options, QString* errorMessages)
 {
-    QList<DbPlugin*> dbPlugins = PLUGINS->getLoadedPlugins<DbPlugin>();
+    return createDb(PLUGINS->getLoadedPlugins<DbPlugin>(), name, path, options, errorMessages);
+}
+
+Db* DbManagerImpl::createDb(const QList<DbPlugin*>& dbPlugins, const QString &name, const QString &path, const QHash<QString,QVariant> &options,
+                            QString* errorMessages)
+{
     Db* db = nullptr;
     QStringList messages;
     QString message;
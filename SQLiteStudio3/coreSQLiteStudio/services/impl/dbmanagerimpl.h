@@ -11,8 +11,15 @@
 #include <QHash>
 #include <QReadWriteLock>
 #include <QSharedPointer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QTimer>
+#include <QSet>
 
 class InvalidDb;
+class QEventLoop;
 
 class API_EXPORT DbManagerImpl : public DbManager
 {
@@ -55,7 +62,75 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         void setInMemDbCreatorPlugin(DbPlugin* plugin);
 
+        /**
+         * @brief Defines time after which probing of a single database file is abandoned.
+         * @param msecs Time in milliseconds. PROBE_TIMEOUT is used by default.
+         */
+        void setProbeTimeout(int msecs);
+
+        /**
+         * @brief Maximum number of database files probed at the same time.
+         */
+        static const int PROBE_THREADS = 4;
+
+        /**
+         * @brief Default time (in milliseconds) after which probing of a single database file is abandoned.
+         */
+        static const int PROBE_TIMEOUT = 15000;
+
     private:
+        /**
+         * @brief State of a single probing, shared between the manager and the worker.
+         */
+        enum ProbeState
+        {
+            PROBE_QUEUED = 0,
+            PROBE_RUNNING = 1,
+            PROBE_ABANDONED = 2
+        };
+
+        /**
+         * @brief Input for probing a single database in a worker thread.
+         */
+        struct ProbeRequest
+        {
+            QString name;
+            QString path;
+            QHash<QString,QVariant> options;
+            QList<DbPlugin*> dbPlugins;
+            QString cachedPluginName;
+            QByteArray cachedSignature;
+            QThread* targetThread = nullptr;
+            QSharedPointer<QAtomicInt> state;
+        };
+
+        /**
+         * @brief Outcome of probing a single database.
+         *
+         * The db object (if any) is already moved to the thread of DbManagerImpl.
+         */
+        struct ProbeResult
+        {
+            Db* db = nullptr;
+            QString errorMessage;
+            QByteArray signature;
+            bool fileMissing = false;
+        };
+
+        /**
+         * @brief Probing of a database that was started, but its result was not merged yet.
+         */
+        struct PendingProbe
+        {
+            QString dbName;
+            QString path;
+            DbPlugin* dbPlugin = nullptr;
+            qint64 queuedAt = 0;
+            QSharedPointer<QAtomicInt> state;
+        };
+
+        typedef QFutureWatcher<ProbeResult> ProbeWatcher;
+
         /**
          * @brief Internal manager initialization.
          *
@@ -113,6 +188,65 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         static Db* createDb(const QString &name, const QString &path, const QHash<QString, QVariant> &options, QString* errorMessages = nullptr);
 
+        static Db* createDb(const QList<DbPlugin*>& dbPlugins, const QString &name, const QString &path, const QHash<QString, QVariant> &options,
+                            QString* errorMessages = nullptr);
+
+        /**
+         * @brief Starts probing of the invalid database in the probing thread pool.
+         * @param invalidDb Database to probe.
+         * @param dbPlugin Plugin that was just loaded and triggered the probing.
+         *
+         * Only databases in local files are probed in threads. Others (like remote databases served by plugins)
+         * are probed in the calling thread, as their plugins are not required to be thread-safe.
+         */
+        void startProbing(Db* invalidDb, DbPlugin* dbPlugin);
+
+        /**
+         * @brief Probes database in a worker thread.
+         * @param request Probing parameters.
+         * @return Probing results.
+         *
+         * If the file signature (see readProbeSignature()) equals to the one cached for the last successful probing,
+         * the database is created by the cached plugin without opening the file.
+         */
+        static ProbeResult probeDb(const ProbeRequest& request);
+
+        /**
+         * @brief Calculates signature of database file for probing cache.
+         * @param path Path to the database file.
+         * @param options Connection options of the database.
+         * @return Hash of file size, modification time, file header and options (except DB_PLUGIN), or empty array if the file could not be read.
+         */
+        static QByteArray readProbeSignature(const QString& path, const QHash<QString, QVariant>& options);
+
+        /**
+         * @brief Replaces invalid database with the successfully loaded one.
+         * @param invalidDb Database to replace.
+         * @param db Loaded database.
+         * @param dbPlugin Plugin that triggered loading.
+         * @return true if the database was accepted, or false if it was deleted.
+         */
+        bool acceptLoadedDb(Db* invalidDb, Db* db, DbPlugin* dbPlugin);
+
+        /**
+         * @brief Merges results of probing into the database list.
+         * @param watcher Watcher of the finished probing.
+         */
+        void handleProbeResult(ProbeWatcher* watcher);
+
+        /**
+         * @brief Blocks until all pending probes are finished or abandoned.
+         *
+         * Results are merged as they come. It's used before dbListLoaded() is emitted,
+         * so everybody who waits for the initial database list gets it complete.
+         */
+        void waitForProbes();
+
+        /**
+         * @brief Stops the timeout timer and ends waitForProbes() once no probe is pending.
+         */
+        void probesUpdated();
+
         /**
          * @brief Registered databases list. Both permanent and transient databases.
          */
@@ -143,6 +277,39 @@ class API_EXPORT DbManagerImpl : public DbManager
 
         QList<DbPlugin*> dbPlugins;
 
+        /**
+         * @brief Clock for measuring probing times.
+         */
+        QElapsedTimer probeClock;
+
+        /**
+         * @brief Thread pool for probing database files.
+         *
+         * It's not deleted if some abandoned workers still hang, as deleting the pool would wait for them.
+         */
+        QThreadPool* probeThreadPool = nullptr;
+
+        /**
+         * @brief Probes that are running or waiting in the pool.
+         */
+        QHash<ProbeWatcher*,PendingProbe> pendingProbes;
+
+        /**
+         * @brief Probes that were not finished in probeTimeout since they were queued. Their results are discarded once they arrive.
+         *
+         * The value tells if the worker was already running when abandoned. Such worker still occupies a thread,
+         * so the pool is allowed one more thread until the worker returns.
+         */
+        QHash<ProbeWatcher*,bool> abandonedProbes;
+
+        QTimer probeTimeoutTimer;
+        int probeTimeout = PROBE_TIMEOUT;
+
+        /**
+         * @brief Event loop of waitForProbes(), if it's waiting at the moment.
+         */
+        QEventLoop* probesWaitLoop = nullptr;
+
     private slots:
         /**
          * @brief Slot called when connected to db.
@@ -180,6 +347,11 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         void loaded(Plugin* plugin, PluginType* type);
 
+        /**
+         * @brief Abandons probes that are running longer than probeTimeout.
+         */
+        void checkProbeTimeouts();
+
     public slots:
         void notifyDatabasesAreLoaded();
         void scanForNewDatabasesInConfig();
@@ -4,8 +4,11 @@
 #include "services/notifymanager.h"
 #include "common/unused.h"
 #include "translations.h"
+#include "common/startuptrace.h"
 #include <QCoreApplication>
 #include <QDir>
+#include <QTimer>
+#include <QThread>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonValue>
@@ -140,17 +143,49 @@ void PluginManagerImpl::scanPlugins()
     qDebug() << "Following plugins found:" << names;
 }
 
+void PluginManagerImpl::loadDeferredPluginsOfType(PluginType* type)
+{
+    if (!pluginsAreInitiallyLoaded || !deferredPluginTypes.contains(type))
+        return;
+
+    deferredPluginTypes.removeOne(type);
+
+    StartupTrace::Scope trace("Deferred plugins: " + type->getName());
+    QStringList alreadyAttempted;
+    for (PluginContainer* container : pluginCategories[type])
+    {
+        if (!container->loaded && shouldAutoLoad(container->name))
+            load(container->name, alreadyAttempted);
+    }
+}
+
 void PluginManagerImpl::loadPlugins()
 {
+    // Explicitly restricted startup types take precedence over deferring.
+    if (!startupPluginTypes.isEmpty())
+        deferredPluginTypes.clear();
+
     QStringList alreadyAttempted;
     for (const QString& pluginName : pluginContainer.keys())
     {
+        PluginType* type = pluginContainer[pluginName]->type;
+        if (!startupPluginTypes.isEmpty() && !startupPluginTypes.contains(type))
+            continue;
+
+        if (deferredPluginTypes.contains(type))
+            continue;
+
         if (shouldAutoLoad(pluginName))
             load(pluginName, alreadyAttempted);
     }
 
     pluginsAreInitiallyLoaded = true;
     emit pluginsInitiallyLoaded();
+
+    // Deferred types are loaded once the event loop runs, so they don't delay the startup,
+    // but they're still loaded by the thread owning the manager and not by whoever asks for them first.
+    if (!deferredPluginTypes.isEmpty())
+        QTimer::singleShot(0, this, [this]() {loadDeferredPlugins();});
 }
 
 bool PluginManagerImpl::initPlugin(QPluginLoader* loader, const QString& fileName)
@@ -564,6 +599,7 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
     }
 
     // Loading pluginName
+    StartupTrace::Scope trace("Plugin: " + pluginName);
     if (!loader->load())
     {
         notifyWarn(tr("Cannot load plugin %1. Error details: %2").arg(pluginName, loader->errorString()));
@@ -772,6 +808,30 @@ bool PluginManagerImpl::arePluginsInitiallyLoaded() const
     return pluginsAreInitiallyLoaded;
 }
 
+void PluginManagerImpl::setStartupPluginTypes(const QList<PluginType*>& types)
+{
+    startupPluginTypes = types;
+}
+
+void PluginManagerImpl::setDeferredPluginTypes(const QList<PluginType*>& types)
+{
+    deferredPluginTypes = types;
+}
+
+void PluginManagerImpl::loadDeferredPlugins()
+{
+    if (QThread::currentThread() != thread())
+    {
+        qCritical() << "Deferred plugins can be loaded only from the thread of the plugin manager.";
+        return;
+    }
+
+    // Copy, because loading removes the type from the list
+    QList<PluginType*> types = deferredPluginTypes;
+    for (PluginType* type : types)
+        loadDeferredPluginsOfType(type);
+}
+
 QList<Plugin*> PluginManagerImpl::getLoadedPlugins() const
 {
     QList<Plugin*> plugins;
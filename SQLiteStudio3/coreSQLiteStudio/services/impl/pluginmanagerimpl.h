@@ -48,6 +48,9 @@ class API_EXPORT PluginManagerImpl : public PluginManager
         QStringList getDependencies(const QString& pluginName) const;
         QStringList getConflicts(const QString& pluginName) const;
         bool arePluginsInitiallyLoaded() const;
+        void setStartupPluginTypes(const QList<PluginType*>& types);
+        void setDeferredPluginTypes(const QList<PluginType*>& types);
+        void loadDeferredPlugins();
         QList<Plugin*> getLoadedPlugins() const;
         QStringList getLoadedPluginNames() const;
         QList<PluginDetails> getAllPluginDetails() const;
@@ -192,6 +195,14 @@ class API_EXPORT PluginManagerImpl : public PluginManager
          */
         void loadPlugins();
 
+        /**
+         * @brief Loads plugins of given type, if the type is still deferred.
+         * @param type Plugin type.
+         *
+         * Only plugins that should be loaded (see shouldAutoLoad()) are loaded.
+         */
+        void loadDeferredPluginsOfType(PluginType* type);
+
         /**
          * @brief Loads given plugin.
          * @param pluginName Name of the plugin to load.
@@ -324,6 +335,16 @@ class API_EXPORT PluginManagerImpl : public PluginManager
         QHash<QString,ScriptingPlugin*> scriptingPlugins;
 
         bool pluginsAreInitiallyLoaded = false;
+
+        /**
+         * @brief Plugin types to be loaded by loadPlugins(). Empty list means all types.
+         */
+        QList<PluginType*> startupPluginTypes;
+
+        /**
+         * @brief Plugin types to be loaded on first use. Types are removed from the list once they're loaded.
+         */
+        QList<PluginType*> deferredPluginTypes;
 };
 
 #endif // PLUGINMANAGERIMPL_H
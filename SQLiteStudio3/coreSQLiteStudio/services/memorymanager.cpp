@@ -0,0 +1,149 @@
+#include "memorymanager.h"
+#include "services/dbmanager.h"
+#include "services/config.h"
+#include "services/notifymanager.h"
+#include "db/db.h"
+#include "db/queryexecutor.h"
+#include "schemaresolver.h"
+#include "common/memoryusage.h"
+#include "common/utils.h"
+#include <QTimer>
+
+MemoryManager::MemoryManager()
+{
+    checkTimer = new QTimer(this);
+    checkTimer->setInterval(CHECK_INTERVAL_MS);
+    connect(checkTimer, SIGNAL(timeout()), this, SLOT(checkLimit()));
+    checkTimer->start();
+}
+
+MemoryManager::~MemoryManager()
+{
+}
+
+void MemoryManager::registerConsumer(MemoryConsumer* consumer)
+{
+    QMutexLocker locker(&consumersMutex);
+    consumers << consumer;
+}
+
+void MemoryManager::deregisterConsumer(MemoryConsumer* consumer)
+{
+    QMutexLocker locker(&consumersMutex);
+    consumers.removeOne(consumer);
+}
+
+QList<MemoryManager::Entry> MemoryManager::getUsage()
+{
+    QList<Entry> entries;
+    Entry entry;
+    Db::MemoryStatus status;
+    for (Db* db : DBLIST->getDbList())
+    {
+        status = Db::MemoryStatus();
+        if (!db->isOpen() || !db->getMemoryStatus(status))
+            continue;
+
+        entry.name = tr("Database %1").arg(db->getName());
+        entry.bytes = status.cacheUsed + status.schemaUsed + status.statementsUsed + status.lookasideUsed;
+        entry.details = tr("page cache %1, schema %2, statements %3, lookaside %4, cache hits %5, misses %6, writes %7")
+                .arg(formatFileSize(status.cacheUsed), formatFileSize(status.schemaUsed), formatFileSize(status.statementsUsed),
+                     formatFileSize(status.lookasideUsed), QString::number(status.cacheHits), QString::number(status.cacheMisses),
+                     QString::number(status.cacheWrites));
+        entries << entry;
+    }
+
+    int cacheEntries = 0;
+    entry.name = tr("Schema cache");
+    entry.bytes = SchemaResolver::getCacheMemoryUsage(cacheEntries);
+    entry.details = tr("%n entries", "", cacheEntries);
+    entries << entry;
+
+    entry.name = tr("Row count cache");
+    entry.bytes = QueryExecutor::getCountCacheMemoryUsage(cacheEntries);
+    entry.details = tr("%n entries", "", cacheEntries);
+    entries << entry;
+
+    QMutexLocker locker(&consumersMutex);
+    for (MemoryConsumer* consumer : consumers)
+    {
+        entry.bytes = consumer->getMemoryUsage();
+        if (entry.bytes == 0)
+            continue;
+
+        entry.name = consumer->getMemoryConsumerName();
+        entry.details.clear();
+        entries << entry;
+    }
+
+    return entries;
+}
+
+QStringList MemoryManager::getUsageReport()
+{
+    QStringList lines;
+    qint64 processMemory = getMemoryUsage();
+    int limit = CFG_CORE.General.MemorySoftLimit.get();
+    QString processMemoryStr = processMemory < 0 ? tr("unknown") : formatFileSize(processMemory);
+    if (limit > 0)
+        lines << tr("Process memory: %1 (soft limit: %2)").arg(processMemoryStr, formatFileSize(((quint64)limit) * 1024 * 1024));
+    else
+        lines << tr("Process memory: %1").arg(processMemoryStr);
+
+    qint64 total = 0;
+    for (const Entry& entry : getUsage())
+    {
+        total += entry.bytes;
+        if (entry.details.isEmpty())
+            lines << QString("%1: %2").arg(entry.name, formatFileSize(entry.bytes));
+        else
+            lines << QString("%1: %2 (%3)").arg(entry.name, formatFileSize(entry.bytes), entry.details);
+    }
+
+    lines << tr("Total accounted memory: %1").arg(formatFileSize(total));
+    return lines;
+}
+
+void MemoryManager::trim()
+{
+    for (Db* db : DBLIST->getDbList())
+    {
+        if (db->isOpen())
+            db->releaseMemory();
+    }
+
+    SchemaResolver::clearCache();
+    QueryExecutor::clearCountCache();
+
+    QMutexLocker locker(&consumersMutex);
+    for (MemoryConsumer* consumer : consumers)
+        consumer->trimMemory();
+}
+
+void MemoryManager::checkLimit()
+{
+    int limit = CFG_CORE.General.MemorySoftLimit.get();
+    if (limit <= 0)
+        return;
+
+    qint64 processMemory = getMemoryUsage();
+    if (processMemory < 0)
+        return;
+
+    if (processMemory <= ((qint64)limit) * 1024 * 1024)
+    {
+        limitExceeded = false;
+        return;
+    }
+
+    // Freed memory is not always given back to the system, so caches are trimmed and the warning is displayed
+    // only once per exceedance, until the usage drops below the limit. Otherwise caches would be dropped on every check.
+    if (limitExceeded)
+        return;
+
+    trim();
+    notifyWarn(tr("Memory used by the application (%1) exceeds the soft limit (%2). Caches were cleared and large values in data grids were released.")
+               .arg(formatFileSize(processMemory), formatFileSize(((quint64)limit) * 1024 * 1024)));
+
+    limitExceeded = true;
+}
@@ -0,0 +1,111 @@
+#ifndef MEMORYMANAGER_H
+#define MEMORYMANAGER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "sqlitestudio.h"
+#include <QObject>
+#include <QList>
+#include <QMutex>
+
+class QTimer;
+
+/**
+ * @brief Object holding memory, which can be accounted and trimmed by the MemoryManager.
+ *
+ * Implementations register themselves with MemoryManager::registerConsumer() and have to deregister
+ * with MemoryManager::deregisterConsumer() before they are deleted. Methods are called from the main thread.
+ */
+class API_EXPORT MemoryConsumer
+{
+    public:
+        virtual ~MemoryConsumer() {}
+
+        /**
+         * @brief Provides name of the consumer, to be displayed to the user.
+         * @return Human readable name.
+         */
+        virtual QString getMemoryConsumerName() const = 0;
+
+        /**
+         * @brief Estimates memory held by the consumer.
+         * @return Estimated number of bytes.
+         */
+        virtual qint64 getMemoryUsage() const = 0;
+
+        /**
+         * @brief Releases memory, that can be restored later on demand.
+         * @return Estimated number of bytes released.
+         */
+        virtual qint64 trimMemory() = 0;
+};
+
+/**
+ * @brief Accounts memory used by databases, caches and registered consumers.
+ *
+ * It collects the memory used by each open database connection (as reported by SQLite),
+ * by caches shared by the application (schema objects, counted result rows) and by all registered
+ * MemoryConsumer objects (such as query results in data grids).
+ *
+ * If the soft limit is configured (CFG_CORE.General.MemorySoftLimit, in megabytes), the memory used
+ * by the process is checked periodically and when it exceeds the limit, memory is trimmed - see trim().
+ * It's trimmed once per exceedance, i.e. again only after the usage dropped below the limit.
+ */
+class API_EXPORT MemoryManager : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Memory used by a single database, cache or consumer.
+         */
+        struct API_EXPORT Entry
+        {
+            QString name;
+            qint64 bytes = 0;
+            QString details;
+        };
+
+        MemoryManager();
+        ~MemoryManager();
+
+        void registerConsumer(MemoryConsumer* consumer);
+        void deregisterConsumer(MemoryConsumer* consumer);
+
+        /**
+         * @brief Collects memory usage of all accounted objects.
+         * @return Entries for databases, caches and consumers, in this order. Consumers holding no memory are skipped.
+         */
+        QList<Entry> getUsage();
+
+        /**
+         * @brief Provides memory usage in human readable form.
+         * @return Lines describing memory of the process and each entry from getUsage().
+         */
+        QStringList getUsageReport();
+
+        /**
+         * @brief Releases memory that can be restored later.
+         *
+         * Unused page cache of all open databases is released, shared caches are cleared
+         * and all registered consumers are trimmed.
+         */
+        void trim();
+
+        /**
+         * @brief Interval of checking the memory used by the process against the soft limit.
+         */
+        static const int CHECK_INTERVAL_MS = 10000;
+
+    private:
+        QTimer* checkTimer = nullptr;
+        QList<MemoryConsumer*> consumers;
+        QMutex consumersMutex;
+        bool limitExceeded = false;
+
+    private slots:
+        void checkLimit();
+};
+
+#define MEMORY_MANAGER SQLITESTUDIO->getMemoryManager()
+
+#endif // MEMORYMANAGER_H
@@ -355,6 +355,41 @@ class API_EXPORT PluginManager : public QObject
          */
         virtual bool arePluginsInitiallyLoaded() const = 0;
 
+        /**
+         * @brief Restricts plugin types that are loaded automatically by init().
+         * @param types Plugin types to be loaded at startup. Empty list (the default) means all types.
+         *
+         * Plugins of other types are still scanned, so they are listed by getAllPluginNames() and getAllPluginDetails(),
+         * but they are not loaded unless explicitly requested with load(). This lets headless clients
+         * (like the batch mode of the CLI) start faster, by loading only plugins they actually need.
+         *
+         * It has to be called before init().
+         */
+        virtual void setStartupPluginTypes(const QList<PluginType*>& types) = 0;
+
+        /**
+         * @brief Defines plugin types that are loaded on first use, instead of at startup.
+         * @param types Plugin types to defer.
+         *
+         * Plugins of deferred types are scanned by init(), but they are loaded (respecting the user's choice
+         * of loaded plugins) only after the startup, when the event loop processes the first events,
+         * or earlier if loadDeferredPlugins() is called. It's meant for plugin types that are not needed until user
+         * does something specific (like exporting data), so they don't slow down the startup.
+         * Until then getLoadedPlugins() and getLoadedPlugin() don't report them.
+         *
+         * It's ignored if setStartupPluginTypes() was used, as the caller has then decided explicitly what to load.
+         * It has to be called before init().
+         */
+        virtual void setDeferredPluginTypes(const QList<PluginType*>& types) = 0;
+
+        /**
+         * @brief Loads plugins of all deferred types that were not loaded yet.
+         *
+         * Use it before presenting full list of plugins with their load state (like in the configuration dialog).
+         * It has to be called from the thread of the plugin manager (the main thread).
+         */
+        virtual void loadDeferredPlugins() = 0;
+
         /**
          * @brief registerPluginType Registers plugin type for loading and managing.
          * @tparam T Interface class (as defined by Qt plugins standard)
@@ -1,30 +1,41 @@
 #include "sqlhistorymodel.h"
 #include "common/global.h"
 #include "db/db.h"
+#include "db/executionprofile.h"
+#include <QRegularExpression>
+#include <QDebug>
 
-SqlHistoryModel::SqlHistoryModel(Db* db, QObject *parent) :
-    QueryModel(db, parent)
+SqlHistoryModel::SqlHistoryModel(Db* db, bool fullTextSearch, QObject *parent) :
+    QAbstractTableModel(parent), db(db), fullTextSearch(fullTextSearch)
 {
-    static_char* query = "SELECT id, dbname, datetime(date, 'unixepoch', 'localtime'), (time_spent / 1000.0)||'s', rows, sql "
-                         "FROM sqleditor_history ORDER BY date DESC";
-
-    setQuery(query);
+    refresh();
 }
 
 QVariant SqlHistoryModel::data(const QModelIndex& index, int role) const
 {
+    if (!index.isValid() || index.row() >= loadedRows.size())
+        return QVariant();
+
     if (role == Qt::TextAlignmentRole && (index.column() == 2 || index.column() == 3))
         return (int)(Qt::AlignRight|Qt::AlignVCenter);
 
-     QVariant d = QueryModel::data(index, role);
+    if (role == Qt::ToolTipRole && index.column() == 3)
+    {
+        QString profile = loadedRows[index.row()]->value(6).toString();
+        if (!profile.isEmpty())
+            return ExecutionProfile::fromJson(profile).toString();
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
 
-    return QueryModel::data(index, role);
+    return loadedRows[index.row()]->value(index.column());
 }
 
 QVariant SqlHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
-        return QueryModel::headerData(section, orientation, role);
+        return QAbstractTableModel::headerData(section, orientation, role);
 
     switch (section)
     {
@@ -42,5 +53,214 @@ QVariant SqlHistoryModel::headerData(int section, Qt::Orientation orientation, i
             return tr("SQL", "sql history header");
     }
 
-    return QueryModel::headerData(section, orientation, role);
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+int SqlHistoryModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return loadedRows.size();
+}
+
+int SqlHistoryModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return COLUMNS;
+}
+
+bool SqlHistoryModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return false;
+
+    return !allLoaded;
+}
+
+void SqlHistoryModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || allLoaded)
+        return;
+
+    QList<SqlResultsRowPtr> rows;
+    if (loadedRows.isEmpty())
+        rows = load(QString(), QList<QVariant>(), PAGE_SIZE);
+    else
+        rows = load("id < ?", {getId(loadedRows.size() - 1)}, PAGE_SIZE);
+
+    allLoaded = rows.size() < PAGE_SIZE;
+    if (rows.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), loadedRows.size(), loadedRows.size() + rows.size() - 1);
+    loadedRows += rows;
+    endInsertRows();
+}
+
+QString SqlHistoryModel::getFilter() const
+{
+    return filter;
+}
+
+void SqlHistoryModel::setFilter(const QString& value)
+{
+    if (filter == value)
+        return;
+
+    filter = value;
+    refresh();
+}
+
+void SqlHistoryModel::refresh()
+{
+    beginResetModel();
+    loadedRows.clear();
+    allLoaded = true;
+    if (db && db->isOpen())
+    {
+        loadedRows = load(QString(), QList<QVariant>(), PAGE_SIZE);
+        allLoaded = loadedRows.size() < PAGE_SIZE;
+    }
+    endResetModel();
+}
+
+void SqlHistoryModel::entryAdded(qint64 id)
+{
+    if (findRow(id) > -1)
+    {
+        entryUpdated(id);
+        return;
+    }
+
+    SqlResultsRowPtr entry = loadEntry(id);
+    if (!entry)
+        return; // not matching the filter
+
+    // Usually it's the most recent entry, so it goes to the top
+    int row = 0;
+    while (row < loadedRows.size() && getId(row) > id)
+        row++;
+
+    if (row == loadedRows.size() && !allLoaded)
+        return; // it will be loaded with next pages
+
+    beginInsertRows(QModelIndex(), row, row);
+    loadedRows.insert(row, entry);
+    endInsertRows();
+}
+
+void SqlHistoryModel::entryUpdated(qint64 id)
+{
+    int row = findRow(id);
+    if (row < 0)
+        return;
+
+    SqlResultsRowPtr entry = loadEntry(id);
+    if (!entry)
+    {
+        beginRemoveRows(QModelIndex(), row, row);
+        loadedRows.removeAt(row);
+        endRemoveRows();
+        return;
+    }
+
+    loadedRows[row] = entry;
+    emit dataChanged(index(row, 0), index(row, COLUMNS - 1));
+}
+
+QList<SqlResultsRowPtr> SqlHistoryModel::load(const QString& condition, const QList<QVariant>& args, int limit)
+{
+    static_qstring(queryTpl, "SELECT id, dbname, datetime(date, 'unixepoch', 'localtime'), (time_spent / 1000.0)||'s', rows, sql, profile "
+                             "FROM sqleditor_history WHERE %1 ORDER BY id DESC LIMIT %2");
+    static_qstring(ftsCondition, "id IN (SELECT rowid FROM sqleditor_history_fts WHERE sqleditor_history_fts MATCH ?)");
+    static_qstring(likeCondition, "sql LIKE ? ESCAPE '\\'");
+
+    if (!db || !db->isOpen())
+        return QList<SqlResultsRowPtr>();
+
+    QStringList conditions;
+    QList<QVariant> queryArgs;
+    if (!filter.trimmed().isEmpty())
+    {
+        if (fullTextSearch)
+        {
+            conditions << ftsCondition;
+            queryArgs << toFtsQuery(filter);
+        }
+        else
+        {
+            conditions << likeCondition;
+            queryArgs << toLikePattern(filter);
+        }
+    }
+
+    if (!condition.isEmpty())
+    {
+        conditions << condition;
+        queryArgs += args;
+    }
+
+    if (conditions.isEmpty())
+        conditions << "1";
+
+    SqlQueryPtr results = db->exec(queryTpl.arg(conditions.join(" AND "), QString::number(limit)), queryArgs);
+    if (results->isError())
+    {
+        qWarning() << "Error while loading SQL history:" << results->getErrorText();
+        return QList<SqlResultsRowPtr>();
+    }
+
+    return results->getAll();
+}
+
+SqlResultsRowPtr SqlHistoryModel::loadEntry(qint64 id)
+{
+    QList<SqlResultsRowPtr> rows = load("id = ?", {id}, 1);
+    if (rows.isEmpty())
+        return SqlResultsRowPtr();
+
+    return rows.first();
+}
+
+int SqlHistoryModel::findRow(qint64 id) const
+{
+    for (int row = 0, total = loadedRows.size(); row < total; row++)
+    {
+        if (getId(row) == id)
+            return row;
+    }
+    return -1;
+}
+
+qint64 SqlHistoryModel::getId(int row) const
+{
+    return loadedRows[row]->value(0).toLongLong();
+}
+
+QString SqlHistoryModel::toFtsQuery(const QString& filter)
+{
+    // Each word becomes a quoted prefix phrase, so no character of the filter is interpreted as FTS5 query syntax.
+    QStringList phrases;
+    for (QString word : filter.split(QRegularExpression("\\s+"),
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+                                     Qt::SkipEmptyParts
+#else
+                                     QString::SkipEmptyParts
+#endif
+                                     ))
+    {
+        phrases << ("\"" + word.replace("\"", "\"\"") + "\"*");
+    }
+
+    return phrases.join(" ");
+}
+
+QString SqlHistoryModel::toLikePattern(const QString& filter)
+{
+    QString pattern = filter.trimmed();
+    pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+    return "%" + pattern + "%";
 }
@@ -1,19 +1,96 @@
 #ifndef SQLHISTORYMODEL_H
 #define SQLHISTORYMODEL_H
 
-#include "querymodel.h"
+#include "coreSQLiteStudio_global.h"
+#include "db/sqlquery.h"
+#include "db/sqlresultsrow.h"
+#include <QAbstractTableModel>
+#include <QList>
 
 class Db;
 
-class SqlHistoryModel : public QueryModel
+/**
+ * @brief Model of SQL editor execution history.
+ *
+ * Entries are loaded in pages, starting from the most recent ones. Next pages are loaded when the view
+ * asks for them (see fetchMore()), so opening the history doesn't read the entire history table.
+ * New and updated entries are applied as single rows (see entryAdded() and entryUpdated()),
+ * while refresh() reloads just the first page.
+ *
+ * Entries can be filtered by their SQL with setFilter(). If the full-text search index is available
+ * (the FTS5 table sqleditor_history_fts), words of the filter are matched as word prefixes with the index.
+ * Otherwise the filter is matched as a substring with LIKE.
+ */
+class API_EXPORT SqlHistoryModel : public QAbstractTableModel
 {
         Q_OBJECT
 
     public:
-        SqlHistoryModel(Db* db, QObject *parent = nullptr);
+        /**
+         * @brief Creates model and loads the first page of entries.
+         * @param db Configuration database.
+         * @param fullTextSearch Tells if the sqleditor_history_fts index can be used for filtering.
+         * @param parent Parent object.
+         */
+        SqlHistoryModel(Db* db, bool fullTextSearch, QObject *parent = nullptr);
 
         QVariant data(const QModelIndex& index, int role) const;
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+        int rowCount(const QModelIndex& parent = QModelIndex()) const;
+        int columnCount(const QModelIndex& parent = QModelIndex()) const;
+        bool canFetchMore(const QModelIndex& parent) const;
+        void fetchMore(const QModelIndex& parent);
+
+        QString getFilter() const;
+
+        /**
+         * @brief Filters entries by their SQL.
+         * @param value Words to look for. Empty string disables filtering.
+         */
+        void setFilter(const QString& value);
+
+    public slots:
+        /**
+         * @brief Drops loaded entries and loads the first page again.
+         */
+        void refresh();
+
+        /**
+         * @brief Adds entry to the model, if it matches the filter.
+         * @param id ID of the added entry.
+         */
+        void entryAdded(qint64 id);
+
+        /**
+         * @brief Reloads single entry, if it's loaded.
+         * @param id ID of the updated entry.
+         */
+        void entryUpdated(qint64 id);
+
+    private:
+        /**
+         * @brief Loads entries from the database.
+         * @param condition Additional condition for entries (besides the filter).
+         * @param args Arguments for the condition.
+         * @param limit Maximum number of entries.
+         * @return Entries ordered from the most recent.
+         */
+        QList<SqlResultsRowPtr> load(const QString& condition, const QList<QVariant>& args, int limit);
+        SqlResultsRowPtr loadEntry(qint64 id);
+        int findRow(qint64 id) const;
+        qint64 getId(int row) const;
+
+        static QString toFtsQuery(const QString& filter);
+        static QString toLikePattern(const QString& filter);
+
+        static const int PAGE_SIZE = 500;
+        static const int COLUMNS = 7;
+
+        Db* db = nullptr;
+        bool fullTextSearch = false;
+        QString filter;
+        QList<SqlResultsRowPtr> loadedRows;
+        bool allLoaded = false;
 };
 
 #endif // SQLHISTORYMODEL_H
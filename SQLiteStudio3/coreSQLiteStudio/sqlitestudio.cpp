@@ -32,8 +32,10 @@
 #include "plugins/importplugin.h"
 #include "plugins/populateplugin.h"
 #include "services/extralicensemanager.h"
+#include "services/memorymanager.h"
 #include "services/sqliteextensionmanager.h"
 #include "translations.h"
+#include "common/startuptrace.h"
 #include "chillout/chillout.h"
 #include <QProcessEnvironment>
 #include <QThreadPool>
@@ -102,6 +104,16 @@ void SQLiteStudio::setExtraLicenseManager(ExtraLicenseManager* value)
     extraLicenseManager = value;
 }
 
+MemoryManager* SQLiteStudio::getMemoryManager() const
+{
+    return memoryManager;
+}
+
+void SQLiteStudio::setMemoryManager(MemoryManager* value)
+{
+    memoryManager = value;
+}
+
 
 bool SQLiteStudio::getImmediateQuit() const
 {
@@ -300,6 +312,9 @@ void SQLiteStudio::setConfig(Config* value)
 
 void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 {
+    StartupTrace::enableFromEnv();
+    StartupTrace::Scope initTrace("Core init");
+
     env = new QProcessEnvironment(QProcessEnvironment::systemEnvironment());
     this->guiAvailable = guiAvailable;
 
@@ -309,13 +324,18 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
     CfgLazyInitializer::init();
 
+    StartupTrace::Scope trace("Utils");
     initUtils();
     CfgMain::staticInit();
     Db::metaInit();
     initUtilsSql();
     SchemaResolver::staticInit();
+
+    trace.next("Keywords & lexer");
     initKeywords();
     Lexer::staticInit();
+
+    trace.next("Completion helper");
     CompletionHelper::init();
 
     qRegisterMetaType<ScriptingPlugin::Context*>();
@@ -324,12 +344,15 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
     dbAttacherFactory = new DbAttacherDefaultFactory();
 
+    trace.next("Config");
     config = new ConfigImpl();
     config->init();
 
+    trace.next("Translations");
     currentLang = CFG_CORE.General.Language.get();
     loadTranslations(initialTranslationFiles);
 
+    trace.next("Services");
     pluginManager = new PluginManagerImpl();
     dbManager = new DbManagerImpl();
 
@@ -341,6 +364,14 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
     pluginManager->registerPluginType<ImportPlugin>(QObject::tr("Importing", "plugin category name"));
     pluginManager->registerPluginType<PopulatePlugin>(QObject::tr("Table populating", "plugin category name"));
 
+    // These are needed only when user actually exports, imports or populates something,
+    // so they are loaded after the startup, instead of slowing it down.
+    pluginManager->setDeferredPluginTypes({
+        pluginManager->getPluginType<ExportPlugin>(),
+        pluginManager->getPluginType<ImportPlugin>(),
+        pluginManager->getPluginType<PopulatePlugin>()
+    });
+
     codeFormatter = new CodeFormatter();
     connect(CFG_CORE.General.ActiveCodeFormatter, SIGNAL(changed(QVariant)), this, SLOT(updateCurrentCodeFormatter()));
     connect(pluginManager, SIGNAL(pluginsInitiallyLoaded()), this, SLOT(updateCodeFormatter()));
@@ -356,6 +387,7 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
     connect(pluginManager, SIGNAL(pluginsInitiallyLoaded()), DBLIST, SLOT(notifyDatabasesAreLoaded()));
 
+    trace.next("Built-in plugins");
     DbPluginSqlite3* sqlite3plugin = new DbPluginSqlite3;
     dynamic_cast<DbManagerImpl*>(dbManager)->setInMemDbCreatorPlugin(sqlite3plugin);
 
@@ -363,6 +395,7 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
     pluginManager->loadBuiltInPlugin(new ScriptingSql);
     pluginManager->loadBuiltInPlugin(sqlite3plugin);
 
+    trace.next("Managers");
     exportManager = new ExportManager();
     importManager = new ImportManager();
     populateManager = new PopulateManager();
@@ -370,6 +403,7 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
     updateManager = new UpdateManager();
 #endif
     extraLicenseManager = new ExtraLicenseManager();
+    memoryManager = new MemoryManager();
 
     extraLicenseManager->addLicense("SQLiteStudio license (GPL v3)", ":/docs/licenses/sqlitestudio_license.txt");
     extraLicenseManager->addLicense("Fugue icons", ":/docs/licenses/fugue_icons.txt");
@@ -383,6 +417,7 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
 void SQLiteStudio::initPlugins()
 {
+    StartupTrace::Scope trace("Plugins");
     pluginManager->init();
 
     connect(pluginManager, SIGNAL(loaded(Plugin*,PluginType*)), this, SLOT(pluginLoaded(Plugin*,PluginType*)));
@@ -409,6 +444,7 @@ void SQLiteStudio::cleanUp()
         safe_delete(exportManager);
         safe_delete(functionManager);
         safe_delete(extraLicenseManager);
+        safe_delete(memoryManager);
         safe_delete(dbManager);
         safe_delete(config);
         safe_delete(codeFormatter);
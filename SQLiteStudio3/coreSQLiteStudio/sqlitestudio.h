@@ -28,6 +28,7 @@ class PluginLoadingHandler;
 class UpdateManager;
 #endif
 class ExtraLicenseManager;
+class MemoryManager;
 class SqliteExtensionManager;
 
 /** @file */
@@ -156,6 +157,9 @@ class API_EXPORT SQLiteStudio : public QObject
         ExtraLicenseManager* getExtraLicenseManager() const;
         void setExtraLicenseManager(ExtraLicenseManager* value);
 
+        MemoryManager* getMemoryManager() const;
+        void setMemoryManager(MemoryManager* value);
+
         QString getCurrentLang() const;
 
         QStringList getInitialTranslationFiles() const;
@@ -219,6 +223,7 @@ class API_EXPORT SQLiteStudio : public QObject
         UpdateManager* updateManager = nullptr;
 #endif
         ExtraLicenseManager* extraLicenseManager = nullptr;
+        MemoryManager* memoryManager = nullptr;
         QString currentLang;
         QStringList initialTranslationFiles;
 
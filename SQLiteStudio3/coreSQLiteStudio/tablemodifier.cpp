@@ -1,4 +1,5 @@
 #include "tablemodifier.h"
+#include "common/utils.h"
 #include "common/utils_sql.h"
 #include "parser/parser.h"
 #include "schemaresolver.h"
@@ -36,6 +37,16 @@ void TableModifier::alterTable(SqliteCreateTablePtr newCreateTable)
     existingColumns = newCreateTable->getColumnNames();
     newName = newCreateTable->table;
 
+    if (planNativeAlter(newCreateTable))
+    {
+        strategy = Strategy::NATIVE_ALTER;
+        estimatedRowsToCopy = 0;
+        return;
+    }
+
+    strategy = Strategy::REBUILD;
+    estimatedRowsToCopy = estimateRowCount();
+
     sqls << "PRAGMA foreign_keys = 0;";
 
     handleFkConstrains(newCreateTable.data(), createTable->table, newName);
@@ -61,6 +72,287 @@ void TableModifier::alterTable(SqliteCreateTablePtr newCreateTable)
     sqls << "PRAGMA foreign_keys = 1;";
 }
 
+bool TableModifier::planNativeAlter(SqliteCreateTablePtr newCreateTable)
+{
+    if (!createTable || table.compare(newName, Qt::CaseInsensitive) != 0)
+        return false;
+
+    if (createTable->withOutRowId.compare(newCreateTable->withOutRowId, Qt::CaseInsensitive) != 0)
+        return false;
+
+    // Table constraints cannot be changed by ALTER TABLE.
+    if (createTable->constraints.size() != newCreateTable->constraints.size())
+        return false;
+
+    for (int i = 0, total = createTable->constraints.size(); i < total; i++)
+    {
+        if (getStatementDdl(createTable->constraints[i]) != getStatementDdl(newCreateTable->constraints[i]))
+            return false;
+    }
+
+    QHash<QString, SqliteCreateTable::Column*> oldColumns;
+    for (SqliteCreateTable::Column* column : createTable->columns)
+        oldColumns[column->name.toLower()] = column;
+
+    QList<QPair<QString, QString>> renamedColumns;
+    QList<SqliteCreateTable::Column*> addedColumns;
+    QSet<QString> keptColumns;
+    int lastOldIdx = -1;
+    for (SqliteCreateTable::Column* column : newCreateTable->columns)
+    {
+        SqliteCreateTable::Column* oldColumn = oldColumns.value(column->originalName.toLower());
+        if (!oldColumn)
+        {
+            if (!isNativeAddColumnPossible(column))
+                return false;
+
+            addedColumns << column;
+            continue;
+        }
+
+        // ADD COLUMN appends at the end, so existing columns have to keep their order and cannot follow new columns.
+        int oldIdx = createTable->columns.indexOf(oldColumn);
+        if (oldIdx < lastOldIdx || !addedColumns.isEmpty() || keptColumns.contains(oldColumn->name.toLower()))
+            return false;
+
+        lastOldIdx = oldIdx;
+
+        // Any change in the column definition other than the name requires rebuild.
+        if (getColumnDdl(oldColumn, oldColumn->name) != getColumnDdl(column, oldColumn->name))
+            return false;
+
+        keptColumns << oldColumn->name.toLower();
+        if (column->name != oldColumn->name)
+            renamedColumns << QPair<QString, QString>(oldColumn->name, column->name);
+    }
+
+    QList<SqliteCreateTable::Column*> droppedColumns;
+    for (SqliteCreateTable::Column* column : createTable->columns)
+    {
+        if (!keptColumns.contains(column->name.toLower()))
+            droppedColumns << column;
+    }
+
+    SchemaResolver resolver(db);
+    resolver.setIgnoreSystemObjects(true);
+
+    // Tables referencing this one are kept in sync by the rebuild procedure (see handleFks()).
+    if (!resolver.getFkReferencingTables(originalTable).isEmpty())
+        return false;
+
+    // RENAME COLUMN updates triggers and views since 3.26.0, unless legacy behavior was enabled.
+    if (!renamedColumns.isEmpty() && (getSqliteVersion() < 3026000 || db->exec("PRAGMA legacy_alter_table")->getSingleCell().toBool()))
+        return false;
+
+    if (!droppedColumns.isEmpty() && getSqliteVersion() < 3035000)
+        return false;
+
+    for (SqliteCreateTable::Column* column : droppedColumns)
+    {
+        if (!isNativeDropColumnPossible(column, resolver))
+            return false;
+    }
+
+    static_qstring(dropColTpl, "ALTER TABLE %1 DROP COLUMN %2;");
+    static_qstring(renameColTpl, "ALTER TABLE %1 RENAME COLUMN %2 TO %3;");
+    static_qstring(addColTpl, "ALTER TABLE %1 ADD COLUMN %2;");
+
+    QString wrappedTable = wrapObjIfNeeded(table);
+    for (SqliteCreateTable::Column* column : droppedColumns)
+        sqls << dropColTpl.arg(wrappedTable, wrapObjIfNeeded(column->name));
+
+    // When a column gets the old name of another renamed column (swap, or a chain like a->b, b->c),
+    // the target name still exists at the time of renaming, so columns are renamed through temporary names.
+    QStringList renamedOldNames;
+    for (const QPair<QString, QString>& renamed : renamedColumns)
+        renamedOldNames << renamed.first;
+
+    bool renameConflict = false;
+    for (const QPair<QString, QString>& renamed : renamedColumns)
+    {
+        if (renamedOldNames.contains(renamed.second, Qt::CaseInsensitive))
+        {
+            renameConflict = true;
+            break;
+        }
+    }
+
+    if (renameConflict)
+    {
+        QStringList usedNames = createTable->getColumnNames() + newCreateTable->getColumnNames();
+        for (QPair<QString, QString>& renamed : renamedColumns)
+        {
+            QString tempName = generateUniqueName(renamed.first + "_tmp", usedNames, Qt::CaseInsensitive);
+            usedNames << tempName;
+            sqls << renameColTpl.arg(wrappedTable, wrapObjIfNeeded(renamed.first), wrapObjIfNeeded(tempName));
+            renamed.first = tempName;
+        }
+    }
+
+    for (const QPair<QString, QString>& renamed : renamedColumns)
+        sqls << renameColTpl.arg(wrappedTable, wrapObjIfNeeded(renamed.first), wrapObjIfNeeded(renamed.second));
+
+    for (SqliteCreateTable::Column* column : addedColumns)
+        sqls << addColTpl.arg(wrappedTable, getColumnDdl(column, column->name));
+
+    if (!renamedColumns.isEmpty())
+    {
+        // SQLite updates column names in triggers and views by itself.
+        modifiedTriggers += resolver.getTriggersForTable(originalTable);
+        modifiedViews += resolver.getViewsForTable(originalTable);
+    }
+
+    return true;
+}
+
+bool TableModifier::isNativeAddColumnPossible(SqliteCreateTable::Column* column)
+{
+    for (SqliteCreateTable::Column::Constraint* constr : column->constraints)
+    {
+        switch (constr->type)
+        {
+            case SqliteCreateTable::Column::Constraint::PRIMARY_KEY:
+            case SqliteCreateTable::Column::Constraint::UNIQUE:
+                return false;
+            case SqliteCreateTable::Column::Constraint::DEFAULT:
+            {
+                // Only constant default values are allowed
+                if (constr->expr || !constr->ctime.isNull())
+                    return false;
+
+                break;
+            }
+            case SqliteCreateTable::Column::Constraint::GENERATED:
+            {
+                if (constr->generatedType == SqliteCreateTable::Column::Constraint::GeneratedType::STORED)
+                    return false;
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    SqliteCreateTable::Column::Constraint* defConstr = column->getConstraint(SqliteCreateTable::Column::Constraint::DEFAULT);
+    bool nullDefault = !defConstr || defConstr->literalNull || (defConstr->id.isNull() && defConstr->literalValue.isNull());
+
+    // Existing rows get the default value, so it cannot be NULL for NOT NULL column, nor non-NULL for foreign key.
+    if (column->hasConstraint(SqliteCreateTable::Column::Constraint::NOT_NULL) && nullDefault)
+        return false;
+
+    if (column->hasConstraint(SqliteCreateTable::Column::Constraint::FOREIGN_KEY) && !nullDefault)
+        return false;
+
+    return true;
+}
+
+bool TableModifier::isNativeDropColumnPossible(SqliteCreateTable::Column* column, SchemaResolver& resolver)
+{
+    if (column->hasConstraint(SqliteCreateTable::Column::Constraint::PRIMARY_KEY) ||
+            column->hasConstraint(SqliteCreateTable::Column::Constraint::UNIQUE) ||
+            column->hasConstraint(SqliteCreateTable::Column::Constraint::FOREIGN_KEY))
+    {
+        return false;
+    }
+
+    // Column cannot be used anywhere else in the table (constraints, generated columns), other than its own definition.
+    if (countColumnOccurrences(column->name, createTable->tokens) > 1)
+        return false;
+
+    for (SqliteCreateIndexPtr index : resolver.getParsedIndexesForTable(originalTable))
+    {
+        if (countColumnOccurrences(column->name, index->tokens) > 0)
+            return false;
+    }
+
+    for (SqliteCreateTriggerPtr trigger : resolver.getParsedTriggersForTable(originalTable, true))
+    {
+        if (countColumnOccurrences(column->name, trigger->tokens) > 0)
+            return false;
+    }
+
+    for (SqliteCreateViewPtr view : resolver.getParsedViewsForTable(originalTable))
+    {
+        if (countColumnOccurrences(column->name, view->tokens) > 0)
+            return false;
+    }
+
+    return true;
+}
+
+int TableModifier::countColumnOccurrences(const QString& column, const TokenList& tokens)
+{
+    int count = 0;
+    QString value;
+    for (const TokenPtr& token : tokens)
+    {
+        if (token->type != Token::OTHER && token->type != Token::STRING)
+            continue;
+
+        value = token->value;
+        if (stripObjName(value).compare(column, Qt::CaseInsensitive) == 0)
+            count++;
+    }
+    return count;
+}
+
+QString TableModifier::getColumnDdl(SqliteCreateTable::Column* column, const QString& name)
+{
+    SqliteCreateTable::Column* columnClone = dynamic_cast<SqliteCreateTable::Column*>(column->clone());
+    columnClone->name = name;
+    QString ddl = getStatementDdl(columnClone);
+    delete columnClone;
+    return ddl;
+}
+
+QString TableModifier::getStatementDdl(SqliteStatement* stmt)
+{
+    // Cloning to avoid overwritting tokens of the original statement.
+    SqliteStatement* stmtClone = stmt->clone();
+    stmtClone->rebuildTokens();
+    QString ddl = stmtClone->detokenize();
+    delete stmtClone;
+    return ddl;
+}
+
+int TableModifier::getSqliteVersion()
+{
+    QStringList parts = db->exec("SELECT sqlite_version()")->getSingleCell().toString().split(".");
+    if (parts.size() < 3)
+        return 0;
+
+    return parts[0].toInt() * 1000000 + parts[1].toInt() * 1000 + parts[2].toInt();
+}
+
+qint64 TableModifier::estimateRowCount()
+{
+    if (!createTable)
+        return -1;
+
+    // First number in the sqlite_stat1 is the number of rows in the table. It's there if the ANALYZE was executed.
+    SqlQueryPtr results = db->exec("SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name = 'sqlite_stat1'");
+    if (!results->isError() && results->getSingleCell().toInt() > 0)
+    {
+        results = db->exec("SELECT stat FROM sqlite_stat1 WHERE tbl = ? LIMIT 1", {originalTable});
+        QString stat = results->isError() ? QString() : results->getSingleCell().toString();
+        bool ok = false;
+        qint64 rows = stat.section(" ", 0, 0).toLongLong(&ok);
+        if (ok)
+            return rows;
+    }
+
+    // Highest ROWID is found quickly, without scanning whole table.
+    if (!createTable->withOutRowId.isNull())
+        return -1;
+
+    results = db->exec(QString("SELECT max(rowid) FROM %1").arg(wrapObjIfNeeded(originalTable)));
+    if (results->isError())
+        return -1;
+
+    return results->getSingleCell().toLongLong();
+}
+
 void TableModifier::renameTo(const QString& newName)
 {
     if (!createTable)
@@ -376,6 +668,16 @@ QString TableModifier::handleUpdateColumn(const QString& colName, bool& modified
     return colName;
 }
 
+TableModifier::Strategy TableModifier::getStrategy() const
+{
+    return strategy;
+}
+
+qint64 TableModifier::getEstimatedRowsToCopy() const
+{
+    return estimatedRowsToCopy;
+}
+
 QStringList TableModifier::getModifiedViews() const
 {
     return modifiedViews;
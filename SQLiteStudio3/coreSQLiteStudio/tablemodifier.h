@@ -12,9 +12,20 @@
 #include "parser/ast/sqlitecreateview.h"
 #include "common/strhash.h"
 
+class SchemaResolver;
+
 class API_EXPORT TableModifier
 {
     public:
+        /**
+         * @brief Way of applying table modifications, chosen by alterTable().
+         */
+        enum class Strategy
+        {
+            REBUILD,        /**< New table is created, all data is copied to it and the old table is dropped. */
+            NATIVE_ALTER    /**< Modifications are applied in place with ALTER TABLE (RENAME COLUMN, ADD COLUMN, DROP COLUMN). */
+        };
+
         TableModifier(Db* db, const QString& table);
         TableModifier(Db* db, const QString& database, const QString& table);
 
@@ -30,9 +41,37 @@ class API_EXPORT TableModifier
         QStringList getModifiedViews() const;
         bool hasMessages() const;
 
+        /**
+         * @brief Provides modification strategy chosen by alterTable().
+         * @return Strategy used for generated SQL statements.
+         *
+         * Native ALTER TABLE statements are used whenever the new table definition differs from the old one
+         * only by renamed, added or dropped columns and SQLite supports it for such columns.
+         * Otherwise the table is rebuilt.
+         */
+        Strategy getStrategy() const;
+
+        /**
+         * @brief Provides estimated number of rows to be copied by generated SQL statements.
+         * @return Number of rows, or -1 if it could not be estimated.
+         *
+         * It's always 0 for Strategy::NATIVE_ALTER. For Strategy::REBUILD it's estimated from sqlite_stat1
+         * (if table was analyzed), or from the highest ROWID. Only the modified table is taken into account,
+         * not other tables rebuilt due to foreign keys referencing the modified table.
+         */
+        qint64 getEstimatedRowsToCopy() const;
+
     private:
         void init();
         void parseDdl();
+        bool planNativeAlter(SqliteCreateTablePtr newCreateTable);
+        bool isNativeAddColumnPossible(SqliteCreateTable::Column* column);
+        bool isNativeDropColumnPossible(SqliteCreateTable::Column* column, SchemaResolver& resolver);
+        int countColumnOccurrences(const QString& column, const TokenList& tokens);
+        QString getColumnDdl(SqliteCreateTable::Column* column, const QString& name);
+        QString getStatementDdl(SqliteStatement* stmt);
+        int getSqliteVersion();
+        qint64 estimateRowCount();
         QString getTempTableName();
         void copyDataTo(const QString& targetTable, const QStringList& srcCols, const QStringList& dstCols);
         void renameTo(const QString& newName);
@@ -161,6 +200,8 @@ class API_EXPORT TableModifier
         QStringList modifiedTriggers;
         QStringList modifiedViews;
         QStringList usedTempTableNames;
+        Strategy strategy = Strategy::REBUILD;
+        qint64 estimatedRowsToCopy = -1;
 };
 
 
@@ -3,6 +3,7 @@
 #include <QTranslator>
 #include <QCoreApplication>
 #include <QDir>
+#include <QFile>
 #include <QDebug>
 #include <QRegularExpression>
 
@@ -14,37 +15,34 @@ void loadTranslation(const QString& baseName)
     if (SQLITESTUDIO_TRANSLATIONS.contains(baseName))
         return;
 
+    QString lang = SQLITESTUDIO->getCurrentLang();
+    QString fileName = baseName+"_"+lang+".qm";
+    QString filePath;
     QTranslator* translator = new QTranslator();
-
-    QString fName;
     bool res = false;
-    QString lang = SQLITESTUDIO->getCurrentLang();
-    QStringList filters = QStringList({baseName+"_"+lang+".qm"});
-    QDir dir;
 
+    // Checking exact file path is much cheaper than listing directories. Translator memory-maps files
+    // from the file system (and uses resources in place), so loading does not copy whole catalog into memory.
     for (const QString& dirPath : SQLITESTUDIO_TRANSLATION_DIRS)
     {
-        dir.setPath(dirPath);
-        for (const QString& f : dir.entryList(filters))
-        {
-            res = translator->load(f, dirPath);
-            if (res)
-            {
-                fName = dirPath + "/" + f;
-                break;
-            }
-        }
+        filePath = dirPath + "/" + fileName;
+        if (!QFile::exists(filePath))
+            continue;
 
+        res = translator->load(filePath);
         if (res)
             break;
     }
 
     if (!res)
+    {
+        delete translator;
         return;
+    }
 
     qApp->installTranslator(translator);
     SQLITESTUDIO_TRANSLATIONS[baseName] = translator;
-    qDebug() << "Loaded:" << fName;
+    qDebug() << "Loaded:" << filePath;
 }
 
 void unloadTranslation(const QString& baseName)
@@ -0,0 +1,160 @@
+#include "fullvaluesloader.h"
+#include "sqlqueryitem.h"
+#include "sqlquerymodelcolumn.h"
+#include "db/db.h"
+#include "db/sqlresultsrow.h"
+#include "common/utils_sql.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+FullValuesLoader::FullValuesLoader(Db* db, QObject *parent) :
+    QObject(parent), db(db)
+{
+}
+
+bool FullValuesLoader::addItem(SqlQueryItem* item)
+{
+    SqlQueryModelColumn* col = item->getColumn();
+    if (!col || col->editionForbiddenReason.size() > 0 || col->table.isNull() || col->column.isNull())
+        return false;
+
+    RowId rowId = item->getRowId();
+    if (rowId.size() != 1 || !rowId.contains("ROWID"))
+        return false;
+
+    bool ok;
+    qint64 rowIdValue = rowId["ROWID"].toLongLong(&ok);
+    if (!ok)
+        return false;
+
+    static_qstring(keyTpl, "%1.%2");
+    QString key = keyTpl.arg(col->database.toLower(), col->table.toLower());
+    Source& source = sources[key];
+    if (source.table.isNull())
+    {
+        source.database = col->database;
+        source.table = col->table;
+    }
+
+    if (!source.columns.contains(col->column, Qt::CaseInsensitive))
+        source.columns << col->column;
+
+    Cell cell;
+    cell.column = col->column;
+    cell.item = item;
+    source.cellsByRowId[rowIdValue] << cell;
+    totalCells++;
+    return true;
+}
+
+void FullValuesLoader::start()
+{
+    QtConcurrent::run(this, &FullValuesLoader::loadAsync);
+}
+
+bool FullValuesLoader::load()
+{
+    values.clear();
+    errorText.clear();
+
+    if (!db->isOpen())
+    {
+        errorText = tr("Cannot load the data for a cell that refers to the already closed database.");
+        return false;
+    }
+
+    int loadedCells = 0;
+    for (const Source& source : sources)
+    {
+        if (!loadSource(source, loadedCells))
+            return false;
+    }
+
+    return true;
+}
+
+bool FullValuesLoader::isEmpty() const
+{
+    return totalCells == 0;
+}
+
+bool FullValuesLoader::isInterrupted() const
+{
+    return interrupted.loadAcquire();
+}
+
+QString FullValuesLoader::getErrorText() const
+{
+    return errorText;
+}
+
+QHash<SqlQueryItem*, QVariant> FullValuesLoader::getValues() const
+{
+    return values;
+}
+
+bool FullValuesLoader::loadSource(const Source& source, int& loadedCells)
+{
+    static_qstring(tpl, "SELECT ROWID, %1 FROM %2 WHERE ROWID IN (%3)");
+
+    QStringList wrappedColumns;
+    for (const QString& column : source.columns)
+        wrappedColumns << wrapObjIfNeeded(column);
+
+    QString src = wrapObjIfNeeded(source.table);
+    if (!source.database.isNull())
+        src.prepend(wrapObjIfNeeded(source.database) + ".");
+
+    QString colsStr = wrappedColumns.join(", ");
+    QList<qint64> rowIds = source.cellsByRowId.keys();
+    QList<QVariant> args;
+    QStringList placeholders;
+    SqlQueryPtr results;
+    SqlResultsRowPtr row;
+    for (int offset = 0, total = rowIds.size(); offset < total; offset += ROWS_PER_QUERY)
+    {
+        if (isInterrupted())
+            return false;
+
+        args.clear();
+        placeholders.clear();
+        for (qint64 rowId : rowIds.mid(offset, ROWS_PER_QUERY))
+        {
+            args << rowId;
+            placeholders << "?";
+        }
+
+        results = db->exec(tpl.arg(colsStr, src, placeholders.join(", ")), args);
+        if (results->isError())
+        {
+            errorText = results->getErrorText();
+            qWarning() << "Error while loading full values of cells:" << errorText;
+            return false;
+        }
+
+        while (results->hasNext())
+        {
+            row = results->next();
+            for (const Cell& cell : source.cellsByRowId.value(row->value(0).toLongLong()))
+            {
+                values[cell.item] = row->value(source.columns.indexOf(cell.column) + 1);
+                loadedCells++;
+            }
+        }
+
+        emit progress(static_cast<int>(100LL * loadedCells / totalCells));
+    }
+    return true;
+}
+
+void FullValuesLoader::loadAsync()
+{
+    bool result = load();
+    emit finished(result && !isInterrupted());
+}
+
+void FullValuesLoader::interrupt()
+{
+    interrupted = 1;
+    db->asyncInterrupt();
+}
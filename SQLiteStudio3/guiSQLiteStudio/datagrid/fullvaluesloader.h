@@ -0,0 +1,99 @@
+#ifndef FULLVALUESLOADER_H
+#define FULLVALUESLOADER_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QObject>
+#include <QHash>
+#include <QVariant>
+#include <QStringList>
+#include <QAtomicInt>
+
+class Db;
+class SqlQueryItem;
+
+/**
+ * @brief Loads full (not limited) values of many data grid cells at once.
+ *
+ * Cells are grouped by the source table and values are loaded by a single
+ * <tt>SELECT ... WHERE ROWID IN (...)</tt> query per chunk of rows, instead of one query per cell.
+ *
+ * Items are added from the GUI thread with addItem(), then start() executes loading
+ * in a separate thread, reporting progress with progress() signal. It can be interrupted with interrupt().
+ * Once finished() is emitted, loaded values are available with getValues().
+ * Items are never accessed from the loading thread, they are used only as keys.
+ *
+ * Only cells referring directly to columns of regular (ROWID) tables can be loaded this way.
+ * For other cells addItem() returns false and it's up to the caller to load them in the old way
+ * (i.e. with SqlQueryItem::getFullValue()).
+ */
+class GUI_API_EXPORT FullValuesLoader : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit FullValuesLoader(Db* db, QObject *parent = nullptr);
+
+        /**
+         * @brief Adds cell to be loaded.
+         * @param item Data grid cell.
+         * @return true if the cell will be loaded, or false if it cannot be loaded in bulk.
+         */
+        bool addItem(SqlQueryItem* item);
+
+        /**
+         * @brief Starts loading in a separate thread.
+         */
+        void start();
+
+        /**
+         * @brief Loads values synchronously in the calling thread.
+         * @return true on success, false on error or interruption.
+         */
+        bool load();
+
+        bool isEmpty() const;
+        bool isInterrupted() const;
+        QString getErrorText() const;
+        QHash<SqlQueryItem*,QVariant> getValues() const;
+
+        /**
+         * @brief Number of rows loaded by a single query.
+         *
+         * Keeps the number of bound parameters well below the SQLite limit.
+         */
+        static const int ROWS_PER_QUERY = 500;
+
+    private:
+        struct Cell
+        {
+            QString column;
+            SqlQueryItem* item = nullptr;
+        };
+
+        struct Source
+        {
+            QString database;
+            QString table;
+            QStringList columns;
+            QHash<qint64,QList<Cell>> cellsByRowId;
+        };
+
+        bool loadSource(const Source& source, int& loadedCells);
+        void loadAsync();
+
+        Db* db = nullptr;
+        QHash<QString,Source> sources;
+        int totalCells = 0;
+        QHash<SqlQueryItem*,QVariant> values;
+        QString errorText;
+        QAtomicInt interrupted = 0;
+
+    public slots:
+        void interrupt();
+
+    signals:
+        void progress(int percent);
+        void finished(bool success);
+};
+
+#endif // FULLVALUESLOADER_H
@@ -472,6 +472,22 @@ QString SqlQueryItem::loadFullData()
     return QString();
 }
 
+DbBlobPtr SqlQueryItem::openBlob(bool readWrite)
+{
+    SqlQueryModelColumn* col = getColumn();
+    Db* db = getModel()->getDb();
+    if (!db->isOpen() || col->editionForbiddenReason.size() > 0 || col->table.isNull())
+        return DbBlobPtr();
+
+    // Only regular ROWID tables can be accessed with the incremental BLOB I/O
+    RowId rowId = getRowId();
+    if (rowId.size() != 1 || !rowId.contains("ROWID"))
+        return DbBlobPtr();
+
+    QString database = col->database.isNull() ? "main" : col->database;
+    return db->openBlob(database, col->table, col->column, rowId["ROWID"].toLongLong(), readWrite);
+}
+
 QVariant SqlQueryItem::getFullValue()
 {
     if (!isLimitedValue())
@@ -3,6 +3,7 @@
 
 #include "sqlquerymodelcolumn.h"
 #include "db/sqlquery.h"
+#include "db/dbblob.h"
 #include "guiSQLiteStudio_global.h"
 #include <QStandardItem>
 
@@ -88,6 +89,14 @@ class GUI_API_EXPORT SqlQueryItem : public QObject, public QStandardItem
          */
         QVariant getFullValue();
 
+        /**
+         * @brief openBlob Opens incremental BLOB I/O handle for the cell.
+         * @param readWrite true to open the handle for writing too.
+         * @return Opened handle, or null if the cell does not refer directly to a table column (or the handle could not be open).
+         * It lets to read the value in chunks, without loading it into memory as a whole.
+         */
+        DbBlobPtr openBlob(bool readWrite = false);
+
         SqlQueryModelColumn* getColumn() const;
         void setColumn(SqlQueryModelColumn* column);
 
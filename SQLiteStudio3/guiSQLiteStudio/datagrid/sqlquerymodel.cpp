@@ -15,6 +15,7 @@
 #include "parser/lexer.h"
 #include "common/compatibility.h"
 #include "mainwindow.h"
+#include "common/memoryusage.h"
 #include <QHeaderView>
 #include <QDebug>
 #include <QApplication>
@@ -24,6 +25,7 @@
 #include <QtMath>
 #include <QMessageBox>
 #include <QThread>
+#include <QElapsedTimer>
 
 QSet<SqlQueryModel*> SqlQueryModel::existingModels;
 
@@ -42,11 +44,15 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
 
     setItemPrototype(new SqlQueryItem());
     existingModels << this;
+    if (MEMORY_MANAGER)
+        MEMORY_MANAGER->registerConsumer(this);
 }
 
 SqlQueryModel::~SqlQueryModel()
 {
     existingModels.remove(this);
+    if (MEMORY_MANAGER)
+        MEMORY_MANAGER->deregisterConsumer(this);
 
     delete queryExecutor;
     queryExecutor = nullptr;
@@ -71,6 +77,11 @@ void SqlQueryModel::setExplainMode(bool explain)
     this->explain = explain;
 }
 
+void SqlQueryModel::setEngineProfiling(bool enabled)
+{
+    engineProfiling = enabled;
+}
+
 void SqlQueryModel::setParams(const QHash<QString, QVariant>& params)
 {
     queryParams = params;
@@ -89,6 +100,11 @@ void SqlQueryModel::executeQuery()
         return;
     }
 
+    // Explicit execution always reads current data. The snapshot of the same query would be reused otherwise
+    // and the filter was built for columns of the previous query.
+    queryExecutor->dropSnapshot();
+    queryExecutor->setSnapshotFilter(QString());
+
     sortOrder.clear();
     queryExecutor->setSkipRowCounting(false);
     queryExecutor->setSortOrder(sortOrder);
@@ -137,7 +153,15 @@ void SqlQueryModel::executeQueryInternal()
     queryExecutor->setParams(queryParams);
     queryExecutor->setResultsPerPage(getRowsPerPage());
     queryExecutor->setExplainMode(explain);
+    queryExecutor->setEngineProfiling(engineProfiling);
+    if (exactCountingRequested)
+        queryExecutor->setCountingMode(QueryExecutor::CountingMode::EXACT);
+    else
+        queryExecutor->setCountingMode(static_cast<QueryExecutor::CountingMode>(CFG_UI.General.ResultsCountingMode.get()));
+
+    queryExecutor->setLazyCountingLimit(CFG_UI.General.LazyCountingLimit.get());
     queryExecutor->setPreloadResults(true);
+    exactCountingRequested = false;
     queryExecutor->exec();
 }
 
@@ -174,11 +198,32 @@ qint64 SqlQueryModel::getExecutionTime()
     return lastExecutionTime;
 }
 
+ExecutionProfile SqlQueryModel::getExecutionProfile() const
+{
+    return executionProfile;
+}
+
 qint64 SqlQueryModel::getTotalRowsReturned()
 {
     return totalRowsReturned;
 }
 
+QueryExecutor::CountAccuracy SqlQueryModel::getTotalRowsAccuracy() const
+{
+    return totalRowsAccuracy;
+}
+
+bool SqlQueryModel::isRowCountingInProgress() const
+{
+    return queryExecutor->isResultsCountingInProgress();
+}
+
+bool SqlQueryModel::hasMoreRowsThanCounted() const
+{
+    // If the number of rows is not exact, the full page of rows means that there might be more rows to browse.
+    return totalRowsAccuracy != QueryExecutor::CountAccuracy::EXACT && rowCount() >= getRowsPerPage();
+}
+
 qint64 SqlQueryModel::getTotalRowsAffected()
 {
     return rowsAffected;
@@ -349,6 +394,10 @@ QList<SqlQueryItem*> SqlQueryModel::getRow(int row)
 
 SqlQueryModel::Features SqlQueryModel::features() const
 {
+    // Results of custom query can be filtered only in the snapshot, otherwise the query would have to be executed again
+    if (queryExecutor->getSnapshotMode())
+        return FILTERING;
+
     return Features();
 }
 
@@ -641,6 +690,9 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
 
     recalculateRowsAndPages(itemsAddedDeletedDelta);
 
+    // Snapshot no longer reflects committed data, so it will be taken again with next reload
+    queryExecutor->dropSnapshot();
+
     emit commitFinished();
 }
 
@@ -659,6 +711,29 @@ void SqlQueryModel::reload()
     reloadInternal();
 }
 
+void SqlQueryModel::refreshSnapshot()
+{
+    if (queryExecutor->isExecutionInProgress())
+    {
+        notifyWarn(tr("Only one query can be executed simultaneously."));
+        return;
+    }
+
+    queryExecutor->dropSnapshot();
+    reload();
+}
+
+void SqlQueryModel::countAllRows()
+{
+    exactCountingRequested = true;
+    reload();
+}
+
+void SqlQueryModel::stopRowCounting()
+{
+    queryExecutor->cancelResultsCounting();
+}
+
 void SqlQueryModel::reloadInternal()
 {
     if (!reloadAvailable)
@@ -1412,9 +1487,13 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
 
     emit aboutToLoadResults();
     storeStep1NumbersFromExecution();
+    QElapsedTimer fetchTimer;
+    fetchTimer.start();
     if (!loadData(results))
         return;
 
+    queryExecutor->recordFetch(fetchTimer.nsecsElapsed() / 1000, rowCount());
+    executionProfile = queryExecutor->getExecutionProfile();
     storeStep2NumbersFromExecution();
 
     requiredDbAttaches = queryExecutor->getRequiredDbAttaches();
@@ -1427,6 +1506,9 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
 
     reloading = false;
 
+    if (queryExecutor->getSkipRowCounting())
+        updateInexactRowCount();
+
     bool rowsCountedManually = queryExecutor->isRowCountingRequired() || rowCount() < getRowsPerPage();
     bool countRes = false;
     if (rowsCountedManually)
@@ -1435,7 +1517,17 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
         emit storeExecutionInHistory();
     }
     else
+    {
         countRes = queryExecutor->countResults();
+        if (countRes && queryExecutor->isResultsCountingInProgress() && queryExecutor->getCountingMode() == QueryExecutor::CountingMode::LAZY)
+        {
+            // Until the counting is finished, rows loaded so far are the known minimum
+            totalRowsReturned = getRowsPerPage() * page + rowCount();
+            totalRowsAccuracy = QueryExecutor::CountAccuracy::LOWER_BOUND;
+            totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)getRowsPerPage()));
+            emit totalRowsAndPagesAvailable();
+        }
+    }
 
     if (!countRes || !queryExecutor->getAsyncMode())
     {
@@ -1481,6 +1573,10 @@ void SqlQueryModel::resultsCountingFinished(quint64 rowsAffected, quint64 rowsRe
 
     this->rowsAffected = rowsAffected;
     this->totalRowsReturned = rowsReturned;
+    this->totalRowsAccuracy = queryExecutor->getTotalRowsAccuracy();
+    if (totalRowsAccuracy == QueryExecutor::CountAccuracy::LOWER_BOUND)
+        this->totalRowsReturned = qMax(totalRowsReturned, (quint64)(getRowsPerPage() * page + rowCount()));
+
     this->totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)getRowsPerPage()));
     detachDatabases();
     emit totalRowsAndPagesAvailable();
@@ -1554,7 +1650,7 @@ void SqlQueryModel::nextPage()
         return;
 
     int newPage = this->page + 1;
-    if ((newPage + 1) > totalPages)
+    if ((newPage + 1) > totalPages && !hasMoreRowsThanCounted())
         newPage = totalPages - 1;
 
     queryExecutor->setSkipRowCounting(true);
@@ -1606,6 +1702,7 @@ void SqlQueryModel::storeStep1NumbersFromExecution()
 
     if (!queryExecutor->getSkipRowCounting())
     {
+        totalRowsAccuracy = QueryExecutor::CountAccuracy::EXACT;
         if (!queryExecutor->isRowCountingRequired())
             totalRowsReturned = queryExecutor->getTotalRowsReturned();
 
@@ -1639,6 +1736,82 @@ Db* SqlQueryModel::getDb() const
     return db;
 }
 
+QString SqlQueryModel::getMemoryConsumerName() const
+{
+    static_qstring(queryTpl, "%1...");
+
+    QString queryStr = query.simplified();
+    if (queryStr.length() > 60)
+        queryStr = queryTpl.arg(queryStr.left(60));
+
+    return tr("Results of %1 (%n row(s)) in database %2", "", rowCount()).arg(queryStr, db ? db->getName() : QString());
+}
+
+qint64 SqlQueryModel::getMemoryUsage() const
+{
+    qint64 size = 0;
+    int cols = columnCount();
+    for (int row = 0, rows = rowCount(); row < rows; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            SqlQueryItem* item = itemFromIndex(row, col);
+            if (!item)
+                continue;
+
+            // Value for display shares the data with the value
+            size += sizeof(SqlQueryItem) + estimateMemoryUsage(item->getValue());
+            if (item->isUncommitted())
+                size += estimateMemoryUsage(item->getOldValue());
+        }
+    }
+    return size;
+}
+
+qint64 SqlQueryModel::trimMemory()
+{
+    qint64 released = 0;
+    int cols = columnCount();
+    for (int row = 0, rows = rowCount(); row < rows; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            SqlQueryItem* item = itemFromIndex(row, col);
+            if (!item || item->isLimitedValue() || item->isUncommitted() || item->isNewRow() || item->isDeletedRow() || item->getRowId().isEmpty())
+                continue;
+
+            if (!item->getColumn() || !item->getColumn()->editionForbiddenReason.isEmpty())
+                continue;
+
+            // Length is compared just like the QueryExecutor limits values - in bytes for blobs and in characters for text
+            QVariant value = item->getValue();
+            QVariant limitedValue;
+            if (value.type() == QVariant::ByteArray)
+            {
+                QByteArray bytes = value.toByteArray();
+                if (bytes.size() < cellDataLengthLimit)
+                    continue;
+
+                limitedValue = bytes.left(cellDataLengthLimit);
+            }
+            else if (value.type() == QVariant::String)
+            {
+                QString str = value.toString();
+                if (str.size() < cellDataLengthLimit)
+                    continue;
+
+                limitedValue = str.left(cellDataLengthLimit);
+            }
+            else
+                continue; // numbers are never long
+
+            released += estimateMemoryUsage(value) - estimateMemoryUsage(limitedValue);
+            item->setValue(limitedValue, true, true);
+        }
+    }
+    return released;
+}
+
 void SqlQueryModel::setDb(Db* value)
 {
     db = value;
@@ -1817,6 +1990,29 @@ void SqlQueryModel::notifyItemEditionEnded(const QModelIndex& idx)
     emit itemEditionEnded(itemFromIndex(idx));
 }
 
+void SqlQueryModel::updateInexactRowCount()
+{
+    if (totalRowsAccuracy == QueryExecutor::CountAccuracy::EXACT)
+        return;
+
+    quint64 rowsUpToCurrentPage = getRowsPerPage() * page + rowCount();
+    if (rowCount() < getRowsPerPage() && (rowCount() > 0 || page == 0))
+    {
+        // Last page was reached, so now the number is known. An empty page could be far beyond the last one, so it doesn't count.
+        totalRowsReturned = rowsUpToCurrentPage;
+        totalRowsAccuracy = QueryExecutor::CountAccuracy::EXACT;
+    }
+    else if (totalRowsReturned < rowsUpToCurrentPage)
+    {
+        totalRowsReturned = rowsUpToCurrentPage;
+    }
+    else
+        return;
+
+    totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)getRowsPerPage()));
+    emit totalRowsAndPagesAvailable();
+}
+
 int SqlQueryModel::getRowsPerPage() const
 {
     int rowsPerPage = CFG_UI.General.NumberOfRowsPerPage.get();
@@ -1909,6 +2105,21 @@ void SqlQueryModel::setSimpleExecutionMode(bool value)
     simpleExecutionMode = value;
 }
 
+void SqlQueryModel::setSnapshotMode(bool value)
+{
+    queryExecutor->setSnapshotMode(value);
+}
+
+bool SqlQueryModel::isSnapshotResults() const
+{
+    return queryExecutor->isSnapshotResults();
+}
+
+QDateTime SqlQueryModel::getSnapshotTime() const
+{
+    return queryExecutor->getSnapshotTime();
+}
+
 void SqlQueryModel::addNewRow()
 {
     addNewRowInternal(getInsertRowIndex());
@@ -2009,37 +2220,77 @@ void SqlQueryModel::handlePossibleTableRename(Db *modDb, const QString &database
 
 void SqlQueryModel::applySqlFilter(const QString& value)
 {
-    UNUSED(value);
-    // For custom query this is not supported.
+    // For custom query this is supported only for snapshot of results.
+    applySnapshotFilter(value);
 }
 
 void SqlQueryModel::applyStringFilter(const QString& value)
 {
-    UNUSED(value);
-    // For custom query this is not supported.
+    static_qstring(pattern, "LIKE '%%1%'");
+    QStringList values;
+    for (int i = 0, total = queryExecutor->getResultColumns().size(); i < total; i++)
+        values << value;
+
+    applySnapshotFilter(getSnapshotFilterConditions(values, pattern, " OR "));
 }
 
 void SqlQueryModel::applyRegExpFilter(const QString& value)
 {
-    UNUSED(value);
-    // For custom query this is not supported.
+    static_qstring(pattern, "REGEXP '%1'");
+    QStringList values;
+    for (int i = 0, total = queryExecutor->getResultColumns().size(); i < total; i++)
+        values << value;
+
+    applySnapshotFilter(getSnapshotFilterConditions(values, pattern, " OR "));
 }
 
 void SqlQueryModel::applyStringFilter(const QStringList& values)
 {
-    UNUSED(values);
-    // For custom query this is not supported.
+    static_qstring(pattern, "LIKE '%%1%'");
+    applySnapshotFilter(getSnapshotFilterConditions(values, pattern, " AND "));
 }
 
 void SqlQueryModel::applyRegExpFilter(const QStringList& values)
 {
-    UNUSED(values);
-    // For custom query this is not supported.
+    static_qstring(pattern, "REGEXP '%1'");
+    applySnapshotFilter(getSnapshotFilterConditions(values, pattern, " AND "));
 }
 
 void SqlQueryModel::resetFilter()
 {
-    // For custom query this is not supported.
+    applySnapshotFilter(QString());
+}
+
+void SqlQueryModel::applySnapshotFilter(const QString& filter)
+{
+    if (!queryExecutor->getSnapshotMode())
+        return;
+
+    queryExecutor->setSnapshotFilter(filter);
+    queryExecutor->setSkipRowCounting(false);
+    queryExecutor->setPage(0);
+    reloadInternal();
+}
+
+QString SqlQueryModel::getSnapshotFilterConditions(const QStringList& values, const QString& pattern, const QString& separator)
+{
+    QList<QueryExecutor::ResultColumnPtr> resultColumns = queryExecutor->getResultColumns();
+    if (values.size() != resultColumns.size())
+    {
+        qCritical() << "Asked to filter snapshot, but number columns"
+                    << resultColumns.size() << "is different than number of values" << values.size();
+        return QString();
+    }
+
+    QStringList conditions;
+    for (int i = 0, total = resultColumns.size(); i < total; ++i)
+    {
+        if (values[i].isEmpty())
+            continue;
+
+        conditions << wrapObjIfNeeded(resultColumns[i]->displayName) + " " + pattern.arg(escapeString(values[i]));
+    }
+    return conditions.join(separator);
 }
 
 int SqlQueryModel::columnCount(const QModelIndex& parent) const
@@ -2109,8 +2360,9 @@ void SqlQueryModel::loadFullDataForEntireRow(int row)
     }
 }
 
-void SqlQueryModel::loadFullDataForEntireColumn(int column)
+QList<SqlQueryItem*> SqlQueryModel::getLimitedItemsInColumn(int column) const
 {
+    QList<SqlQueryItem*> items;
     int rowCnt = rowCount();
     SqlQueryItem *item = nullptr;
     for (int row = 0; row < rowCnt; row++)
@@ -2122,8 +2374,9 @@ void SqlQueryModel::loadFullDataForEntireColumn(int column)
         if (!item->isLimitedValue())
             continue;
 
-        item->loadFullData();
+        items << item;
     }
+    return items;
 }
 
 bool SqlQueryModel::doesColumnHaveLimitedValues(int column) const
@@ -10,6 +10,7 @@
 #include "guiSQLiteStudio_global.h"
 #include "sqlqueryitemdelegate.h"
 #include "common/strhash.h"
+#include "services/memorymanager.h"
 #include <QStandardItemModel>
 #include <QItemSelection>
 
@@ -18,7 +19,7 @@ class FormView;
 class SqlQueryView;
 class SqlQueryRowNumModel;
 
-class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
+class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel, public MemoryConsumer
 {
         Q_OBJECT
 
@@ -43,11 +44,16 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QString getQuery() const;
         void setQuery(const QString &value);
         void setExplainMode(bool explain);
+        void setEngineProfiling(bool enabled);
         void setParams(const QHash<QString, QVariant>& params);
         Db* getDb() const;
         void setDb(Db* value);
         qint64 getExecutionTime();
+        ExecutionProfile getExecutionProfile() const;
         qint64 getTotalRowsReturned();
+        QueryExecutor::CountAccuracy getTotalRowsAccuracy() const;
+        bool isRowCountingInProgress() const;
+        bool hasMoreRowsThanCounted() const;
         qint64 getTotalRowsAffected();
         qint64 getTotalPages();
         QList<SqlQueryModelColumnPtr> getColumns();
@@ -64,7 +70,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
         bool isExecutionInProgress() const;
         void loadFullDataForEntireRow(int row);
-        void loadFullDataForEntireColumn(int column);
+        QList<SqlQueryItem*> getLimitedItemsInColumn(int column) const;
         bool doesColumnHaveLimitedValues(int column) const;
         StrHash<QString> attachDependencyTables();
         void detachDependencyTables();
@@ -168,6 +174,27 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         bool getSimpleExecutionMode() const;
         void setSimpleExecutionMode(bool value);
 
+        /**
+         * @brief Enables reading results from a snapshot.
+         * @param value true to enable.
+         *
+         * See "Result snapshots" section in QueryExecutor description. When enabled, results of the query
+         * can also be filtered (see features()). It should be set before the model is attached to the DataView.
+         */
+        void setSnapshotMode(bool value);
+
+        /**
+         * @brief Tells if results of the last execution were read from a snapshot.
+         * @return true if they were read from the snapshot.
+         */
+        bool isSnapshotResults() const;
+
+        /**
+         * @brief Provides time when the snapshot of results was taken.
+         * @return Time of the snapshot, or invalid time if there is no snapshot.
+         */
+        QDateTime getSnapshotTime() const;
+
         int getHardRowLimit() const;
         void setHardRowLimit(int value);
 
@@ -186,6 +213,18 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void setCellDataLengthLimit(int value);
         int getCellDataLengthLimit();
 
+        QString getMemoryConsumerName() const;
+        qint64 getMemoryUsage() const;
+
+        /**
+         * @brief Releases full values of cells, that were loaded on demand.
+         * @return Estimated number of bytes released.
+         *
+         * Values of unmodified cells that are longer than the cell data length limit are truncated to the limit
+         * and marked as limited again, so they will be loaded from the database next time they are needed.
+         */
+        qint64 trimMemory();
+
     protected:
         class CommitUpdateQueryBuilder : public RowIdConditionBuilder
         {
@@ -362,11 +401,20 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void commitInternal(const QList<SqlQueryItem*>& items);
         void rollbackInternal(const QList<SqlQueryItem*>& items);
         void reloadInternal();
+        /**
+         * @brief Applies filter to the snapshot of results.
+         * @param filter SQL expression, or empty string to show all rows.
+         *
+         * Does nothing if the snapshot mode is disabled.
+         */
+        void applySnapshotFilter(const QString& filter);
+        QString getSnapshotFilterConditions(const QStringList& values, const QString& pattern, const QString& separator);
         void addNewRowInternal(int rowIdx);
         Icon& getIconForIdx(int idx) const;
         void detachDatabases();
         QString getDatabaseForCommit(const QString& database);
         void recalculateRowsAndPages(int rowsDelta);
+        void updateInexactRowCount();
         int getInsertRowIndex();
         void notifyItemEditionEnded(const QModelIndex& idx);
         int getRowsPerPage() const;
@@ -375,6 +423,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QString query;
         QHash<QString, QVariant> queryParams;
         bool explain = false;
+        bool engineProfiling = false;
         bool simpleExecutionMode = false;
 
         /**
@@ -402,6 +451,12 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         quint64 lastExecutionTime = 0;
 
+        /**
+         * @brief executionProfile
+         * Keeps detailed timings of recently successfully executed query, including loading its rows into the model.
+         */
+        ExecutionProfile executionProfile;
+
         /**
          * @brief totalRowsReturned
          * Keeps number of rows returned from recently successfully executed query.
@@ -409,6 +464,19 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         quint64 totalRowsReturned = 0;
 
+        /**
+         * @brief totalRowsAccuracy
+         * Tells if the totalRowsReturned is exact, estimated, or just a lower bound,
+         * depending on the counting mode used (see QueryExecutor::setCountingMode()).
+         */
+        QueryExecutor::CountAccuracy totalRowsAccuracy = QueryExecutor::CountAccuracy::EXACT;
+
+        /**
+         * @brief exactCountingRequested
+         * Set by countAllRows() to use exact counting for the next execution, regardless of configured counting mode.
+         */
+        bool exactCountingRequested = false;
+
         /**
          * @brief rowsAffected
          * Keeps number of rows affected by recently successfully executed query.
@@ -514,6 +582,9 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void commit(const QList<SqlQueryItem*>& items);
         void rollback(const QList<SqlQueryItem*>& items);
         void reload();
+        void refreshSnapshot();
+        void countAllRows();
+        void stopRowCounting();
         void updateSelectiveCommitRollbackActions(const QItemSelection& selected, const QItemSelection& deselected);
         void addNewRow();
         void addMultipleRows();
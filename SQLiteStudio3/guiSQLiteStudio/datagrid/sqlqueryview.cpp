@@ -2,6 +2,7 @@
 #include "sqlqueryitemdelegate.h"
 #include "sqlquerymodel.h"
 #include "sqlqueryitem.h"
+#include "fullvaluesloader.h"
 #include "common/widgetcover.h"
 #include "tsvserializer.h"
 #include "iconmanager.h"
@@ -30,6 +31,7 @@
 #include <QCryptographicHash>
 #include <QMessageBox>
 #include <QScrollBar>
+#include <QEventLoop>
 
 CFG_KEYS_DEFINE(SqlQueryView)
 
@@ -321,7 +323,62 @@ void SqlQueryView::generateDelete()
 
 void SqlQueryView::loadFullValuesForColumn()
 {
-    getModel()->loadFullDataForEntireColumn(headerContextMenuSection);
+    bool ok;
+    QHash<SqlQueryItem*,QVariant> fullValues = loadFullValues(getModel()->getLimitedItemsInColumn(headerContextMenuSection), ok);
+    if (!ok)
+        return;
+
+    for (auto it = fullValues.cbegin(); it != fullValues.cend(); ++it)
+        it.key()->setValue(it.value(), false, true);
+}
+
+QHash<SqlQueryItem*,QVariant> SqlQueryView::loadFullValues(const QList<SqlQueryItem*>& items, bool& ok)
+{
+    ok = true;
+    QHash<SqlQueryItem*,QVariant> fullValues;
+    FullValuesLoader loader(getModel()->getDb());
+    for (SqlQueryItem* item : items)
+    {
+        if (!item->isLimitedValue())
+            continue;
+
+        if (!loader.addItem(item))
+            fullValues[item] = item->getFullValue(); // not a table cell, needs to be loaded by the item itself
+    }
+
+    if (loader.isEmpty())
+        return fullValues;
+
+    QEventLoop loop;
+    bool success = false;
+    connect(&loader, &FullValuesLoader::progress, widgetCover, &WidgetCover::setProgress);
+    connect(&loader, &FullValuesLoader::finished, &loop, [&loop, &success](bool result)
+    {
+        success = result;
+        loop.quit();
+    });
+    QMetaObject::Connection cancelConn = connect(widgetCover, SIGNAL(cancelClicked()), &loader, SLOT(interrupt()));
+
+    widgetCover->displayProgress(100);
+    widgetCover->setProgress(0);
+    widgetCover->show();
+    loader.start();
+    loop.exec();
+    widgetCover->hide();
+    widgetCover->noDisplayProgress();
+    disconnect(cancelConn);
+
+    if (!success)
+    {
+        if (!loader.isInterrupted())
+            notifyError(tr("Could not load full values of cells: %1").arg(loader.getErrorText()));
+
+        ok = false;
+        return fullValues;
+    }
+
+    fullValues.unite(loader.getValues());
+    return fullValues;
 }
 
 bool SqlQueryView::editInEditorIfNecessary(SqlQueryItem* item)
@@ -522,12 +579,18 @@ void SqlQueryView::copy(bool withHeader)
         theDataRow.clear();
     }
 
+    // Full values of limited cells are loaded at once, not one by one
+    bool loaded;
+    QHash<SqlQueryItem*,QVariant> fullValues = loadFullValues(selectedItems, loaded);
+    if (!loaded)
+        return;
+
     // Data
     for (const QList<SqlQueryItem*>& itemsInRows : groupedItems)
     {
         for (SqlQueryItem* item : itemsInRows)
         {
-            itemValue = item->getFullValue();
+            itemValue = fullValues.contains(item) ? fullValues[item] : item->getValue();
             if (itemValue.userType() == QVariant::Double)
                 cells << doubleToString(itemValue);
             else
@@ -854,6 +917,24 @@ void SqlQueryView::openValueEditor(SqlQueryItem* item)
         return;
     }
 
+    if (item->isLimitedValue() && !item->isUncommitted() && !item->isNewRow())
+    {
+        // Huge values are presented directly from the database, in chunks, without loading them into memory.
+        // They're loaded entirely only when the user wants to edit them.
+        DbBlobPtr blob = item->openBlob();
+        if (blob && blob->size() > streamedValueThreshold)
+        {
+            MultiEditorDialog viewer(this);
+            viewer.setWindowTitle(tr("Edit value"));
+            viewer.setDataType(item->getColumn()->dataType);
+            viewer.setBlob(blob);
+            viewer.setReadOnly(true);
+            viewer.setFullValueEditEnabled(item->getColumn()->canEdit());
+            if (viewer.exec() != MultiEditorDialog::EDIT_FULL_VALUE)
+                return;
+        }
+    }
+
     MultiEditorDialog editor(this);
     editor.setWindowTitle(tr("Edit value"));
     editor.setDataType(item->getColumn()->dataType);
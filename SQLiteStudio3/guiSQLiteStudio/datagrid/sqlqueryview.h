@@ -111,9 +111,24 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void goToReferencedRow(const QString& table, const QString& column, const QVariant& value);
         void copy(bool withHeaders);
 
+        /**
+         * @brief Loads full values of limited cells from the database in bulk.
+         * @param items Cells to load. Cells that are not limited are skipped.
+         * @param ok Set to false if loading failed or was interrupted by the user.
+         * @return Full values of limited cells.
+         *
+         * Loading happens in a separate thread, while the view is covered with progress bar and cancel button.
+         */
+        QHash<SqlQueryItem*,QVariant> loadFullValues(const QList<SqlQueryItem*>& items, bool& ok);
+
         constexpr static const char* mimeDataId = "application/x-sqlitestudio-data-view-data";
         constexpr static const int minHeaderWidth = 15;
 
+        /**
+         * @brief Size of value (in bytes) above which the value editor streams it from database instead of loading it.
+         */
+        constexpr static const qint64 streamedValueThreshold = 10 * 1024 * 1024;
+
         SqlQueryItemDelegate* itemDelegate = nullptr;
         QMenu* contextMenu = nullptr;
         QMenu* headerContextMenu = nullptr;
@@ -12,6 +12,7 @@
 SqlTableModel::SqlTableModel(QObject *parent) :
     SqlDataSourceQueryModel(parent)
 {
+    queryExecutor->setKeysetPaging(true);
 }
 
 QString SqlTableModel::getTable() const
@@ -25,6 +25,10 @@
 #include <QLineEdit>
 #include <QSizePolicy>
 #include <QScrollBar>
+#include <QPlainTextEdit>
+#include <QFontDatabase>
+#include <QTreeWidget>
+#include <QHBoxLayout>
 
 CFG_KEYS_DEFINE(DataView)
 DataView::TabsPosition DataView::tabsPosition;
@@ -45,6 +49,7 @@ void DataView::init(SqlQueryModel* model)
     this->model->setView(gridView);
 
     rowCountLabel = new QLabel();
+    snapshotLabel = new QLabel();
     formViewRowCountLabel = new QLabel();
     formViewCurrentRowLabel = new QLabel();
 
@@ -77,6 +82,9 @@ void DataView::initSlots()
     connect(model, SIGNAL(executionStarted()), gridView, SLOT(executionStarted()));
     connect(model, SIGNAL(loadingEnded(bool)), gridView, SLOT(executionEnded()));
     connect(model, SIGNAL(totalRowsAndPagesAvailable()), this, SLOT(totalRowsAndPagesAvailable()));
+    connect(rowCountLabel, SIGNAL(linkActivated(QString)), this, SLOT(rowCountLinkActivated(QString)));
+    connect(formViewRowCountLabel, SIGNAL(linkActivated(QString)), this, SLOT(rowCountLinkActivated(QString)));
+    connect(snapshotLabel, SIGNAL(linkActivated(QString)), this, SLOT(snapshotLinkActivated(QString)));
     connect(gridView->horizontalHeader(), SIGNAL(sectionClicked(int)), this, SLOT(columnsHeaderClicked(int)));
     connect(this, SIGNAL(currentChanged(int)), this, SLOT(tabChanged(int)));
     connect(model, SIGNAL(itemEditionEnded(SqlQueryItem*)), this, SLOT(adjustColumnWidth(SqlQueryItem*)));
@@ -143,6 +151,25 @@ void DataView::createContents()
     gridView->setCornerButtonEnabled(true);
     gridView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
     gridWidget->layout()->addWidget(gridView);
+
+    executionProfileView = new QPlainTextEdit();
+    executionProfileView->setReadOnly(true);
+    executionProfileView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    executionProfileView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    queryPlanView = new QTreeWidget();
+    queryPlanView->setHeaderLabels({tr("Query plan", "data view"), tr("Loops", "data view"), tr("Rows visited", "data view"),
+                                    tr("Rows estimated", "data view")});
+    queryPlanView->setVisible(false);
+
+    executionProfileWidget = new QWidget();
+    executionProfileWidget->setLayout(new QHBoxLayout());
+    executionProfileWidget->layout()->setMargin(0);
+    executionProfileWidget->layout()->addWidget(executionProfileView);
+    executionProfileWidget->layout()->addWidget(queryPlanView);
+    executionProfileWidget->setMaximumHeight(executionProfileView->fontMetrics().height() * 12);
+    executionProfileWidget->setVisible(false);
+    gridWidget->layout()->addWidget(executionProfileWidget);
 }
 
 void DataView::createFilterPanel()
@@ -230,8 +257,14 @@ void DataView::createActions()
         createFilteringActions();
 
     actionMap[GRID_TOTAL_ROWS] = gridToolBar->addWidget(rowCountLabel);
+    actionMap[GRID_SNAPSHOT] = gridToolBar->addWidget(snapshotLabel);
+    actionMap[GRID_SNAPSHOT]->setVisible(false);
+    createAction(EXECUTION_PROFILE, ICONS.STATUS_INFO, tr("Show execution profile", "data view"), this, SLOT(toggleExecutionProfile()), gridToolBar);
+    actionMap[EXECUTION_PROFILE]->setCheckable(true);
+    actionMap[EXECUTION_PROFILE]->setChecked(CFG_UI.General.ShowExecutionProfile.get());
+    executionProfileWidget->setVisible(actionMap[EXECUTION_PROFILE]->isChecked());
 
-    noConfigShortcutActions << GRID_TOTAL_ROWS << FILTER_VALUE;
+    noConfigShortcutActions << GRID_TOTAL_ROWS << GRID_SNAPSHOT << FILTER_VALUE;
 
     createAction(SELECTIVE_COMMIT, ICONS.COMMIT, tr("Commit changes for selected cells", "data view"), this, SLOT(selectiveCommitGrid()), this);
     createAction(SELECTIVE_ROLLBACK, ICONS.ROLLBACK, tr("Rollback changes for selected cells", "data view"), this, SLOT(selectiveRollbackGrid()), this);
@@ -446,7 +479,7 @@ void DataView::updateGridNavigationState()
 {
     int page = model->getCurrentPage();
     bool prevResultsAvailable = page > 0;
-    bool nextResultsAvailable = (page + 1) < model->getTotalPages();
+    bool nextResultsAvailable = (page + 1) < model->getTotalPages() || model->hasMoreRowsThanCounted();
     bool reloadResultsAvailable = model->canReload();
     bool pageNumEditAvailable = (prevResultsAvailable || nextResultsAvailable);
 
@@ -646,15 +679,44 @@ void DataView::updatePageEdit()
     updateCurrentFormViewRow();
 }
 
-void DataView::updateResultsCount(int resultsCount)
+void DataView::updateResultsCount(qint64 resultsCount)
 {
+    static_qstring(linkTpl, "%1 (<a href=\"%2\">%3</a>)");
+
     if (resultsCount >= 0)
     {
-        QString msg = QObject::tr("Total rows loaded: %1").arg(resultsCount);
+        QString count = QString::number(resultsCount);
+        QString tooltip;
+        QString msg;
+        switch (model->getTotalRowsAccuracy())
+        {
+            case QueryExecutor::CountAccuracy::EXACT:
+                msg = QObject::tr("Total rows loaded: %1").arg(count);
+                break;
+            case QueryExecutor::CountAccuracy::ESTIMATED:
+                msg = linkTpl.arg(QObject::tr("Total rows loaded: %1").arg("~" + count), "count", tr("count exactly"));
+                tooltip = tr("Number of rows was estimated from table statistics, it may differ from the real number of rows.");
+                break;
+            case QueryExecutor::CountAccuracy::LOWER_BOUND:
+            {
+                count = QString(QChar(0x2265)) + " " + count;
+                if (model->isRowCountingInProgress())
+                {
+                    msg = linkTpl.arg(QObject::tr("Total rows loaded: %1").arg(count), "stop", tr("stop counting"));
+                    tooltip = tr("Rows are being counted. Rows loaded so far can be browsed in the meantime.");
+                }
+                else
+                {
+                    msg = linkTpl.arg(QObject::tr("Total rows loaded: %1").arg(count), "count", tr("count all"));
+                    tooltip = tr("Rows were counted only up to the limit defined in configuration, or the counting was stopped.");
+                }
+                break;
+            }
+        }
         rowCountLabel->setText(msg);
         formViewRowCountLabel->setText(msg);
-        rowCountLabel->setToolTip(QString());
-        formViewRowCountLabel->setToolTip(QString());
+        rowCountLabel->setToolTip(tooltip);
+        formViewRowCountLabel->setToolTip(tooltip);
     }
     else
     {
@@ -669,6 +731,23 @@ void DataView::updateResultsCount(int resultsCount)
     }
 }
 
+void DataView::updateSnapshotLabel()
+{
+    static_qstring(linkTpl, "%1 (<a href=\"%2\">%3</a>)");
+
+    if (!model->isSnapshotResults())
+    {
+        actionMap[GRID_SNAPSHOT]->setVisible(false);
+        return;
+    }
+
+    QString time = model->getSnapshotTime().toString("hh:mm:ss");
+    snapshotLabel->setText(linkTpl.arg(tr("Snapshot from %1", "data view").arg(time), "refresh", tr("refresh", "data view")));
+    snapshotLabel->setToolTip(tr("Results are read from a snapshot taken when the query was executed, so paging, sorting and filtering "
+                                 "don't execute the query again. Changes made in the database since then are not visible until the snapshot is refreshed."));
+    actionMap[GRID_SNAPSHOT]->setVisible(true);
+}
+
 void DataView::updateCurrentFormViewRow()
 {
     int rowsPerPage = CFG_UI.General.NumberOfRowsPerPage.get();
@@ -703,6 +782,14 @@ void DataView::dataLoadingEnded(bool successful)
         updatePageEdit();
         resizeColumnsInitiallyToContents();
         recreateFilterInputs();
+
+        // Query profiling was requested explicitly, so its results are shown even if the profile panel is disabled.
+        if (model->getExecutionProfile().engineStats.collected && executionProfileWidget->isHidden())
+        {
+            actionMap[EXECUTION_PROFILE]->setChecked(true);
+            executionProfileWidget->setVisible(true);
+        }
+        updateExecutionProfile();
     }
 
     setNavigationState(true);
@@ -711,6 +798,68 @@ void DataView::dataLoadingEnded(bool successful)
 void DataView::executionSuccessful()
 {
     updateResultsCount(-1);
+    updateSnapshotLabel();
+}
+
+void DataView::toggleExecutionProfile()
+{
+    bool show = actionMap[EXECUTION_PROFILE]->isChecked();
+    CFG_UI.General.ShowExecutionProfile.set(show);
+    executionProfileWidget->setVisible(show);
+    updateExecutionProfile();
+}
+
+void DataView::updateExecutionProfile()
+{
+    if (executionProfileWidget->isHidden())
+        return;
+
+    ExecutionProfile profile = model->getExecutionProfile();
+    executionProfileView->setPlainText(profile.toString());
+    updateQueryPlan(profile);
+}
+
+void DataView::updateQueryPlan(const ExecutionProfile& profile)
+{
+    queryPlanView->clear();
+    queryPlanView->setVisible(!profile.plan.isEmpty());
+    if (profile.plan.isEmpty())
+        return;
+
+    QHash<int,QTreeWidgetItem*> itemsById;
+    QTreeWidgetItem* item = nullptr;
+    for (const ExecutionProfile::PlanNode& node : profile.plan)
+    {
+        QTreeWidgetItem* parentItem = itemsById.value(node.parent);
+        if (parentItem)
+            item = new QTreeWidgetItem(parentItem);
+        else
+            item = new QTreeWidgetItem(queryPlanView);
+
+        item->setText(0, node.detail);
+        if (node.scanStats)
+        {
+            item->setText(1, QString::number(node.loops));
+            item->setText(2, QString::number(node.visits));
+            item->setText(3, QString::number(node.estimatedRows, 'f', 1));
+        }
+
+        if (node.hotSpot)
+        {
+            QFont font = item->font(0);
+            font.setBold(true);
+            for (int col = 0; col < queryPlanView->columnCount(); col++)
+            {
+                item->setFont(col, font);
+                item->setForeground(col, QBrush(Qt::red));
+                item->setToolTip(col, node.hotSpotReason);
+            }
+        }
+        itemsById[node.id] = item;
+    }
+
+    queryPlanView->expandAll();
+    queryPlanView->resizeColumnToContents(0);
 }
 
 void DataView::totalRowsAndPagesAvailable()
@@ -721,6 +870,27 @@ void DataView::totalRowsAndPagesAvailable()
     updateNavigationState();
 }
 
+void DataView::rowCountLinkActivated(const QString& link)
+{
+    if (link == "stop")
+    {
+        model->stopRowCounting();
+        return;
+    }
+
+    totalPagesAvailable = false;
+    setNavigationState(false);
+    model->countAllRows();
+}
+
+void DataView::snapshotLinkActivated(const QString& link)
+{
+    UNUSED(link);
+    totalPagesAvailable = false;
+    setNavigationState(false);
+    model->refreshSnapshot();
+}
+
 void DataView::refreshData()
 {
     totalPagesAvailable = false;
@@ -17,6 +17,9 @@ class IntValidator;
 class WidgetCover;
 class QScrollArea;
 class QLineEdit;
+class QPlainTextEdit;
+class QTreeWidget;
+struct ExecutionProfile;
 
 CFG_KEY_LIST(DataView, QObject::tr("Data view (both grid and form)"),
      CFG_KEY_ENTRY(REFRESH_DATA,    Qt::Key_F5,                   QObject::tr("Refresh data"))
@@ -55,6 +58,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
             INSERT_ROW_BEFORE,
             INSERT_ROW_AFTER,
             INSERT_ROW_AT_END,
+            EXECUTION_PROFILE,
+            GRID_SNAPSHOT,
             // Form view
             FORM_TOTAL_ROWS,
             FORM_CURRENT_ROW
@@ -133,7 +138,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void updateGridNavigationState();
         void goToPage(const QString& pageStr);
         void updatePageEdit();
-        void updateResultsCount(int resultsCount);
+        void updateResultsCount(qint64 resultsCount);
+        void updateSnapshotLabel();
         void updateCurrentFormViewRow();
         void setFormViewEnabled(bool enabled);
         void readData();
@@ -141,6 +147,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void formViewFocusFirstEditor();
         void recreateFilterInputs();
         void createFilteringActions();
+        void updateExecutionProfile();
+        void updateQueryPlan(const ExecutionProfile& profile);
 
         static TabsPosition tabsPosition;
         static QHash<Action,QAction*> staticActions;
@@ -159,6 +167,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         QWidget* perColumnAreaParent = nullptr;
         ExtLineEdit* filterEdit = nullptr;
         QLabel* rowCountLabel = nullptr;
+        QLabel* snapshotLabel = nullptr;
         QLabel* formViewRowCountLabel = nullptr;
         QLabel* formViewCurrentRowLabel = nullptr;
         ExtLineEdit* pageEdit = nullptr;
@@ -173,6 +182,9 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         QStringList filterValues;
         QWidget* filterLeftSpacer = nullptr;
         QWidget* filterRightSpacer = nullptr;
+        QPlainTextEdit* executionProfileView = nullptr;
+        QTreeWidget* queryPlanView = nullptr;
+        QWidget* executionProfileWidget = nullptr;
 
     signals:
 
@@ -182,7 +194,10 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
     private slots:
         void dataLoadingEnded(bool successful);
         void executionSuccessful();
+        void toggleExecutionProfile();
         void totalRowsAndPagesAvailable();
+        void rowCountLinkActivated(const QString& link);
+        void snapshotLinkActivated(const QString& link);
         void insertRow();
         void insertMultipleRows();
         void deleteRow();
@@ -29,6 +29,10 @@
 #include "querygenerator.h"
 #include "dialogs/execfromfiledialog.h"
 #include "dialogs/fileexecerrorsdialog.h"
+#include "dialogs/indexadvisordialog.h"
+#include "dialogs/dbdiffdialog.h"
+#include "dialogs/dbbackupdialog.h"
+#include "dialogs/dbmaintenancedialog.h"
 #include "common/compatibility.h"
 #include <QApplication>
 #include <QClipboard>
@@ -131,6 +135,7 @@ void DbTree::init()
     connect(treeModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SIGNAL(sessionValueChanged()));
     connect(treeModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SIGNAL(sessionValueChanged()));
     connect(treeModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SIGNAL(sessionValueChanged()));
+    connect(treeModel, SIGNAL(schemaRefreshed(Db*)), this, SLOT(updateActionsForCurrent()));
     connect(ui->treeView, SIGNAL(expanded(QModelIndex)), this, SIGNAL(sessionValueChanged()));
     connect(ui->treeView, SIGNAL(collapsed(QModelIndex)), this, SIGNAL(sessionValueChanged()));
 
@@ -185,6 +190,10 @@ void DbTree::createActions()
     createAction(GENERATE_DELETE, "DELETE", this, SLOT(generateDeleteForTable()), this);
     createAction(OPEN_DB_DIRECTORY, ICONS.DIRECTORY_OPEN_WITH_DB, tr("Open file's directory"), this, SLOT(openDbDirectory()), this);
     createAction(EXEC_SQL_FROM_FILE, ICONS.EXEC_SQL_FROM_FILE, tr("Execute SQL from file"), this, SLOT(execSqlFromFile()), this);
+    createAction(INDEX_ADVISOR, ICONS.INDEX, tr("Index advisor"), this, SLOT(indexAdvisor()), this);
+    createAction(COMPARE_DB, ICONS.DATABASE, tr("Compare with another database"), this, SLOT(compareDb()), this);
+    createAction(BACKUP_DB, ICONS.DATABASE_EXPORT, tr("Back up / clone database"), this, SLOT(backupDb()), this);
+    createAction(MAINTENANCE_DB, ICONS.INTEGRITY_CHECK, tr("Database maintenance"), this, SLOT(maintenanceDb()), this);
 }
 
 void DbTree::updateActionStates(const QStandardItem *item)
@@ -211,11 +220,11 @@ void DbTree::updateActionStates(const QStandardItem *item)
 
         if (dbTreeItem->getDb())
         {
-            enabled << DELETE_DB << EDIT_DB;
+            enabled << DELETE_DB << EDIT_DB << MAINTENANCE_DB;
             if (dbTreeItem->getDb()->isOpen())
             {
                 enabled << DISCONNECT_FROM_DB << IMPORT_INTO_DB << EXPORT_DB << REFRESH_SCHEMA
-                        << VACUUM_DB << INTEGRITY_CHECK;
+                        << VACUUM_DB << INTEGRITY_CHECK << INDEX_ADVISOR << COMPARE_DB << BACKUP_DB;
                 isDbOpen = true;
             }
             else
@@ -428,6 +437,10 @@ void DbTree::setupActionsForMenu(DbTreeItem* currItem, QMenu* contextMenu)
                     actions += ActionEntry(EXPORT_DB);
                     actions += ActionEntry(VACUUM_DB);
                     actions += ActionEntry(INTEGRITY_CHECK);
+                    actions += ActionEntry(INDEX_ADVISOR);
+                    actions += ActionEntry(COMPARE_DB);
+                    actions += ActionEntry(BACKUP_DB);
+                    actions += ActionEntry(MAINTENANCE_DB);
                     actions += ActionEntry(EXEC_SQL_FROM_FILE);
                     actions += ActionEntry(OPEN_DB_DIRECTORY);
                     actions += ActionEntry(_separator);
@@ -1514,6 +1527,46 @@ void DbTree::integrityCheck()
     win->execute();
 }
 
+void DbTree::indexAdvisor()
+{
+    Db* db = getSelectedDb();
+    if (!db || !db->isValid())
+        return;
+
+    IndexAdvisorDialog dialog(db, MAINWINDOW);
+    dialog.exec();
+}
+
+void DbTree::compareDb()
+{
+    Db* db = getSelectedDb();
+    if (!db || !db->isValid())
+        return;
+
+    DbDiffDialog dialog(db, MAINWINDOW);
+    dialog.exec();
+}
+
+void DbTree::backupDb()
+{
+    Db* db = getSelectedDb();
+    if (!db || !db->isValid())
+        return;
+
+    DbBackupDialog dialog(db, MAINWINDOW);
+    dialog.exec();
+}
+
+void DbTree::maintenanceDb()
+{
+    Db* db = getSelectedDb();
+    if (!db || !db->isValid())
+        return;
+
+    DbMaintenanceDialog dialog(db, MAINWINDOW);
+    dialog.exec();
+}
+
 void DbTree::createSimilarTable()
 {
     Db* db = getSelectedDb();
@@ -92,6 +92,10 @@ class GUI_API_EXPORT DbTree : public QDockWidget, public ExtActionContainer
             GENERATE_DELETE,
             OPEN_DB_DIRECTORY,
             EXEC_SQL_FROM_FILE,
+            INDEX_ADVISOR,
+            COMPARE_DB,
+            BACKUP_DB,
+            MAINTENANCE_DB,
             _separator // Never use it directly, it's just for menu setup
         };
 
@@ -212,6 +216,10 @@ class GUI_API_EXPORT DbTree : public QDockWidget, public ExtActionContainer
         void delColumn();
         void vacuumDb();
         void integrityCheck();
+        void indexAdvisor();
+        void compareDb();
+        void backupDb();
+        void maintenanceDb();
         void createSimilarTable();
         void resetAutoincrement();
         void eraseTableData();
@@ -13,6 +13,7 @@
 #include "dialogs/errorsconfirmdialog.h"
 #include "dialogs/versionconvertsummarydialog.h"
 #include "db/invaliddb.h"
+#include "db/dbperformanceprofile.h"
 #include "services/notifymanager.h"
 #include "common/compatibility.h"
 #include <QMimeData>
@@ -24,6 +25,8 @@
 #include <QCheckBox>
 #include <QWidgetAction>
 #include <QClipboard>
+#include <QPointer>
+#include <QtConcurrent/QtConcurrentRun>
 
 const QString DbTreeModel::toolTipTableTmp = "<table>%1</table>";
 const QString DbTreeModel::toolTipHdrRowTmp = "<tr><th><img src=\"%1\"/></th><th colspan=2>%2</th></tr>";
@@ -146,7 +149,7 @@ bool DbTreeModel::applyFilter(QStandardItem *parentItem, const QString &filter)
          item = dynamic_cast<DbTreeItem*>(parentItem->child(i));
          index = item->index();
          subFilterResult = applyFilter(item, filter);
-         matched = empty || subFilterResult || item->text().contains(filter, Qt::CaseInsensitive);
+         matched = empty || subFilterResult || item->text().contains(filter, Qt::CaseInsensitive) || tableColumnsMatch(item, filter);
          treeView->setRowHidden(index.row(), index.parent(), !matched);
 
          if (matched)
@@ -155,6 +158,21 @@ bool DbTreeModel::applyFilter(QStandardItem *parentItem, const QString &filter)
     return visibilityForParent;
 }
 
+bool DbTreeModel::tableColumnsMatch(DbTreeItem* tableItem, const QString& filter) const
+{
+    DbTreeItem::Type type = tableItem->getType();
+    if (type != DbTreeItem::Type::TABLE && type != DbTreeItem::Type::VIRTUAL_TABLE)
+        return false;
+
+    // Column items are created lazily, so names of not loaded columns are taken from the schema snapshot
+    for (const QString& column : columnNames.value(tableItem->getDb()).value(tableItem->text(), Qt::CaseInsensitive))
+    {
+        if (column.contains(filter, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
+
 void DbTreeModel::storeGroups()
 {
     QList<Config::DbGroupPtr> groups = childsToConfig(invisibleRootItem());
@@ -274,6 +292,14 @@ void DbTreeModel::restoreGroup(const Config::DbGroupPtr& group, QList<Db*>* dbLi
 void DbTreeModel::expanded(const QModelIndex &index)
 {
     QStandardItem* item = itemFromIndex(index);
+    DbTreeItem::Type type = dynamic_cast<DbTreeItem*>(item)->getType();
+    if (type == DbTreeItem::Type::TABLE || type == DbTreeItem::Type::VIRTUAL_TABLE)
+    {
+        loadTableColumns(dynamic_cast<DbTreeItem*>(item));
+        if (!currentFilter.isEmpty())
+            applyFilter(item, currentFilter);
+    }
+
     if (!item->hasChildren())
     {
         treeView->collapse(index);
@@ -352,8 +378,34 @@ void DbTreeModel::refreshSchema(Db* db)
         qWarning() << "Refreshing schema of db that couldn't be found in the model:" << db->getName();
         return;
     }
-    refreshSchema(db, item);
-    applyFilter(item, currentFilter);
+
+    if (!db->isOpen())
+        return;
+
+    if (schemaLoaders.contains(db))
+    {
+        schemaReloadsPending << db;
+        return;
+    }
+
+    bool ignoreSystemObjects = !CFG_UI.General.ShowSystemObjects.get();
+    bool withColumns = CFG_UI.General.ShowRegularTableLabels.get();
+
+    QPointer<Db> dbPtr = db;
+    QFutureWatcher<DbTreeSchemaSnapshot>* watcher = new QFutureWatcher<DbTreeSchemaSnapshot>(this);
+    schemaLoaders[db] = watcher;
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, db, dbPtr]()
+    {
+        schemaLoaders.remove(db);
+        watcher->deleteLater();
+        if (!dbPtr)
+        {
+            schemaReloadsPending.remove(db);
+            return;
+        }
+        schemaSnapshotLoaded(db, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&DbTreeSchemaSnapshot::load, db, ignoreSystemObjects, withColumns));
 }
 
 QList<DbTreeItem*> DbTreeModel::getAllItemsAsFlatList() const
@@ -431,6 +483,9 @@ QString DbTreeModel::getDbToolTip(DbTreeItem* item) const
 
         if (db->isOpen())
             rows << toolTipRowTmp.arg(tr("Encoding:", "dbtree tooltip")).arg(db->getEncoding());
+
+        for (const QPair<QString, QString>& profileEntry : DbPerformanceProfile::describe(db->getConnectionOptions()))
+            rows << toolTipRowTmp.arg(profileEntry.first + ":").arg(profileEntry.second);
     }
     else
     {
@@ -485,199 +540,226 @@ void DbTreeModel::refreshSchema(Db* db, QStandardItem *item)
     if (!db->isOpen())
         return;
 
-    // Remember expanded state of this branch
-    QHash<QString, bool> expandedState;
-    collectExpandedState(expandedState, item);
-
-    // Delete child nodes
-    while (item->rowCount() > 0)
-        item->removeRow(0);
-
-    // Now prepare to create new branch
-    SchemaResolver resolver(db);
-    resolver.setIgnoreSystemObjects(!CFG_UI.General.ShowSystemObjects.get());
-
-    // Collect all db objects and build the db branch
-    bool sort = CFG_UI.General.SortObjects.get();
-    QStringList tables = resolver.getTables();
-    QStringList virtualTables;
-    for (const QString& table : tables)
-    {
-        if (resolver.isVirtualTable(table))
-            virtualTables << table;
-    }
+    bool ignoreSystemObjects = !CFG_UI.General.ShowSystemObjects.get();
+    bool withColumns = CFG_UI.General.ShowRegularTableLabels.get();
+    DbTreeSchemaSnapshot snapshot = DbTreeSchemaSnapshot::load(db, ignoreSystemObjects, withColumns);
+    if (!snapshot.valid)
+        return;
 
-    QList<QStandardItem*> tableItems = refreshSchemaTables(tables, virtualTables, sort);
-    StrHash<QList<QStandardItem*>> allTableColumns = refreshSchemaTableColumns(resolver.getAllTableColumns());
-    StrHash<QList<QStandardItem*>> indexItems = refreshSchemaIndexes(resolver.getGroupedIndexes(), sort);
-    StrHash<QList<QStandardItem*>> triggerItems = refreshSchemaTriggers(resolver.getGroupedTriggers(), sort);
-    QList<QStandardItem*> viewItems = refreshSchemaViews(resolver.getViews(), sort);
-    refreshSchemaBuild(item, tableItems, indexItems, triggerItems, viewItems, allTableColumns);
-    populateChildItemsWithDb(item, db);
-    restoreExpandedState(expandedState, item);
+    applySchemaSnapshot(db, item, snapshot);
 }
 
-void DbTreeModel::collectExpandedState(QHash<QString, bool> &state, QStandardItem *parentItem)
+void DbTreeModel::schemaSnapshotLoaded(Db* db, const DbTreeSchemaSnapshot& snapshot)
 {
-    if (!parentItem)
-        parentItem = root();
+    if (schemaReloadsPending.remove(db))
+    {
+        // Schema was modified again while it was being loaded, so this snapshot is already outdated
+        refreshSchema(db);
+        return;
+    }
 
-    DbTreeItem* dbTreeItem = dynamic_cast<DbTreeItem*>(parentItem);
-    if (dbTreeItem)
-        state[dbTreeItem->signature()] = treeView->isExpanded(dbTreeItem->index());
+    QStandardItem* item = findItem(DbTreeItem::Type::DB, db);
+    if (!item || !db->isOpen() || !snapshot.valid)
+        return;
 
-    for (int i = 0; i < parentItem->rowCount(); i++)
-        collectExpandedState(state, parentItem->child(i));
+    applySchemaSnapshot(db, item, snapshot);
+    applyFilter(item, currentFilter);
+    emit schemaRefreshed(db);
 }
 
-QList<QStandardItem *> DbTreeModel::refreshSchemaTables(const QStringList &tables, const QStringList& virtualTables, bool sort)
+void DbTreeModel::applySchemaSnapshot(Db* db, QStandardItem* dbItem, const DbTreeSchemaSnapshot& snapshot)
 {
-    QStringList sortedTables = tables;
-    if (sort)
-        sortedTables.sort(Qt::CaseInsensitive);
-
-    QList<QStandardItem *> items;
-    for (const QString& table : sortedTables)
+    if (dbItem->rowCount() == 0)
     {
-        if (virtualTables.contains(table))
-            items += DbTreeItemFactory::createVirtualTable(table, this);
-        else
-            items += DbTreeItemFactory::createTable(table, this);
+        DbTreeItem* tablesItem = DbTreeItemFactory::createTables(this);
+        DbTreeItem* viewsItem = DbTreeItemFactory::createViews(this);
+        tablesItem->setDb(db);
+        viewsItem->setDb(db);
+        dbItem->appendRow(tablesItem);
+        dbItem->appendRow(viewsItem);
     }
 
-    return items;
-}
+    bool sort = CFG_UI.General.SortObjects.get();
+    bool sortColumns = CFG_UI.General.SortColumns.get();
+    bool sortColumnsChanged = (columnsSorted.value(db, sortColumns) != sortColumns);
+    columnsSorted[db] = sortColumns;
 
-StrHash<QList<QStandardItem*>> DbTreeModel::refreshSchemaTableColumns(const StrHash<QStringList> &columns)
-{
-    QStringList sortedColumns;
-    bool doSort = CFG_UI.General.SortColumns.get();
-    StrHash<QList<QStandardItem*>> items;
-    for (const QString& key : columns.keys())
+    // Tables
+    QStandardItem* tablesItem = dbItem->child(0);
+    syncChildItems(tablesItem, snapshot.tables, sort, db, [this, &snapshot](const QString& table)
+    {
+        DbTreeItem* tableItem = snapshot.isVirtualTable(table) ? DbTreeItemFactory::createVirtualTable(table, this) :
+                                                                 DbTreeItemFactory::createTable(table, this);
+        tableItem->appendRow(DbTreeItemFactory::createColumns(this));
+        tableItem->appendRow(DbTreeItemFactory::createIndexes(this));
+        tableItem->appendRow(DbTreeItemFactory::createTriggers(this));
+        return tableItem;
+    },
+    [&snapshot](DbTreeItem* tableItem)
     {
-        sortedColumns = columns[key];
-        if (doSort)
-            ::sSort(sortedColumns);
+        return snapshot.isVirtualTable(tableItem->text()) == (tableItem->getType() == DbTreeItem::Type::VIRTUAL_TABLE);
+    });
+
+    StrHash<QString>& knownDdls = tableDdls[db];
+    DbTreeItem* tableItem = nullptr;
+    QStandardItem* columnsItem = nullptr;
+    QString table;
+    for (int i = 0; i < tablesItem->rowCount(); i++)
+    {
+        tableItem = dynamic_cast<DbTreeItem*>(tablesItem->child(i));
+        table = tableItem->text();
+
+        // Columns are reloaded only for tables that have changed
+        columnsItem = tableItem->child(0);
+        if (sortColumnsChanged || !knownDdls.contains(table) || knownDdls[table] != snapshot.tableDdls.value(table))
+            columnsItem->removeRows(0, columnsItem->rowCount());
+
+        if (columnsItem->rowCount() == 0)
+        {
+            if (snapshot.tableColumns.contains(table))
+                refreshTableColumns(tableItem, snapshot.tableColumns.value(table));
+            else if (treeView->isExpanded(tableItem->index()))
+                loadTableColumns(tableItem);
+        }
 
-        for (const QString& column : sortedColumns)
-            items[key] += DbTreeItemFactory::createColumn(column, this);
+        syncChildItems(tableItem->child(1), snapshot.indexes.value(table, Qt::CaseInsensitive), sort, db, [this](const QString& index)
+        {
+            return DbTreeItemFactory::createIndex(index, this);
+        });
+        syncChildItems(tableItem->child(2), snapshot.triggers.value(table, Qt::CaseInsensitive), sort, db, [this](const QString& trigger)
+        {
+            return DbTreeItemFactory::createTrigger(trigger, this);
+        });
     }
-    return items;
-}
+    knownDdls = snapshot.tableDdls;
+    columnNames[db] = snapshot.columnNames;
 
-StrHash<QList<QStandardItem *> > DbTreeModel::refreshSchemaIndexes(const StrHash<QStringList> &indexes, bool sort)
-{
-    StrHash<QList<QStandardItem *> > items;
-    QStringList sortedIndexes;
-    for (const QString& key : indexes.keys())
+    // Views
+    QStandardItem* viewsItem = dbItem->child(1);
+    syncChildItems(viewsItem, snapshot.views, sort, db, [this](const QString& view)
     {
-        sortedIndexes = indexes[key];
-        if (sort)
-            sortedIndexes.sort(Qt::CaseInsensitive);
+        DbTreeItem* viewItem = DbTreeItemFactory::createView(view, this);
+        viewItem->appendRow(DbTreeItemFactory::createTriggers(this));
+        return viewItem;
+    });
 
-        for (const QString& index : sortedIndexes)
-            items[key] += DbTreeItemFactory::createIndex(index, this);
+    QStandardItem* viewItem = nullptr;
+    for (int i = 0; i < viewsItem->rowCount(); i++)
+    {
+        viewItem = viewsItem->child(i);
+        syncChildItems(viewItem->child(0), snapshot.triggers.value(viewItem->text(), Qt::CaseInsensitive), sort, db, [this](const QString& trigger)
+        {
+            return DbTreeItemFactory::createTrigger(trigger, this);
+        });
     }
-    return items;
 }
 
-StrHash<QList<QStandardItem*>> DbTreeModel::refreshSchemaTriggers(const StrHash<QStringList> &triggers, bool sort)
+void DbTreeModel::syncChildItems(QStandardItem* parentItem, const QStringList& names, bool sort, Db* db,
+                                 std::function<DbTreeItem*(const QString&)> createItem,
+                                 std::function<bool(DbTreeItem*)> isUpToDate)
 {
-    StrHash<QList<QStandardItem*>> items;
-    QStringList sortedTriggers;
-    for (const QString& key : triggers.keys())
-    {
-        sortedTriggers = triggers[key];
-        if (sort)
-            sortedTriggers.sort(Qt::CaseInsensitive);
+    QSet<QString> nameSet = toSet(names);
+    if (sort && !areChildItemsSorted(parentItem))
+        parentItem->removeRows(0, parentItem->rowCount());
 
-        for (const QString& trigger : sortedTriggers)
-            items[key] += DbTreeItemFactory::createTrigger(trigger, this);
+    // Remove items of objects that no longer exist
+    QSet<QString> existing;
+    DbTreeItem* child = nullptr;
+    for (int i = parentItem->rowCount() - 1; i >= 0; i--)
+    {
+        child = dynamic_cast<DbTreeItem*>(parentItem->child(i));
+        if (!nameSet.contains(child->text()) || (isUpToDate && !isUpToDate(child)))
+        {
+            parentItem->removeRow(i);
+            continue;
+        }
+        existing << child->text();
     }
-    return items;
-}
 
-QList<QStandardItem *> DbTreeModel::refreshSchemaViews(const QStringList &views, bool sort)
-{
-    QStringList sortedViews = views;
-    if (sort)
-        sortedViews.sort(Qt::CaseInsensitive);
+    // Add items for new objects
+    DbTreeItem* newItem = nullptr;
+    for (const QString& name : names)
+    {
+        if (existing.contains(name))
+            continue;
 
-    QList<QStandardItem *> items;
-    for (const QString& view : sortedViews)
-        items += DbTreeItemFactory::createView(view, this);
+        newItem = createItem(name);
+        newItem->setDb(db);
+        populateChildItemsWithDb(newItem, db);
+        if (sort)
+            parentItem->insertRow(getSortedInsertionRow(parentItem, name), newItem);
+        else
+            parentItem->appendRow(newItem);
 
-    return items;
+        existing << name;
+    }
 }
 
-void DbTreeModel::populateChildItemsWithDb(QStandardItem *parentItem, Db* db)
+bool DbTreeModel::areChildItemsSorted(QStandardItem* parentItem)
 {
-    QStandardItem* childItem = nullptr;
-    for (int i = 0; i < parentItem->rowCount(); i++)
+    for (int i = 1, total = parentItem->rowCount(); i < total; i++)
     {
-        childItem = parentItem->child(i);
-        dynamic_cast<DbTreeItem*>(childItem)->setDb(db);
-        populateChildItemsWithDb(childItem, db);
+        if (parentItem->child(i - 1)->text().compare(parentItem->child(i)->text(), Qt::CaseInsensitive) > 0)
+            return false;
     }
+    return true;
 }
 
-void DbTreeModel::refreshSchemaBuild(QStandardItem *dbItem,
-                                     QList<QStandardItem*> tables,
-                                     StrHash<QList<QStandardItem*> > indexes,
-                                     StrHash<QList<QStandardItem*> > triggers,
-                                     QList<QStandardItem*> views,
-                                     StrHash<QList<QStandardItem*> > allTableColumns)
+int DbTreeModel::getSortedInsertionRow(QStandardItem* parentItem, const QString& name)
 {
-    DbTreeItem* tablesItem = DbTreeItemFactory::createTables(this);
-    DbTreeItem* viewsItem = DbTreeItemFactory::createViews(this);
-
-    dbItem->appendRow(tablesItem);
-    dbItem->appendRow(viewsItem);
-
-    DbTreeItem* columnsItem = nullptr;
-    DbTreeItem* indexesItem = nullptr;
-    DbTreeItem* triggersItem = nullptr;
-    for (QStandardItem* tableItem : tables)
+    int low = 0;
+    int high = parentItem->rowCount();
+    int mid;
+    while (low < high)
     {
-        tablesItem->appendRow(tableItem);
+        mid = (low + high) / 2;
+        if (parentItem->child(mid)->text().compare(name, Qt::CaseInsensitive) <= 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
 
-        columnsItem = DbTreeItemFactory::createColumns(this);
-        indexesItem = DbTreeItemFactory::createIndexes(this);
-        triggersItem = DbTreeItemFactory::createTriggers(this);
+void DbTreeModel::loadTableColumns(DbTreeItem* tableItem)
+{
+    QStandardItem* columnsItem = tableItem->child(0);
+    if (!columnsItem || columnsItem->rowCount() > 0)
+        return;
 
-        tableItem->appendRow(columnsItem);
-        tableItem->appendRow(indexesItem);
-        tableItem->appendRow(triggersItem);
+    Db* db = tableItem->getDb();
+    if (!db || !db->isOpen())
+        return;
 
-        for (QStandardItem* columnItem : allTableColumns[tableItem->text()])
-            columnsItem->appendRow(columnItem);
+    SchemaResolver resolver(db);
+    refreshTableColumns(tableItem, resolver.getTableColumns(tableItem->text()));
+}
 
-        for (QStandardItem* indexItem : indexes[tableItem->text()])
-            indexesItem->appendRow(indexItem);
+void DbTreeModel::refreshTableColumns(DbTreeItem* tableItem, const QStringList& columns)
+{
+    QStringList sortedColumns = columns;
+    if (CFG_UI.General.SortColumns.get())
+        ::sSort(sortedColumns);
 
-        for (QStandardItem* triggerItem : triggers[tableItem->text()])
-            triggersItem->appendRow(triggerItem);
-    }
-    for (QStandardItem* viewItem : views)
+    QStandardItem* columnsItem = tableItem->child(0);
+    DbTreeItem* columnItem = nullptr;
+    for (const QString& column : sortedColumns)
     {
-        viewsItem->appendRow(viewItem);
-
-        triggersItem = DbTreeItemFactory::createTriggers(this);
-        viewItem->appendRow(triggersItem);
-        for (QStandardItem* triggerItem : triggers[viewItem->text()])
-            triggersItem->appendRow(triggerItem);
+        columnItem = DbTreeItemFactory::createColumn(column, this);
+        columnItem->setDb(tableItem->getDb());
+        columnsItem->appendRow(columnItem);
     }
 }
 
-void DbTreeModel::restoreExpandedState(const QHash<QString, bool>& expandedState, QStandardItem* parentItem)
+void DbTreeModel::populateChildItemsWithDb(QStandardItem *parentItem, Db* db)
 {
-    DbTreeItem* parentDbTreeItem = dynamic_cast<DbTreeItem*>(parentItem);
-    QString sig = parentDbTreeItem->signature();
-    if (expandedState.contains(sig) && expandedState[sig])
-        treeView->expand(parentItem->index());
-
-    for (QStandardItem* child : parentDbTreeItem->childs())
-        restoreExpandedState(expandedState, child);
+    QStandardItem* childItem = nullptr;
+    for (int i = 0; i < parentItem->rowCount(); i++)
+    {
+        childItem = parentItem->child(i);
+        dynamic_cast<DbTreeItem*>(childItem)->setDb(db);
+        populateChildItemsWithDb(childItem, db);
+    }
 }
 
 DbTreeItem* DbTreeModel::findFirstItemOfType(DbTreeItem::Type type, QStandardItem* parentItem)
@@ -729,6 +811,9 @@ void DbTreeModel::dbDisconnected(Db* db)
     while (item->rowCount() > 0)
         item->removeRow(0);
 
+    tableDdls.remove(db);
+    columnNames.remove(db);
+    columnsSorted.remove(db);
     treeView->collapse(item->index());
 }
 
@@ -6,8 +6,11 @@
 #include "services/config.h"
 #include "guiSQLiteStudio_global.h"
 #include "common/strhash.h"
+#include "dbtreeschemasnapshot.h"
 #include <QStandardItemModel>
 #include <QObject>
+#include <QFutureWatcher>
+#include <functional>
 
 class DbManager;
 class DbTreeView;
@@ -37,6 +40,15 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QStandardItem *root() const;
         QStringList getGroupFor(QStandardItem* item);
         void storeGroups();
+
+        /**
+         * @brief Refreshes schema branch of the database asynchronously.
+         * @param db Database to refresh.
+         *
+         * Schema snapshot is loaded in a separate thread and then compared with the current branch,
+         * so only items of added, removed or modified objects are touched. Emits schemaRefreshed() when done.
+         * If called again while loading is in progress, the schema will be reloaded once more after that.
+         */
         void refreshSchema(Db* db);
         QList<DbTreeItem*> getAllItemsAsFlatList() const;
         void setTreeView(DbTreeView *value);
@@ -66,18 +78,16 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QList<Config::DbGroupPtr> childsToConfig(QStandardItem* item);
         void restoreGroup(const Config::DbGroupPtr& group, QList<Db*>* dbList = nullptr, QStandardItem *parent = nullptr);
         bool applyFilter(QStandardItem* parentItem, const QString& filter);
+        bool tableColumnsMatch(DbTreeItem* tableItem, const QString& filter) const;
         void refreshSchema(Db* db, QStandardItem* item);
-        void collectExpandedState(QHash<QString, bool>& state, QStandardItem* parentItem = nullptr);
-        QStandardItem* refreshSchemaDb(Db* db);
-        QList<QStandardItem*> refreshSchemaTables(const QStringList &tables, const QStringList& virtualTables, bool sort);
-        StrHash<QList<QStandardItem*>> refreshSchemaTableColumns(const StrHash<QStringList>& columns);
-        StrHash<QList<QStandardItem*>> refreshSchemaIndexes(const StrHash<QStringList>& indexes, bool sort);
-        StrHash<QList<QStandardItem*>> refreshSchemaTriggers(const StrHash<QStringList>& triggers, bool sort);
-        QList<QStandardItem*> refreshSchemaViews(const QStringList &views, bool sort);
+        void schemaSnapshotLoaded(Db* db, const DbTreeSchemaSnapshot& snapshot);
+        void applySchemaSnapshot(Db* db, QStandardItem* dbItem, const DbTreeSchemaSnapshot& snapshot);
+        void syncChildItems(QStandardItem* parentItem, const QStringList& names, bool sort, Db* db,
+                            std::function<DbTreeItem*(const QString&)> createItem,
+                            std::function<bool(DbTreeItem*)> isUpToDate = nullptr);
+        void loadTableColumns(DbTreeItem* tableItem);
+        void refreshTableColumns(DbTreeItem* tableItem, const QStringList& columns);
         void populateChildItemsWithDb(QStandardItem* parentItem, Db* db);
-        void refreshSchemaBuild(QStandardItem* dbItem, QList<QStandardItem*> tables, StrHash<QList<QStandardItem*> > indexes,
-                                StrHash<QList<QStandardItem*> > triggers, QList<QStandardItem*> views, StrHash<QList<QStandardItem*> > allTableColumns);
-        void restoreExpandedState(const QHash<QString, bool>& expandedState, QStandardItem* parentItem);
         DbTreeItem* findFirstItemOfType(DbTreeItem::Type type, QStandardItem* parentItem);
         QString getToolTip(DbTreeItem *item) const;
         QString getDbToolTip(DbTreeItem *item) const;
@@ -90,6 +100,8 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         bool quickAddDroppedDb(const QString& filePath);
         void moveOrCopyDbObjects(const QList<DbTreeItem*>& srcItems, DbTreeItem* dstItem, bool move, bool includeData, bool includeIndexes, bool includeTriggers);
 
+        static bool areChildItemsSorted(QStandardItem* parentItem);
+        static int getSortedInsertionRow(QStandardItem* parentItem, const QString& name);
         static bool confirmReferencedTables(const QStringList& tables);
         static bool resolveNameConflict(QString& nameInConflict);
         static bool confirmConversion(const QList<QPair<QString, QString>>& diffs);
@@ -106,6 +118,11 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QList<Interruptable*> interruptables;
         bool ignoreDbLoadedSignal = false;
         QString currentFilter;
+        QHash<Db*,QFutureWatcher<DbTreeSchemaSnapshot>*> schemaLoaders;
+        QSet<Db*> schemaReloadsPending;
+        QHash<Db*,StrHash<QString>> tableDdls;
+        QHash<Db*,StrHash<QStringList>> columnNames;
+        QHash<Db*,bool> columnsSorted;
 
     private slots:
         void expanded(const QModelIndex &index);
@@ -133,6 +150,7 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
 
     signals:
         void updateItemHidden(DbTreeItem* item);
+        void schemaRefreshed(Db* db);
 };
 
 #endif // DBTREEMODEL_H
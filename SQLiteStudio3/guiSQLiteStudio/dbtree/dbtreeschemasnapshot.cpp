@@ -0,0 +1,106 @@
+#include "dbtreeschemasnapshot.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "db/sqlresultsrow.h"
+#include "schemaresolver.h"
+#include "common/utils_sql.h"
+#include <QRegularExpression>
+#include <QDebug>
+
+static void loadColumnNames(Db* db, DbTreeSchemaSnapshot& snapshot)
+{
+    // Virtual tables are skipped, as reading their columns requires the module to be loaded
+    static_qstring(columnsSql, "SELECT m.name, c.name FROM main.sqlite_master m JOIN pragma_table_info(m.name) c "
+                               "WHERE m.type = 'table' AND m.sql NOT LIKE 'CREATE VIRTUAL%'");
+
+    SqlQueryPtr results = db->exec(columnsSql);
+    if (results->isError())
+    {
+        // The filter will then match only names of columns that are loaded into the tree
+        qWarning() << "Could not read column names for the database tree:" << results->getErrorText();
+        return;
+    }
+
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        snapshot.columnNames[row->value(0).toString()] << row->value(1).toString();
+    }
+}
+
+bool DbTreeSchemaSnapshot::isVirtualTable(const QString& table) const
+{
+    return virtualTables.contains(table.toLower());
+}
+
+DbTreeSchemaSnapshot DbTreeSchemaSnapshot::load(Db* db, bool ignoreSystemObjects, bool withColumns)
+{
+    static const QRegularExpression virtualTableRe("^\\s*CREATE\\s+VIRTUAL\\s+TABLE\\b", QRegularExpression::CaseInsensitiveOption);
+
+    DbTreeSchemaSnapshot snapshot;
+    if (!db->isOpen())
+        return snapshot;
+
+    SqlQueryPtr results = db->exec("SELECT type, name, tbl_name, sql FROM main.sqlite_master");
+    if (results->isError())
+    {
+        qWarning() << "Could not read schema for the database tree:" << results->getErrorText();
+        return snapshot;
+    }
+
+    QString type;
+    QString name;
+    QString ddl;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        type = row->value(0).toString();
+        name = row->value(1).toString();
+        ddl = row->value(3).toString();
+        if (type == "table")
+        {
+            if (ignoreSystemObjects && isSystemTable(name))
+                continue;
+
+            snapshot.tables << name;
+            snapshot.tableDdls[name] = ddl;
+            if (virtualTableRe.match(ddl).hasMatch())
+                snapshot.virtualTables << name.toLower();
+        }
+        else if (type == "index")
+        {
+            if (ignoreSystemObjects && isSystemIndex(name))
+                continue;
+
+            snapshot.indexes[row->value(2).toString()] << name;
+        }
+        else if (type == "trigger")
+        {
+            snapshot.triggers[row->value(2).toString()] << name;
+        }
+        else if (type == "view")
+        {
+            snapshot.views << name;
+        }
+    }
+
+    if (!ignoreSystemObjects)
+        snapshot.tables << "sqlite_master" << "sqlite_temp_master";
+
+    if (withColumns)
+    {
+        SchemaResolver resolver(db);
+        resolver.setIgnoreSystemObjects(ignoreSystemObjects);
+        snapshot.tableColumns = resolver.getAllTableColumns();
+        snapshot.columnNames = snapshot.tableColumns;
+    }
+    else
+    {
+        loadColumnNames(db, snapshot);
+    }
+
+    snapshot.valid = true;
+    return snapshot;
+}
@@ -0,0 +1,46 @@
+#ifndef DBTREESCHEMASNAPSHOT_H
+#define DBTREESCHEMASNAPSHOT_H
+
+#include "guiSQLiteStudio_global.h"
+#include "common/strhash.h"
+#include <QStringList>
+#include <QSet>
+
+class Db;
+
+/**
+ * @brief Database objects to be presented in the database tree.
+ *
+ * It's a plain data structure, so it can be loaded in a separate thread and then applied
+ * to the tree model in the GUI thread. All objects (together with their owning tables
+ * and DDLs) are read with a single scan of the sqlite_master table.
+ * Column items are not created from the snapshot, unless explicitly requested,
+ * but column names are always read (with one more query), so the tree filter can match them.
+ */
+struct GUI_API_EXPORT DbTreeSchemaSnapshot
+{
+    QStringList tables;
+    QSet<QString> virtualTables;            /**< Lower-cased names of virtual tables. */
+    QStringList views;
+    StrHash<QStringList> indexes;           /**< Index names grouped by table. */
+    StrHash<QStringList> triggers;          /**< Trigger names grouped by table or view. */
+    StrHash<QString> tableDdls;             /**< DDL of each table, used to detect tables that have changed. */
+    StrHash<QStringList> tableColumns;      /**< Column names grouped by table. Empty unless requested. */
+    StrHash<QStringList> columnNames;       /**< Column names grouped by table, as reported by SQLite. Used by the tree filter. */
+    bool valid = false;
+
+    bool isVirtualTable(const QString& table) const;
+
+    /**
+     * @brief Loads snapshot of the main schema of the database.
+     * @param db Database to read.
+     * @param ignoreSystemObjects true to skip sqlite_* tables and indexes.
+     * @param withColumns true to also load columns of all tables (which requires query per table).
+     * @return Snapshot, which is not valid if the schema could not be read.
+     *
+     * It's safe to call it from a thread other than the GUI thread.
+     */
+    static DbTreeSchemaSnapshot load(Db* db, bool ignoreSystemObjects, bool withColumns);
+};
+
+#endif // DBTREESCHEMASNAPSHOT_H
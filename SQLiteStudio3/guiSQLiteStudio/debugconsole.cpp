@@ -1,6 +1,7 @@
 #include "debugconsole.h"
 #include "ui_debugconsole.h"
 #include "iconmanager.h"
+#include "services/memorymanager.h"
 #include <QPushButton>
 
 DebugConsole::DebugConsole(QWidget *parent) :
@@ -13,6 +14,9 @@ DebugConsole::DebugConsole(QWidget *parent) :
     QPushButton* resetBtn = ui->buttonBox->button(QDialogButtonBox::Reset);
     connect(resetBtn, SIGNAL(clicked()), this, SLOT(reset()));
 
+    QPushButton* memoryBtn = ui->buttonBox->addButton(tr("Memory usage"), QDialogButtonBox::ActionRole);
+    connect(memoryBtn, SIGNAL(clicked()), this, SLOT(printMemoryUsage()));
+
     initFormats();
 }
 
@@ -73,6 +77,12 @@ void DebugConsole::reset()
     ui->textEdit->clear();
 }
 
+void DebugConsole::printMemoryUsage()
+{
+    for (const QString& line : MEMORY_MANAGER->getUsageReport())
+        debug(line);
+}
+
 void DebugConsole::showEvent(QShowEvent*)
 {
     setWindowIcon(ICONS.SQLITESTUDIO_APP);
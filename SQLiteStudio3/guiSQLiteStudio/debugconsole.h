@@ -33,6 +33,7 @@ class GUI_API_EXPORT DebugConsole : public QDialog
 
     private slots:
         void reset();
+        void printMemoryUsage();
 
     public slots:
         void debug(const QString& msg);
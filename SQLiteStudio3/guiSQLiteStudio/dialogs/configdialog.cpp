@@ -186,6 +186,9 @@ void ConfigDialog::init()
     ui->stackedWidget->setCurrentWidget(ui->generalPage);
     initPageMap();
     initInternalCustomConfigWidgets();
+
+    // Plugins page presents load state of all plugins, so deferred ones have to be loaded to present it correctly.
+    PLUGINS->loadDeferredPlugins();
     initPlugins();
     initPluginsPage();
     initFormatterPlugins();
@@ -0,0 +1,128 @@
+#include "dbbackupdialog.h"
+#include "ui_dbbackupdialog.h"
+#include "dbbackup.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "services/notifymanager.h"
+#include "common/widgetcover.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDialogButtonBox>
+#include <QPushButton>
+#include <QMessageBox>
+#include <QFileInfo>
+#include <QDir>
+
+DbBackupDialog::DbBackupDialog(Db* db, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DbBackupDialog),
+    db(db)
+{
+    init();
+}
+
+DbBackupDialog::~DbBackupDialog()
+{
+    if (watcher->isRunning())
+    {
+        backup->interrupt();
+        watcher->waitForFinished();
+    }
+
+    safe_delete(backup);
+    delete ui;
+}
+
+void DbBackupDialog::init()
+{
+    ui->setupUi(this);
+    setWindowTitle(tr("Back up database %1").arg(db->getName()));
+    ui->dbName->setText(db->getName());
+
+    QFileInfo dbFile(db->getPath());
+    ui->fileEdit->setFile(dbFile.dir().absoluteFilePath(dbFile.completeBaseName() + "_copy." + dbFile.suffix()));
+
+    widgetCover = new WidgetCover(this);
+    widgetCover->initWithInterruptContainer(tr("Cancel"));
+    widgetCover->setVisible(false);
+
+    watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(finished()));
+    connect(widgetCover, SIGNAL(cancelClicked()), this, SLOT(interrupt()));
+    connect(ui->fileEdit, SIGNAL(fileChanged(QString)), this, SLOT(updateState()));
+    connect(ui->backupApiRadio, SIGNAL(toggled(bool)), this, SLOT(updateState()));
+    updateState();
+}
+
+void DbBackupDialog::updateState()
+{
+    bool running = watcher->isRunning();
+    ui->optionsGroup->setEnabled(!running);
+    ui->throttlingGroup->setEnabled(!running && ui->backupApiRadio->isChecked());
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!running && !ui->fileEdit->getFile().trimmed().isEmpty());
+}
+
+void DbBackupDialog::accept()
+{
+    if (watcher->isRunning())
+        return;
+
+    if (!db->isOpen())
+    {
+        notifyError(tr("Database %1 has to be open to back it up.").arg(db->getName()));
+        return;
+    }
+
+    QString path = ui->fileEdit->getFile().trimmed();
+    if (QFileInfo(path).exists())
+    {
+        QMessageBox::StandardButton res = QMessageBox::question(this, tr("Overwrite file"),
+                                                                tr("File %1 already exists. Do you want to overwrite it?").arg(path));
+        if (res != QMessageBox::Yes)
+            return;
+    }
+
+    safe_delete(backup);
+    backup = new DbBackup(db, path);
+    backup->setMode(ui->backupApiRadio->isChecked() ? DbBackup::Mode::BACKUP : DbBackup::Mode::VACUUM_INTO);
+    backup->setPagesPerStep(ui->pagesSpin->value());
+    backup->setPauseMs(ui->pauseSpin->value());
+    connect(backup, SIGNAL(progress(int,int)), this, SLOT(progress(int,int)));
+
+    widgetCover->displayProgress(0);
+    watcher->setFuture(QtConcurrent::run(backup, &DbBackup::exec));
+    widgetCover->show();
+    updateState();
+}
+
+void DbBackupDialog::progress(int copiedPages, int totalPages)
+{
+    if (totalPages <= 0)
+        return;
+
+    widgetCover->displayProgress(totalPages, "%p%");
+    widgetCover->setProgress(copiedPages);
+}
+
+void DbBackupDialog::finished()
+{
+    widgetCover->hide();
+    updateState();
+    if (!watcher->result())
+    {
+        notifyError(backup->getErrorText());
+        return;
+    }
+
+    QString path = ui->fileEdit->getFile().trimmed();
+    notifyInfo(tr("Database %1 was copied to file %2.").arg(db->getName(), path));
+    if (ui->addToListCheck->isChecked())
+        DBLIST->addDb(DBLIST->generateUniqueDbName(path), path, db->getConnectionOptions(), true);
+
+    QDialog::accept();
+}
+
+void DbBackupDialog::interrupt()
+{
+    if (watcher->isRunning())
+        backup->interrupt();
+}
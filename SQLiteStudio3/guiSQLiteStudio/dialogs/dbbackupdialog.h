@@ -0,0 +1,43 @@
+#ifndef DBBACKUPDIALOG_H
+#define DBBACKUPDIALOG_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QDialog>
+#include <QFutureWatcher>
+
+namespace Ui {
+    class DbBackupDialog;
+}
+
+class Db;
+class DbBackup;
+class WidgetCover;
+
+class GUI_API_EXPORT DbBackupDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        DbBackupDialog(Db* db, QWidget *parent = nullptr);
+        ~DbBackupDialog();
+
+    private:
+        void init();
+
+        Ui::DbBackupDialog *ui;
+        Db* db = nullptr;
+        DbBackup* backup = nullptr;
+        QFutureWatcher<bool>* watcher = nullptr;
+        WidgetCover* widgetCover = nullptr;
+
+    private slots:
+        void updateState();
+        void progress(int copiedPages, int totalPages);
+        void finished();
+        void interrupt();
+
+    public slots:
+        void accept();
+};
+
+#endif // DBBACKUPDIALOG_H
@@ -0,0 +1,178 @@
+#include "dbdiffdialog.h"
+#include "ui_dbdiffdialog.h"
+#include "dbdiff.h"
+#include "db/db.h"
+#include "common/widgetcover.h"
+#include "services/notifymanager.h"
+#include "dbtree/dbtree.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QHeaderView>
+#include <QMessageBox>
+
+DbDiffDialog::DbDiffDialog(Db* db, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DbDiffDialog),
+    db(db)
+{
+    init();
+}
+
+DbDiffDialog::~DbDiffDialog()
+{
+    if (watcher->isRunning())
+    {
+        diff->interrupt();
+        watcher->waitForFinished();
+    }
+
+    safe_delete(diff);
+    delete ui;
+}
+
+void DbDiffDialog::init()
+{
+    ui->setupUi(this);
+    setWindowTitle(tr("Compare database %1").arg(db->getName()));
+    ui->srcDbName->setText(db->getName());
+    ui->scriptEdit->setDb(db);
+    ui->dataTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    widgetCover = new WidgetCover(this);
+    widgetCover->initWithInterruptContainer(tr("Cancel"));
+    widgetCover->setVisible(false);
+
+    watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(finished()));
+    connect(widgetCover, SIGNAL(cancelClicked()), this, SLOT(interrupt()));
+    connect(ui->compareButton, SIGNAL(clicked()), this, SLOT(compare()));
+    connect(ui->applyButton, SIGNAL(clicked()), this, SLOT(applyDiff()));
+    connect(ui->dstDbCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(clearResults()));
+    clearResults();
+}
+
+void DbDiffDialog::clearResults()
+{
+    if (watcher->isRunning())
+        return;
+
+    safe_delete(diff);
+    ui->dataTable->setRowCount(0);
+    ui->schemaList->clear();
+    ui->scriptEdit->clear();
+    ui->statusLabel->clear();
+    updateState();
+}
+
+void DbDiffDialog::compare()
+{
+    if (watcher->isRunning())
+        return;
+
+    clearResults();
+    dstDb = ui->dstDbCombo->currentDb();
+    if (!dstDb || !db->isOpen() || !dstDb->isOpen())
+    {
+        ui->statusLabel->setText(tr("Both databases have to be open to compare them."));
+        return;
+    }
+
+    if (dstDb == db)
+    {
+        ui->statusLabel->setText(tr("Select a different database to compare with."));
+        return;
+    }
+
+    diff = new DbDiff(db, dstDb);
+    applying = false;
+    watcher->setFuture(QtConcurrent::run(diff, &DbDiff::compare));
+
+    ui->statusLabel->setText(tr("Comparing databases..."));
+    widgetCover->show();
+    updateState();
+}
+
+void DbDiffDialog::applyDiff()
+{
+    if (watcher->isRunning() || !diff)
+        return;
+
+    QMessageBox::StandardButton res = QMessageBox::question(this, tr("Synchronize database"),
+                                                            tr("Are you sure you want to execute %n statement(s) of the synchronization script on database %1?",
+                                                               "", diff->getScript().size()).arg(dstDb->getName()));
+    if (res != QMessageBox::Yes)
+        return;
+
+    applying = true;
+    watcher->setFuture(QtConcurrent::run(diff, &DbDiff::apply));
+
+    ui->statusLabel->setText(tr("Synchronizing database %1...").arg(dstDb->getName()));
+    widgetCover->show();
+    updateState();
+}
+
+void DbDiffDialog::finished()
+{
+    widgetCover->hide();
+    bool success = watcher->result();
+    if (applying)
+    {
+        if (success)
+        {
+            notifyInfo(tr("Database %1 was synchronized with database %2.").arg(dstDb->getName(), db->getName()));
+            DBTREE->refreshSchema(dstDb);
+            clearResults();
+        }
+        else
+        {
+            notifyError(diff->getErrorText());
+            ui->statusLabel->setText(tr("Synchronization failed, no changes were made."));
+        }
+        updateState();
+        return;
+    }
+
+    if (!success)
+    {
+        ui->statusLabel->setText(diff->getErrorText().isEmpty() ? tr("Comparison was interrupted.") : diff->getErrorText());
+        safe_delete(diff);
+        updateState();
+        return;
+    }
+
+    const QList<DbDiff::TableDiff>& tableDiffs = diff->getTableDiffs();
+    ui->dataTable->setRowCount(tableDiffs.size());
+    int row = 0;
+    for (const DbDiff::TableDiff& tableDiff : tableDiffs)
+    {
+        ui->dataTable->setItem(row, TABLE, new QTableWidgetItem(tableDiff.table));
+        ui->dataTable->setItem(row, INSERTED, new QTableWidgetItem(QString::number(tableDiff.inserted)));
+        ui->dataTable->setItem(row, UPDATED, new QTableWidgetItem(QString::number(tableDiff.updated)));
+        ui->dataTable->setItem(row, DELETED, new QTableWidgetItem(QString::number(tableDiff.deleted)));
+        row++;
+    }
+
+    ui->schemaList->addItems(diff->getSchemaDifferences());
+    ui->scriptEdit->setPlainText(diff->getScript().join("\n"));
+
+    if (diff->getScript().isEmpty())
+        ui->statusLabel->setText(tr("Databases are identical."));
+    else
+        ui->statusLabel->setText(tr("Found %n different table(s) and %1 schema difference(s).", "", tableDiffs.size())
+                                 .arg(diff->getSchemaDifferences().size()));
+
+    updateState();
+}
+
+void DbDiffDialog::interrupt()
+{
+    if (watcher->isRunning() && !applying)
+        diff->interrupt();
+}
+
+void DbDiffDialog::updateState()
+{
+    bool running = watcher->isRunning();
+    ui->compareButton->setEnabled(!running);
+    ui->dbGroup->setEnabled(!running);
+    ui->applyButton->setEnabled(!running && diff && !diff->getScript().isEmpty());
+}
@@ -0,0 +1,52 @@
+#ifndef DBDIFFDIALOG_H
+#define DBDIFFDIALOG_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QDialog>
+#include <QFutureWatcher>
+
+namespace Ui {
+    class DbDiffDialog;
+}
+
+class Db;
+class DbDiff;
+class WidgetCover;
+
+class GUI_API_EXPORT DbDiffDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        DbDiffDialog(Db* db, QWidget *parent = nullptr);
+        ~DbDiffDialog();
+
+    private:
+        enum Column
+        {
+            TABLE = 0,
+            INSERTED = 1,
+            UPDATED = 2,
+            DELETED = 3
+        };
+
+        void init();
+
+        Ui::DbDiffDialog *ui;
+        Db* db = nullptr;
+        Db* dstDb = nullptr;
+        DbDiff* diff = nullptr;
+        QFutureWatcher<bool>* watcher = nullptr;
+        WidgetCover* widgetCover = nullptr;
+        bool applying = false;
+
+    private slots:
+        void clearResults();
+        void compare();
+        void applyDiff();
+        void finished();
+        void interrupt();
+        void updateState();
+};
+
+#endif // DBDIFFDIALOG_H
@@ -0,0 +1,226 @@
+#include "dbmaintenancedialog.h"
+#include "ui_dbmaintenancedialog.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "services/notifymanager.h"
+#include "common/utils.h"
+#include "iconmanager.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QHeaderView>
+#include <QPushButton>
+
+DbMaintenanceDialog::DbMaintenanceDialog(Db* db, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DbMaintenanceDialog)
+{
+    init();
+    initDbList(db);
+}
+
+DbMaintenanceDialog::~DbMaintenanceDialog()
+{
+    if (watcher->isRunning())
+    {
+        maintenance->interrupt();
+        watcher->waitForFinished();
+    }
+
+    safe_delete(maintenance);
+    delete ui;
+}
+
+void DbMaintenanceDialog::init()
+{
+    ui->setupUi(this);
+    ui->reportTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->historyTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->progressBar->setVisible(false);
+
+    watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(finished()));
+    connect(ui->runButton, SIGNAL(clicked()), this, SLOT(run()));
+    connect(ui->cancelButton, SIGNAL(clicked()), this, SLOT(interrupt()));
+    connect(ui->dbList, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(updateState()));
+    for (QCheckBox* check : {ui->quickCheck, ui->integrityCheck, ui->foreignKeyCheck, ui->analyzeCheck})
+        connect(check, SIGNAL(toggled(bool)), this, SLOT(updateState()));
+
+    refreshHistory();
+}
+
+void DbMaintenanceDialog::initDbList(Db* selectedDb)
+{
+    for (Db* db : DBLIST->getValidDbList())
+    {
+        QListWidgetItem* item = new QListWidgetItem(ICONS.DATABASE, db->getName());
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(db == selectedDb ? Qt::Checked : Qt::Unchecked);
+        item->setData(Qt::UserRole, QVariant::fromValue(db));
+        ui->dbList->addItem(item);
+    }
+    updateState();
+}
+
+QList<DbMaintenance::Operation> DbMaintenanceDialog::getOperations() const
+{
+    QList<DbMaintenance::Operation> operations;
+    if (ui->quickCheck->isChecked())
+        operations << DbMaintenance::Operation::QUICK_CHECK;
+
+    if (ui->integrityCheck->isChecked())
+        operations << DbMaintenance::Operation::INTEGRITY_CHECK;
+
+    if (ui->foreignKeyCheck->isChecked())
+        operations << DbMaintenance::Operation::FOREIGN_KEY_CHECK;
+
+    if (ui->analyzeCheck->isChecked())
+        operations << DbMaintenance::Operation::ANALYZE;
+
+    return operations;
+}
+
+QList<Db*> DbMaintenanceDialog::getCheckedDbs() const
+{
+    QList<Db*> dbs;
+    for (int i = 0; i < ui->dbList->count(); i++)
+    {
+        QListWidgetItem* item = ui->dbList->item(i);
+        if (item->checkState() == Qt::Checked)
+            dbs << item->data(Qt::UserRole).value<Db*>();
+    }
+    return dbs;
+}
+
+void DbMaintenanceDialog::run()
+{
+    if (watcher->isRunning())
+        return;
+
+    QList<Db*> dbs = getCheckedDbs();
+    QList<DbMaintenance::Operation> operations = getOperations();
+    if (dbs.isEmpty() || operations.isEmpty())
+        return;
+
+    safe_delete(maintenance);
+    maintenance = new DbMaintenance();
+    for (Db* db : dbs)
+        maintenance->addDb(db);
+
+    maintenance->setOperations(operations);
+    maintenance->setThreads(ui->threadsSpin->value());
+    connect(maintenance, SIGNAL(started(int)), this, SLOT(started(int)), Qt::QueuedConnection);
+    connect(maintenance, SIGNAL(taskFinished(DbMaintenance::Result,int,int)), this, SLOT(taskFinished(DbMaintenance::Result,int,int)),
+            Qt::QueuedConnection);
+
+    failedTasks = 0;
+    tasksWithIssues = 0;
+    ui->reportTable->setRowCount(0);
+    ui->tabWidget->setCurrentWidget(ui->reportTab);
+    ui->progressBar->setRange(0, 0);
+    ui->progressBar->setVisible(true);
+    ui->statusLabel->setText(tr("Preparing tasks..."));
+
+    watcher->setFuture(QtConcurrent::run(maintenance, &DbMaintenance::exec));
+    updateState();
+}
+
+void DbMaintenanceDialog::interrupt()
+{
+    if (watcher->isRunning())
+        maintenance->interrupt();
+}
+
+void DbMaintenanceDialog::started(int totalTasks)
+{
+    ui->progressBar->setRange(0, totalTasks);
+    ui->progressBar->setValue(0);
+    ui->statusLabel->setText(tr("Executing %n task(s)...", "", totalTasks));
+}
+
+void DbMaintenanceDialog::taskFinished(const DbMaintenance::Result& result, int finishedTasks, int totalTasks)
+{
+    ui->progressBar->setMaximum(totalTasks);
+    ui->progressBar->setValue(finishedTasks);
+
+    QString resultText;
+    if (!result.success)
+    {
+        resultText = tr("Failed: %1").arg(result.issues.join("; "));
+        failedTasks++;
+    }
+    else if (!result.issues.isEmpty())
+    {
+        resultText = tr("%n issue(s)", "", result.issues.size());
+        tasksWithIssues++;
+    }
+    else
+    {
+        resultText = tr("OK");
+    }
+
+    int row = ui->reportTable->rowCount();
+    ui->reportTable->insertRow(row);
+    setItem(ui->reportTable, row, REPORT_DATABASE, result.database);
+    setItem(ui->reportTable, row, REPORT_OPERATION, DbMaintenance::toString(result.operation));
+    setItem(ui->reportTable, row, REPORT_OBJECT, result.object);
+    setItem(ui->reportTable, row, REPORT_RESULT, resultText);
+    setItem(ui->reportTable, row, REPORT_DURATION, formatTimePeriod(result.duration));
+
+    if (!result.issues.isEmpty())
+    {
+        ui->reportTable->item(row, REPORT_RESULT)->setIcon(result.success ? ICONS.STATUS_WARNING : ICONS.STATUS_ERROR);
+        ui->reportTable->item(row, REPORT_RESULT)->setToolTip(result.issues.join("\n"));
+    }
+}
+
+void DbMaintenanceDialog::finished()
+{
+    bool completed = watcher->result();
+    ui->progressBar->setVisible(false);
+
+    QList<DbMaintenance::Result> results = maintenance->getResults();
+    DbMaintenance::storeHistory(results);
+    refreshHistory();
+
+    QString summary = tr("Finished %n task(s)", "", results.size());
+    if (!completed)
+        summary = tr("Interrupted after %n task(s)", "", results.size());
+
+    ui->statusLabel->setText(tr("%1, %2 with issues, %3 failed.").arg(summary).arg(tasksWithIssues).arg(failedTasks));
+    if (tasksWithIssues > 0 || failedTasks > 0)
+        notifyWarn(tr("Database maintenance found issues in %1 task(s) and %2 task(s) failed.").arg(tasksWithIssues).arg(failedTasks));
+
+    updateState();
+}
+
+void DbMaintenanceDialog::refreshHistory()
+{
+    QList<DbMaintenance::HistoryEntry> history = DbMaintenance::getHistory();
+    ui->historyTable->setRowCount(history.size());
+
+    // Most recent entries go first
+    int row = 0;
+    for (int i = history.size() - 1; i >= 0; i--, row++)
+    {
+        const DbMaintenance::HistoryEntry& entry = history[i];
+        setItem(ui->historyTable, row, HISTORY_DATE, entry.date.toString(Qt::SystemLocaleShortDate));
+        setItem(ui->historyTable, row, HISTORY_DATABASE, entry.database);
+        setItem(ui->historyTable, row, HISTORY_OPERATION, DbMaintenance::toString(entry.operation));
+        setItem(ui->historyTable, row, HISTORY_OBJECTS, QString::number(entry.objects));
+        setItem(ui->historyTable, row, HISTORY_ISSUES, QString::number(entry.issues));
+        setItem(ui->historyTable, row, HISTORY_DURATION, formatTimePeriod(entry.duration));
+    }
+}
+
+void DbMaintenanceDialog::setItem(QTableWidget* table, int row, int column, const QString& text)
+{
+    table->setItem(row, column, new QTableWidgetItem(text));
+}
+
+void DbMaintenanceDialog::updateState()
+{
+    bool running = watcher->isRunning();
+    ui->dbList->setEnabled(!running);
+    ui->operationsGroup->setEnabled(!running);
+    ui->runButton->setEnabled(!running && !getCheckedDbs().isEmpty() && !getOperations().isEmpty());
+    ui->cancelButton->setEnabled(running);
+}
@@ -0,0 +1,66 @@
+#ifndef DBMAINTENANCEDIALOG_H
+#define DBMAINTENANCEDIALOG_H
+
+#include "guiSQLiteStudio_global.h"
+#include "dbmaintenance.h"
+#include <QDialog>
+#include <QFutureWatcher>
+
+namespace Ui {
+    class DbMaintenanceDialog;
+}
+
+class Db;
+class QTableWidget;
+
+class GUI_API_EXPORT DbMaintenanceDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        DbMaintenanceDialog(Db* db, QWidget *parent = nullptr);
+        ~DbMaintenanceDialog();
+
+    private:
+        enum ReportColumn
+        {
+            REPORT_DATABASE = 0,
+            REPORT_OPERATION = 1,
+            REPORT_OBJECT = 2,
+            REPORT_RESULT = 3,
+            REPORT_DURATION = 4
+        };
+
+        enum HistoryColumn
+        {
+            HISTORY_DATE = 0,
+            HISTORY_DATABASE = 1,
+            HISTORY_OPERATION = 2,
+            HISTORY_OBJECTS = 3,
+            HISTORY_ISSUES = 4,
+            HISTORY_DURATION = 5
+        };
+
+        void init();
+        void initDbList(Db* selectedDb);
+        QList<DbMaintenance::Operation> getOperations() const;
+        QList<Db*> getCheckedDbs() const;
+        void refreshHistory();
+        void setItem(QTableWidget* table, int row, int column, const QString& text);
+
+        Ui::DbMaintenanceDialog *ui;
+        DbMaintenance* maintenance = nullptr;
+        QFutureWatcher<bool>* watcher = nullptr;
+        int failedTasks = 0;
+        int tasksWithIssues = 0;
+
+    private slots:
+        void run();
+        void interrupt();
+        void started(int totalTasks);
+        void taskFinished(const DbMaintenance::Result& result, int finishedTasks, int totalTasks);
+        void finished();
+        void updateState();
+};
+
+#endif // DBMAINTENANCEDIALOG_H
@@ -0,0 +1,146 @@
+#include "indexadvisordialog.h"
+#include "ui_indexadvisordialog.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/widgetcover.h"
+#include "services/notifymanager.h"
+#include "dbtree/dbtree.h"
+#include "mainwindow.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QHeaderView>
+#include <algorithm>
+
+IndexAdvisorDialog::IndexAdvisorDialog(Db* db, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::IndexAdvisorDialog),
+    db(db)
+{
+    init();
+}
+
+IndexAdvisorDialog::~IndexAdvisorDialog()
+{
+    if (watcher->isRunning())
+        watcher->waitForFinished();
+
+    safe_delete(advisor);
+    delete ui;
+}
+
+void IndexAdvisorDialog::init()
+{
+    ui->setupUi(this);
+    setWindowTitle(tr("Index advisor for %1").arg(db->getName()));
+    ui->scriptEdit->setDb(db);
+    ui->resultsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    widgetCover = new WidgetCover(this);
+    widgetCover->setVisible(false);
+
+    watcher = new QFutureWatcher<QList<IndexAdvisor::RecommendationPtr>>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(analyzeFinished()));
+    connect(ui->analyzeButton, SIGNAL(clicked()), this, SLOT(analyze()));
+    connect(ui->createButton, SIGNAL(clicked()), this, SLOT(createSelectedIndexes()));
+    connect(ui->resultsTable, SIGNAL(itemSelectionChanged()), this, SLOT(updateState()));
+    updateState();
+}
+
+void IndexAdvisorDialog::analyze()
+{
+    if (watcher->isRunning())
+        return;
+
+    safe_delete(advisor);
+    advisor = new IndexAdvisor(db);
+    if (ui->historyRadio->isChecked())
+    {
+        int limit = ui->historyLimitSpin->value();
+        IndexAdvisor* theAdvisor = advisor;
+        watcher->setFuture(QtConcurrent::run([theAdvisor, limit]()
+        {
+            theAdvisor->addHistory(limit);
+            return theAdvisor->advise();
+        }));
+    }
+    else
+    {
+        advisor->addQueries(ui->scriptEdit->toPlainText());
+        watcher->setFuture(QtConcurrent::run(advisor, &IndexAdvisor::advise));
+    }
+
+    ui->statusLabel->setText(tr("Analyzing queries..."));
+    widgetCover->show();
+    updateState();
+}
+
+void IndexAdvisorDialog::analyzeFinished()
+{
+    widgetCover->hide();
+    recommendations = watcher->result();
+
+    ui->resultsTable->setRowCount(0);
+    ui->resultsTable->setRowCount(recommendations.size());
+    int row = 0;
+    for (const IndexAdvisor::RecommendationPtr& recommendation : recommendations)
+    {
+        ui->resultsTable->setItem(row, TABLE, new QTableWidgetItem(recommendation->table));
+        ui->resultsTable->setItem(row, COLUMNS, new QTableWidgetItem(recommendation->columns.join(", ")));
+        ui->resultsTable->setItem(row, BENEFIT, new QTableWidgetItem(QString::number(recommendation->estimatedBenefit, 'f', 2)));
+        ui->resultsTable->setItem(row, QUERIES, new QTableWidgetItem(QString::number(recommendation->queries.size())));
+        for (int col = TABLE; col <= QUERIES; col++)
+            ui->resultsTable->item(row, col)->setToolTip(recommendation->ddl + "\n\n" + recommendation->queries.join("\n\n"));
+
+        row++;
+    }
+
+    if (recommendations.isEmpty())
+        ui->statusLabel->setText(tr("Analyzed %n query(s), no index would make them faster.", "", advisor->getQueryCount()));
+    else
+        ui->statusLabel->setText(tr("Analyzed %n query(s).", "", advisor->getQueryCount()));
+
+    for (const QString& error : advisor->getErrors())
+        notifyWarn(error);
+
+    updateState();
+}
+
+void IndexAdvisorDialog::createSelectedIndexes()
+{
+    QList<int> rows;
+    for (const QModelIndex& idx : ui->resultsTable->selectionModel()->selectedRows())
+        rows << idx.row();
+
+    // Removing created ones from the bottom, so remaining row numbers stay valid
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+    int created = 0;
+    SqlQueryPtr results;
+    for (int row : rows)
+    {
+        IndexAdvisor::RecommendationPtr recommendation = recommendations[row];
+        results = db->exec(recommendation->ddl);
+        if (results->isError())
+        {
+            notifyError(tr("Could not create index %1: %2").arg(recommendation->indexName, results->getErrorText()));
+            continue;
+        }
+
+        recommendations.removeAt(row);
+        ui->resultsTable->removeRow(row);
+        created++;
+    }
+
+    if (created == 0)
+        return;
+
+    notifyInfo(tr("Created %n index(es).", "", created));
+    DBTREE->refreshSchema(db);
+}
+
+void IndexAdvisorDialog::updateState()
+{
+    bool running = watcher->isRunning();
+    ui->analyzeButton->setEnabled(!running);
+    ui->sourceGroup->setEnabled(!running);
+    ui->createButton->setEnabled(!running && ui->resultsTable->selectionModel()->hasSelection());
+}
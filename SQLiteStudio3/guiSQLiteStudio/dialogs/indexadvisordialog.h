@@ -0,0 +1,49 @@
+#ifndef INDEXADVISORDIALOG_H
+#define INDEXADVISORDIALOG_H
+
+#include "indexadvisor.h"
+#include "guiSQLiteStudio_global.h"
+#include <QDialog>
+#include <QFutureWatcher>
+
+namespace Ui {
+    class IndexAdvisorDialog;
+}
+
+class Db;
+class WidgetCover;
+
+class GUI_API_EXPORT IndexAdvisorDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        IndexAdvisorDialog(Db* db, QWidget *parent = nullptr);
+        ~IndexAdvisorDialog();
+
+    private:
+        enum Column
+        {
+            TABLE = 0,
+            COLUMNS = 1,
+            BENEFIT = 2,
+            QUERIES = 3
+        };
+
+        void init();
+
+        Ui::IndexAdvisorDialog *ui;
+        Db* db = nullptr;
+        IndexAdvisor* advisor = nullptr;
+        QList<IndexAdvisor::RecommendationPtr> recommendations;
+        QFutureWatcher<QList<IndexAdvisor::RecommendationPtr>>* watcher = nullptr;
+        WidgetCover* widgetCover = nullptr;
+
+    private slots:
+        void analyze();
+        void analyzeFinished();
+        void createSelectedIndexes();
+        void updateState();
+};
+
+#endif // INDEXADVISORDIALOG_H
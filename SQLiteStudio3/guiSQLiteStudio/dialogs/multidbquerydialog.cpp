@@ -0,0 +1,257 @@
+#include "multidbquerydialog.h"
+#include "ui_multidbquerydialog.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "services/notifymanager.h"
+#include "common/utils.h"
+#include "iconmanager.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QHeaderView>
+#include <QPushButton>
+
+MultiDbQueryDialog::MultiDbQueryDialog(Db* db, const QString& query, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::MultiDbQueryDialog)
+{
+    init();
+    initDbList(db);
+    ui->sqlEdit->setDb(db);
+    ui->sqlEdit->setPlainText(query);
+}
+
+MultiDbQueryDialog::~MultiDbQueryDialog()
+{
+    if (watcher->isRunning())
+    {
+        multiQuery->interrupt();
+        watcher->waitForFinished();
+    }
+
+    safe_delete(multiQuery);
+    delete ui;
+}
+
+void MultiDbQueryDialog::init()
+{
+    ui->setupUi(this);
+    ui->timingTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->progressBar->setVisible(false);
+
+    for (MultiDbQuery::Merge merge : {MultiDbQuery::Merge::UNION, MultiDbQuery::Merge::SUM, MultiDbQuery::Merge::COUNT})
+        ui->mergeCombo->addItem(MultiDbQuery::toString(merge), static_cast<int>(merge));
+
+    watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(finished()));
+    connect(ui->runButton, SIGNAL(clicked()), this, SLOT(run()));
+    connect(ui->cancelButton, SIGNAL(clicked()), this, SLOT(interrupt()));
+    connect(ui->checkAllButton, SIGNAL(clicked()), this, SLOT(checkAll()));
+    connect(ui->uncheckAllButton, SIGNAL(clicked()), this, SLOT(uncheckAll()));
+    connect(ui->dbList, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(updateState()));
+    connect(ui->sqlEdit, SIGNAL(textChanged()), this, SLOT(updateState()));
+}
+
+void MultiDbQueryDialog::initDbList(Db* selectedDb)
+{
+    for (Db* db : DBLIST->getValidDbList())
+    {
+        QListWidgetItem* item = new QListWidgetItem(ICONS.DATABASE, db->getName());
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(db == selectedDb ? Qt::Checked : Qt::Unchecked);
+        item->setData(Qt::UserRole, QVariant::fromValue(db));
+        ui->dbList->addItem(item);
+    }
+    updateState();
+}
+
+QList<Db*> MultiDbQueryDialog::getCheckedDbs() const
+{
+    QList<Db*> dbs;
+    for (int i = 0; i < ui->dbList->count(); i++)
+    {
+        QListWidgetItem* item = ui->dbList->item(i);
+        if (item->checkState() == Qt::Checked)
+            dbs << item->data(Qt::UserRole).value<Db*>();
+    }
+    return dbs;
+}
+
+void MultiDbQueryDialog::setCheckedAll(bool checked)
+{
+    ui->dbList->blockSignals(true);
+    for (int i = 0; i < ui->dbList->count(); i++)
+        ui->dbList->item(i)->setCheckState(checked ? Qt::Checked : Qt::Unchecked);
+
+    ui->dbList->blockSignals(false);
+    updateState();
+}
+
+void MultiDbQueryDialog::checkAll()
+{
+    setCheckedAll(true);
+}
+
+void MultiDbQueryDialog::uncheckAll()
+{
+    setCheckedAll(false);
+}
+
+void MultiDbQueryDialog::run()
+{
+    if (watcher->isRunning())
+        return;
+
+    QList<Db*> dbs = getCheckedDbs();
+    QString query = ui->sqlEdit->toPlainText().trimmed();
+    if (dbs.isEmpty() || query.isEmpty())
+        return;
+
+    safe_delete(multiQuery);
+    multiQuery = new MultiDbQuery(query);
+    for (Db* db : dbs)
+        multiQuery->addDb(db);
+
+    multiQuery->setMerge(static_cast<MultiDbQuery::Merge>(ui->mergeCombo->currentData().toInt()));
+    multiQuery->setThreads(ui->threadsSpin->value());
+    connect(multiQuery, SIGNAL(started(int)), this, SLOT(started(int)), Qt::QueuedConnection);
+    connect(multiQuery, SIGNAL(columnsFetched(QStringList)), this, SLOT(columnsFetched(QStringList)), Qt::QueuedConnection);
+    connect(multiQuery, SIGNAL(rowsFetched(QString,QList<QList<QVariant>>)), this, SLOT(rowsFetched(QString,QList<QList<QVariant>>)),
+            Qt::QueuedConnection);
+    connect(multiQuery, SIGNAL(dbFinished(MultiDbQuery::Result,int,int)), this, SLOT(dbFinished(MultiDbQuery::Result,int,int)),
+            Qt::QueuedConnection);
+
+    totalRows = 0;
+    failedDbs = 0;
+    ui->resultsTable->clear();
+    ui->resultsTable->setRowCount(0);
+    ui->resultsTable->setColumnCount(0);
+    ui->timingTable->setRowCount(0);
+    ui->progressBar->setRange(0, dbs.size());
+    ui->progressBar->setValue(0);
+    ui->progressBar->setVisible(true);
+
+    watcher->setFuture(QtConcurrent::run(multiQuery, &MultiDbQuery::exec));
+    updateState();
+}
+
+void MultiDbQueryDialog::interrupt()
+{
+    if (watcher->isRunning())
+        multiQuery->interrupt();
+}
+
+void MultiDbQueryDialog::started(int totalDbs)
+{
+    ui->statusLabel->setText(tr("Executing query on %n database(s)...", "", totalDbs));
+}
+
+void MultiDbQueryDialog::columnsFetched(const QStringList& columns)
+{
+    if (multiQuery->getMerge() == MultiDbQuery::Merge::COUNT)
+        return;
+
+    ui->resultsTable->setColumnCount(columns.size() + 1);
+    ui->resultsTable->setHorizontalHeaderLabels(QStringList({tr("Database")}) + columns);
+}
+
+void MultiDbQueryDialog::rowsFetched(const QString& database, const QList<QList<QVariant>>& rows)
+{
+    totalRows += rows.size();
+    for (const QList<QVariant>& row : rows)
+    {
+        if (ui->resultsTable->rowCount() >= MAX_DISPLAYED_ROWS)
+            break;
+
+        appendRow(database, row);
+    }
+}
+
+void MultiDbQueryDialog::dbFinished(const MultiDbQuery::Result& result, int finishedDbs, int totalDbs)
+{
+    ui->progressBar->setMaximum(totalDbs);
+    ui->progressBar->setValue(finishedDbs);
+
+    int row = ui->timingTable->rowCount();
+    ui->timingTable->insertRow(row);
+    setItem(ui->timingTable, row, TIMING_DATABASE, result.database);
+    setItem(ui->timingTable, row, TIMING_RESULT, result.success ? tr("OK") : result.errorText);
+    setItem(ui->timingTable, row, TIMING_ROWS, QString::number(result.rowsAffected > 0 ? result.rowsAffected : result.rows));
+    setItem(ui->timingTable, row, TIMING_DURATION, formatTimePeriod(result.duration));
+    if (!result.success)
+    {
+        ui->timingTable->item(row, TIMING_RESULT)->setIcon(ICONS.STATUS_ERROR);
+        ui->timingTable->item(row, TIMING_RESULT)->setToolTip(result.errorText);
+        failedDbs++;
+    }
+
+    if (multiQuery->getMerge() == MultiDbQuery::Merge::COUNT && result.success)
+    {
+        totalRows += result.rows;
+        if (ui->resultsTable->columnCount() == 0)
+        {
+            ui->resultsTable->setColumnCount(2);
+            ui->resultsTable->setHorizontalHeaderLabels({tr("Database"), tr("Rows")});
+        }
+        appendRow(result.database, {result.rows});
+    }
+}
+
+void MultiDbQueryDialog::finished()
+{
+    bool completed = watcher->result();
+    ui->progressBar->setVisible(false);
+
+    switch (multiQuery->getMerge())
+    {
+        case MultiDbQuery::Merge::UNION:
+            break;
+        case MultiDbQuery::Merge::SUM:
+            if (!multiQuery->getColumns().isEmpty())
+                appendRow(tr("All databases"), multiQuery->getTotals());
+
+            break;
+        case MultiDbQuery::Merge::COUNT:
+            if (ui->resultsTable->columnCount() > 0)
+                appendRow(tr("All databases"), {totalRows});
+
+            break;
+    }
+
+    QList<MultiDbQuery::Result> results = multiQuery->getResults();
+    QString summary = tr("Query executed on %n database(s)", "", results.size());
+    if (!completed)
+        summary = tr("Interrupted after %n database(s)", "", results.size());
+
+    summary = tr("%1, %2 failed.").arg(summary).arg(failedDbs);
+    if (multiQuery->getMerge() == MultiDbQuery::Merge::UNION && totalRows > MAX_DISPLAYED_ROWS)
+        summary += " " + tr("Only first %1 of %2 rows are displayed.").arg(MAX_DISPLAYED_ROWS).arg(totalRows);
+
+    ui->statusLabel->setText(summary);
+    ui->resultsTable->resizeColumnsToContents();
+    if (failedDbs > 0)
+        notifyWarn(tr("Query failed on %n database(s).", "", failedDbs));
+
+    updateState();
+}
+
+void MultiDbQueryDialog::appendRow(const QString& database, const QList<QVariant>& values)
+{
+    int row = ui->resultsTable->rowCount();
+    ui->resultsTable->insertRow(row);
+    setItem(ui->resultsTable, row, 0, database);
+    for (int i = 0, total = qMin(values.size(), ui->resultsTable->columnCount() - 1); i < total; i++)
+        setItem(ui->resultsTable, row, i + 1, values[i].isNull() ? QString() : values[i].toString());
+}
+
+void MultiDbQueryDialog::setItem(QTableWidget* table, int row, int column, const QString& text)
+{
+    table->setItem(row, column, new QTableWidgetItem(text));
+}
+
+void MultiDbQueryDialog::updateState()
+{
+    bool running = watcher->isRunning();
+    ui->dbGroup->setEnabled(!running);
+    ui->queryGroup->setEnabled(!running);
+    ui->runButton->setEnabled(!running && !getCheckedDbs().isEmpty() && !ui->sqlEdit->toPlainText().trimmed().isEmpty());
+    ui->cancelButton->setEnabled(running);
+}
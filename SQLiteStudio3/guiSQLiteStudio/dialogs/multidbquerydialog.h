@@ -0,0 +1,61 @@
+#ifndef MULTIDBQUERYDIALOG_H
+#define MULTIDBQUERYDIALOG_H
+
+#include "guiSQLiteStudio_global.h"
+#include "multidbquery.h"
+#include <QDialog>
+#include <QFutureWatcher>
+
+namespace Ui {
+    class MultiDbQueryDialog;
+}
+
+class Db;
+class QTableWidget;
+
+class GUI_API_EXPORT MultiDbQueryDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        MultiDbQueryDialog(Db* db, const QString& query, QWidget *parent = nullptr);
+        ~MultiDbQueryDialog();
+
+    private:
+        enum TimingColumn
+        {
+            TIMING_DATABASE = 0,
+            TIMING_RESULT = 1,
+            TIMING_ROWS = 2,
+            TIMING_DURATION = 3
+        };
+
+        void init();
+        void initDbList(Db* selectedDb);
+        QList<Db*> getCheckedDbs() const;
+        void setCheckedAll(bool checked);
+        void appendRow(const QString& database, const QList<QVariant>& values);
+        void setItem(QTableWidget* table, int row, int column, const QString& text);
+
+        static const int MAX_DISPLAYED_ROWS = 100000;
+
+        Ui::MultiDbQueryDialog *ui;
+        MultiDbQuery* multiQuery = nullptr;
+        QFutureWatcher<bool>* watcher = nullptr;
+        qint64 totalRows = 0;
+        int failedDbs = 0;
+
+    private slots:
+        void run();
+        void interrupt();
+        void checkAll();
+        void uncheckAll();
+        void started(int totalDbs);
+        void columnsFetched(const QStringList& columns);
+        void rowsFetched(const QString& database, const QList<QList<QVariant>>& rows);
+        void dbFinished(const MultiDbQuery::Result& result, int finishedDbs, int totalDbs);
+        void finished();
+        void updateState();
+};
+
+#endif // MULTIDBQUERYDIALOG_H
@@ -49,6 +49,7 @@ SOURCES +=\
     uiutils.cpp \
     dbtree/dbtreeitemdelegate.cpp \
     dbtree/dbtreeitemfactory.cpp \
+    dbtree/dbtreeschemasnapshot.cpp \
     sqleditor.cpp \
     datagrid/sqlquerymodel.cpp \
     datagrid/sqldatasourcequerymodel.cpp \
@@ -57,6 +58,7 @@ SOURCES +=\
     statusfield.cpp \
     common/tablewidget.cpp \
     datagrid/sqlqueryitem.cpp \
+    datagrid/fullvaluesloader.cpp \
     datagrid/sqlqueryview.cpp \
     datagrid/sqlquerymodelcolumn.cpp \
     datagrid/sqlqueryitemdelegate.cpp \
@@ -186,6 +188,11 @@ SOURCES +=\
     windows/sqliteextensioneditormodel.cpp \
     dialogs/bindparamsdialog.cpp \
     dialogs/execfromfiledialog.cpp \
+    dialogs/indexadvisordialog.cpp \
+    dialogs/dbdiffdialog.cpp \
+    dialogs/dbbackupdialog.cpp \
+    dialogs/dbmaintenancedialog.cpp \
+    dialogs/multidbquerydialog.cpp \
     dialogs/fileexecerrorsdialog.cpp
 
 HEADERS  += mainwindow.h \
@@ -202,6 +209,7 @@ HEADERS  += mainwindow.h \
     uiutils.h \
     dbtree/dbtreeitemdelegate.h \
     dbtree/dbtreeitemfactory.h \
+    dbtree/dbtreeschemasnapshot.h \
     sqleditor.h \
     datagrid/sqlquerymodel.h \
     datagrid/sqldatasourcequerymodel.h \
@@ -210,6 +218,7 @@ HEADERS  += mainwindow.h \
     statusfield.h \
     common/tablewidget.h \
     datagrid/sqlqueryitem.h \
+    datagrid/fullvaluesloader.h \
     datagrid/sqlqueryview.h \
     datagrid/sqlquerymodelcolumn.h \
     datagrid/sqlqueryitemdelegate.h \
@@ -345,6 +354,11 @@ HEADERS  += mainwindow.h \
     dialogs/bindparamsdialog.h \
     common/bindparam.h \
     dialogs/execfromfiledialog.h \
+    dialogs/indexadvisordialog.h \
+    dialogs/dbdiffdialog.h \
+    dialogs/dbbackupdialog.h \
+    dialogs/dbmaintenancedialog.h \
+    dialogs/multidbquerydialog.h \
     dialogs/fileexecerrorsdialog.h
 
 FORMS    += mainwindow.ui \
@@ -396,6 +410,11 @@ FORMS    += mainwindow.ui \
     windows/sqliteextensioneditor.ui \
     dialogs/bindparamsdialog.ui \
     dialogs/execfromfiledialog.ui \
+    dialogs/indexadvisordialog.ui \
+    dialogs/dbdiffdialog.ui \
+    dialogs/dbbackupdialog.ui \
+    dialogs/dbmaintenancedialog.ui \
+    dialogs/multidbquerydialog.ui \
     dialogs/fileexecerrorsdialog.ui
 
 RESOURCES += \
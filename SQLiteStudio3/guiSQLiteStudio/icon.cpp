@@ -88,6 +88,7 @@ QString Icon::toImgSrc() const
     if (aliased)
         return aliased->toImgSrc();
 
+    ensureLoaded();
     if (!filePath.isNull())
         return getPath();
     else
@@ -111,11 +112,7 @@ QByteArray Icon::toPixmapBytes() const
         return aliased->toPixmapBytes();
 
     QByteArray byteArray;
-    if (!loaded)
-    {
-        qCritical() << "Referring to a movie that was not yet loaded:" << name;
-        return byteArray;
-    }
+    ensureLoaded();
 
     QBuffer buffer(&byteArray);
     iconHandle->pixmap(16, 16).save(&buffer, "PNG");
@@ -127,6 +124,7 @@ QString Icon::toUrl() const
     if (aliased)
         return aliased->toUrl();
 
+    ensureLoaded();
     if (filePath.isNull())
         return toBase64Url();
 
@@ -138,11 +136,7 @@ QIcon* Icon::toQIconPtr() const
     if (aliased)
         return aliased->toQIconPtr();
 
-    if (!loaded)
-    {
-        qCritical() << "Referring to an icon that was not yet loaded:" << name;
-        return nullptr;
-    }
+    ensureLoaded();
 
     return iconHandle;
 }
@@ -167,11 +161,7 @@ QMovie* Icon::toQMoviePtr() const
     if (aliased)
         return aliased->toQMoviePtr();
 
-    if (!loaded)
-    {
-        qCritical() << "Referring to a movie that was not yet loaded:" << name;
-        return nullptr;
-    }
+    ensureLoaded();
 
     if (!movieHandle)
         return nullptr; // this is not a movie
@@ -195,11 +185,7 @@ QIcon* Icon::with(Icon::Attributes attr)
     if (aliased)
         return aliased->with(attr);
 
-    if (!loaded)
-    {
-        qCritical() << "Referring to a icon that was not yet loaded:" << name;
-        return nullptr;
-    }
+    ensureLoaded();
 
     if (movieHandle)
         return nullptr; // this is a movie
@@ -235,6 +221,7 @@ QString Icon::getPath() const
     if (aliased)
         aliased->getPath();
 
+    ensureLoaded();
     return filePath;
 }
 
@@ -243,6 +230,7 @@ bool Icon::isNull() const
     if (aliased)
         return aliased->isNull();
 
+    ensureLoaded();
     return (!iconHandle || iconHandle->isNull()) && !movieHandle;
 }
 
@@ -251,6 +239,7 @@ bool Icon::isMovie() const
     if (aliased)
         return aliased->isMovie();
 
+    ensureLoaded();
     return movieHandle != nullptr;
 }
 
@@ -277,21 +266,27 @@ QIcon Icon::merge(const QIcon& icon, Icon::Attributes attr)
     return mergeAttribute(&icon, attr);
 }
 
-void Icon::loadAll()
-{
-    for (Icon* icon : instances.values())
-        icon->load();
-}
-
 void Icon::reloadAll()
 {
+    // Icons that were not used yet will be loaded on first use anyway
     for (Icon* icon : instances.values())
     {
+        if (!icon->loaded)
+            continue;
+
         icon->loaded = false;
         icon->load();
     }
 }
 
+void Icon::ensureLoaded() const
+{
+    if (loaded)
+        return;
+
+    const_cast<Icon*>(this)->load();
+}
+
 QString Icon::getIconNameForAttribute(Icon::Attributes attr)
 {
     switch (attr)
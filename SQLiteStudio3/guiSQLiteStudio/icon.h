@@ -71,7 +71,6 @@ class GUI_API_EXPORT Icon
         operator QVariant() const;
 
         static void init();
-        static void loadAll();
         static void reloadAll();
         static Icon& createFrom(const QString& name, Icon* copy, Attributes attr);
         static Icon& aliasOf(const QString& name, Icon* other);
@@ -80,6 +79,13 @@ class GUI_API_EXPORT Icon
     private:
         explicit Icon(const QString& name);
 
+        /**
+         * @brief Loads the icon if it wasn't loaded yet.
+         *
+         * Icons are loaded on first use, so the startup does not have to load all of them.
+         */
+        void ensureLoaded() const;
+
         static QString getIconNameForAttribute(Attributes attr);
         static QIcon mergeAttribute(const QIcon* icon, Attributes attr);
 
@@ -3,6 +3,7 @@
 #include "services/pluginmanager.h"
 #include "common/unused.h"
 #include "common/global.h"
+#include "common/startuptrace.h"
 #include <QApplication>
 #include <QDir>
 #include <QString>
@@ -45,16 +46,14 @@ void IconManager::init()
     iconDirs += STRINGIFY(ICONS_DIR);
 #endif
 
-    iconFileExtensions << "*.png" << "*.PNG" << "*.jpg" << "*.JPG" << "*.svg" << "*.SVG";
-    movieFileExtensions << "*.gif" << "*.GIF" << "*.mng" << "*.MNG";
+    iconFileExtensions << "png" << "jpg" << "svg";
+    movieFileExtensions << "gif" << "mng";
+    for (const QString& ext : iconFileExtensions + movieFileExtensions)
+        fileNameFilters << "*." + ext << "*." + ext.toUpper();
 
-    for (QString dirPath : iconDirs)
-    {
-        loadRecurently(dirPath, "", false);
-        loadRecurently(dirPath, "", true);
-    }
-
-    Icon::loadAll();
+    StartupTrace::Scope trace("Icons scan");
+    for (const QString& dirPath : iconDirs)
+        loadRecurently(dirPath, "");
 
     if (PLUGINS->arePluginsInitiallyLoaded())
         enableRescanning();
@@ -72,19 +71,16 @@ void IconManager::rescanResources(const QString& pluginName)
     if (!pluginName.isNull() && PLUGINS->isBuiltIn(pluginName))
         return;
 
-    for (const QString& name : resourceMovies)
+    for (const QString& name : resourceNames)
     {
-        delete movies[name];
-        movies.remove(name);
-    }
-
-    for (const QString& name : resourceIcons)
+        delete movies.take(name);
         icons.remove(name);
+        paths.remove(name);
+        movieNames.remove(name);
+    }
 
-    resourceMovies.clear();
-    resourceIcons.clear();
-    loadRecurently(":/icons", "", true);
-    loadRecurently(":/icons", "", false);
+    resourceNames.clear();
+    loadRecurently(":/icons", "");
 
     Icon::reloadAll();
     emit rescannedFor(pluginName);
@@ -109,35 +105,31 @@ void IconManager::pluginsInitiallyLoaded()
     disconnect(PLUGINS, SIGNAL(pluginsInitiallyLoaded()), this, SLOT(pluginsInitiallyLoaded()));
 }
 
-void IconManager::loadRecurently(QString dirPath, const QString& prefix, bool movie)
+void IconManager::loadRecurently(QString dirPath, const QString& prefix)
 {
-    QStringList extensions = movie ? movieFileExtensions : iconFileExtensions;
+    // Only paths are collected here. Icons and movies are created on first request (see getIcon() and getMovie()),
+    // as most of them are not used during the session at all.
     QString path;
     QString name;
     QDir dir(dirPath);
-    for (QFileInfo entry : dir.entryInfoList(extensions, QDir::AllDirs|QDir::Files|QDir::NoDotAndDotDot|QDir::Readable))
+    for (QFileInfo entry : dir.entryInfoList(fileNameFilters, QDir::AllDirs|QDir::Files|QDir::NoDotAndDotDot|QDir::Readable))
     {
         if (entry.isDir())
         {
-            loadRecurently(entry.absoluteFilePath(), prefix+entry.fileName()+"_", movie);
+            loadRecurently(entry.absoluteFilePath(), prefix+entry.fileName()+"_");
             continue;
         }
 
         path = entry.absoluteFilePath();
         name = entry.baseName();
         paths[name] = path;
-        if (movie)
-            movies[name] = new QMovie(path);
+        if (movieFileExtensions.contains(entry.suffix().toLower()))
+            movieNames << name;
         else
-            icons[name] = new QIcon(path);
+            movieNames.remove(name);
 
         if (path.startsWith(":/"))
-        {
-            if (movie)
-                resourceMovies << name;
-            else
-                resourceIcons << name;
-        }
+            resourceNames << name;
     }
 }
 
@@ -150,21 +142,39 @@ void IconManager::enableRescanning()
 
 QMovie* IconManager::getMovie(const QString& name)
 {
-    if (!movies.contains(name))
+    QMovie* movie = movies.value(name);
+    if (movie)
+        return movie;
+
+    if (!movieNames.contains(name))
+    {
         qCritical() << "Movie missing:" << name;
+        return nullptr;
+    }
 
-    return movies[name];
+    movie = new QMovie(paths[name]);
+    movies[name] = movie;
+    return movie;
 }
 
 QIcon* IconManager::getIcon(const QString& name)
 {
-    if (!icons.contains(name))
+    QIcon* icon = icons.value(name);
+    if (icon)
+        return icon;
+
+    if (!paths.contains(name) || movieNames.contains(name))
+    {
         qCritical() << "Icon missing:" << name;
+        return nullptr;
+    }
 
-    return icons[name];
+    icon = new QIcon(paths[name]);
+    icons[name] = icon;
+    return icon;
 }
 
 bool IconManager::isMovie(const QString& name)
 {
-    return movies.contains(name);
+    return movieNames.contains(name);
 }
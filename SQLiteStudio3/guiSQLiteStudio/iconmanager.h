@@ -5,6 +5,7 @@
 #include "guiSQLiteStudio_global.h"
 #include <QStringList>
 #include <QHash>
+#include <QSet>
 #include <QIcon>
 #include <QVariant>
 
@@ -262,18 +263,28 @@ class GUI_API_EXPORT IconManager : public QObject
 
     private:
         IconManager();
-        void loadRecurently(QString dirPath, const QString& prefix, bool movie);
+        void loadRecurently(QString dirPath, const QString& prefix);
         void enableRescanning();
 
         static IconManager* instance;
+
+        /**
+         * @brief Icons created so far. Other icons are created on first call to getIcon().
+         */
         QHash<QString,QIcon*> icons;
+
+        /**
+         * @brief Movies created so far. Other movies are created on first call to getMovie().
+         */
         QHash<QString,QMovie*> movies;
+
         QHash<QString,QString> paths;
+        QSet<QString> movieNames;
         QStringList iconDirs;
         QStringList iconFileExtensions;
         QStringList movieFileExtensions;
-        QStringList resourceIcons;
-        QStringList resourceMovies;
+        QStringList fileNameFilters;
+        QSet<QString> resourceNames;
 
     private slots:
         void rescanResources(Plugin* plugin, PluginType* pluginType);
@@ -228,6 +228,39 @@ void MultiEditor::setValue(const QVariant& value)
     valueModified = false;
 }
 
+void MultiEditor::setBlob(const DbBlobPtr& blob)
+{
+    bool anySupported = findFirst<MultiEditorWidget>(editors, [](MultiEditorWidget* w) {return w->isBlobSupported();});
+    if (!anySupported)
+    {
+        MultiEditorWidget* hexEditor = new MultiEditorHex();
+        hexEditor->setTabLabel(tr("Hex"));
+        addEditor(hexEditor);
+    }
+
+    for (MultiEditorWidget* editorWidget : editors.toVector())
+    {
+        if (editorWidget->isBlobSupported())
+            continue;
+
+        editors.removeOne(editorWidget);
+        tabs->removeTab(tabs->indexOf(editorWidget));
+        editorWidget->deleteLater();
+    }
+
+    for (MultiEditorWidget* editorWidget : editors)
+    {
+        editorWidget->setBlob(blob);
+        editorWidget->setUpToDate(true);
+    }
+
+    showTab(0);
+    nullCheck->setChecked(false);
+    nullCheck->setEnabled(false);
+    valueBeforeNull.clear();
+    valueModified = false;
+}
+
 QVariant MultiEditor::getValue() const
 {
     if (nullCheck->isChecked())
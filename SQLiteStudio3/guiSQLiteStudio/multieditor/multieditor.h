@@ -3,6 +3,7 @@
 
 #include "guiSQLiteStudio_global.h"
 #include "datagrid/sqlquerymodelcolumn.h"
+#include "db/dbblob.h"
 #include <QWidget>
 #include <QVariant>
 
@@ -45,6 +46,15 @@ class GUI_API_EXPORT MultiEditor : public QWidget
 
         void setValue(const QVariant& value);
         QVariant getValue() const;
+
+        /**
+         * @brief Sets huge value to be presented using incremental BLOB handle.
+         * @param blob Opened BLOB handle.
+         *
+         * Only editors supporting BLOB handles are kept (the hex editor is added if none of them does).
+         * The value is never loaded into memory as a whole, therefore it cannot be edited, nor set to null.
+         */
+        void setBlob(const DbBlobPtr& blob);
         bool isModified() const;
         bool eventFilter(QObject* obj, QEvent* event);
         bool getReadOnly() const;
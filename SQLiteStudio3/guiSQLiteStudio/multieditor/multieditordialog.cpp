@@ -2,6 +2,7 @@
 #include "multieditor.h"
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
+#include <QPushButton>
 
 MultiEditorDialog::MultiEditorDialog(QWidget *parent) :
     QDialog(parent)
@@ -17,8 +18,15 @@ MultiEditorDialog::MultiEditorDialog(QWidget *parent) :
     buttonBox = new QDialogButtonBox(Qt::Horizontal);
     buttonBox->addButton(QDialogButtonBox::Ok);
     buttonBox->addButton(QDialogButtonBox::Cancel);
+    editFullValueButton = buttonBox->addButton(tr("Load entire value for editing"), QDialogButtonBox::ActionRole);
+    editFullValueButton->setVisible(false);
     vbox->addWidget(buttonBox);
 
+    connect(editFullValueButton, &QPushButton::clicked, [this]()
+    {
+        done(EDIT_FULL_VALUE);
+    });
+
     connect(buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
     connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
 }
@@ -38,6 +46,11 @@ QVariant MultiEditorDialog::getValue()
     return multiEditor->getValue();
 }
 
+void MultiEditorDialog::setBlob(const DbBlobPtr& blob)
+{
+    multiEditor->setBlob(blob);
+}
+
 void MultiEditorDialog::setDataType(const DataType& dataType)
 {
     multiEditor->setDataType(dataType);
@@ -47,3 +60,8 @@ void MultiEditorDialog::setReadOnly(bool readOnly)
 {
     multiEditor->setReadOnly(readOnly);
 }
+
+void MultiEditorDialog::setFullValueEditEnabled(bool enabled)
+{
+    editFullValueButton->setVisible(enabled);
+}
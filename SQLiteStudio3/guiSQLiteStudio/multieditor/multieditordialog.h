@@ -2,28 +2,46 @@
 #define MULTIEDITORDIALOG_H
 
 #include "datagrid/sqlquerymodelcolumn.h"
+#include "db/dbblob.h"
 #include "guiSQLiteStudio_global.h"
 #include <QDialog>
 
 class MultiEditor;
 class QDialogButtonBox;
+class QPushButton;
 
 class GUI_API_EXPORT MultiEditorDialog : public QDialog
 {
         Q_OBJECT
     public:
+        /**
+         * @brief Result of exec() when the user asked to edit the value presented with setBlob().
+         */
+        static const int EDIT_FULL_VALUE = 2;
+
         explicit MultiEditorDialog(QWidget *parent = 0);
         ~MultiEditorDialog();
 
         void setValue(const QVariant& value);
         QVariant getValue();
+        void setBlob(const DbBlobPtr& blob);
 
         void setDataType(const DataType& dataType);
         void setReadOnly(bool readOnly);
 
+        /**
+         * @brief Shows button for editing the value presented with setBlob().
+         * @param enabled true to show the button.
+         *
+         * The streamed value is read-only. When the button is clicked, the dialog is closed with EDIT_FULL_VALUE result,
+         * so the caller can load the entire value and edit it.
+         */
+        void setFullValueEditEnabled(bool enabled);
+
     private:
         MultiEditor* multiEditor = nullptr;
         QDialogButtonBox* buttonBox = nullptr;
+        QPushButton* editFullValueButton = nullptr;
 };
 
 #endif // MULTIEDITORDIALOG_H
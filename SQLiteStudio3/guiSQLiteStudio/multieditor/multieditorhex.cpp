@@ -1,7 +1,15 @@
 #include "multieditorhex.h"
 #include "qhexedit2/qhexedit.h"
 #include "common/unused.h"
+#include "iconmanager.h"
+#include "uiconfig.h"
+#include "services/notifymanager.h"
 #include <QVBoxLayout>
+#include <QToolBar>
+#include <QLabel>
+#include <QAction>
+#include <QFile>
+#include <QFileDialog>
 
 MultiEditorHex::MultiEditorHex()
 {
@@ -9,6 +17,16 @@ MultiEditorHex::MultiEditorHex()
     hexEdit = new QHexEdit();
     layout()->addWidget(hexEdit);
 
+    blobToolBar = new QToolBar();
+    prevPageAction = blobToolBar->addAction(ICONS.PAGE_PREV, tr("Previous page"), this, SLOT(prevBlobPage()));
+    nextPageAction = blobToolBar->addAction(ICONS.PAGE_NEXT, tr("Next page"), this, SLOT(nextBlobPage()));
+    blobPageLabel = new QLabel();
+    blobToolBar->addWidget(blobPageLabel);
+    blobToolBar->addSeparator();
+    blobToolBar->addAction(ICONS.SAVE_FILE, tr("Store in a file"), this, SLOT(saveBlob()));
+    blobToolBar->setVisible(false);
+    layout()->addWidget(blobToolBar);
+
     connect(hexEdit, SIGNAL(dataChanged()), this, SLOT(modificationChanged()));
     setFocusProxy(hexEdit);
 }
@@ -29,7 +47,7 @@ QVariant MultiEditorHex::getValue()
 
 void MultiEditorHex::setReadOnly(bool value)
 {
-    hexEdit->setReadOnly(value);
+    hexEdit->setReadOnly(value || blob);
 }
 
 void MultiEditorHex::focusThisWidget()
@@ -37,6 +55,73 @@ void MultiEditorHex::focusThisWidget()
     hexEdit->setFocus();
 }
 
+bool MultiEditorHex::isBlobSupported() const
+{
+    return true;
+}
+
+void MultiEditorHex::setBlob(const DbBlobPtr& blob)
+{
+    this->blob = blob;
+    blobToolBar->setVisible(!blob.isNull());
+    hexEdit->setReadOnly(true);
+    loadBlobPage(0);
+}
+
+void MultiEditorHex::loadBlobPage(qint64 offset)
+{
+    if (!blob)
+        return;
+
+    blobOffset = offset;
+    QByteArray page;
+    if (blob->seek(offset))
+        page = blob->read(BLOB_PAGE_SIZE);
+
+    hexEdit->setAddressOffset(static_cast<int>(offset));
+    hexEdit->setData(page);
+
+    qint64 size = blob->size();
+    blobPageLabel->setText(tr("Bytes %1 - %2 of %3").arg(offset).arg(offset + page.size()).arg(size));
+    prevPageAction->setEnabled(offset > 0);
+    nextPageAction->setEnabled(offset + BLOB_PAGE_SIZE < size);
+}
+
+void MultiEditorHex::prevBlobPage()
+{
+    loadBlobPage(qMax<qint64>(blobOffset - BLOB_PAGE_SIZE, 0));
+}
+
+void MultiEditorHex::nextBlobPage()
+{
+    loadBlobPage(blobOffset + BLOB_PAGE_SIZE);
+}
+
+void MultiEditorHex::saveBlob()
+{
+    if (!blob)
+        return;
+
+    QString dir = getFileDialogInitPath();
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save to file"), dir);
+    if (fileName.isNull())
+        return;
+
+    setFileDialogInitPathByFile(fileName);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        notifyError(tr("Could not open file %1 for writting.").arg(fileName));
+        return;
+    }
+
+    if (!blob->copyTo(&file))
+        notifyError(tr("Could not write data into the file %1").arg(fileName));
+
+    file.close();
+}
+
 QList<QWidget*> MultiEditorHex::getNoScrollWidgets()
 {
     return QList<QWidget*>();
@@ -9,6 +9,9 @@
 
 class QHexEdit;
 class QBuffer;
+class QToolBar;
+class QLabel;
+class QAction;
 
 class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
 {
@@ -21,14 +24,32 @@ class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
         QVariant getValue();
         void setReadOnly(bool value);
         void focusThisWidget();
+        bool isBlobSupported() const;
+        void setBlob(const DbBlobPtr& blob);
 
         QList<QWidget*> getNoScrollWidgets();
 
     private:
+        /**
+         * @brief Size of a single page of BLOB presented at once.
+         */
+        static const qint64 BLOB_PAGE_SIZE = 1024*1024;
+
+        void loadBlobPage(qint64 offset);
+
         QHexEdit* hexEdit = nullptr;
+        QToolBar* blobToolBar = nullptr;
+        QLabel* blobPageLabel = nullptr;
+        QAction* prevPageAction = nullptr;
+        QAction* nextPageAction = nullptr;
+        DbBlobPtr blob;
+        qint64 blobOffset = 0;
 
     private slots:
         void modificationChanged();
+        void prevBlobPage();
+        void nextBlobPage();
+        void saveBlob();
 };
 
 class GUI_API_EXPORT MultiEditorHexPlugin : public BuiltInPlugin, public MultiEditorWidgetPlugin
@@ -1,4 +1,5 @@
 #include "multieditorwidget.h"
+#include "common/unused.h"
 
 MultiEditorWidget::MultiEditorWidget(QWidget *parent) :
     QWidget(parent)
@@ -12,6 +13,16 @@ void MultiEditorWidget::installEventFilter(QObject* filterObj)
         w->installEventFilter(filterObj);
 }
 
+bool MultiEditorWidget::isBlobSupported() const
+{
+    return false;
+}
+
+void MultiEditorWidget::setBlob(const DbBlobPtr& blob)
+{
+    UNUSED(blob);
+}
+
 void MultiEditorWidget::setTabLabel(const QString& value)
 {
     tabLabel = value;
@@ -2,6 +2,7 @@
 #define MULTIEDITORWIDGET_H
 
 #include "guiSQLiteStudio_global.h"
+#include "db/dbblob.h"
 #include <QWidget>
 
 class GUI_API_EXPORT MultiEditorWidget : public QWidget
@@ -17,6 +18,25 @@ class GUI_API_EXPORT MultiEditorWidget : public QWidget
         virtual QList<QWidget*> getNoScrollWidgets() = 0;
         virtual void focusThisWidget() = 0;
 
+        /**
+         * @brief Tells whether the editor can work directly on the incremental BLOB handle.
+         * @return true if setBlob() is supported by this editor.
+         *
+         * Editors supporting this are used for values too big to be loaded into memory as a whole.
+         * Default implementation returns false.
+         */
+        virtual bool isBlobSupported() const;
+
+        /**
+         * @brief Sets BLOB handle as a source of value for the editor.
+         * @param blob Opened BLOB handle.
+         *
+         * It's called instead of setValue() for huge values, only for editors returning true from isBlobSupported().
+         * Editor should read from the handle in chunks and never load the whole value into memory.
+         * Default implementation does nothing.
+         */
+        virtual void setBlob(const DbBlobPtr& blob);
+
         void installEventFilter(QObject* filterObj);
 
         void setTabLabel(const QString& value);
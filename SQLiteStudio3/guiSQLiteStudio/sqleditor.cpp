@@ -11,6 +11,7 @@
 #include "common/utils_sql.h"
 #include "parser/lexer.h"
 #include "parser/parser.h"
+#include "parser/parsercheckpoints.h"
 #include "parser/parsererror.h"
 #include "common/unused.h"
 #include "services/notifymanager.h"
@@ -77,6 +78,15 @@ SqlEditor::~SqlEditor()
         delete queryParser;
         queryParser = nullptr;
     }
+
+    if (MEMORY_MANAGER)
+        MEMORY_MANAGER->deregisterConsumer(this);
+
+    if (completionCheckpoints)
+    {
+        delete completionCheckpoints;
+        completionCheckpoints = nullptr;
+    }
 }
 
 void SqlEditor::init()
@@ -119,6 +129,16 @@ void SqlEditor::init()
 
     queryParser = new Parser();
 
+    // Position in the document is never greater than in the virtual SQL, so it can be used for invalidation as it is.
+    completionCheckpoints = new ParserCheckpoints();
+    connect(document(), &QTextDocument::contentsChange, this, [this](int position, int charsRemoved, int charsAdded)
+    {
+        UNUSED(charsRemoved);
+        UNUSED(charsAdded);
+        completionCheckpoints->invalidateFrom(position);
+    });
+    MEMORY_MANAGER->registerConsumer(this);
+
     connect(this, &QWidget::customContextMenuRequested, this, &SqlEditor::customContextMenuRequested);
     connect(CFG_UI.Fonts.SqlEditor, SIGNAL(changed(QVariant)), this, SLOT(changeFont(QVariant)));
     connect(CFG, SIGNAL(massSaveCommitted()), this, SLOT(configModified()));
@@ -307,6 +327,26 @@ bool SqlEditor::getHighlightingSyntax() const
     return highlightingSyntax;
 }
 
+QString SqlEditor::getMemoryConsumerName() const
+{
+    if (db)
+        return tr("Completion state of SQL editor for database %1").arg(db->getName());
+
+    return tr("Completion state of SQL editor");
+}
+
+qint64 SqlEditor::getMemoryUsage() const
+{
+    return completionCheckpoints->getMemoryUsage();
+}
+
+qint64 SqlEditor::trimMemory()
+{
+    qint64 size = completionCheckpoints->getMemoryUsage();
+    completionCheckpoints->clear();
+    return size;
+}
+
 void SqlEditor::updateUndoAction(bool enabled)
 {
     actionMap[UNDO]->setEnabled(enabled);
@@ -498,6 +538,7 @@ void SqlEditor::complete()
 
     CompletionHelper completionHelper(sql, curPos, db);
     completionHelper.setCreateTriggerTable(createTriggerTable);
+    completionHelper.setParserCheckpoints(completionCheckpoints);
     CompletionHelper::Results result = completionHelper.getExpectedTokens();
     if (result.filtered().size() == 0)
         return;
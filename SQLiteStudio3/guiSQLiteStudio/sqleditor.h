@@ -4,6 +4,7 @@
 #include "guiSQLiteStudio_global.h"
 #include "common/extactioncontainer.h"
 #include "sqlitesyntaxhighlighter.h"
+#include "services/memorymanager.h"
 #include <QPlainTextEdit>
 #include <QTextEdit>
 #include <QFont>
@@ -13,6 +14,7 @@
 
 class CompleterWindow;
 class Parser;
+class ParserCheckpoints;
 class SqlEditor;
 class SearchTextDialog;
 class SearchTextLocator;
@@ -50,7 +52,7 @@ CFG_KEY_LIST(SqlEditor, QObject::tr("SQL editor input field"),
     CFG_KEY_ENTRY(TOGGLE_COMMENT,  Qt::CTRL + Qt::Key_Slash,          QObject::tr("Toggle comment"))
 )
 
-class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContainer
+class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContainer, public MemoryConsumer
 {
         Q_OBJECT
         Q_ENUMS(Action)
@@ -114,6 +116,10 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
 
         bool getHighlightingSyntax() const;
 
+        QString getMemoryConsumerName() const;
+        qint64 getMemoryUsage() const;
+        qint64 trimMemory();
+
         static QHash<Action, QAction*> staticActions;
         static bool wrapWords;
 
@@ -225,6 +231,7 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         bool deletionKeyPressed = false;
         LazyTrigger* queryParserTrigger = nullptr;
         Parser* queryParser = nullptr;
+        ParserCheckpoints* completionCheckpoints = nullptr;
         QHash<QString,QStringList> objectsInNamedDb;
         QMutex objectsInNamedDbMutex;
         bool objectLinksEnabled = false;
@@ -66,6 +66,7 @@ CFG_UI_CATEGORIES(Ui,
 
     CFG_CATEGORY(General,
         CFG_ENTRY(QString,               DataViewTabs,                QString())
+        CFG_ENTRY(bool,                  ShowExecutionProfile,        false)
         CFG_ENTRY(QString,               SqlEditorTabs,               QString())
         CFG_ENTRY(QString,               SqlEditorDbListOrder,        "LikeDbTree")
         CFG_ENTRY(bool,                  SqlEditorWrapWords,          false)
@@ -81,6 +82,9 @@ CFG_UI_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ShowVirtualTableLabels,      true)
         CFG_ENTRY(int,                   NumberOfRowsPerPage,         1000)
         CFG_ENTRY(bool,                  LimitRowsForManyColumns,     true)
+        CFG_ENTRY(int,                   ResultsCountingMode,         0)
+        CFG_ENTRY(int,                   LazyCountingLimit,           100000)
+        CFG_ENTRY(bool,                  SnapshotQueryResults,        false)
         CFG_ENTRY(QString,               Style,                       &Cfg::getStyleDefaultValue)
         CFG_ENTRY(Cfg::Session,          Session,                     Cfg::Session())
         CFG_ENTRY(bool,                  AllowMultipleSessions,       false)
@@ -13,6 +13,7 @@
 #include "plugins/scriptingplugin.h"
 #include "uiconfig.h"
 #include <QDesktopServices>
+#include <QLocale>
 #include <QSyntaxHighlighter>
 
 CollationsEditor::CollationsEditor(QWidget *parent) :
@@ -102,10 +103,22 @@ void CollationsEditor::init()
     connect(ui->allDatabasesRadio, SIGNAL(clicked()), this, SLOT(updateModified()));
     connect(ui->selectedDatabasesRadio, SIGNAL(clicked()), this, SLOT(updateModified()));
     connect(ui->langCombo, SIGNAL(currentTextChanged(QString)), this, SLOT(updateModified()));
+    connect(ui->typeCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(updateModified()));
+    connect(ui->localeCombo, SIGNAL(currentTextChanged(QString)), this, SLOT(updateModified()));
 
     connect(dbListModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(updateModified()));
     connect(CFG_UI.Fonts.SqlEditor, SIGNAL(changed(QVariant)), this, SLOT(changeFont(QVariant)));
 
+    // Collation types
+    ui->typeCombo->addItem(tr("Comparison function"), static_cast<int>(CollationManager::CollationType::FUNCTION_BASED));
+    ui->typeCombo->addItem(tr("Sort key function"), static_cast<int>(CollationManager::CollationType::SORT_KEY_BASED));
+    ui->typeCombo->addItem(tr("Locale"), static_cast<int>(CollationManager::CollationType::LOCALE_BASED));
+    ui->typeCombo->setItemData(0, tr("Code compares two values (arguments: first, second) and returns -1, 0 or 1."), Qt::ToolTipRole);
+    ui->typeCombo->setItemData(1, tr("Code returns a sort key for a single value (argument: value). "
+                                     "Keys are compared byte by byte and calculated only once per distinct value, which is much faster for large data."), Qt::ToolTipRole);
+    ui->typeCombo->setItemData(2, tr("Values are compared according to the rules of the selected language. No code is needed."), Qt::ToolTipRole);
+    initLocales();
+
     // Language plugins
     for (ScriptingPlugin* plugin : PLUGINS->getLoadedPlugins<ScriptingPlugin>())
         ui->langCombo->addItem(plugin->getLanguage());
@@ -129,7 +142,9 @@ int CollationsEditor::getCurrentCollationRow() const
 void CollationsEditor::collationDeselected(int row)
 {
     model->setName(row, ui->nameEdit->text());
+    model->setType(row, getCurrentType());
     model->setLang(row, ui->langCombo->currentText());
+    model->setLocale(row, ui->localeCombo->currentText());
     model->setAllDatabases(row, ui->allDatabasesRadio->isChecked());
     model->setCode(row, ui->codeEdit->toPlainText());
     model->setModified(row, currentModified);
@@ -145,7 +160,9 @@ void CollationsEditor::collationSelected(int row)
     updatesForSelection = true;
     ui->nameEdit->setText(model->getName(row));
     ui->codeEdit->setPlainText(model->getCode(row));
+    setCurrentType(model->getType(row));
     ui->langCombo->setCurrentText(model->getLang(row));
+    ui->localeCombo->setCurrentText(model->getLocale(row));
 
     // Databases
     dbListModel->setDatabases(model->getDatabases(row));
@@ -169,6 +186,8 @@ void CollationsEditor::clearEdits()
     ui->langCombo->setCurrentText(QString());
     ui->allDatabasesRadio->setChecked(true);
     ui->langCombo->setCurrentIndex(-1);
+    setCurrentType(CollationManager::CollationType::FUNCTION_BASED);
+    ui->localeCombo->setCurrentText(QString());
 }
 
 void CollationsEditor::selectCollation(int row)
@@ -184,6 +203,28 @@ QStringList CollationsEditor::getCurrentDatabases() const
     return dbListModel->getDatabases();
 }
 
+CollationManager::CollationType CollationsEditor::getCurrentType() const
+{
+    return static_cast<CollationManager::CollationType>(ui->typeCombo->currentData().toInt());
+}
+
+void CollationsEditor::setCurrentType(CollationManager::CollationType type)
+{
+    ui->typeCombo->setCurrentIndex(ui->typeCombo->findData(static_cast<int>(type)));
+}
+
+void CollationsEditor::initLocales()
+{
+    QStringList names;
+    for (const QLocale& locale : QLocale::matchingLocales(QLocale::AnyLanguage, QLocale::AnyScript, QLocale::AnyCountry))
+        names << locale.name();
+
+    names.removeDuplicates();
+    names.sort();
+    ui->localeCombo->addItems(names);
+    ui->localeCombo->setToolTip(tr("Locale name, like en_US. When empty, the system locale is used."));
+}
+
 void CollationsEditor::setFont(const QFont& font)
 {
     ui->codeEdit->setFont(font);
@@ -283,15 +324,21 @@ void CollationsEditor::updateCurrentCollationState()
     bool nameOk = model->isAllowedName(row, name) && !name.trimmed().isEmpty();
     setValidState(ui->nameEdit, nameOk, tr("Enter a non-empty, unique name of the collation."));
 
-    bool langOk = ui->langCombo->currentIndex() >= 0;
-    ui->codeGroup->setEnabled(langOk);
+    bool localeBased = (getCurrentType() == CollationManager::CollationType::LOCALE_BASED);
+    ui->langCombo->setEnabled(!localeBased);
+    ui->langLabel->setEnabled(!localeBased);
+    ui->localeCombo->setEnabled(localeBased);
+    ui->localeLabel->setEnabled(localeBased);
+
+    bool langOk = localeBased || ui->langCombo->currentIndex() >= 0;
+    ui->codeGroup->setEnabled(langOk && !localeBased);
     ui->databasesGroup->setEnabled(langOk);
     ui->nameEdit->setEnabled(langOk);
     ui->nameLabel->setEnabled(langOk);
     ui->databaseList->setEnabled(ui->selectedDatabasesRadio->isChecked());
     setValidState(ui->langCombo, langOk, tr("Pick the implementation language."));
 
-    bool codeOk = !ui->codeEdit->toPlainText().trimmed().isEmpty();
+    bool codeOk = localeBased || !ui->codeEdit->toPlainText().trimmed().isEmpty();
     setValidState(ui->codeEdit, codeOk, tr("Enter a non-empty implementation code."));
 
     // Syntax highlighter
@@ -350,10 +397,12 @@ void CollationsEditor::updateModified()
         bool nameDiff = model->getName(row) != ui->nameEdit->text();
         bool codeDiff = model->getCode(row) != ui->codeEdit->toPlainText();
         bool langDiff = model->getLang(row) != ui->langCombo->currentText();
+        bool typeDiff = model->getType(row) != getCurrentType();
+        bool localeDiff = model->getLocale(row) != ui->localeCombo->currentText();
         bool allDatabasesDiff = model->getAllDatabases(row) != ui->allDatabasesRadio->isChecked();
         bool dbDiff = toSet(getCurrentDatabases()) != toSet(model->getDatabases(row)); // QSet to ignore order
 
-        currentModified = (nameDiff || codeDiff || langDiff || allDatabasesDiff || dbDiff);
+        currentModified = (nameDiff || codeDiff || langDiff || typeDiff || localeDiff || allDatabasesDiff || dbDiff);
     }
 
     updateCurrentCollationState();
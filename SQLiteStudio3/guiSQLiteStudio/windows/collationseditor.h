@@ -60,6 +60,9 @@ class GUI_API_EXPORT CollationsEditor : public MdiChild
         void clearEdits();
         void selectCollation(int row);
         QStringList getCurrentDatabases() const;
+        CollationManager::CollationType getCurrentType() const;
+        void setCurrentType(CollationManager::CollationType type);
+        void initLocales();
         void setFont(const QFont& font);
 
         Ui::CollationsEditor *ui = nullptr;
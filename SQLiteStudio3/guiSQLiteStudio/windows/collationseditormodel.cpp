@@ -69,6 +69,16 @@ QString CollationsEditorModel::getName(int row) const
     GETTER(collationList[row]->data->name, QString());
 }
 
+void CollationsEditorModel::setType(int row, CollationManager::CollationType type)
+{
+    SETTER(collationList[row]->data->type, type);
+}
+
+CollationManager::CollationType CollationsEditorModel::getType(int row) const
+{
+    GETTER(collationList[row]->data->type, CollationManager::CollationType::FUNCTION_BASED);
+}
+
 void CollationsEditorModel::setLang(int row, const QString& lang)
 {
     SETTER(collationList[row]->data->lang, lang);
@@ -79,6 +89,16 @@ QString CollationsEditorModel::getLang(int row) const
     GETTER(collationList[row]->data->lang, QString());
 }
 
+void CollationsEditorModel::setLocale(int row, const QString& locale)
+{
+    SETTER(collationList[row]->data->locale, locale);
+}
+
+QString CollationsEditorModel::getLocale(int row) const
+{
+    GETTER(collationList[row]->data->locale, QString());
+}
+
 void CollationsEditorModel::setAllDatabases(int row, bool allDatabases)
 {
     SETTER(collationList[row]->data->allDatabases, allDatabases);
@@ -14,6 +14,7 @@
 #include "common/extaction.h"
 #include "uiconfig.h"
 #include "services/config.h"
+#include "sqlhistorymodel.h"
 #include "parser/lexer.h"
 #include "common/utils_sql.h"
 #include "parser/parser.h"
@@ -21,6 +22,7 @@
 #include "dialogs/exportdialog.h"
 #include "themetuner.h"
 #include "dialogs/bindparamsdialog.h"
+#include "dialogs/multidbquerydialog.h"
 #include "common/bindparam.h"
 #include "common/dbcombobox.h"
 #include <QComboBox>
@@ -98,6 +100,7 @@ void EditorWindow::init()
                                      });
 
     resultsModel = new SqlQueryModel(this);
+    resultsModel->setSnapshotMode(CFG_UI.General.SnapshotQueryResults.get());
     ui->dataView->init(resultsModel);
 
     createDbCombo();
@@ -124,13 +127,16 @@ void EditorWindow::init()
     connect(resultsModel, SIGNAL(storeExecutionInHistory()), this, SLOT(storeExecutionInHistory()));
 
     // SQL history list
-    ui->historyList->setModel(CFG->getSqlHistoryModel());
+    SqlHistoryModel* sqlHistoryModel = CFG->createSqlHistoryModel(this);
+    ui->historyList->setModel(sqlHistoryModel);
     ui->historyList->hideColumn(0);
+    ui->historyList->hideColumn(6);
     ui->historyList->resizeColumnToContents(1);
     connect(ui->historyList->selectionModel(), SIGNAL(currentRowChanged(QModelIndex,QModelIndex)),
             this, SLOT(historyEntrySelected(QModelIndex,QModelIndex)));
     connect(ui->historyList, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(historyEntryActivated(QModelIndex)));
     connect(ui->historyList, &QWidget::customContextMenuRequested, this, &EditorWindow::sqlHistoryContextMenuRequested);
+    connect(ui->historyFilterEdit, &QLineEdit::textChanged, sqlHistoryModel, &SqlHistoryModel::setFilter);
 
     updateState();
 }
@@ -380,6 +386,8 @@ void EditorWindow::createActions()
     ui->toolBar->addSeparator();
     createAction(EXEC_QUERY, ICONS.EXEC_QUERY, tr("Execute query"), this, SLOT(execQuery()), ui->toolBar, ui->sqlEdit);
     createAction(EXPLAIN_QUERY, ICONS.EXPLAIN_QUERY, tr("Explain query"), this, SLOT(explainQuery()), ui->toolBar, ui->sqlEdit);
+    createAction(PROFILE_QUERY, ICONS.STATUS_INFO, tr("Execute and profile query"), this, SLOT(profileQuery()), ui->toolBar, ui->sqlEdit);
+    createAction(EXEC_ON_MULTIPLE_DBS, ICONS.DATABASE, tr("Execute query on multiple databases"), this, SLOT(execOnMultipleDbs()), ui->toolBar, ui->sqlEdit);
     ui->toolBar->addSeparator();
     ui->toolBar->addAction(ui->sqlEdit->getAction(SqlEditor::FORMAT_SQL));
     createAction(CLEAR_HISTORY, ICONS.CLEAR_HISTORY, tr("Clear execution history", "sql editor"), this, SLOT(clearHistory()), ui->toolBar);
@@ -461,7 +469,7 @@ void EditorWindow::updateShortcutTips()
     }
 }
 
-void EditorWindow::execQuery(bool explain, QueryExecMode querySelectionMode)
+void EditorWindow::execQuery(bool explain, QueryExecMode querySelectionMode, bool profile)
 {
     QString sql = getQueryToExecute(true, querySelectionMode);
     QHash<QString, QVariant> bindParams;
@@ -471,6 +479,7 @@ void EditorWindow::execQuery(bool explain, QueryExecMode querySelectionMode)
 
     resultsModel->setDb(getCurrentDb());
     resultsModel->setExplainMode(explain);
+    resultsModel->setEngineProfiling(profile);
     resultsModel->setQuery(sql);
     resultsModel->setParams(bindParams);
     resultsModel->setQueryCountLimitForSmartMode(queryLimitForSmartExecution);
@@ -500,6 +509,17 @@ void EditorWindow::explainQuery()
     execQuery(true);
 }
 
+void EditorWindow::profileQuery()
+{
+    execQuery(false, DEFAULT, true);
+}
+
+void EditorWindow::execOnMultipleDbs()
+{
+    MultiDbQueryDialog dialog(getCurrentDb(), getQueryToExecute(), MAINWINDOW);
+    dialog.exec();
+}
+
 bool EditorWindow::processBindParams(QString& sql, QHash<QString, QVariant>& queryParams)
 {
     // Get all bind parameters from the query
@@ -580,7 +600,8 @@ void EditorWindow::executionSuccessful()
         notifyInfo(tr("Query finished in %1 second(s).").arg(time));
     }
 
-    lastQueryHistoryId = CFG->addSqlHistory(resultsModel->getQuery(), resultsModel->getDb()->getName(), resultsModel->getExecutionTime(), 0);
+    lastQueryHistoryId = CFG->addSqlHistory(resultsModel->getQuery(), resultsModel->getDb()->getName(), resultsModel->getExecutionTime(), 0,
+                                              resultsModel->getExecutionProfile().toJson());
 
     // If we added first history entry - resize dates column.
     if (ui->historyList->model()->rowCount() == 1)
@@ -611,7 +632,8 @@ void EditorWindow::storeExecutionInHistory()
     else
         rows = rowsAffected;
 
-    CFG->updateSqlHistory(lastQueryHistoryId, resultsModel->getQuery(), resultsModel->getDb()->getName(), resultsModel->getExecutionTime(), rows);
+    CFG->updateSqlHistory(lastQueryHistoryId, resultsModel->getQuery(), resultsModel->getDb()->getName(), resultsModel->getExecutionTime(), rows,
+                          resultsModel->getExecutionProfile().toJson());
 }
 
 void EditorWindow::prevDb()
@@ -752,6 +774,8 @@ void EditorWindow::updateState()
     actionMap[CURRENT_DB]->setEnabled(!executionInProgress);
     actionMap[EXEC_QUERY]->setEnabled(!executionInProgress);
     actionMap[EXPLAIN_QUERY]->setEnabled(!executionInProgress);
+    actionMap[PROFILE_QUERY]->setEnabled(!executionInProgress);
+    actionMap[EXEC_ON_MULTIPLE_DBS]->setEnabled(!executionInProgress);
 }
 
 void EditorWindow::checkTextChangedForSession()
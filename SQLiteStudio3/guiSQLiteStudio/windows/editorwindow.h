@@ -29,6 +29,7 @@ CFG_KEY_LIST(EditorWindow, QObject::tr("SQL editor window"),
      CFG_KEY_ENTRY(EXEC_ONE_QUERY,            Qt::CTRL + Qt::Key_F9,      QObject::tr("Execute single query under cursor"))
      CFG_KEY_ENTRY(EXEC_ALL_QUERIES,          Qt::SHIFT + Qt::Key_F9,     QObject::tr("Execute all queries in editor"))
      CFG_KEY_ENTRY(EXPLAIN_QUERY,             Qt::Key_F8,                 QObject::tr("Execute \"%1\" query").arg("EXPLAIN"))
+     CFG_KEY_ENTRY(PROFILE_QUERY,             Qt::SHIFT + Qt::Key_F8,     QObject::tr("Execute query and profile it"))
      CFG_KEY_ENTRY(PREV_DB,                   Qt::CTRL + Qt::Key_Up,      QObject::tr("Switch current working database to previous on the list"))
      CFG_KEY_ENTRY(NEXT_DB,                   Qt::CTRL + Qt::Key_Down,    QObject::tr("Switch current working database to next on the list"))
      CFG_KEY_ENTRY(SHOW_NEXT_TAB,             Qt::ALT + Qt::Key_Right,    QObject::tr("Go to next editor tab"))
@@ -56,6 +57,8 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
             EXEC_ONE_QUERY,
             EXEC_ALL_QUERIES,
             EXPLAIN_QUERY,
+            PROFILE_QUERY,
+            EXEC_ON_MULTIPLE_DBS,
             RESULTS_IN_TAB,
             RESULTS_BELOW,
             CURRENT_DB,
@@ -148,10 +151,12 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
         bool settingSqlContents = false;
 
     private slots:
-        void execQuery(bool explain = false, QueryExecMode querySelectionMode = DEFAULT);
+        void execQuery(bool explain = false, QueryExecMode querySelectionMode = DEFAULT, bool profile = false);
         void execOneQuery();
         void execAllQueries();
         void explainQuery();
+        void profileQuery();
+        void execOnMultipleDbs();
         void dbChanged();
         void executionSuccessful();
         void executionFailed(const QString& errorText);
@@ -354,6 +354,10 @@ void TableWindow::executeStructureChanges()
             for (QString& warn : tableModifier->getWarnings())
                 dialog.addWarning(warn);
 
+            if (tableModifier->getStrategy() == TableModifier::Strategy::REBUILD && tableModifier->getEstimatedRowsToCopy() > 0)
+                dialog.addInfo(tr("The table will be recreated and approximately %1 rows will be copied.", "table window")
+                               .arg(tableModifier->getEstimatedRowsToCopy()));
+
             if (dialog.exec() != QDialog::Accepted)
                 return;
         }
@@ -27,6 +27,7 @@
 #include "dialogs/triggerdialog.h"
 #include "services/pluginmanager.h"
 #include "singleapplication/singleapplication.h"
+#include "common/startuptrace.h"
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 #include <QApplication>
@@ -61,6 +62,7 @@ QString uiHandleCmdLineArgs(bool applyOptions = true)
     QCommandLineOption executorDebugOption("debug-query-executor", QObject::tr("Enables debugging of SQLiteStudio's query executor."));
     QCommandLineOption listPluginsOption("list-plugins", QObject::tr("Lists plugins installed in the SQLiteStudio and quits."));
     QCommandLineOption masterConfigOption("master-config", QObject::tr("Points to the master configuration file. Read manual at wiki page for more details."), QObject::tr("SQLiteStudio settings file"));
+    QCommandLineOption startupTraceOption("startup-trace", QObject::tr("Measures durations of startup phases and writes them into given file, in the Chrome Trace Event format."), QObject::tr("trace file"));
     parser.addOption(debugOption);
     parser.addOption(debugStdOutOption);
     parser.addOption(debugFileOption);
@@ -70,6 +72,7 @@ QString uiHandleCmdLineArgs(bool applyOptions = true)
     parser.addOption(executorDebugOption);
     parser.addOption(masterConfigOption);
     parser.addOption(listPluginsOption);
+    parser.addOption(startupTraceOption);
 
     parser.addPositionalArgument(QObject::tr("file"), QObject::tr("Database file to open"));
 
@@ -90,6 +93,9 @@ QString uiHandleCmdLineArgs(bool applyOptions = true)
 
         if (parser.isSet(masterConfigOption))
             Config::setMasterConfigFile(parser.value(masterConfigOption));
+
+        if (parser.isSet(startupTraceOption))
+            StartupTrace::enable(parser.value(startupTraceOption));
     }
 
     QStringList args = parser.positionalArguments();
@@ -152,6 +158,8 @@ int main(int argc, char *argv[])
     SQLITESTUDIO->setInitialTranslationFiles({"coreSQLiteStudio", "guiSQLiteStudio", "sqlitestudio"});
     SQLITESTUDIO->init(a.arguments(), true);
     IconManager::getInstance()->init();
+
+    StartupTrace::Scope trace("GUI static init");
     DbTree::staticInit();
     DataView::staticInit();
     EditorWindow::staticInit();
@@ -164,9 +172,11 @@ int main(int argc, char *argv[])
     TriggerDialog::staticInit();
     SqlEditor::staticInit();
 
+    trace.next("Main window");
     MainWindow* mainWin = MAINWINDOW;
 
     QObject::connect(&a, &SingleApplication::receivedMessage, mainWin, &MainWindow::messageFromSecondaryInstance);
+    trace.end();
 
     SQLITESTUDIO->initPlugins();
 
@@ -178,7 +188,9 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    trace.next("Icons rescan");
     IconManager::getInstance()->rescanResources();
+    trace.end();
 
     if (!LanguageDialog::didAskForDefaultLanguage() && !SQLITESTUDIO->getConfig()->isInMemory())
     {
@@ -199,12 +211,16 @@ int main(int argc, char *argv[])
     // while translation files were not loaded yet. Now they are.
     ExtActionContainer::refreshShortcutTranslations();
 
+    trace.next("Session restore");
     MainWindow::getInstance()->restoreSession();
     MainWindow::getInstance()->show();
 
     if (!dbToOpen.isNull())
         MainWindow::getInstance()->openDb(dbToOpen);
 
+    trace.end();
+    StartupTrace::finish();
+
 #ifdef PORTABLE_CONFIG
     UPDATES->checkForUpdates();
 #endif
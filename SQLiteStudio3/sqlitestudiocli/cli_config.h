@@ -30,6 +30,7 @@ CFG_CATEGORIES(Cli,
         CFG_ENTRY(QString,                 CommandPrefixChar,  ".")
         CFG_ENTRY(CliResultsDisplay::Mode, ResultsDisplayMode, CliResultsDisplay::CLASSIC)
         CFG_ENTRY(QString,                 NullValue,          "")
+        CFG_ENTRY(bool,                    Timer,              false)
     )
 )
 
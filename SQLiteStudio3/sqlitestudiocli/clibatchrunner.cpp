@@ -0,0 +1,400 @@
+#include "clibatchrunner.h"
+#include "cli_config.h"
+#include "qio.h"
+#include "exportworker.h"
+#include "db/db.h"
+#include "db/queryexecutor.h"
+#include "db/sqlresultsrow.h"
+#include "services/dbmanager.h"
+#include "services/exportmanager.h"
+#include "services/importmanager.h"
+#include "services/notifymanager.h"
+#include "plugins/exportplugin.h"
+#include "plugins/importplugin.h"
+#include "common/utils.h"
+#include "common/utils_sql.h"
+#include "common/unused.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScopedPointer>
+#include <cstdio>
+
+bool CliBatchRunner::Options::isBatchRequested() const
+{
+    return !sqlFile.isNull() || !query.isNull() || !importFormat.isNull() || !exportFormat.isNull();
+}
+
+CliBatchRunner::CliBatchRunner(const Options& options, QObject* parent) :
+    QObject(parent), options(options)
+{
+    connect(NOTIFY_MANAGER, SIGNAL(notifyError(QString)), this, SLOT(printNotifiedError(QString)));
+    connect(NOTIFY_MANAGER, SIGNAL(notifyWarning(QString)), this, SLOT(printNotifiedWarning(QString)));
+}
+
+int CliBatchRunner::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!validateOptions())
+    {
+        printTiming(INVALID_ARGUMENTS);
+        return INVALID_ARGUMENTS;
+    }
+
+    if (!openDb())
+    {
+        printTiming(DB_ERROR);
+        return DB_ERROR;
+    }
+
+    if (!readQueries())
+    {
+        printTiming(INVALID_ARGUMENTS);
+        return INVALID_ARGUMENTS;
+    }
+    timing.prepare = timer.elapsed();
+
+    if (!options.importFormat.isNull() && !importData())
+    {
+        printTiming(IMPORT_ERROR);
+        return IMPORT_ERROR;
+    }
+
+    if (queries.isEmpty())
+    {
+        printTiming(SUCCESS);
+        return SUCCESS;
+    }
+
+    if (!execPrecedingQueries())
+    {
+        printTiming(EXECUTION_ERROR);
+        return EXECUTION_ERROR;
+    }
+
+    int exitCode = SUCCESS;
+    if (options.exportFormat.isNull())
+    {
+        if (!execAndPrintLastQuery())
+            exitCode = EXECUTION_ERROR;
+    }
+    else if (!execAndExportLastQuery())
+    {
+        exitCode = EXPORT_ERROR;
+    }
+
+    printTiming(exitCode);
+    return exitCode;
+}
+
+bool CliBatchRunner::validateOptions()
+{
+    if (options.database.isEmpty())
+    {
+        error(tr("Database (name or file path) has to be specified for batch execution."));
+        return false;
+    }
+
+    if (!options.sqlFile.isNull() && !options.query.isNull())
+    {
+        error(tr("SQL file and SQL query cannot be both specified for batch execution. Use one of them."));
+        return false;
+    }
+
+    if (!options.exportFormat.isNull() && options.sqlFile.isNull() && options.query.isNull())
+    {
+        error(tr("Export requires SQL file or SQL query, which results will be exported."));
+        return false;
+    }
+
+    if (!options.importFormat.isNull() && (options.importFile.isEmpty() || options.importTable.isEmpty()))
+    {
+        error(tr("Import requires both input file and target table to be specified."));
+        return false;
+    }
+
+    if (!options.exportFormat.isNull() && !EXPORT_MANAGER->getPluginForFormat(options.exportFormat))
+    {
+        error(tr("Export format '%1' is not supported. Supported formats are: %2.")
+              .arg(options.exportFormat, EXPORT_MANAGER->getAvailableFormats(ExportManager::QUERY_RESULTS).join(", ")));
+        return false;
+    }
+
+    if (!options.importFormat.isNull() && !IMPORT_MANAGER->getPluginForDataSourceType(options.importFormat))
+    {
+        error(tr("Import data source type '%1' is not supported. Supported types are: %2.")
+              .arg(options.importFormat, IMPORT_MANAGER->getImportDataSourceTypes().join(", ")));
+        return false;
+    }
+
+    return true;
+}
+
+bool CliBatchRunner::openDb()
+{
+    db = DBLIST->getByName(options.database);
+    if (!db)
+    {
+        QString path = QFileInfo(options.database).absoluteFilePath();
+        db = DBLIST->getByPath(path);
+        if (!db)
+        {
+            QString name = DBLIST->generateUniqueDbName(path);
+            if (name.isNull() || !DBLIST->addDb(name, path, false))
+            {
+                error(tr("Could not find database named '%1', nor could open it as a file.").arg(options.database));
+                return false;
+            }
+            db = DBLIST->getByName(name);
+        }
+    }
+
+    if (!db || !db->isValid())
+    {
+        error(tr("Database '%1' cannot be used, because it's not supported by any of loaded database plugins.").arg(options.database));
+        return false;
+    }
+
+    if (!db->isOpen() && !db->open())
+    {
+        error(tr("Could not open database '%1': %2").arg(options.database, db->getErrorText()));
+        return false;
+    }
+
+    return true;
+}
+
+bool CliBatchRunner::readQueries()
+{
+    QString sql = options.query;
+    if (!options.sqlFile.isNull())
+    {
+        QString err;
+        sql = readFileContents(options.sqlFile, &err);
+        if (!err.isNull())
+        {
+            error(err);
+            return false;
+        }
+    }
+
+    if (sql.isNull())
+        return true;
+
+    queries = quickSplitQueries(sql, false, true);
+    return true;
+}
+
+bool CliBatchRunner::importData()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ImportPlugin* plugin = IMPORT_MANAGER->getPluginForDataSourceType(options.importFormat);
+    plugin->validateOptions();
+
+    ImportManager::StandardImportConfig config;
+    config.inputFileName = options.importFile;
+    config.codec = options.codec.isEmpty() ? defaultCodecName() : options.codec;
+
+    bool success = false;
+    auto successConn = connect(IMPORT_MANAGER, &ImportManager::importSuccessful, [&success]()
+    {
+        success = true;
+    });
+
+    IMPORT_MANAGER->configure(options.importFormat, config);
+    IMPORT_MANAGER->importToTable(db, options.importTable, false);
+    disconnect(successConn);
+
+    timing.import = timer.elapsed();
+    if (!success)
+        error(tr("Could not import data from file '%1' into table '%2'.").arg(options.importFile, options.importTable));
+
+    return success;
+}
+
+bool CliBatchRunner::execPrecedingQueries()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SqlQueryPtr results;
+    for (int i = 0, total = queries.size() - 1; i < total; i++)
+    {
+        results = db->exec(queries[i]);
+        timing.statements++;
+        if (results->isError())
+        {
+            timing.exec += timer.elapsed();
+            error(tr("Error while executing statement #%1: %2").arg(i + 1).arg(results->getErrorText()));
+            return false;
+        }
+    }
+
+    timing.exec += timer.elapsed();
+    return true;
+}
+
+bool CliBatchRunner::execAndPrintLastQuery()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QueryExecutor executor(db, queries.last());
+    executor.setAsyncMode(false);
+    executor.setNoMetaColumns(true);
+    executor.setSkipRowCounting(true);
+
+    QString errorText;
+    connect(&executor, &QueryExecutor::executionFailed, [&errorText](int code, const QString& msg)
+    {
+        UNUSED(code);
+        errorText = msg;
+    });
+
+    executor.exec();
+    timing.statements++;
+    timing.exec += timer.elapsed();
+
+    SqlQueryPtr results = executor.getResults();
+    if (!errorText.isNull() || !results || results->isError())
+    {
+        if (errorText.isNull() && results)
+            errorText = results->getErrorText();
+
+        error(tr("Error while executing statement #%1: %2").arg(queries.size()).arg(errorText));
+        return false;
+    }
+
+    timer.restart();
+    printResults(&executor, results);
+    timing.fetch = timer.elapsed();
+    return true;
+}
+
+bool CliBatchRunner::execAndExportLastQuery()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ExportPlugin* plugin = EXPORT_MANAGER->getPluginForFormat(options.exportFormat);
+    plugin->setExportMode(ExportManager::QUERY_RESULTS);
+    plugin->validateOptions();
+
+    ExportManager::StandardExportConfig* config = new ExportManager::StandardExportConfig();
+    config->outputFileName = options.exportFile;
+    config->codec = options.codec;
+    if (config->codec.isEmpty())
+        config->codec = plugin->getDefaultEncoding();
+
+    if (config->codec.isEmpty())
+        config->codec = defaultCodecName();
+
+    QIODevice::OpenMode openMode = QIODevice::WriteOnly|QIODevice::Truncate;
+    if (!plugin->isBinaryData())
+        openMode |= QIODevice::Text;
+
+    // Empty or "-" output file means the standard output, so the export can be piped.
+    QScopedPointer<QFile> output(new QFile(options.exportFile));
+    bool opened = (options.exportFile.isEmpty() || options.exportFile == "-") ? output->open(stdout, openMode) : output->open(openMode);
+    if (!opened)
+    {
+        error(tr("Could not export to file %1. File cannot be open for writting.").arg(options.exportFile));
+        delete config;
+        return false;
+    }
+
+    bool success = false;
+    ExportWorker worker(plugin, config, output.data());
+    worker.setAutoDelete(false);
+    connect(&worker, &ExportWorker::finished, [&success](bool result, QIODevice* device)
+    {
+        UNUSED(device);
+        success = result;
+    });
+    worker.prepareExportQueryResults(db, queries.last());
+    worker.run();
+    output->close();
+    delete config;
+
+    const ExportWorker::Statistics& stats = worker.getStatistics();
+    timing.statements++;
+    timing.exec += stats.executionTime;
+    timing.fetch = stats.fetchTime;
+    timing.rows = stats.rowCount;
+    timing.exportTime = timer.elapsed() - stats.executionTime - stats.fetchTime;
+
+    if (!success)
+        error(tr("Export of query results using format '%1' failed.").arg(options.exportFormat));
+
+    return success;
+}
+
+void CliBatchRunner::printResults(QueryExecutor* executor, SqlQueryPtr results)
+{
+    int resultColumnCount = executor->getResultColumns().size();
+    if (resultColumnCount == 0)
+        return;
+
+    QStringList line;
+    for (const QueryExecutor::ResultColumnPtr& resCol : executor->getResultColumns())
+        line << resCol->displayName;
+
+    qOut << line.join("|") << "\n";
+
+    QString nullValue = CFG_CLI.Console.NullValue.get();
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        line.clear();
+        for (const QVariant& value : row->valueList().mid(0, resultColumnCount))
+            line << ((value.isValid() && !value.isNull()) ? value.toString() : nullValue);
+
+        qOut << line.join("|") << "\n";
+        timing.rows++;
+    }
+    qOut.flush();
+}
+
+void CliBatchRunner::printTiming(int exitCode)
+{
+    if (!options.printTiming)
+        return;
+
+    QJsonObject summary;
+    summary["prepare_ms"] = timing.prepare;
+    summary["import_ms"] = timing.import;
+    summary["exec_ms"] = timing.exec;
+    summary["fetch_ms"] = timing.fetch;
+    summary["export_ms"] = timing.exportTime;
+    summary["statements"] = timing.statements;
+    summary["rows"] = timing.rows;
+    summary["exit_code"] = exitCode;
+
+    qErr << QString::fromUtf8(QJsonDocument(summary).toJson(QJsonDocument::Compact)) << "\n";
+    qErr.flush();
+}
+
+void CliBatchRunner::error(const QString& msg)
+{
+    qErr << msg << "\n";
+    qErr.flush();
+}
+
+void CliBatchRunner::printNotifiedError(const QString& msg)
+{
+    static_qstring(tpl, "[ERROR] %1");
+    error(tpl.arg(msg));
+}
+
+void CliBatchRunner::printNotifiedWarning(const QString& msg)
+{
+    static_qstring(tpl, "[WARNING] %1");
+    error(tpl.arg(msg));
+}
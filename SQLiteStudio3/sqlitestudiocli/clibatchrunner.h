@@ -0,0 +1,99 @@
+#ifndef CLIBATCHRUNNER_H
+#define CLIBATCHRUNNER_H
+
+#include "db/sqlquery.h"
+#include <QObject>
+#include <QStringList>
+
+class Db;
+class QueryExecutor;
+
+/**
+ * @brief Non-interactive (headless) execution of the CLI client.
+ *
+ * It's used when the sqlitestudiocli is started with any of batch options (like --execute or --command).
+ * Instead of starting interactive console it executes SQL script file or single query on the given database,
+ * optionally imports data before that and/or exports results of the last statement, then it quits
+ * with one of ExitCode values.
+ *
+ * Results of the last statement are printed to the standard output (unless they are exported).
+ * Errors are printed to the standard error output. When requested, timing summary is printed
+ * to the standard error output as a single line of JSON.
+ */
+class CliBatchRunner : public QObject
+{
+        Q_OBJECT
+
+    public:
+        enum ExitCode
+        {
+            SUCCESS = 0,
+            INVALID_ARGUMENTS = 1,
+            DB_ERROR = 2,
+            EXECUTION_ERROR = 3,
+            EXPORT_ERROR = 4,
+            IMPORT_ERROR = 5
+        };
+
+        struct Options
+        {
+            QString database;
+            QString sqlFile;
+            QString query;
+            QString exportFormat;
+            QString exportFile;
+            QString importFormat;
+            QString importFile;
+            QString importTable;
+            QString codec;
+            bool printTiming = false;
+
+            /**
+             * @brief Tells whether any of batch-only options was used.
+             * @return true if CLI should run in headless mode.
+             */
+            bool isBatchRequested() const;
+        };
+
+        explicit CliBatchRunner(const Options& options, QObject* parent = nullptr);
+
+        /**
+         * @brief Runs the batch job synchronously.
+         * @return Exit code for the application.
+         */
+        int run();
+
+    private:
+        struct Timing
+        {
+            qint64 prepare = 0;
+            qint64 exec = 0;
+            qint64 fetch = 0;
+            qint64 exportTime = 0;
+            qint64 import = 0;
+            qint64 rows = 0;
+            int statements = 0;
+        };
+
+        bool validateOptions();
+        bool openDb();
+        bool readQueries();
+        bool importData();
+        bool execPrecedingQueries();
+        bool execAndPrintLastQuery();
+        bool execAndExportLastQuery();
+        void printResults(QueryExecutor* executor, SqlQueryPtr results);
+        void printTiming(int exitCode);
+        void error(const QString& msg);
+
+        Options options;
+        Db* db = nullptr;
+        QStringList queries;
+        Timing timing;
+
+    private slots:
+        void printNotifiedError(const QString& msg);
+        void printNotifiedWarning(const QString& msg);
+};
+
+#endif // CLIBATCHRUNNER_H
@@ -18,6 +18,7 @@
 #include "clicommandcd.h"
 #include "clicommandtree.h"
 #include "clicommanddesc.h"
+#include "clicommandtimer.h"
 #include <QDebug>
 
 QHash<QString,CliCommandFactory::CliCommandCreatorFunc> CliCommandFactory::mapping;
@@ -44,6 +45,7 @@ void CliCommandFactory::init()
     REGISTER_CMD(CliCommandCd);
     REGISTER_CMD(CliCommandTree);
     REGISTER_CMD(CliCommandDesc);
+    REGISTER_CMD(CliCommandTimer);
 }
 
 CliCommand *CliCommandFactory::getCommand(const QString &cmdName)
@@ -11,6 +11,7 @@
 #include "common/compatibility.h"
 #include <QList>
 #include <QDebug>
+#include <QElapsedTimer>
 
 void CliCommandSql::execute()
 {
@@ -33,6 +34,7 @@ void CliCommandSql::execute()
 
     // Executor deletes itself later when called with lambda.
     QueryExecutor *executor = new QueryExecutor(db, syntax.getArgument(STRING));
+    connect(executor, SIGNAL(executionFinished(SqlQueryPtr)), this, SLOT(executionFinished()));
     connect(executor, SIGNAL(executionFinished(SqlQueryPtr)), this, SIGNAL(execComplete()));
     connect(executor, SIGNAL(executionFailed(int,QString)), this, SLOT(executionFailed(int,QString)));
     connect(executor, SIGNAL(executionFailed(int,QString)), this, SIGNAL(execComplete()));
@@ -42,21 +44,25 @@ void CliCommandSql::execute()
         if (results->isError())
             return; // should not happen, since results handler function is called only for successful executions
 
+        QElapsedTimer fetchTimer;
+        fetchTimer.start();
+        qint64 rows;
         switch (CFG_CLI.Console.ResultsDisplayMode.get())
         {
             case CliResultsDisplay::FIXED:
-                printResultsFixed(executor, results);
+                rows = printResultsFixed(executor, results);
                 break;
             case CliResultsDisplay::COLUMNS:
-                printResultsColumns(executor, results);
+                rows = printResultsColumns(executor, results);
                 break;
             case CliResultsDisplay::ROW:
-                printResultsRowByRow(executor, results);
+                rows = printResultsRowByRow(executor, results);
                 break;
             default:
-                printResultsClassic(executor, results);
+                rows = printResultsClassic(executor, results);
                 break;
         }
+        executor->recordFetch(fetchTimer.nsecsElapsed() / 1000, rows);
     });
 }
 
@@ -87,7 +93,7 @@ void CliCommandSql::defineSyntax()
     syntax.setStrictArgumentCount(false);
 }
 
-void CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr results)
+qint64 CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr results)
 {
     int resultColumnCount = executor->getResultColumns().size();
 
@@ -101,9 +107,11 @@ void CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr res
     SqlResultsRowPtr row;
     QList<QVariant> values;
     int i;
+    qint64 rowCnt = 0;
     while (results->hasNext())
     {
         row = results->next();
+        rowCnt++;
         i = 0;
         values = row->valueList().mid(0, resultColumnCount);
         for (QVariant value : values)
@@ -118,9 +126,10 @@ void CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr res
         qOut << "\n";
     }
     qOut.flush();
+    return rowCnt;
 }
 
-void CliCommandSql::printResultsFixed(QueryExecutor* executor, SqlQueryPtr results)
+qint64 CliCommandSql::printResultsFixed(QueryExecutor* executor, SqlQueryPtr results)
 {
     QList<QueryExecutor::ResultColumnPtr> resultColumns = executor->getResultColumns();
     int resultColumnsCount = resultColumns.size();
@@ -128,12 +137,12 @@ void CliCommandSql::printResultsFixed(QueryExecutor* executor, SqlQueryPtr resul
     int baseColWidth = termCols / resultColumns.size() - 1;
 
     if (resultColumnsCount == 0)
-        return;
+        return 0;
 
     if ((resultColumnsCount * 2 - 1) > termCols)
     {
         println(tr("Too many columns to display in %1 mode.").arg("FIXED"));
-        return;
+        return 0;
     }
 
     int width;
@@ -155,13 +164,18 @@ void CliCommandSql::printResultsFixed(QueryExecutor* executor, SqlQueryPtr resul
     printColumnHeader(widths, columns);
 
     // Data
+    qint64 rowCnt = 0;
     while (results->hasNext())
+    {
         printColumnDataRow(widths, results->next(), resultColumnsCount);
+        rowCnt++;
+    }
 
     qOut.flush();
+    return rowCnt;
 }
 
-void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr results)
+qint64 CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr results)
 {
     // Check if we don't have more columns than we can display
     QList<QueryExecutor::ResultColumnPtr> resultColumns = executor->getResultColumns();
@@ -169,13 +183,13 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
     int resultColumnsCount = resultColumns.size();
     QStringList headerNames;
     if (resultColumnsCount == 0)
-        return;
+        return 0;
 
     // Every column requires at least 1 character width + column separators between them
     if ((resultColumnsCount * 2 - 1) > termCols)
     {
         println(tr("Too many columns to display in %1 mode.").arg("COLUMNS"));
-        return;
+        return 0;
     }
 
     // Preload data (we will calculate column widths basing on real values)
@@ -233,9 +247,10 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
         printColumnDataRow(finalWidths, row, resultColumnsCount);
 
     qOut.flush();
+    return allRows.size();
 }
 
-void CliCommandSql::printResultsRowByRow(QueryExecutor* executor, SqlQueryPtr results)
+qint64 CliCommandSql::printResultsRowByRow(QueryExecutor* executor, SqlQueryPtr results)
 {
     // Columns
     int resultColumnCount = executor->getResultColumns().size();
@@ -271,6 +286,7 @@ void CliCommandSql::printResultsRowByRow(QueryExecutor* executor, SqlQueryPtr re
         rowCnt++;
     }
     qOut.flush();
+    return rowCnt - 1;
 }
 
 void CliCommandSql::shrinkColumns(QList<CliCommandSql::SortedColumnWidth*>& columnWidths, int termCols, int resultColumnsCount, int totalWidth)
@@ -405,6 +421,19 @@ void CliCommandSql::executionFailed(int code, const QString& msg)
     qOut.flush();
 }
 
+void CliCommandSql::executionFinished()
+{
+    if (!CFG_CLI.Console.Timer.get())
+        return;
+
+    QueryExecutor* executor = qobject_cast<QueryExecutor*>(sender());
+    if (!executor)
+        return;
+
+    qOut << executor->getExecutionProfile().toString() << "\n\n";
+    qOut.flush();
+}
+
 CliCommandSql::SortedColumnWidth::SortedColumnWidth()
 {
     dataWidth = 0;
@@ -49,10 +49,10 @@ class CliCommandSql : public CliCommand
                 int dataWidth;
         };
 
-        void printResultsClassic(QueryExecutor *executor, SqlQueryPtr results);
-        void printResultsFixed(QueryExecutor *executor, SqlQueryPtr results);
-        void printResultsColumns(QueryExecutor *executor, SqlQueryPtr results);
-        void printResultsRowByRow(QueryExecutor *executor, SqlQueryPtr results);
+        qint64 printResultsClassic(QueryExecutor *executor, SqlQueryPtr results);
+        qint64 printResultsFixed(QueryExecutor *executor, SqlQueryPtr results);
+        qint64 printResultsColumns(QueryExecutor *executor, SqlQueryPtr results);
+        qint64 printResultsRowByRow(QueryExecutor *executor, SqlQueryPtr results);
         void shrinkColumns(QList<SortedColumnWidth*>& columnWidths, int termCols, int resultColumnsCount, int totalWidth);
         void printColumnHeader(const QList<int>& widths, const QStringList& columns);
         void printColumnDataRow(const QList<int>& widths, const SqlResultsRowPtr& row, int rowIdCount);
@@ -61,6 +61,7 @@ class CliCommandSql : public CliCommand
 
     private slots:
         void executionFailed(int code, const QString& msg);
+        void executionFinished();
 };
 
 #endif // CLICOMMANDSQL_H
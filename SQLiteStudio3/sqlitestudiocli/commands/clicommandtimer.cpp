@@ -0,0 +1,37 @@
+#include "clicommandtimer.h"
+#include "cli_config.h"
+
+void CliCommandTimer::execute()
+{
+    if (syntax.isArgumentSet(STATE))
+        CFG_CLI.Console.Timer.set(syntax.getArgument(STATE).toLower() == "on");
+
+    if (CFG_CLI.Console.Timer.get())
+        println(tr("Query execution profile is printed after each query."));
+    else
+        println(tr("Query execution profile is not printed."));
+}
+
+QString CliCommandTimer::shortHelp() const
+{
+    return tr("enables or disables printing of query execution profile");
+}
+
+QString CliCommandTimer::fullHelp() const
+{
+    return tr(
+                "When called without argument, tells whether the query execution profile is printed. "
+                "When the argument is passed, the printing is turned on or off.\n"
+                "\n"
+                "The profile is printed after results of each query. It contains time spent on each step of query processing "
+                "(parsing, transparent database attaching, adding ROWID columns, etc.), number of times the query was parsed, "
+                "size of the SQL produced by each step, time of preparing the final query, time until the first row was available, "
+                "time spent on reading and printing rows and number of rows."
+                );
+}
+
+void CliCommandTimer::defineSyntax()
+{
+    syntax.setName("timer");
+    syntax.addStrictArgument(STATE, {"on", "off"}, false);
+}
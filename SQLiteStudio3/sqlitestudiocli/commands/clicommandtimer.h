@@ -0,0 +1,23 @@
+#ifndef CLICOMMANDTIMER_H
+#define CLICOMMANDTIMER_H
+
+#include "clicommand.h"
+
+class CliCommandTimer : public CliCommand
+{
+        Q_OBJECT
+
+    public:
+        void execute();
+        QString shortHelp() const;
+        QString fullHelp() const;
+        void defineSyntax();
+
+    private:
+        enum ArgIgs
+        {
+            STATE
+        };
+};
+
+#endif // CLICOMMANDTIMER_H
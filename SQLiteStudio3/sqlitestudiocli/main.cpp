@@ -4,17 +4,24 @@
 #include "commands/clicommand.h"
 #include "cli_config.h"
 #include "cliutils.h"
+#include "clibatchrunner.h"
 #include "qio.h"
 #include "climsghandler.h"
 #include "completionhelper.h"
 #include "services/updatemanager.h"
 #include "services/pluginmanager.h"
+#include "plugins/dbplugin.h"
+#include "plugins/scriptingplugin.h"
+#include "plugins/exportplugin.h"
+#include "plugins/importplugin.h"
+#include "common/startuptrace.h"
 #include <QCoreApplication>
 #include <QtGlobal>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 
 bool listPlugins = false;
+CliBatchRunner::Options batchOptions;
 
 QString cliHandleCmdLineArgs()
 {
@@ -30,6 +37,27 @@ QString cliHandleCmdLineArgs()
     parser.addOption(lemonDebugOption);
     parser.addOption(listPluginsOption);
 
+    QCommandLineOption executeOption({"e", "execute"}, QObject::tr("Executes SQL script from given file on the database and quits (batch mode)."), QObject::tr("SQL file"));
+    QCommandLineOption commandOption({"c", "command"}, QObject::tr("Executes given SQL query on the database and quits (batch mode)."), QObject::tr("SQL"));
+    QCommandLineOption databaseOption("database", QObject::tr("Database for batch mode, given as name from the database list or as a file path. Defaults to the positional file argument."), QObject::tr("name or path"));
+    QCommandLineOption exportFormatOption("export-format", QObject::tr("In batch mode exports results of the last statement using given format (like CSV, JSON, SQL)."), QObject::tr("format"));
+    QCommandLineOption exportFileOption("export-file", QObject::tr("Output file for the batch mode export. Use - for standard output."), QObject::tr("file"));
+    QCommandLineOption importFormatOption("import-format", QObject::tr("In batch mode imports data using given data source type (like CSV) before executing any SQL."), QObject::tr("type"));
+    QCommandLineOption importFileOption("import-file", QObject::tr("Input file for the batch mode import."), QObject::tr("file"));
+    QCommandLineOption importTableOption("import-table", QObject::tr("Target table for the batch mode import."), QObject::tr("table"));
+    QCommandLineOption codecOption("codec", QObject::tr("Text encoding used by the batch mode import and export."), QObject::tr("codec"));
+    QCommandLineOption timingOption("timing", QObject::tr("In batch mode prints timing summary as JSON on standard error output."));
+    parser.addOption(executeOption);
+    parser.addOption(commandOption);
+    parser.addOption(databaseOption);
+    parser.addOption(exportFormatOption);
+    parser.addOption(exportFileOption);
+    parser.addOption(importFormatOption);
+    parser.addOption(importFileOption);
+    parser.addOption(importTableOption);
+    parser.addOption(codecOption);
+    parser.addOption(timingOption);
+
     parser.addPositionalArgument(QObject::tr("file"), QObject::tr("Database file to open"));
 
     parser.process(qApp->arguments());
@@ -43,12 +71,50 @@ QString cliHandleCmdLineArgs()
     CompletionHelper::enableLemonDebug = parser.isSet(lemonDebugOption);
 
     QStringList args = parser.positionalArguments();
+
+    if (parser.isSet(executeOption))
+        batchOptions.sqlFile = parser.value(executeOption);
+
+    if (parser.isSet(commandOption))
+        batchOptions.query = parser.value(commandOption);
+
+    if (parser.isSet(exportFormatOption))
+        batchOptions.exportFormat = parser.value(exportFormatOption);
+
+    if (parser.isSet(importFormatOption))
+        batchOptions.importFormat = parser.value(importFormatOption);
+
+    batchOptions.database = parser.isSet(databaseOption) ? parser.value(databaseOption) : args.value(0);
+    batchOptions.exportFile = parser.value(exportFileOption);
+    batchOptions.importFile = parser.value(importFileOption);
+    batchOptions.importTable = parser.value(importTableOption);
+    batchOptions.codec = parser.value(codecOption);
+    batchOptions.printTiming = parser.isSet(timingOption);
+
     if (args.size() > 0)
         return args[0];
 
     return QString();
 }
 
+int runBatch()
+{
+    // Headless run does not need all plugins. Loading only required types shortens the startup.
+    QList<PluginType*> pluginTypes = {PLUGINS->getPluginType<DbPlugin>(), PLUGINS->getPluginType<ScriptingPlugin>()};
+    if (!batchOptions.exportFormat.isNull())
+        pluginTypes << PLUGINS->getPluginType<ExportPlugin>();
+
+    if (!batchOptions.importFormat.isNull())
+        pluginTypes << PLUGINS->getPluginType<ImportPlugin>();
+
+    PLUGINS->setStartupPluginTypes(pluginTypes);
+    SQLITESTUDIO->initPlugins();
+    StartupTrace::finish();
+
+    CliBatchRunner runner(batchOptions);
+    return runner.run();
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
@@ -65,7 +131,12 @@ int main(int argc, char *argv[])
 
     SQLITESTUDIO->setInitialTranslationFiles({"coreSQLiteStudio", "sqlitestudiocli"});
     SQLITESTUDIO->init(a.arguments(), false);
+
+    if (batchOptions.isBatchRequested())
+        return runBatch();
+
     SQLITESTUDIO->initPlugins();
+    StartupTrace::finish();
 
     if (listPlugins)
     {
@@ -35,6 +35,7 @@ portable {
 TRANSLATIONS += $$files(translations/*.ts)
 
 SOURCES += main.cpp \
+    clibatchrunner.cpp \
     cli.cpp \
     commands/clicommand.cpp \
     commands/clicommandfactory.cpp \
@@ -61,7 +62,8 @@ SOURCES += main.cpp \
     clicommandsyntax.cpp \
     commands/clicommandtree.cpp \
     clicompleter.cpp \
-    commands/clicommanddesc.cpp
+    commands/clicommanddesc.cpp \
+    commands/clicommandtimer.cpp
 
 LIBS += -lcoreSQLiteStudio
 
@@ -75,6 +77,7 @@ unix: {
 }
 
 HEADERS += \
+    clibatchrunner.h \
     cli.h \
     commands/clicommand.h \
     commands/clicommandfactory.h \
@@ -101,7 +104,8 @@ HEADERS += \
     clicommandsyntax.h \
     commands/clicommandtree.h \
     clicompleter.h \
-    commands/clicommanddesc.h
+    commands/clicommanddesc.h \
+    commands/clicommandtimer.h
 
 unix: {
     target.path = $$BINDIR